@@ -0,0 +1,376 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/AsyncLogger.h"
+
+#include "carla/Exception.h"
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace carla {
+namespace logging {
+
+  // ===========================================================================
+  // -- AsyncLogger::Record ----------------------------------------------------
+  // ===========================================================================
+
+  struct AsyncLogger::Record {
+    std::atomic_size_t sequence{0u};
+    size_t position;
+    uint64_t timestamp;
+    Level level;
+    const char *prefix;
+    WriteFunction write;
+    DestroyFunction destroy;
+    Storage storage;
+  };
+
+  // ===========================================================================
+  // -- AsyncLogger::Backend ---------------------------------------------------
+  // ===========================================================================
+
+  /// Ring buffer of records and the writer thread consuming them. The ring
+  /// buffer is a bounded multi-producer queue, see
+  /// http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+  class AsyncLogger::Backend : private NonCopyable {
+  public:
+
+    ~Backend() {
+      StopWriter();
+    }
+
+    void Start(Options options);
+
+    void Stop() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      StopWriter();
+    }
+
+    void Flush();
+
+    void *Reserve(Level level, const char *prefix, const void *call_site, Record *&record);
+
+    void Commit(Record *record, WriteFunction write, DestroyFunction destroy);
+
+    uint64_t GetDroppedCount() const {
+      return _dropped.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetSuppressedCount() const {
+      return _suppressed.load(std::memory_order_relaxed);
+    }
+
+  private:
+
+    struct CallSite {
+      std::atomic<uint64_t> second{0u};
+      std::atomic<uint32_t> count{0u};
+    };
+
+    static uint64_t Now() {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    void StopWriter();
+
+    bool IsRateExceeded(Level level, const void *call_site, uint64_t timestamp);
+
+    /// Writer thread loop, @a reported_dropped and @a reported_suppressed are
+    /// the number of dropped and suppressed messages already reported.
+    void Run(uint64_t reported_dropped, uint64_t reported_suppressed);
+
+    void Write(Level level, const char *prefix, uint64_t timestamp, const std::string &message);
+
+    std::mutex _mutex;
+
+    Options _options;
+
+    std::unique_ptr<Record[]> _records;
+
+    size_t _mask = 0u;
+
+    std::atomic_size_t _enqueue_position{0u};
+
+    std::atomic_size_t _written_position{0u};
+
+    std::atomic_size_t _producers{0u};
+
+    std::atomic<uint64_t> _dropped{0u};
+
+    std::atomic<uint64_t> _suppressed{0u};
+
+    std::atomic_bool _running{false};
+
+    std::array<CallSite, 1024u> _call_sites;
+
+    std::ofstream _file;
+
+    std::thread _thread;
+  };
+
+  void AsyncLogger::Backend::Start(Options options) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    StopWriter();
+    if (options.binary && options.file_path.empty()) {
+      throw_exception(std::invalid_argument("binary logging requires a file path"));
+    }
+    if (!options.file_path.empty()) {
+      _file.open(
+          options.file_path,
+          options.binary ? (std::ios::app | std::ios::binary) : std::ios::app);
+      if (!_file.is_open()) {
+        throw_exception(std::runtime_error("failed to open log file " + options.file_path));
+      }
+    }
+    size_t capacity = 2u;
+    while (capacity < options.capacity) {
+      capacity <<= 1u;
+    }
+    _records = std::make_unique<Record[]>(capacity);
+    for (auto i = 0u; i < capacity; ++i) {
+      _records[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _mask = capacity - 1u;
+    _enqueue_position = 0u;
+    _written_position = 0u;
+    for (auto &call_site : _call_sites) {
+      call_site.second = 0u;
+      call_site.count = 0u;
+    }
+    _options = std::move(options);
+    _running = true;
+    const auto dropped = _dropped.load();
+    const auto suppressed = _suppressed.load();
+    _thread = std::thread([this, dropped, suppressed]() { Run(dropped, suppressed); });
+    _enabled = true;
+  }
+
+  void AsyncLogger::Backend::StopWriter() {
+    _enabled = false;
+    // Wait for the calls that already reserved a record.
+    while (_producers.load() != 0u) {
+      std::this_thread::yield();
+    }
+    if (_thread.joinable()) {
+      _running = false;
+      _thread.join();
+    }
+    if (_file.is_open()) {
+      _file.close();
+    }
+  }
+
+  void AsyncLogger::Backend::Flush() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto target = _enqueue_position.load();
+    while (_thread.joinable() && (_written_position.load(std::memory_order_acquire) < target)) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+
+  bool AsyncLogger::Backend::IsRateExceeded(Level level, const void *call_site, uint64_t timestamp) {
+    const auto max_rate = _options.max_rate_per_call_site;
+    if ((call_site == nullptr) || (max_rate == 0u) || (level >= Level::Warning)) {
+      return false;
+    }
+    // Fibonacci hashing of the address and the level, call sites that collide
+    // share the same limit.
+    const auto key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(call_site)) ^ static_cast<uint64_t>(level);
+    const auto hash = key * 11400714819323198485ull;
+    auto &counter = _call_sites[hash % _call_sites.size()];
+    const uint64_t second = timestamp / 1'000'000'000u;
+    auto current = counter.second.load(std::memory_order_relaxed);
+    if ((current != second) &&
+        counter.second.compare_exchange_strong(current, second, std::memory_order_relaxed)) {
+      counter.count.store(0u, std::memory_order_relaxed);
+    }
+    return counter.count.fetch_add(1u, std::memory_order_relaxed) >= max_rate;
+  }
+
+  void *AsyncLogger::Backend::Reserve(
+      Level level,
+      const char *prefix,
+      const void *call_site,
+      Record *&record) {
+    ++_producers;
+    // Disabled between the check of the caller and now.
+    if (!_enabled.load()) {
+      --_producers;
+      return nullptr;
+    }
+    const auto timestamp = Now();
+    if (IsRateExceeded(level, call_site, timestamp)) {
+      _suppressed.fetch_add(1u, std::memory_order_relaxed);
+      --_producers;
+      return nullptr;
+    }
+    auto position = _enqueue_position.load(std::memory_order_relaxed);
+    for (;;) {
+      record = &_records[position & _mask];
+      const auto sequence = record->sequence.load(std::memory_order_acquire);
+      const auto difference =
+          static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+      if (difference == 0) {
+        if (_enqueue_position.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        // Full.
+        _dropped.fetch_add(1u, std::memory_order_relaxed);
+        --_producers;
+        return nullptr;
+      } else {
+        position = _enqueue_position.load(std::memory_order_relaxed);
+      }
+    }
+    record->position = position;
+    record->timestamp = timestamp;
+    record->level = level;
+    record->prefix = prefix;
+    return &record->storage;
+  }
+
+  void AsyncLogger::Backend::Commit(Record *record, WriteFunction write, DestroyFunction destroy) {
+    record->write = write;
+    record->destroy = destroy;
+    record->sequence.store(record->position + 1u, std::memory_order_release);
+    --_producers;
+  }
+
+  void AsyncLogger::Backend::Write(
+      Level level,
+      const char *prefix,
+      uint64_t timestamp,
+      const std::string &message) {
+    if (_options.binary) {
+      const auto level_value = static_cast<uint8_t>(level);
+      const auto size = static_cast<uint32_t>(message.size());
+      _file.write(reinterpret_cast<const char *>(&timestamp), sizeof(timestamp));
+      _file.write(reinterpret_cast<const char *>(&level_value), sizeof(level_value));
+      _file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+      _file.write(message.data(), size);
+      return;
+    }
+    std::ostream &out =
+        _file.is_open() ? _file :
+        (level >= Level::Warning ? std::cerr : std::cout);
+    // Same format as the synchronous log functions.
+    if (prefix != nullptr) {
+      out << prefix << ' ';
+    }
+    out << message << " \n";
+  }
+
+  void AsyncLogger::Backend::Run(uint64_t reported_dropped, uint64_t reported_suppressed) {
+    const auto capacity = _mask + 1u;
+    size_t position = 0u;
+    std::ostringstream message;
+    for (;;) {
+      const bool running = _running.load(std::memory_order_acquire);
+      size_t count = 0u;
+      for (;;) {
+        auto &record = _records[position & _mask];
+        if (record.sequence.load(std::memory_order_acquire) != position + 1u) {
+          break;
+        }
+        message.str({});
+        record.write(message, &record.storage);
+        record.destroy(&record.storage);
+        Write(record.level, record.prefix, record.timestamp, message.str());
+        record.sequence.store(position + capacity, std::memory_order_release);
+        ++position;
+        ++count;
+      }
+      const auto dropped = _dropped.load(std::memory_order_relaxed);
+      if (dropped != reported_dropped) {
+        Write(
+            Level::Warning,
+            "WARNING:",
+            Now(),
+            "async logger dropped " + std::to_string(dropped - reported_dropped) +
+            " messages, the buffer was full");
+        reported_dropped = dropped;
+        ++count;
+      }
+      const auto suppressed = _suppressed.load(std::memory_order_relaxed);
+      if (suppressed != reported_suppressed) {
+        Write(
+            Level::Warning,
+            "WARNING:",
+            Now(),
+            "async logger suppressed " + std::to_string(suppressed - reported_suppressed) +
+            " messages exceeding the maximum rate");
+        reported_suppressed = suppressed;
+        ++count;
+      }
+      if (count > 0u) {
+        if (_file.is_open()) {
+          _file.flush();
+        } else {
+          std::cout.flush();
+          std::cerr.flush();
+        }
+        _written_position.store(position, std::memory_order_release);
+      } else if (!running) {
+        break;
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+  // ===========================================================================
+  // -- AsyncLogger ------------------------------------------------------------
+  // ===========================================================================
+
+  std::atomic_bool AsyncLogger::_enabled{false};
+
+  AsyncLogger::Backend &AsyncLogger::GetBackend() {
+    static Backend backend;
+    return backend;
+  }
+
+  void AsyncLogger::Enable(Options options) {
+    GetBackend().Start(std::move(options));
+  }
+
+  void AsyncLogger::Disable() {
+    GetBackend().Stop();
+  }
+
+  void AsyncLogger::Flush() {
+    GetBackend().Flush();
+  }
+
+  uint64_t AsyncLogger::GetDroppedCount() {
+    return GetBackend().GetDroppedCount();
+  }
+
+  uint64_t AsyncLogger::GetSuppressedCount() {
+    return GetBackend().GetSuppressedCount();
+  }
+
+  void *AsyncLogger::Reserve(
+      Level level,
+      const char *prefix,
+      const void *call_site,
+      Record *&record) {
+    return GetBackend().Reserve(level, prefix, call_site, record);
+  }
+
+  void AsyncLogger::Commit(Record *record, WriteFunction write, DestroyFunction destroy) {
+    GetBackend().Commit(record, write, destroy);
+  }
+
+} // namespace logging
+} // namespace carla
@@ -0,0 +1,247 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/Platform.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace carla {
+namespace logging {
+
+  enum class Level : uint8_t {
+    Log      =  0u,
+    Debug    = 10u,
+    Info     = 20u,
+    Warning  = 30u,
+    Error    = 40u,
+    Critical = 50u
+  };
+
+namespace detail {
+
+  // https://stackoverflow.com/a/27375675
+  template <typename Arg, typename ... Args>
+  LIBCARLA_NOINLINE
+  static void write_arguments(std::ostream &out, Arg &&arg, Args && ... args) {
+    out << std::boolalpha << std::forward<Arg>(arg);
+    using expander = int[];
+    (void) expander{0, (void(out << ' ' << std::forward<Args>(args)), 0) ...};
+  }
+
+  /// Character arrays are string literals in practice and are kept by
+  /// pointer, character pointers may point to a temporary buffer (e.g.
+  /// `c_str()` or `what()`) and are copied.
+  template <typename T>
+  struct stored_argument {
+    using decayed = std::decay_t<T>;
+    using array = std::remove_reference_t<T>;
+    static constexpr bool is_char_pointer =
+        std::is_same<decayed, const char *>::value ||
+        std::is_same<decayed, char *>::value;
+    static constexpr bool is_literal =
+        std::is_array<array>::value &&
+        std::is_const<std::remove_extent_t<array>>::value;
+    using type = std::conditional_t<
+        is_char_pointer && !is_literal,
+        std::string,
+        decayed>;
+  };
+
+  template <typename T>
+  using stored_argument_t = typename stored_argument<T>::type;
+
+  template <bool... Bs>
+  using all_true = std::is_same<
+      std::integer_sequence<bool, true, Bs...>,
+      std::integer_sequence<bool, Bs..., true>>;
+
+  template <typename T>
+  static inline const void *get_call_site_impl(T &&arg, std::true_type) {
+    return static_cast<const void *>(arg);
+  }
+
+  template <typename T>
+  static inline const void *get_call_site_impl(T &&, std::false_type) {
+    return nullptr;
+  }
+
+  /// The address of the string literal a log call starts with identifies its
+  /// call site; calls not starting with a literal are never rate limited. The
+  /// linker may merge identical literals, so calls starting with the same
+  /// text at the same level share their rate.
+  template <typename T, typename ... Args>
+  static inline const void *get_call_site(T &&arg, Args && ...) {
+    return get_call_site_impl(
+        std::forward<T>(arg),
+        std::integral_constant<bool, stored_argument<T>::is_literal>{});
+  }
+
+  /// Arguments of a log call copied into a ring buffer slot, formatted later
+  /// by the writer thread.
+  template <typename ... Ts>
+  class LogArguments {
+  public:
+
+    template <typename ... Args>
+    explicit LogArguments(Args && ... args)
+      : _arguments(std::forward<Args>(args)...) {}
+
+    static void Write(std::ostream &out, void *self) {
+      static_cast<LogArguments *>(self)->Write(out, std::index_sequence_for<Ts...>{});
+    }
+
+    static void Destroy(void *self) {
+      static_cast<LogArguments *>(self)->~LogArguments();
+    }
+
+  private:
+
+    template <size_t ... Is>
+    void Write(std::ostream &out, std::index_sequence<Is...>) {
+      write_arguments(out, std::get<Is>(_arguments)...);
+    }
+
+    std::tuple<Ts...> _arguments;
+  };
+
+} // namespace detail
+
+  /// Logging backend that moves the formatting and the output of log messages
+  /// out of the calling thread.
+  ///
+  /// Each log call copies its arguments into a slot of a fixed-size lock-free
+  /// ring buffer and returns; a background thread formats the messages and
+  /// writes them out. The calling thread never blocks: if the buffer is full
+  /// the message is dropped. Messages below Level::Warning from a call site
+  /// exceeding the maximum rate are suppressed, warnings and errors are never
+  /// rate limited. The number of dropped and suppressed messages is reported
+  /// in the output.
+  ///
+  /// Disabled by default, while disabled log calls are written synchronously
+  /// as usual.
+  class AsyncLogger : private NonCopyable {
+  public:
+
+    struct Options {
+      /// Number of messages the ring buffer can hold, rounded up to a power of
+      /// two.
+      size_t capacity = 4096u;
+
+      /// Maximum number of messages per second from each call site, 0 for no
+      /// limit. Applies only to messages below Level::Warning.
+      uint32_t max_rate_per_call_site = 100u;
+
+      /// Write the messages to this file instead of stdout and stderr.
+      std::string file_path;
+
+      /// Write binary records instead of lines of text, each record is the
+      /// timestamp in nanoseconds since epoch (uint64), the level (uint8), the
+      /// size of the message (uint32) and the message. Requires a file_path.
+      bool binary = false;
+    };
+
+    /// Starts the writer thread with @a options, restarting it if it was
+    /// already running.
+    static void Enable(Options options);
+
+    /// Writes the pending messages and stops the writer thread.
+    static void Disable();
+
+    static bool IsEnabled() {
+      return _enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Waits until every message logged before this call is written.
+    static void Flush();
+
+    /// Number of messages dropped because the buffer was full.
+    static uint64_t GetDroppedCount();
+
+    /// Number of messages suppressed because their call site exceeded its
+    /// rate.
+    static uint64_t GetSuppressedCount();
+
+    template <typename ... Args>
+    static void Push(Level level, const char *prefix, Args && ... args);
+
+  private:
+
+    struct Record;
+
+    class Backend;
+
+    static Backend &GetBackend();
+
+    /// Bytes available to store the arguments of each message, calls with
+    /// larger arguments are formatted in the calling thread.
+    static constexpr size_t STORAGE_SIZE = 192u;
+
+    using Storage = std::aligned_storage_t<STORAGE_SIZE, alignof(std::max_align_t)>;
+
+    using WriteFunction = void (*)(std::ostream &, void *);
+
+    using DestroyFunction = void (*)(void *);
+
+    /// Returns the storage of a free slot, or nullptr if the message has to
+    /// be dropped. Must be followed by a call to Commit.
+    static void *Reserve(Level level, const char *prefix, const void *call_site, Record *&record);
+
+    static void Commit(Record *record, WriteFunction write, DestroyFunction destroy);
+
+    template <typename ... Args>
+    static auto MakeArguments(std::true_type, Args && ... args) {
+      return detail::LogArguments<detail::stored_argument_t<Args>...>(std::forward<Args>(args)...);
+    }
+
+    template <typename ... Args>
+    static auto MakeArguments(std::false_type, Args && ... args) {
+      std::ostringstream out;
+      detail::write_arguments(out, std::forward<Args>(args)...);
+      return detail::LogArguments<std::string>(out.str());
+    }
+
+    static std::atomic_bool _enabled;
+  };
+
+  template <typename ... Args>
+  LIBCARLA_NOINLINE
+  void AsyncLogger::Push(Level level, const char *prefix, Args && ... args) {
+    using Arguments = detail::LogArguments<detail::stored_argument_t<Args>...>;
+    using is_copyable = detail::all_true<
+        std::is_constructible<detail::stored_argument_t<Args>, Args &&>::value...>;
+    using fits = std::integral_constant<bool,
+        (sizeof(Arguments) <= STORAGE_SIZE) &&
+        (alignof(Arguments) <= alignof(Storage)) &&
+        is_copyable::value &&
+        std::is_nothrow_move_constructible<Arguments>::value>;
+    const void *call_site = detail::get_call_site(args...);
+    // Copy the arguments before taking a slot, so a throwing copy cannot
+    // leave the slot reserved.
+    auto arguments = MakeArguments(fits{}, std::forward<Args>(args)...);
+    using ArgumentsT = decltype(arguments);
+    Record *record = nullptr;
+    void *storage = Reserve(level, prefix, call_site, record);
+    if (storage != nullptr) {
+      new (storage) ArgumentsT(std::move(arguments));
+      Commit(record, &ArgumentsT::Write, &ArgumentsT::Destroy);
+    }
+  }
+
+} // namespace logging
+} // namespace carla
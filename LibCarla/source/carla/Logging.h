@@ -35,29 +35,41 @@
 //
 //  * LOG_DEBUG_ONLY(/* code here */)
 //  * LOG_INFO_ONLY(/* code here */)
+//
+// The messages are written synchronously by the calling thread, unless the
+// asynchronous backend is enabled with logging::AsyncLogger::Enable.
 
 // =============================================================================
 // -- Implementation of log functions ------------------------------------------
 // =============================================================================
 
+#include "carla/AsyncLogger.h"
+
 #include <iostream>
 
 namespace carla {
 
 namespace logging {
 
-  // https://stackoverflow.com/a/27375675
   template <typename Arg, typename ... Args>
-  LIBCARLA_NOINLINE
-  static void write_to_stream(std::ostream &out, Arg &&arg, Args && ... args) {
-    out << std::boolalpha << std::forward<Arg>(arg);
-    using expander = int[];
-    (void) expander{0, (void(out << ' ' << std::forward<Args>(args)), 0) ...};
+  static inline void write_to_stream(std::ostream &out, Arg &&arg, Args && ... args) {
+    detail::write_arguments(out, std::forward<Arg>(arg), std::forward<Args>(args) ...);
+  }
+
+  template <typename ... Args>
+  static inline void write(std::ostream &out, Level level, const char *prefix, Args && ... args) {
+    if (AsyncLogger::IsEnabled()) {
+      AsyncLogger::Push(level, prefix, std::forward<Args>(args) ...);
+    } else if (prefix != nullptr) {
+      logging::write_to_stream(out, prefix, std::forward<Args>(args) ..., '\n');
+    } else {
+      logging::write_to_stream(out, std::forward<Args>(args) ..., '\n');
+    }
   }
 
   template <typename ... Args>
   static inline void log(Args && ... args) {
-    logging::write_to_stream(std::cout, std::forward<Args>(args) ..., '\n');
+    logging::write(std::cout, Level::Log, nullptr, std::forward<Args>(args) ...);
   }
 
 } // namespace logging
@@ -66,7 +78,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_debug(Args && ... args) {
-    logging::write_to_stream(std::cout, "DEBUG:", std::forward<Args>(args) ..., '\n');
+    logging::write(std::cout, logging::Level::Debug, "DEBUG:", std::forward<Args>(args) ...);
   }
 
 #else
@@ -80,7 +92,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_info(Args && ... args) {
-    logging::write_to_stream(std::cout, "INFO: ", std::forward<Args>(args) ..., '\n');
+    logging::write(std::cout, logging::Level::Info, "INFO: ", std::forward<Args>(args) ...);
   }
 
 #else
@@ -94,7 +106,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_warning(Args && ... args) {
-    logging::write_to_stream(std::cerr, "WARNING:", std::forward<Args>(args) ..., '\n');
+    logging::write(std::cerr, logging::Level::Warning, "WARNING:", std::forward<Args>(args) ...);
   }
 
 #else
@@ -108,7 +120,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_error(Args && ... args) {
-    logging::write_to_stream(std::cerr, "ERROR:", std::forward<Args>(args) ..., '\n');
+    logging::write(std::cerr, logging::Level::Error, "ERROR:", std::forward<Args>(args) ...);
   }
 
 #else
@@ -122,7 +134,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_critical(Args && ... args) {
-    logging::write_to_stream(std::cerr, "CRITICAL:", std::forward<Args>(args) ..., '\n');
+    logging::write(std::cerr, logging::Level::Critical, "CRITICAL:", std::forward<Args>(args) ...);
   }
 
 #else
@@ -0,0 +1,239 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/NonCopyable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace carla {
+
+  /// A move-only callable taking no arguments and returning nothing. Callables
+  /// up to INLINE_SIZE bytes that can be moved without throwing are stored
+  /// inline, so wrapping them does not allocate; bigger ones are stored in the
+  /// heap.
+  class Task {
+  public:
+
+    static constexpr size_t INLINE_SIZE = 48u;
+
+    Task() noexcept = default;
+
+    template <
+        typename FunctorT,
+        typename = typename std::enable_if<
+            !std::is_same<typename std::decay<FunctorT>::type, Task>::value>::type>
+    Task(FunctorT &&functor) {
+      using F = typename std::decay<FunctorT>::type;
+      Emplace<F>(std::forward<FunctorT>(functor), std::integral_constant<bool, IsInline<F>()>{});
+    }
+
+    Task(Task &&rhs) noexcept {
+      MoveFrom(rhs);
+    }
+
+    Task &operator=(Task &&rhs) noexcept {
+      if (this != &rhs) {
+        Reset();
+        MoveFrom(rhs);
+      }
+      return *this;
+    }
+
+    Task(const Task &) = delete;
+
+    Task &operator=(const Task &) = delete;
+
+    ~Task() {
+      Reset();
+    }
+
+    explicit operator bool() const noexcept {
+      return _operations != nullptr;
+    }
+
+    void operator()() {
+      DEBUG_ASSERT(_operations != nullptr);
+      _operations->invoke(&_storage);
+    }
+
+    void Reset() noexcept {
+      if (_operations != nullptr) {
+        _operations->destroy(&_storage);
+        _operations = nullptr;
+      }
+    }
+
+    /// Whether a callable of type @a F is stored without allocating.
+    template <typename F>
+    static constexpr bool IsInline() {
+      return (sizeof(F) <= INLINE_SIZE) &&
+             (alignof(F) <= alignof(std::max_align_t)) &&
+             std::is_nothrow_move_constructible<F>::value;
+    }
+
+  private:
+
+    struct Operations {
+      void (*invoke)(void *storage);
+      /// Move-constructs the callable in @a to and destroys the one in @a from.
+      void (*relocate)(void *from, void *to);
+      void (*destroy)(void *storage);
+    };
+
+    template <typename F>
+    struct InlineOperations {
+      static void Invoke(void *storage) {
+        (*static_cast<F *>(storage))();
+      }
+      static void Relocate(void *from, void *to) noexcept {
+        auto *functor = static_cast<F *>(from);
+        new (to) F(std::move(*functor));
+        functor->~F();
+      }
+      static void Destroy(void *storage) noexcept {
+        static_cast<F *>(storage)->~F();
+      }
+      static const Operations *Get() {
+        static constexpr Operations operations{&Invoke, &Relocate, &Destroy};
+        return &operations;
+      }
+    };
+
+    template <typename F>
+    struct HeapOperations {
+      static F *&Pointer(void *storage) {
+        return *static_cast<F **>(storage);
+      }
+      static void Invoke(void *storage) {
+        (*Pointer(storage))();
+      }
+      static void Relocate(void *from, void *to) noexcept {
+        new (to) F *(Pointer(from));
+      }
+      static void Destroy(void *storage) noexcept {
+        delete Pointer(storage);
+      }
+      static const Operations *Get() {
+        static constexpr Operations operations{&Invoke, &Relocate, &Destroy};
+        return &operations;
+      }
+    };
+
+    template <typename F, typename FunctorT>
+    void Emplace(FunctorT &&functor, std::true_type /* inline */) {
+      new (&_storage) F(std::forward<FunctorT>(functor));
+      _operations = InlineOperations<F>::Get();
+    }
+
+    template <typename F, typename FunctorT>
+    void Emplace(FunctorT &&functor, std::false_type /* inline */) {
+      new (&_storage) F *(new F(std::forward<FunctorT>(functor)));
+      _operations = HeapOperations<F>::Get();
+    }
+
+    void MoveFrom(Task &rhs) noexcept {
+      if (rhs._operations != nullptr) {
+        rhs._operations->relocate(&rhs._storage, &_storage);
+        _operations = rhs._operations;
+        rhs._operations = nullptr;
+      }
+    }
+
+    typename std::aligned_storage<INLINE_SIZE, alignof(std::max_align_t)>::type _storage;
+
+    const Operations *_operations = nullptr;
+  };
+
+namespace detail {
+
+  /// A double-ended queue of tasks. The owner pushes and pops at the back,
+  /// the most recent task, while other threads steal from the front. The
+  /// memory of the queue is reused, pushing only allocates when the queue
+  /// grows beyond its largest size so far.
+  class TaskDeque : private NonCopyable {
+  public:
+
+    void Push(Task &&task) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_size == _tasks.size()) {
+        Grow();
+      }
+      _tasks[(_head + _size) & (_tasks.size() - 1u)] = std::move(task);
+      ++_size;
+      _approximate_size = _size;
+    }
+
+    bool Pop(Task &task) {
+      if (_approximate_size == 0u) {
+        return false;
+      }
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_size == 0u) {
+        return false;
+      }
+      --_size;
+      _approximate_size = _size;
+      task = std::move(_tasks[(_head + _size) & (_tasks.size() - 1u)]);
+      return true;
+    }
+
+    bool Steal(Task &task) {
+      if (_approximate_size == 0u) {
+        return false;
+      }
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_size == 0u) {
+        return false;
+      }
+      task = std::move(_tasks[_head]);
+      _head = (_head + 1u) & (_tasks.size() - 1u);
+      --_size;
+      _approximate_size = _size;
+      return true;
+    }
+
+    /// Whether the queue is empty, without locking.
+    bool IsEmpty() const {
+      return _approximate_size == 0u;
+    }
+
+  private:
+
+    void Grow() {
+      std::vector<Task> tasks(std::max<size_t>(16u, 2u * _tasks.size()));
+      for (size_t i = 0u; i < _size; ++i) {
+        tasks[i] = std::move(_tasks[(_head + i) & (_tasks.size() - 1u)]);
+      }
+      _tasks = std::move(tasks);
+      _head = 0u;
+    }
+
+    std::mutex _mutex;
+
+    /// Ring buffer, its size is always a power of two.
+    std::vector<Task> _tasks;
+
+    size_t _head = 0u;
+
+    size_t _size = 0u;
+
+    /// Copy of _size readable without locking, sequentially consistent so
+    /// ThreadPool can tell whether a worker may go to sleep.
+    std::atomic_size_t _approximate_size{0u};
+  };
+
+} // namespace detail
+} // namespace carla
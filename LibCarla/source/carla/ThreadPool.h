@@ -6,24 +6,133 @@
 
 #pragma once
 
-#include "carla/MoveHandler.h"
 #include "carla/NonCopyable.h"
+#include "carla/Task.h"
 #include "carla/ThreadGroup.h"
 #include "carla/Time.h"
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/post.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <future>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <type_traits>
 
 namespace carla {
 
-  /// A thread pool based on Boost.Asio's io context.
+namespace detail {
+
+  /// Shared state of a ThreadPool::ParallelFor call, the range is split in
+  /// chunks that the participating threads claim one at a time.
+  class ParallelForState : private NonCopyable {
+  public:
+
+    using call_type = void (*)(void *func, size_t begin, size_t end);
+
+    ParallelForState(size_t size, size_t grain_size, void *func, call_type call)
+      : _size(size),
+        _grain_size(grain_size),
+        _number_of_chunks((size + grain_size - 1u) / grain_size),
+        _func(func),
+        _call(call),
+        _remaining(_number_of_chunks) {}
+
+    /// Run chunks until there are none left to claim. The function is only
+    /// accessed while some chunk is pending, so this can be called after the
+    /// ParallelFor call returned.
+    void Work() {
+      for (auto chunk = _next++; chunk < _number_of_chunks; chunk = _next++) {
+        const auto begin = chunk * _grain_size;
+        const auto end = std::min(begin + _grain_size, _size);
+        if (!_failed) {
+#ifndef LIBCARLA_NO_EXCEPTIONS
+          try {
+#endif // LIBCARLA_NO_EXCEPTIONS
+            _call(_func, begin, end);
+#ifndef LIBCARLA_NO_EXCEPTIONS
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_exception == nullptr) {
+              _exception = std::current_exception();
+            }
+            _failed = true;
+          }
+#endif // LIBCARLA_NO_EXCEPTIONS
+        }
+        if (--_remaining == 0u) {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _condition.notify_all();
+        }
+      }
+    }
+
+    /// Block until every chunk is done. Chunks are only run by threads that
+    /// already claimed them, so this never waits for a queued task.
+    void Wait() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this]() { return _remaining == 0u; });
+#ifndef LIBCARLA_NO_EXCEPTIONS
+      if (_exception != nullptr) {
+        std::rethrow_exception(_exception);
+      }
+#endif // LIBCARLA_NO_EXCEPTIONS
+    }
+
+    size_t GetNumberOfChunks() const {
+      return _number_of_chunks;
+    }
+
+  private:
+
+    const size_t _size;
+
+    const size_t _grain_size;
+
+    const size_t _number_of_chunks;
+
+    void *const _func;
+
+    const call_type _call;
+
+    std::atomic_size_t _next{0u};
+
+    std::atomic_size_t _remaining;
+
+    std::atomic_bool _failed{false};
+
+    std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    std::exception_ptr _exception;
+  };
+
+} // namespace detail
+
+  /// A thread pool based on Boost.Asio's io context, with a work-stealing
+  /// scheduler for the tasks posted with Post and ParallelFor.
+  ///
+  /// Each thread running the pool owns a queue of tasks; tasks posted from a
+  /// worker go to its own queue, tasks posted from other threads are spread
+  /// among the queues, and idle workers steal from the others. Workers wait
+  /// for tasks inside the io_context, so they keep serving its handlers too.
   class ThreadPool : private NonCopyable {
   public:
 
+    /// Threads beyond this number share the queues of the first ones.
+    static constexpr size_t MAX_QUEUES = 64u;
+
+    /// Number of tasks a busy worker runs between polls of the io_context.
+    static constexpr size_t TASKS_PER_POLL = 16u;
+
     ThreadPool() : _work_to_do(_io_context) {}
 
     /// Stops the ThreadPool and joins all its threads.
@@ -41,14 +150,59 @@ namespace carla {
     std::future<ResultT> Post(FunctorT &&functor) {
       auto task = std::packaged_task<ResultT()>(std::forward<FunctorT>(functor));
       auto future = task.get_future();
-      boost::asio::post(_io_context, carla::MoveHandler(task));
+      Schedule(Task(std::move(task)));
       return future;
     }
 
+    /// Call @a func(i) for each i in [0, size), in chunks of @a grain_size
+    /// consecutive indices, or of a size that gives a few chunks per worker if
+    /// zero. The calling thread takes part and blocks until all the calls are
+    /// done, the first exception thrown by @a func is rethrown.
+    ///
+    /// Can be called from the pool's own tasks, and works even if the pool is
+    /// not running, in which case all the calls are made by the caller.
+    template <typename FuncT>
+    void ParallelFor(size_t size, size_t grain_size, FuncT &&func) {
+      if (size == 0u) {
+        return;
+      }
+      // Threads launched by AsyncRun count even before they start running.
+      const size_t workers = std::min<size_t>(
+          std::max(_number_of_workers.load(), _number_of_async_workers.load()),
+          size_t(MAX_QUEUES));
+      if (grain_size == 0u) {
+        grain_size = std::max<size_t>(1u, size / (4u * (workers + 1u)));
+      }
+      using F = typename std::remove_reference<FuncT>::type;
+      auto call = [](void *f, size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+          (*static_cast<F *>(f))(i);
+        }
+      };
+      auto state = std::make_shared<detail::ParallelForState>(
+          size,
+          grain_size,
+          const_cast<void *>(static_cast<const void *>(std::addressof(func))),
+          call);
+      const auto helpers = std::min(state->GetNumberOfChunks() - 1u, workers);
+      for (size_t i = 0u; i < helpers; ++i) {
+        Schedule(Task([state]() { state->Work(); }));
+      }
+      state->Work();
+      state->Wait();
+    }
+
+    /// @copydoc ParallelFor(size_t, size_t, FuncT &&)
+    template <typename FuncT>
+    void ParallelFor(size_t size, FuncT &&func) {
+      ParallelFor(size, 0u, std::forward<FuncT>(func));
+    }
+
     /// Launch threads to run tasks asynchronously. Launch specific number of
     /// threads if @a worker_threads is provided, otherwise use all available
     /// hardware concurrency.
     void AsyncRun(size_t worker_threads) {
+      _number_of_async_workers += worker_threads;
       _workers.CreateThreads(worker_threads, [this]() { Run(); });
     }
 
@@ -61,7 +215,7 @@ namespace carla {
     ///
     /// @warning This function blocks until the ThreadPool has been stopped.
     void Run() {
-      _io_context.run();
+      RunWorker(false, std::chrono::steady_clock::time_point{});
     }
 
     /// Run tasks in this thread for an specific @a duration.
@@ -69,21 +223,125 @@ namespace carla {
     /// @warning This function blocks until the ThreadPool has been stopped, or
     /// until the specified time duration has elapsed.
     void RunFor(time_duration duration) {
-      _io_context.run_for(duration.to_chrono());
+      RunWorker(true, std::chrono::steady_clock::now() + duration.to_chrono());
     }
 
     /// Stop the ThreadPool and join all its threads.
     void Stop() {
       _io_context.stop();
       _workers.JoinAll();
+      _number_of_async_workers = 0u;
     }
 
   private:
 
+    /// The pool and queue of the worker running in this thread, if any.
+    struct WorkerContext {
+      ThreadPool *pool = nullptr;
+      size_t queue = 0u;
+    };
+
+    static WorkerContext &GetWorkerContext() {
+      static thread_local WorkerContext context;
+      return context;
+    }
+
+    /// Number of queues in use, never decreases so no task is left behind.
+    size_t GetNumberOfQueues() const {
+      return std::max<size_t>(1u, std::min<size_t>(_number_of_queues.load(), size_t(MAX_QUEUES)));
+    }
+
+    void Schedule(Task &&task) {
+      const auto &context = GetWorkerContext();
+      const auto queue = context.pool == this ?
+          context.queue :
+          _next_queue.fetch_add(1u, std::memory_order_relaxed) % GetNumberOfQueues();
+      _queues[queue].Push(std::move(task));
+      // Pairs with the check in RunWorker, either the worker sees the task or
+      // we see the worker.
+      if (_sleeping_workers > 0u) {
+        boost::asio::post(_io_context, []() {});
+      }
+    }
+
+    bool TryRunTask(size_t queue) {
+      Task task;
+      if (!_queues[queue].Pop(task)) {
+        const auto count = GetNumberOfQueues();
+        for (size_t i = 1u; i < count; ++i) {
+          if (_queues[(queue + i) % count].Steal(task)) {
+            break;
+          }
+        }
+      }
+      if (task) {
+        task();
+        return true;
+      }
+      return false;
+    }
+
+    bool HasPendingTasks() const {
+      const auto count = GetNumberOfQueues();
+      for (size_t i = 0u; i < count; ++i) {
+        if (!_queues[i].IsEmpty()) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void RunWorker(bool has_deadline, std::chrono::steady_clock::time_point deadline) {
+      auto &context = GetWorkerContext();
+      const auto previous_context = context;
+      context.pool = this;
+      context.queue = _number_of_workers++ % MAX_QUEUES;
+      auto queues = _number_of_queues.load();
+      while ((queues <= context.queue) &&
+             !_number_of_queues.compare_exchange_weak(queues, context.queue + 1u));
+      size_t tasks_since_poll = 0u;
+      while (!_io_context.stopped() &&
+             (!has_deadline || (std::chrono::steady_clock::now() < deadline))) {
+        if (TryRunTask(context.queue)) {
+          if (++tasks_since_poll == TASKS_PER_POLL) {
+            tasks_since_poll = 0u;
+            _io_context.poll();
+          }
+          continue;
+        }
+        tasks_since_poll = 0u;
+        ++_sleeping_workers;
+        if (!HasPendingTasks()) {
+          if (has_deadline) {
+            _io_context.run_one_until(deadline);
+          } else {
+            _io_context.run_one();
+          }
+        }
+        --_sleeping_workers;
+      }
+      --_number_of_workers;
+      context = previous_context;
+    }
+
     boost::asio::io_context _io_context;
 
     boost::asio::io_context::work _work_to_do;
 
+    std::array<detail::TaskDeque, MAX_QUEUES> _queues;
+
+    std::atomic_size_t _number_of_queues{0u};
+
+    /// Threads running the pool, either launched by AsyncRun or calling Run.
+    std::atomic_size_t _number_of_workers{0u};
+
+    /// Threads launched by AsyncRun and not yet joined.
+    std::atomic_size_t _number_of_async_workers{0u};
+
+    std::atomic_size_t _sleeping_workers{0u};
+
+    std::atomic_size_t _next_queue{0u};
+
     ThreadGroup _workers;
   };
 
@@ -0,0 +1,85 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/WildcardPattern.h"
+
+#include "carla/StringUtil.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace carla {
+
+  /// Maximum number of patterns kept compiled, the cache is flushed when full.
+  static constexpr size_t MAX_CACHED_PATTERNS = 1024u;
+
+  WildcardPattern::WildcardPattern(std::string pattern)
+    : _pattern(std::move(pattern)) {
+#ifndef _WIN32
+    // On Windows StringUtil::Match uses PathMatchSpec, which is case
+    // insensitive, thus every pattern goes through it.
+    _is_simple = (_pattern.find_first_of("?[\\") == std::string::npos);
+#endif // _WIN32
+    if (_is_simple) {
+      size_t begin = 0u;
+      size_t end;
+      while ((end = _pattern.find('*', begin)) != std::string::npos) {
+        _segments.emplace_back(_pattern, begin, end - begin);
+        begin = end + 1u;
+      }
+      _segments.emplace_back(_pattern, begin);
+    }
+  }
+
+  std::shared_ptr<const WildcardPattern> WildcardPattern::Get(const std::string &pattern) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::shared_ptr<const WildcardPattern>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(pattern);
+    if (it != cache.end()) {
+      return it->second;
+    }
+    if (cache.size() >= MAX_CACHED_PATTERNS) {
+      cache.clear();
+    }
+    auto compiled = std::make_shared<const WildcardPattern>(pattern);
+    cache.emplace(pattern, compiled);
+    return compiled;
+  }
+
+  bool WildcardPattern::Match(const std::string &str) const {
+    if (!_is_simple) {
+      return StringUtil::Match(str, _pattern);
+    }
+    const auto &front = _segments.front();
+    if (_segments.size() == 1u) {
+      return str == front;
+    }
+    const auto &back = _segments.back();
+    if ((str.size() < front.size() + back.size()) ||
+        (str.compare(0u, front.size(), front) != 0) ||
+        (str.compare(str.size() - back.size(), back.size(), back) != 0)) {
+      return false;
+    }
+    // Stars match any sequence, taking the earliest occurrence of each
+    // segment in between the first and the last ones is enough.
+    size_t position = front.size();
+    const size_t end = str.size() - back.size();
+    for (auto i = 1u; i < _segments.size() - 1u; ++i) {
+      const auto &segment = _segments[i];
+      if (segment.empty()) {
+        continue;
+      }
+      position = str.find(segment, position);
+      if ((position == std::string::npos) || (position + segment.size() > end)) {
+        return false;
+      }
+      position += segment.size();
+    }
+    return true;
+  }
+
+} // namespace carla
@@ -0,0 +1,46 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace carla {
+
+  /// A Unix shell-style wildcard pattern compiled for repeated matching.
+  ///
+  /// Patterns made only of literal text and '*' (e.g. "vehicle.*",
+  /// "*traffic_light*") are matched with plain string comparisons. Any other
+  /// pattern (with '?', '[' or '\') falls back to StringUtil::Match, so the
+  /// result is always the same as StringUtil::Match.
+  class WildcardPattern {
+  public:
+
+    explicit WildcardPattern(std::string pattern);
+
+    /// Return the compiled @a pattern, compiling it only the first time it is
+    /// requested.
+    static std::shared_ptr<const WildcardPattern> Get(const std::string &pattern);
+
+    const std::string &GetPattern() const {
+      return _pattern;
+    }
+
+    bool Match(const std::string &str) const;
+
+  private:
+
+    std::string _pattern;
+
+    /// Literal pieces in between stars, empty if the pattern is not simple.
+    std::vector<std::string> _segments;
+
+    bool _is_simple = false;
+  };
+
+} // namespace carla
@@ -31,10 +31,14 @@ namespace client {
   }
 
   bool ActorBlueprint::MatchTags(const std::string &wildcard_pattern) const {
+    return MatchTags(*WildcardPattern::Get(wildcard_pattern));
+  }
+
+  bool ActorBlueprint::MatchTags(const WildcardPattern &pattern) const {
     return
-        StringUtil::Match(_id, wildcard_pattern) ||
+        pattern.Match(_id) ||
         std::any_of(_tags.begin(), _tags.end(), [&](const auto &tag) {
-          return StringUtil::Match(tag, wildcard_pattern);
+          return pattern.Match(tag);
         });
   }
 
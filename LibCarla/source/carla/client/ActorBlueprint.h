@@ -8,6 +8,7 @@
 
 #include "carla/Debug.h"
 #include "carla/Iterator.h"
+#include "carla/WildcardPattern.h"
 #include "carla/client/ActorAttribute.h"
 #include "carla/rpc/ActorDefinition.h"
 #include "carla/rpc/ActorDescription.h"
@@ -59,6 +60,9 @@ namespace client {
     /// @a wildcard_pattern follows Unix shell-style wildcards.
     bool MatchTags(const std::string &wildcard_pattern) const;
 
+    /// Test if any of the flags matches the compiled @a pattern.
+    bool MatchTags(const WildcardPattern &pattern) const;
+
     std::vector<std::string> GetTags() const {
       return {_tags.begin(), _tags.end()};
     }
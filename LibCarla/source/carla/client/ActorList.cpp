@@ -6,10 +6,12 @@
 
 #include "carla/client/ActorList.h"
 
-#include "carla/StringUtil.h"
+#include "carla/WildcardPattern.h"
 #include "carla/client/detail/ActorFactory.h"
 
 #include <iterator>
+#include <numeric>
+#include <unordered_map>
 
 namespace carla {
 namespace client {
@@ -18,10 +20,25 @@ namespace client {
       detail::EpisodeProxy episode,
       std::vector<rpc::Actor> actors)
     : _episode(std::move(episode)),
-      _actors(std::make_move_iterator(actors.begin()), std::make_move_iterator(actors.end())) {}
+      _storage(std::make_shared<Storage>()),
+      _indices(actors.size()) {
+    _storage->actors.assign(
+        std::make_move_iterator(actors.begin()),
+        std::make_move_iterator(actors.end()));
+    std::iota(_indices.begin(), _indices.end(), 0u);
+  }
+
+  ActorList::ActorList(
+      detail::EpisodeProxy episode,
+      std::shared_ptr<Storage> storage,
+      std::vector<uint32_t> indices)
+    : _episode(std::move(episode)),
+      _storage(std::move(storage)),
+      _indices(std::move(indices)) {}
 
   SharedPtr<Actor> ActorList::Find(const ActorId actor_id) const {
-    for (auto &actor : _actors) {
+    for (auto i : _indices) {
+      auto &actor = _storage->actors[i];
       if (actor_id == actor.GetId()) {
         return actor.Get(_episode);
       }
@@ -30,13 +47,38 @@ namespace client {
   }
 
   SharedPtr<ActorList> ActorList::Filter(const std::string &wildcard_pattern) const {
-    SharedPtr<ActorList> filtered (new ActorList(_episode, {}));
-    for (auto &&actor : _actors) {
-      if (StringUtil::Match(actor.GetTypeId(), wildcard_pattern)) {
-        filtered->_actors.push_back(actor);
-      }
+    BuildPartitionIfNeeded();
+    const auto pattern = WildcardPattern::Get(wildcard_pattern);
+    const auto &type_ids = _storage->type_ids;
+    std::vector<bool> matches(type_ids.size());
+    bool any_match = false;
+    for (auto i = 0u; i < type_ids.size(); ++i) {
+      matches[i] = pattern->Match(type_ids[i]);
+      any_match = any_match || matches[i];
+    }
+    std::vector<uint32_t> indices;
+    if (any_match) {
+      const auto &actor_types = _storage->actor_types;
+      std::copy_if(_indices.begin(), _indices.end(), std::back_inserter(indices), [&](auto i) {
+        return matches[actor_types[i]];
+      });
     }
-    return filtered;
+    return SharedPtr<ActorList>{new ActorList(_episode, _storage, std::move(indices))};
+  }
+
+  void ActorList::BuildPartitionIfNeeded() const {
+    std::call_once(_storage->partition_flag, [storage = _storage.get()]() {
+      std::unordered_map<std::string, uint32_t> type_index;
+      storage->actor_types.reserve(storage->actors.size());
+      for (auto &&actor : storage->actors) {
+        const auto &type_id = actor.GetTypeId();
+        auto result = type_index.emplace(type_id, static_cast<uint32_t>(storage->type_ids.size()));
+        if (result.second) {
+          storage->type_ids.emplace_back(type_id);
+        }
+        storage->actor_types.emplace_back(result.first->second);
+      }
+    });
   }
 
 } // namespace client
@@ -10,6 +10,9 @@
 
 #include <boost/iterator/transform_iterator.hpp>
 
+#include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace carla {
@@ -18,10 +21,23 @@ namespace client {
   class ActorList : public EnableSharedFromThis<ActorList> {
   private:
 
+    /// Actors shared by a list and all the lists filtered from it.
+    struct Storage {
+      std::vector<detail::ActorVariant> actors;
+
+      /// Distinct type ids of the actors, and index into them of the type id
+      /// of each actor. Built the first time the list is filtered.
+      std::vector<std::string> type_ids;
+
+      std::vector<uint32_t> actor_types;
+
+      std::once_flag partition_flag;
+    };
+
     template <typename It>
     auto MakeIterator(It it) const {
-      return boost::make_transform_iterator(it, [this](auto &v) {
-        return v.Get(_episode);
+      return boost::make_transform_iterator(it, [this](auto i) {
+        return _storage->actors[i].Get(_episode);
       });
     }
 
@@ -31,30 +47,33 @@ namespace client {
     SharedPtr<Actor> Find(ActorId actor_id) const;
 
     /// Filters a list of Actor with type id matching @a wildcard_pattern.
+    ///
+    /// The pattern is matched once per distinct type id, not once per actor,
+    /// and the actors are shared with the filtered list.
     SharedPtr<ActorList> Filter(const std::string &wildcard_pattern) const;
 
     SharedPtr<Actor> operator[](size_t pos) const {
-      return _actors[pos].Get(_episode);
+      return _storage->actors[_indices[pos]].Get(_episode);
     }
 
     SharedPtr<Actor> at(size_t pos) const {
-      return _actors.at(pos).Get(_episode);
+      return _storage->actors[_indices.at(pos)].Get(_episode);
     }
 
     auto begin() const {
-      return MakeIterator(_actors.begin());
+      return MakeIterator(_indices.begin());
     }
 
     auto end() const {
-      return MakeIterator(_actors.end());
+      return MakeIterator(_indices.end());
     }
 
     bool empty() const {
-      return _actors.empty();
+      return _indices.empty();
     }
 
     size_t size() const {
-      return _actors.size();
+      return _indices.size();
     }
 
   private:
@@ -63,9 +82,19 @@ namespace client {
 
     ActorList(detail::EpisodeProxy episode, std::vector<rpc::Actor> actors);
 
+    ActorList(
+        detail::EpisodeProxy episode,
+        std::shared_ptr<Storage> storage,
+        std::vector<uint32_t> indices);
+
+    void BuildPartitionIfNeeded() const;
+
     detail::EpisodeProxy _episode;
 
-    std::vector<detail::ActorVariant> _actors;
+    std::shared_ptr<Storage> _storage;
+
+    /// Position in the storage of the actors of this list.
+    std::vector<uint32_t> _indices;
   };
 
 } // namespace client
@@ -153,6 +153,48 @@ namespace client {
       return responses;
     }
 
+    /// Apply a vehicle control to many vehicles in a single call, cheaper
+    /// than an ApplyBatch of ApplyVehicleControl commands.
+    void ApplyVehicleControls(
+        const rpc::VehicleControlBatch &batch,
+        bool do_tick_cue = false) const {
+      _simulator->ApplyVehicleControls(batch, do_tick_cue);
+    }
+
+    /// @copydoc ApplyVehicleControls
+    ///
+    /// Returns the ids of the actors the control could not be applied to.
+    std::vector<rpc::ActorId> ApplyVehicleControlsSync(
+        const rpc::VehicleControlBatch &batch,
+        bool do_tick_cue = false) const {
+      auto failed = _simulator->ApplyVehicleControlsSync(batch, false);
+      if (do_tick_cue)
+        _simulator->Tick(_simulator->GetNetworkingTimeout());
+
+      return failed;
+    }
+
+    /// Teleport many actors in a single call, cheaper than an ApplyBatch of
+    /// ApplyTransform commands.
+    void ApplyTransforms(
+        const rpc::TransformBatch &batch,
+        bool do_tick_cue = false) const {
+      _simulator->ApplyTransforms(batch, do_tick_cue);
+    }
+
+    /// @copydoc ApplyTransforms
+    ///
+    /// Returns the ids of the actors that could not be moved.
+    std::vector<rpc::ActorId> ApplyTransformsSync(
+        const rpc::TransformBatch &batch,
+        bool do_tick_cue = false) const {
+      auto failed = _simulator->ApplyTransformsSync(batch, false);
+      if (do_tick_cue)
+        _simulator->Tick(_simulator->GetNetworkingTimeout());
+
+      return failed;
+    }
+
   private:
 
     std::shared_ptr<detail::Simulator> _simulator;
@@ -102,6 +102,32 @@ namespace client {
     return result;
   }
 
+  road::element::WaypointArray Map::GenerateWaypointArray(double distance) const {
+    return _map.GenerateWaypointArray(distance);
+  }
+
+  const road::RoutePlanner &Map::GetRoutePlanner() const {
+    std::call_once(_route_planner_flag, [this]() {
+      _route_planner = std::make_unique<road::RoutePlanner>(_map);
+    });
+    return *_route_planner;
+  }
+
+  Map::Route Map::TraceRoute(
+      const geom::Location &origin,
+      const geom::Location &destination,
+      const double sampling_resolution) const {
+    const auto route = GetRoutePlanner().TraceRoute(origin, destination, sampling_resolution);
+    Route result;
+    result.reserve(route.size());
+    for (const auto &point : route) {
+      result.emplace_back(
+          SharedPtr<Waypoint>(new Waypoint{shared_from_this(), point.first}),
+          point.second);
+    }
+    return result;
+  }
+
   std::vector<road::element::LaneMarking> Map::CalculateCrossedLanes(
   const geom::Location &origin,
   const geom::Location &destination) const {
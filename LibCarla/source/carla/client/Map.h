@@ -12,9 +12,12 @@
 #include "carla/road/Lane.h"
 #include "carla/road/Map.h"
 #include "carla/road/RoadTypes.h"
+#include "carla/road/RoutePlanner.h"
 #include "carla/rpc/MapInfo.h"
 #include "Landmark.h"
 
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace carla {
@@ -67,6 +70,23 @@ namespace client {
 
     std::vector<SharedPtr<Waypoint>> GenerateWaypoints(double distance) const;
 
+    /// Same waypoints as GenerateWaypoints, with their transforms, in a
+    /// compact structure of arrays instead of one object per waypoint.
+    road::element::WaypointArray GenerateWaypointArray(double distance) const;
+
+    using Route = std::vector<std::pair<SharedPtr<Waypoint>, road::RoadOption>>;
+
+    /// Shortest driving route from @a origin to @a destination, sampled every
+    /// @a sampling_resolution meters. Each waypoint comes with the maneuver
+    /// the vehicle is doing at that point. Returns an empty route if the
+    /// destination cannot be reached.
+    ///
+    /// The route planner is built the first time a route is requested.
+    Route TraceRoute(
+        const geom::Location &origin,
+        const geom::Location &destination,
+        double sampling_resolution = 2.0) const;
+
     std::vector<road::element::LaneMarking> CalculateCrossedLanes(
         const geom::Location &origin,
         const geom::Location &destination) const;
@@ -104,6 +124,12 @@ namespace client {
     const rpc::MapInfo _description;
 
     const road::Map _map;
+
+    const road::RoutePlanner &GetRoutePlanner() const;
+
+    mutable std::once_flag _route_planner_flag;
+
+    mutable std::unique_ptr<road::RoutePlanner> _route_planner;
   };
 
 } // namespace client
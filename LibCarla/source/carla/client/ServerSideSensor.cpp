@@ -39,7 +39,10 @@ namespace client {
   void ServerSideSensor::Listen(CallbackFunctionType callback) {
     log_debug("calling sensor Listen() ", GetDisplayId());
     log_debug(GetDisplayId(), ": subscribing to stream");
-    GetEpisode().Lock()->SubscribeToSensor(*this, std::move(callback));
+    if (_latency_stats == nullptr) {
+      _latency_stats = MakeShared<sensor::LatencyStats>();
+    }
+    GetEpisode().Lock()->SubscribeToSensor(*this, std::move(callback), _latency_stats);
     listening_mask.set(0);
   }
 
@@ -55,6 +58,16 @@ namespace client {
     listening_mask.reset(0);
   }
 
+  void ServerSideSensor::SetCompression(sensor::s11n::CompressionType compression) {
+    log_debug(GetDisplayId(), ": setting compression", static_cast<int>(compression));
+    GetEpisode().Lock()->SetSensorCompression(*this, compression);
+  }
+
+  void ServerSideSensor::EnableLatencyStats(bool enabled) {
+    log_debug(GetDisplayId(), ": setting timing", enabled);
+    GetEpisode().Lock()->SetSensorTiming(*this, enabled);
+  }
+
   void ServerSideSensor::ListenToGBuffer(uint32_t GBufferId, CallbackFunctionType callback) {
     log_debug(GetDisplayId(), ": subscribing to gbuffer stream");
     RELEASE_ASSERT(GBufferId < GBufferTextureCount);
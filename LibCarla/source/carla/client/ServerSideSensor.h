@@ -7,6 +7,8 @@
 #pragma once
 
 #include "carla/client/Sensor.h"
+#include "carla/sensor/LatencyStats.h"
+#include "carla/sensor/s11n/PayloadCompression.h"
 #include <bitset>
 
 namespace carla {
@@ -47,6 +49,25 @@ namespace client {
       return listening_mask.test(id + 1);
     }
 
+    /// Compress the data of this sensor in the simulator before sending it.
+    /// Compression is lossless and applies to every client listening to the
+    /// sensor, it trades server CPU time for bandwidth.
+    ///
+    /// @warning It is not negotiated per client, clients older than
+    /// compression support cannot decode the data of a compressed sensor.
+    void SetCompression(sensor::s11n::CompressionType compression);
+
+    /// Make the simulator attach its timestamps to the data of this sensor,
+    /// so the latency of each message received by Listen is recorded in
+    /// GetLatencyStats. Applies to every client listening to the sensor.
+    void EnableLatencyStats(bool enabled);
+
+    /// Latency histograms of the messages received since the first call to
+    /// Listen, nullptr if this instance never listened.
+    SharedPtr<sensor::LatencyStats> GetLatencyStats() const {
+      return _latency_stats;
+    }
+
     /// @copydoc Actor::Destroy()
     ///
     /// Additionally stop listening.
@@ -56,6 +77,8 @@ namespace client {
 
     std::bitset<16> listening_mask;
 
+    SharedPtr<sensor::LatencyStats> _latency_stats;
+
   };
 
 } // namespace client
@@ -108,6 +108,10 @@ namespace client {
     return GetEpisode().Lock()->GetLightBoxes(*this);
   }
 
+  detail::ResponseFuture<std::vector<geom::BoundingBox>> TrafficLight::GetLightBoxesAsync() const {
+    return GetEpisode().Lock()->GetLightBoxesAsync(*this);
+  }
+
   road::SignId TrafficLight::GetOpenDRIVEID() const {
     return GetEpisode().Lock()->GetActorSnapshot(*this).state.traffic_light_data.sign_id;
   }
@@ -10,6 +10,7 @@
 #include "carla/rpc/TrafficLightState.h"
 #include "carla/client/Waypoint.h"
 #include "carla/client/Map.h"
+#include "carla/client/detail/ResponseFuture.h"
 #include "carla/geom/BoundingBox.h"
 
 namespace carla {
@@ -72,6 +73,10 @@ namespace client {
 
     std::vector<geom::BoundingBox> GetLightBoxes() const;
 
+    /// Same as GetLightBoxes, but returns without waiting for the simulator's
+    /// response.
+    detail::ResponseFuture<std::vector<geom::BoundingBox>> GetLightBoxesAsync() const;
+
     road::SignId GetOpenDRIVEID() const;
 
     std::vector<SharedPtr<Waypoint>> GetStopWaypoints() const;
@@ -63,6 +63,10 @@ namespace client {
     return GetEpisode().Lock()->GetAckermannControllerSettings(*this);
   }
 
+  detail::ResponseFuture<rpc::AckermannControllerSettings> Vehicle::GetAckermannControllerSettingsAsync() const {
+    return GetEpisode().Lock()->GetAckermannControllerSettingsAsync(*this);
+  }
+
   void Vehicle::ApplyAckermannControllerSettings(const rpc::AckermannControllerSettings &settings) {
     GetEpisode().Lock()->ApplyAckermannControllerSettings(*this, settings);
   }
@@ -91,6 +95,10 @@ namespace client {
     return GetEpisode().Lock()->GetWheelSteerAngle(*this, wheel_location);
   }
 
+  detail::ResponseFuture<float> Vehicle::GetWheelSteerAngleAsync(WheelLocation wheel_location) const {
+    return GetEpisode().Lock()->GetWheelSteerAngleAsync(*this, wheel_location);
+  }
+
   Vehicle::Control Vehicle::GetControl() const {
     return GetEpisode().Lock()->GetActorSnapshot(*this).state.vehicle_data.control;
   }
@@ -99,6 +107,10 @@ namespace client {
     return GetEpisode().Lock()->GetVehiclePhysicsControl(*this);
   }
 
+  detail::ResponseFuture<Vehicle::PhysicsControl> Vehicle::GetPhysicsControlAsync() const {
+    return GetEpisode().Lock()->GetVehiclePhysicsControlAsync(*this);
+  }
+
   Vehicle::LightState Vehicle::GetLightState() const {
     return GetEpisode().Lock()->GetVehicleLightState(*this).GetLightStateEnum();
   }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/client/Actor.h"
+#include "carla/client/detail/ResponseFuture.h"
 #include "carla/rpc/AckermannControllerSettings.h"
 #include "carla/rpc/TrafficLightState.h"
 #include "carla/rpc/VehicleAckermannControl.h"
@@ -60,6 +61,10 @@ namespace client {
     /// @warning This function does call the simulator.
     rpc::AckermannControllerSettings GetAckermannControllerSettings() const;
 
+    /// Same as GetAckermannControllerSettings, but returns without waiting for
+    /// the simulator's response.
+    detail::ResponseFuture<rpc::AckermannControllerSettings> GetAckermannControllerSettingsAsync() const;
+
     /// Apply Ackermann control settings to this vehicle
     void ApplyAckermannControllerSettings(const rpc::AckermannControllerSettings &settings);
 
@@ -83,6 +88,10 @@ namespace client {
     /// @note The function returns the rotation of the vehicle based on the it's physics
     float GetWheelSteerAngle(WheelLocation wheel_location);
 
+    /// Same as GetWheelSteerAngle, but returns without waiting for the
+    /// simulator's response.
+    detail::ResponseFuture<float> GetWheelSteerAngleAsync(WheelLocation wheel_location) const;
+
     /// Return the control last applied to this vehicle.
     ///
     /// @note This function does not call the simulator, it returns the data
@@ -94,6 +103,11 @@ namespace client {
     /// @warning This function does call the simulator.
     PhysicsControl GetPhysicsControl() const;
 
+    /// Same as GetPhysicsControl, but returns without waiting for the
+    /// simulator's response. Querying many vehicles this way overlaps the
+    /// requests instead of paying a round trip for each one.
+    detail::ResponseFuture<PhysicsControl> GetPhysicsControlAsync() const;
+
     /// Return the current open lights (LightState) of this vehicle.
     ///
     /// @note This function does not call the simulator, it returns the data
@@ -11,7 +11,6 @@
 #include "carla/client/ActorBlueprint.h"
 #include "carla/client/ActorList.h"
 #include "carla/client/detail/Simulator.h"
-#include "carla/StringUtil.h"
 #include "carla/road/SignalType.h"
 #include "carla/road/Junction.h"
 #include "carla/client/TrafficLight.h"
@@ -165,50 +164,23 @@ namespace client {
   }
 
   SharedPtr<Actor> World::GetTrafficSign(const Landmark& landmark) const {
-    SharedPtr<ActorList> actors = GetActors();
-    SharedPtr<TrafficSign> result;
-    std::string landmark_id = landmark.GetId();
-    for (size_t i = 0; i < actors->size(); i++) {
-      SharedPtr<Actor> actor = actors->at(i);
-      if (StringUtil::Match(actor->GetTypeId(), "*traffic.*")) {
-        TrafficSign* sign = static_cast<TrafficSign*>(actor.get());
-        if(sign && (sign->GetSignId() == landmark_id)) {
-          return actor;
-        }
-      }
-    }
-    return nullptr;
+    auto simulator = _episode.Lock();
+    auto description = simulator->GetTrafficSignBySignId(landmark.GetId());
+    return description.has_value() ?
+        simulator->MakeActor(std::move(*description)) :
+        nullptr;
   }
 
   SharedPtr<Actor> World::GetTrafficLight(const Landmark& landmark) const {
-    SharedPtr<ActorList> actors = GetActors();
-    SharedPtr<TrafficLight> result;
-    std::string landmark_id = landmark.GetId();
-    for (size_t i = 0; i < actors->size(); i++) {
-      SharedPtr<Actor> actor = actors->at(i);
-      if (StringUtil::Match(actor->GetTypeId(), "*traffic_light*")) {
-        TrafficLight* tl = static_cast<TrafficLight*>(actor.get());
-        if(tl && (tl->GetSignId() == landmark_id)) {
-          return actor;
-        }
-      }
-    }
-    return nullptr;
+    return GetTrafficLightFromOpenDRIVE(landmark.GetId());
   }
 
   SharedPtr<Actor> World::GetTrafficLightFromOpenDRIVE(const road::SignId& sign_id) const {
-    SharedPtr<ActorList> actors = GetActors();
-    SharedPtr<TrafficLight> result;
-    for (size_t i = 0; i < actors->size(); i++) {
-      SharedPtr<Actor> actor = actors->at(i);
-      if (StringUtil::Match(actor->GetTypeId(), "*traffic_light*")) {
-        TrafficLight* tl = static_cast<TrafficLight*>(actor.get());
-        if(tl && (tl->GetSignId() == sign_id)) {
-          return actor;
-        }
-      }
-    }
-    return nullptr;
+    auto simulator = _episode.Lock();
+    auto description = simulator->GetTrafficLightBySignId(sign_id);
+    return description.has_value() ?
+        simulator->MakeActor(std::move(*description)) :
+        nullptr;
   }
 
   void World::ResetAllTrafficLights() {
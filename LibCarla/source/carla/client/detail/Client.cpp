@@ -10,6 +10,7 @@
 #include "carla/Version.h"
 #include "carla/client/FileTransfer.h"
 #include "carla/client/TimeoutException.h"
+#include "carla/profiler/Profiler.h"
 #include "carla/rpc/AckermannControllerSettings.h"
 #include "carla/rpc/ActorDescription.h"
 #include "carla/rpc/BoneTransformDataIn.h"
@@ -59,6 +60,7 @@ namespace detail {
 
     template <typename ... Args>
     auto RawCall(const std::string &function, Args && ... args) {
+      CARLA_PROFILE_DYNAMIC_SPAN(rpc, function);
       try {
         return rpc_client.call(function, std::forward<Args>(args) ...);
       } catch (const ::rpc::timeout &) {
@@ -77,6 +79,15 @@ namespace detail {
       return Get(response);
     }
 
+    /// Issue the call and return a future to its response.
+    template <typename T, typename ... Args>
+    ResponseFuture<T> CallAsync(const std::string &function, Args && ... args) {
+      return {
+          rpc_client.async_request(function, std::forward<Args>(args) ...),
+          GetTimeout(),
+          endpoint};
+    }
+
     template <typename ... Args>
     void AsyncCall(const std::string &function, Args && ... args) {
       // Discard returned future.
@@ -283,6 +294,27 @@ namespace detail {
     return _pimpl->CallAndWait<carla::rpc::VehicleLightState>("get_vehicle_light_state", vehicle);
   }
 
+  ResponseFuture<rpc::VehiclePhysicsControl> Client::GetVehiclePhysicsControlAsync(
+      rpc::ActorId vehicle) const {
+    return _pimpl->CallAsync<rpc::VehiclePhysicsControl>("get_physics_control", vehicle);
+  }
+
+  ResponseFuture<rpc::AckermannControllerSettings> Client::GetAckermannControllerSettingsAsync(
+      rpc::ActorId vehicle) const {
+    return _pimpl->CallAsync<rpc::AckermannControllerSettings>("get_ackermann_controller_settings", vehicle);
+  }
+
+  ResponseFuture<float> Client::GetWheelSteerAngleAsync(
+      rpc::ActorId vehicle,
+      rpc::VehicleWheelLocation wheel_location) const {
+    return _pimpl->CallAsync<float>("get_wheel_steer_angle", vehicle, wheel_location);
+  }
+
+  ResponseFuture<std::vector<geom::BoundingBox>> Client::GetLightBoxesAsync(
+      rpc::ActorId traffic_light) const {
+    return _pimpl->CallAsync<std::vector<geom::BoundingBox>>("get_light_boxes", traffic_light);
+  }
+
   void Client::ApplyPhysicsControlToVehicle(
       rpc::ActorId vehicle,
       const rpc::VehiclePhysicsControl &physics_control) {
@@ -586,6 +618,16 @@ namespace detail {
     _pimpl->streaming_client.UnSubscribe(token);
   }
 
+  void Client::SetStreamCompression(const streaming::Token &token, uint8_t compression) {
+    carla::streaming::detail::token_type thisToken(token);
+    _pimpl->CallAndWait<void>("set_sensor_compression", thisToken.get_stream_id(), compression);
+  }
+
+  void Client::SetStreamTiming(const streaming::Token &token, bool enabled) {
+    carla::streaming::detail::token_type thisToken(token);
+    _pimpl->CallAndWait<void>("set_sensor_timing", thisToken.get_stream_id(), enabled);
+  }
+
   void Client::SubscribeToGBuffer(
       rpc::ActorId ActorId,
       uint32_t GBufferId,
@@ -622,6 +664,28 @@ namespace detail {
     return result.as<std::vector<rpc::CommandResponse>>();
   }
 
+  void Client::ApplyVehicleControls(const rpc::VehicleControlBatch &batch, bool do_tick_cue) {
+    _pimpl->AsyncCall("apply_vehicle_controls", batch, do_tick_cue);
+  }
+
+  std::vector<rpc::ActorId> Client::ApplyVehicleControlsSync(
+      const rpc::VehicleControlBatch &batch,
+      bool do_tick_cue) {
+    using return_t = std::vector<rpc::ActorId>;
+    return _pimpl->CallAndWait<return_t>("apply_vehicle_controls", batch, do_tick_cue);
+  }
+
+  void Client::ApplyTransforms(const rpc::TransformBatch &batch, bool do_tick_cue) {
+    _pimpl->AsyncCall("apply_transforms", batch, do_tick_cue);
+  }
+
+  std::vector<rpc::ActorId> Client::ApplyTransformsSync(
+      const rpc::TransformBatch &batch,
+      bool do_tick_cue) {
+    using return_t = std::vector<rpc::ActorId>;
+    return _pimpl->CallAndWait<return_t>("apply_transforms", batch, do_tick_cue);
+  }
+
   uint64_t Client::SendTickCue() {
     return _pimpl->CallAndWait<uint64_t>("tick_cue");
   }
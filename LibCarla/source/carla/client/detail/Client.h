@@ -9,12 +9,14 @@
 #include "carla/Memory.h"
 #include "carla/NonCopyable.h"
 #include "carla/Time.h"
+#include "carla/client/detail/ResponseFuture.h"
 #include "carla/geom/Transform.h"
 #include "carla/geom/Location.h"
 #include "carla/rpc/Actor.h"
 #include "carla/rpc/ActorDefinition.h"
 #include "carla/rpc/AttachmentType.h"
 #include "carla/rpc/Command.h"
+#include "carla/rpc/CommandBatch.h"
 #include "carla/rpc/CommandResponse.h"
 #include "carla/rpc/EnvironmentObject.h"
 #include "carla/rpc/EpisodeInfo.h"
@@ -155,6 +157,27 @@ namespace detail {
 
     rpc::VehicleLightState GetVehicleLightState(rpc::ActorId vehicle) const;
 
+    /// @name Asynchronous getters
+    ///
+    /// Issue the call and return without waiting for the response, so many
+    /// independent queries can be in flight at the same time.
+    /// @{
+
+    ResponseFuture<rpc::VehiclePhysicsControl> GetVehiclePhysicsControlAsync(
+        rpc::ActorId vehicle) const;
+
+    ResponseFuture<rpc::AckermannControllerSettings> GetAckermannControllerSettingsAsync(
+        rpc::ActorId vehicle) const;
+
+    ResponseFuture<float> GetWheelSteerAngleAsync(
+        rpc::ActorId vehicle,
+        rpc::VehicleWheelLocation wheel_location) const;
+
+    ResponseFuture<std::vector<geom::BoundingBox>> GetLightBoxesAsync(
+        rpc::ActorId traffic_light) const;
+
+    /// @}
+
     void ApplyPhysicsControlToVehicle(
         rpc::ActorId vehicle,
         const rpc::VehiclePhysicsControl &physics_control);
@@ -375,6 +398,10 @@ namespace detail {
 
     void UnSubscribeFromStream(const streaming::Token &token);
 
+    void SetStreamCompression(const streaming::Token &token, uint8_t compression);
+
+    void SetStreamTiming(const streaming::Token &token, bool enabled);
+
     void UnSubscribeFromGBuffer(
         rpc::ActorId ActorId,
         uint32_t GBufferId);
@@ -389,6 +416,24 @@ namespace detail {
         std::vector<rpc::Command> commands,
         bool do_tick_cue);
 
+    void ApplyVehicleControls(
+        const rpc::VehicleControlBatch &batch,
+        bool do_tick_cue);
+
+    /// Returns the ids of the actors the control could not be applied to.
+    std::vector<rpc::ActorId> ApplyVehicleControlsSync(
+        const rpc::VehicleControlBatch &batch,
+        bool do_tick_cue);
+
+    void ApplyTransforms(
+        const rpc::TransformBatch &batch,
+        bool do_tick_cue);
+
+    /// Returns the ids of the actors that could not be moved.
+    std::vector<rpc::ActorId> ApplyTransformsSync(
+        const rpc::TransformBatch &batch,
+        bool do_tick_cue);
+
     uint64_t SendTickCue();
 
     std::vector<rpc::LightState> QueryLightsStateToServer() const;
@@ -141,8 +141,35 @@ using namespace std::chrono_literals;
     return GetActorsById_Impl(_client, _actors, GetState()->GetActorIds());
   }
 
+  boost::optional<rpc::Actor> Episode::GetTrafficSignBySignId(const road::SignId &sign_id) {
+    UpdateLandmarkIndexIfNeeded();
+    auto id = _landmarks.FindTrafficSign(sign_id);
+    if (!id.has_value()) {
+      return boost::none;
+    }
+    return GetActorById(*id);
+  }
+
+  boost::optional<rpc::Actor> Episode::GetTrafficLightBySignId(const road::SignId &sign_id) {
+    UpdateLandmarkIndexIfNeeded();
+    auto id = _landmarks.FindTrafficLight(sign_id);
+    if (!id.has_value()) {
+      return boost::none;
+    }
+    return GetActorById(*id);
+  }
+
+  void Episode::UpdateLandmarkIndexIfNeeded() {
+    auto state = GetState();
+    if (!_landmarks.IsUpToDate(state)) {
+      auto actors = GetActorsById_Impl(_client, _actors, state->GetActorIds());
+      _landmarks.Rebuild(std::move(state), actors);
+    }
+  }
+
   void Episode::OnEpisodeStarted() {
     _actors.Clear();
+    _landmarks.Clear();
     _on_tick_callbacks.Clear();
     _navigation.reset();
     traffic_manager::TrafficManager::Release();
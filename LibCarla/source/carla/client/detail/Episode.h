@@ -14,6 +14,7 @@
 #include "carla/client/detail/CachedActorList.h"
 #include "carla/client/detail/CallbackList.h"
 #include "carla/client/detail/EpisodeState.h"
+#include "carla/client/detail/LandmarkActorIndex.h"
 #include "carla/client/detail/WalkerNavigation.h"
 #include "carla/rpc/EpisodeInfo.h"
 
@@ -67,6 +68,14 @@ namespace detail {
 
     std::vector<rpc::Actor> GetActors();
 
+    /// Retrieve the traffic sign (or traffic light) actor matching the
+    /// OpenDRIVE @a sign_id, or empty optional if there is none.
+    boost::optional<rpc::Actor> GetTrafficSignBySignId(const road::SignId &sign_id);
+
+    /// Retrieve the traffic light actor matching the OpenDRIVE @a sign_id, or
+    /// empty optional if there is none.
+    boost::optional<rpc::Actor> GetTrafficLightBySignId(const road::SignId &sign_id);
+
     boost::optional<WorldSnapshot> WaitForState(time_duration timeout) {
       return _snapshot.WaitFor(timeout);
     }
@@ -124,6 +133,8 @@ namespace detail {
 
     void OnEpisodeChanged();
 
+    void UpdateLandmarkIndexIfNeeded();
+
     Client &_client;
 
     AtomicSharedPtr<const EpisodeState> _state;
@@ -134,6 +145,8 @@ namespace detail {
 
     CachedActorList _actors;
 
+    LandmarkActorIndex _landmarks;
+
     CallbackList<WorldSnapshot> _on_tick_callbacks;
 
     CallbackList<WorldSnapshot> _on_map_change_callbacks;
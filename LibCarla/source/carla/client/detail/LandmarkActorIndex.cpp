@@ -0,0 +1,106 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/LandmarkActorIndex.h"
+
+#include "carla/StringUtil.h"
+#include "carla/client/detail/EpisodeState.h"
+
+#include <cstring>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  static bool HaveSameActors(const EpisodeState &lhs, const EpisodeState &rhs) {
+    if ((lhs.GetEpisodeId() != rhs.GetEpisodeId()) || (lhs.size() != rhs.size())) {
+      return false;
+    }
+    for (auto &&id : rhs.GetActorIds()) {
+      if (!lhs.ContainsActorSnapshot(id)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool LandmarkActorIndex::IsUpToDate(std::shared_ptr<const EpisodeState> state) {
+    DEBUG_ASSERT(state != nullptr);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_state == state) {
+      return true;
+    }
+    if ((_state == nullptr) || !HaveSameActors(*_state, *state)) {
+      return false;
+    }
+    // Same actors in a newer frame, the index is still valid.
+    _state = std::move(state);
+    return true;
+  }
+
+  void LandmarkActorIndex::Rebuild(
+      std::shared_ptr<const EpisodeState> state,
+      const std::vector<rpc::Actor> &actors) {
+    DEBUG_ASSERT(state != nullptr);
+    MapType traffic_signs;
+    MapType traffic_lights;
+    for (auto &&actor : actors) {
+      const auto &type_id = actor.description.id;
+      const bool is_traffic_sign = StringUtil::Match(type_id, "*traffic.*");
+      const bool is_traffic_light = StringUtil::Match(type_id, "*traffic_light*");
+      if (!is_traffic_sign && !is_traffic_light) {
+        continue;
+      }
+      auto snapshot = state->GetActorSnapshotIfPresent(actor.id);
+      if (!snapshot.has_value()) {
+        continue;
+      }
+      const auto &data = snapshot->state.traffic_light_data.sign_id;
+      road::SignId sign_id(data, strnlen(data, sizeof(data)));
+      // As the linear search this replaces, the first actor found wins.
+      if (is_traffic_sign) {
+        traffic_signs.emplace(sign_id, actor.id);
+      }
+      if (is_traffic_light) {
+        traffic_lights.emplace(std::move(sign_id), actor.id);
+      }
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _state = std::move(state);
+    _traffic_signs = std::move(traffic_signs);
+    _traffic_lights = std::move(traffic_lights);
+  }
+
+  boost::optional<ActorId> LandmarkActorIndex::FindTrafficSign(const road::SignId &sign_id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Find(_traffic_signs, sign_id);
+  }
+
+  boost::optional<ActorId> LandmarkActorIndex::FindTrafficLight(const road::SignId &sign_id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return Find(_traffic_lights, sign_id);
+  }
+
+  void LandmarkActorIndex::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _state = nullptr;
+    _traffic_signs.clear();
+    _traffic_lights.clear();
+  }
+
+  boost::optional<ActorId> LandmarkActorIndex::Find(
+      const MapType &map,
+      const road::SignId &sign_id) {
+    auto it = map.find(sign_id);
+    if (it != map.end()) {
+      return it->second;
+    }
+    return boost::none;
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
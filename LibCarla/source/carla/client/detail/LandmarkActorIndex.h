@@ -0,0 +1,78 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/road/RoadTypes.h"
+#include "carla/rpc/Actor.h"
+#include "carla/rpc/ActorId.h"
+
+#include <boost/optional.hpp>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  class EpisodeState;
+
+  // ===========================================================================
+  // -- LandmarkActorIndex -----------------------------------------------------
+  // ===========================================================================
+
+  /// Maps the OpenDRIVE sign ids to the traffic sign and traffic light actors
+  /// of an episode.
+  ///
+  /// The index is built lazily from the actor descriptions and the episode
+  /// state, and it is rebuilt only when the set of actors of the episode
+  /// changes, so consecutive look-ups within the same set of actors are hash
+  /// look-ups.
+  class LandmarkActorIndex : private NonCopyable {
+  public:
+
+    /// Return whether the index was built with the same set of actors present
+    /// in @a state.
+    bool IsUpToDate(std::shared_ptr<const EpisodeState> state);
+
+    /// Rebuild the index from the descriptions of all the @a actors present
+    /// in @a state.
+    void Rebuild(
+        std::shared_ptr<const EpisodeState> state,
+        const std::vector<rpc::Actor> &actors);
+
+    /// Retrieve the id of the traffic sign (or traffic light) actor matching
+    /// @a sign_id.
+    boost::optional<ActorId> FindTrafficSign(const road::SignId &sign_id) const;
+
+    /// Retrieve the id of the traffic light actor matching @a sign_id.
+    boost::optional<ActorId> FindTrafficLight(const road::SignId &sign_id) const;
+
+    void Clear();
+
+  private:
+
+    using MapType = std::unordered_map<road::SignId, ActorId>;
+
+    static boost::optional<ActorId> Find(const MapType &map, const road::SignId &sign_id);
+
+    mutable std::mutex _mutex;
+
+    /// Last state the index has been validated against.
+    std::shared_ptr<const EpisodeState> _state;
+
+    MapType _traffic_signs;
+
+    MapType _traffic_lights;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
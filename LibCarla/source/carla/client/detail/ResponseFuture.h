@@ -0,0 +1,87 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Exception.h"
+#include "carla/MsgPack.h"
+#include "carla/Time.h"
+#include "carla/client/TimeoutException.h"
+#include "carla/rpc/Response.h"
+
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Response of an RPC call issued without waiting for it. The call is
+  /// already on its way to the server when the future is created, so many
+  /// independent calls can be overlapped and waited for afterwards.
+  template <typename T>
+  class ResponseFuture {
+  public:
+
+    using value_type = T;
+
+    ResponseFuture() = default;
+
+    ResponseFuture(
+        std::future<clmdep_msgpack::object_handle> future,
+        time_duration timeout,
+        std::string endpoint)
+      : _future(std::move(future)),
+        _timeout(timeout),
+        _endpoint(std::move(endpoint)) {}
+
+    /// Whether the future refers to a call, false once Get has been called.
+    bool IsValid() const {
+      return _future.valid();
+    }
+
+    /// Whether the response has arrived, Get will not block.
+    bool IsReady() const {
+      return _future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /// Wait for the response and return its value. Throws TimeoutException if
+    /// the response does not arrive within the client's timeout, and
+    /// std::runtime_error if the server responded with an error.
+    ///
+    /// @pre IsValid().
+    T Get() {
+      if (_future.wait_for(_timeout.to_chrono()) != std::future_status::ready) {
+        throw_exception(TimeoutException(_endpoint, _timeout));
+      }
+      auto response = _future.get().get().template as<rpc::Response<T>>();
+      if (response.HasError()) {
+        throw_exception(std::runtime_error(response.GetError().What()));
+      }
+      return GetValue(response);
+    }
+
+  private:
+
+    template <typename U>
+    static U GetValue(rpc::Response<U> &response) {
+      return std::move(response.Get());
+    }
+
+    static void GetValue(rpc::Response<void> &) {}
+
+    std::future<clmdep_msgpack::object_handle> _future;
+
+    time_duration _timeout;
+
+    std::string _endpoint;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -19,6 +19,7 @@
 #include "carla/client/detail/ActorFactory.h"
 #include "carla/trafficmanager/TrafficManager.h"
 #include "carla/sensor/Deserializer.h"
+#include "carla/streaming/Client.h"
 
 #include <exception>
 #include <thread>
@@ -379,14 +380,31 @@ namespace detail {
 
   void Simulator::SubscribeToSensor(
       const Sensor &sensor,
-      std::function<void(SharedPtr<sensor::SensorData>)> callback) {
+      std::function<void(SharedPtr<sensor::SensorData>)> callback,
+      SharedPtr<sensor::LatencyStats> latency_stats) {
     DEBUG_ASSERT(_episode != nullptr);
     _client.SubscribeToStream(
         sensor.GetActorDescription().GetStreamToken(),
-        [cb=std::move(callback), ep=WeakEpisodeProxy{shared_from_this()}](auto buffer) {
-          auto data = sensor::Deserializer::Deserialize(std::move(buffer));
+        [cb=std::move(callback), ep=WeakEpisodeProxy{shared_from_this()}, stats=std::move(latency_stats)](auto buffer) {
+          using Serializer = sensor::s11n::SensorHeaderSerializer;
+          if ((stats == nullptr) || !Serializer::HasTiming(Serializer::Deserialize(buffer))) {
+            auto data = sensor::Deserializer::Deserialize(std::move(buffer));
+            data->_episode = ep.TryLock();
+            cb(std::move(data));
+            return;
+          }
+          sensor::MessageTimestamps timestamps;
+          timestamps.receive = streaming::Client::GetReceiveTime();
+          timestamps.dispatch = Serializer::Now();
+          boost::optional<sensor::Deserializer::Timing> timing;
+          auto data = sensor::Deserializer::Deserialize(std::move(buffer), timing);
+          timestamps.deserialize = Serializer::Now();
           data->_episode = ep.TryLock();
           cb(std::move(data));
+          timestamps.callback = Serializer::Now();
+          DEBUG_ASSERT(timing != boost::none);
+          timestamps.server = *timing;
+          stats->Record(timestamps);
         });
   }
   
@@ -395,6 +413,18 @@ namespace detail {
     // If in the future we need to unsubscribe from each gbuffer individually, it should be done here.
   }
 
+  void Simulator::SetSensorCompression(
+      const Sensor &sensor,
+      sensor::s11n::CompressionType compression) {
+    _client.SetStreamCompression(
+        sensor.GetActorDescription().GetStreamToken(),
+        static_cast<uint8_t>(compression));
+  }
+
+  void Simulator::SetSensorTiming(const Sensor &sensor, bool enabled) {
+    _client.SetStreamTiming(sensor.GetActorDescription().GetStreamToken(), enabled);
+  }
+
   void Simulator::SubscribeToGBuffer(
       Actor &actor,
       uint32_t gbuffer_id,
@@ -27,6 +27,8 @@
 #include "carla/rpc/VehicleWheels.h"
 #include "carla/rpc/Texture.h"
 #include "carla/rpc/MaterialParameter.h"
+#include "carla/sensor/LatencyStats.h"
+#include "carla/sensor/s11n/PayloadCompression.h"
 
 #include <boost/optional.hpp>
 
@@ -253,6 +255,10 @@ namespace detail {
       return _client.GetVehicleLightState(vehicle.GetId());
     }
 
+    ResponseFuture<rpc::VehiclePhysicsControl> GetVehiclePhysicsControlAsync(const Vehicle &vehicle) const {
+      return _client.GetVehiclePhysicsControlAsync(vehicle.GetId());
+    }
+
     /// Returns all the BBs of all the elements of the level
     std::vector<geom::BoundingBox> GetLevelBBs(uint8_t queried_tag) const {
       return _client.GetLevelBBs(queried_tag);
@@ -319,6 +325,16 @@ namespace detail {
       return _episode->GetActors();
     }
 
+    boost::optional<rpc::Actor> GetTrafficSignBySignId(const road::SignId &sign_id) const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetTrafficSignBySignId(sign_id);
+    }
+
+    boost::optional<rpc::Actor> GetTrafficLightBySignId(const road::SignId &sign_id) const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetTrafficLightBySignId(sign_id);
+    }
+
     /// Creates an actor instance out of a description of an existing actor.
     /// Note that this does not spawn an actor.
     ///
@@ -465,6 +481,10 @@ namespace detail {
       return _client.GetAckermannControllerSettings(vehicle.GetId());
     }
 
+    ResponseFuture<rpc::AckermannControllerSettings> GetAckermannControllerSettingsAsync(const Vehicle &vehicle) const {
+      return _client.GetAckermannControllerSettingsAsync(vehicle.GetId());
+    }
+
     void ApplyAckermannControllerSettings(Vehicle &vehicle, const rpc::AckermannControllerSettings &settings) {
       _client.ApplyAckermannControllerSettings(vehicle.GetId(), settings);
     }
@@ -513,6 +533,10 @@ namespace detail {
       return _client.GetWheelSteerAngle(vehicle.GetId(), wheel_location);
     }
 
+    ResponseFuture<float> GetWheelSteerAngleAsync(const Vehicle &vehicle, rpc::VehicleWheelLocation wheel_location) const {
+      return _client.GetWheelSteerAngleAsync(vehicle.GetId(), wheel_location);
+    }
+
     void EnableCarSim(Vehicle &vehicle, std::string simfile_path) {
       _client.EnableCarSim(vehicle.GetId(), simfile_path);
     }
@@ -586,12 +610,19 @@ namespace detail {
     // =========================================================================
     /// @{
 
+    /// If @a latency_stats is not null, the messages that carry the timing
+    /// trailer are recorded in it.
     void SubscribeToSensor(
         const Sensor &sensor,
-        std::function<void(SharedPtr<sensor::SensorData>)> callback);
+        std::function<void(SharedPtr<sensor::SensorData>)> callback,
+        SharedPtr<sensor::LatencyStats> latency_stats = nullptr);
 
     void UnSubscribeFromSensor(Actor &sensor);
 
+    void SetSensorCompression(const Sensor &sensor, sensor::s11n::CompressionType compression);
+
+    void SetSensorTiming(const Sensor &sensor, bool enabled);
+
     void SubscribeToGBuffer(
         Actor & sensor,
         uint32_t gbuffer_id,
@@ -639,6 +670,10 @@ namespace detail {
       return _client.GetLightBoxes(trafficLight.GetId());
     }
 
+    ResponseFuture<std::vector<geom::BoundingBox>> GetLightBoxesAsync(const TrafficLight &trafficLight) const {
+      return _client.GetLightBoxesAsync(trafficLight.GetId());
+    }
+
     std::vector<ActorId> GetGroupTrafficLights(TrafficLight &trafficLight) {
       return _client.GetGroupTrafficLights(trafficLight.GetId());
     }
@@ -667,6 +702,22 @@ namespace detail {
       return _client.ApplyBatchSync(std::move(commands), do_tick_cue);
     }
 
+    void ApplyVehicleControls(const rpc::VehicleControlBatch &batch, bool do_tick_cue) {
+      _client.ApplyVehicleControls(batch, do_tick_cue);
+    }
+
+    auto ApplyVehicleControlsSync(const rpc::VehicleControlBatch &batch, bool do_tick_cue) {
+      return _client.ApplyVehicleControlsSync(batch, do_tick_cue);
+    }
+
+    void ApplyTransforms(const rpc::TransformBatch &batch, bool do_tick_cue) {
+      _client.ApplyTransforms(batch, do_tick_cue);
+    }
+
+    auto ApplyTransformsSync(const rpc::TransformBatch &batch, bool do_tick_cue) {
+      return _client.ApplyTransformsSync(batch, do_tick_cue);
+    }
+
     /// @}
     // =========================================================================
     /// @name Operations lights
@@ -0,0 +1,1349 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/mock/MockServer.h"
+
+#include "carla/Buffer.h"
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/Functional.h"
+#include "carla/Logging.h"
+#include "carla/Version.h"
+#include "carla/geom/BoundingBox.h"
+#include "carla/geom/Math.h"
+#include "carla/opendrive/OpenDriveParser.h"
+#include "carla/road/Map.h"
+#include "carla/rpc/Actor.h"
+#include "carla/rpc/ActorDefinition.h"
+#include "carla/rpc/ActorDescription.h"
+#include "carla/rpc/AttachmentType.h"
+#include "carla/rpc/Command.h"
+#include "carla/rpc/CommandBatch.h"
+#include "carla/rpc/CommandResponse.h"
+#include "carla/rpc/EpisodeInfo.h"
+#include "carla/rpc/EpisodeSettings.h"
+#include "carla/rpc/MapInfo.h"
+#include "carla/rpc/ObjectLabel.h"
+#include "carla/rpc/Response.h"
+#include "carla/rpc/Server.h"
+#include "carla/rpc/VehicleControl.h"
+#include "carla/rpc/VehicleLightState.h"
+#include "carla/rpc/VehicleLightStateList.h"
+#include "carla/rpc/WalkerControl.h"
+#include "carla/rpc/WeatherParameters.h"
+#include "carla/sensor/SensorRegistry.h"
+#include "carla/sensor/data/ActorDynamicState.h"
+#include "carla/sensor/data/RadarData.h"
+#include "carla/sensor/s11n/EpisodeStateSerializer.h"
+#include "carla/sensor/s11n/ImageSerializer.h"
+#include "carla/sensor/s11n/PayloadCompression.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+#include "carla/streaming/Server.h"
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace carla {
+namespace mock {
+
+  using ActorId = rpc::ActorId;
+
+  template <typename T>
+  using R = rpc::Response<T>;
+
+  // ===========================================================================
+  // -- Constants --------------------------------------------------------------
+  // ===========================================================================
+
+  /// Distance between the spawn points generated along the lanes of the map.
+  static constexpr double SPAWN_POINT_DISTANCE = 20.0;
+
+  /// Kinematic model of the vehicles controlled by clients.
+  static constexpr float MAX_ACCELERATION = 4.0f;     // m/s^2
+  static constexpr float MAX_DECELERATION = 8.0f;     // m/s^2
+  static constexpr float ROLLING_DECELERATION = 0.5f; // m/s^2
+  static constexpr float MAX_SPEED = 60.0f;           // m/s
+  static constexpr float MAX_STEER_ANGLE = 70.0f;     // degrees
+  static constexpr float WHEELBASE = 2.9f;            // m
+
+  /// Walkers spawned by the server change direction about this often.
+  static constexpr float WALKER_SPEED = 1.4f;         // m/s
+  static constexpr float WALKER_TURN_PERIOD = 10.0f;  // s
+
+  /// Width of the lanes of the ring road.
+  static constexpr double LANE_WIDTH = 3.5;            // m
+
+  // ===========================================================================
+  // -- Helpers ----------------------------------------------------------------
+  // ===========================================================================
+
+  enum class ActorType {
+    Spectator,
+    Vehicle,
+    Walker,
+    Camera,
+    Radar,
+    OtherSensor,
+    Other
+  };
+
+  static bool StartsWith(const std::string &str, const char *prefix) {
+    return str.compare(0u, std::strlen(prefix), prefix) == 0;
+  }
+
+  static ActorType GetActorType(const std::string &type_id) {
+    if (StartsWith(type_id, "vehicle.")) {
+      return ActorType::Vehicle;
+    } else if (StartsWith(type_id, "walker.")) {
+      return ActorType::Walker;
+    } else if (type_id == "sensor.camera.rgb") {
+      return ActorType::Camera;
+    } else if (type_id == "sensor.other.radar") {
+      return ActorType::Radar;
+    } else if (StartsWith(type_id, "sensor.")) {
+      return ActorType::OtherSensor;
+    } else if (type_id == "spectator") {
+      return ActorType::Spectator;
+    }
+    return ActorType::Other;
+  }
+
+  static std::string GetAttribute(
+      const rpc::ActorDescription &description,
+      const std::string &id,
+      std::string default_value) {
+    for (const auto &attribute : description.attributes) {
+      if (attribute.id == id) {
+        return attribute.value;
+      }
+    }
+    return default_value;
+  }
+
+  static rpc::ActorAttribute MakeAttribute(
+      std::string id,
+      rpc::ActorAttributeType type,
+      std::vector<std::string> recommended_values,
+      bool is_modifiable = true) {
+    rpc::ActorAttribute attribute;
+    attribute.id = std::move(id);
+    attribute.type = type;
+    if (!recommended_values.empty()) {
+      attribute.value = recommended_values.front();
+    }
+    attribute.recommended_values = is_modifiable ?
+        std::move(recommended_values) :
+        std::vector<std::string>{};
+    attribute.is_modifiable = is_modifiable;
+    return attribute;
+  }
+
+  static std::string ToString(double value) {
+    std::ostringstream out;
+    out << std::setprecision(15) << value;
+    return out.str();
+  }
+
+  // ===========================================================================
+  // -- MockActor --------------------------------------------------------------
+  // ===========================================================================
+
+  struct MockActor {
+    ActorType type = ActorType::Other;
+
+    rpc::Actor description;
+
+    /// Relative to the parent if attached.
+    geom::Transform transform;
+
+    geom::Vector3D velocity;
+
+    geom::Vector3D acceleration;
+
+    bool simulate_physics = true;
+
+    rpc::VehicleControl vehicle_control;
+
+    rpc::WalkerControl walker_control;
+
+    rpc::VehicleLightState::flag_type light_state = 0u;
+
+    boost::optional<geom::Vector3D> target_velocity;
+
+    /// Driven by the server along the lanes, either spawned at start-up or
+    /// with autopilot enabled.
+    bool autopilot = false;
+
+    /// Signed speed along the forward vector.
+    float speed = 0.0f;
+
+    boost::optional<road::element::Waypoint> waypoint;
+
+    boost::optional<streaming::Stream> stream;
+
+    double sensor_tick = 0.0;
+
+    double next_measurement = 0.0;
+
+    uint32_t image_width = 0u;
+
+    uint32_t image_height = 0u;
+
+    float fov = 90.0f;
+
+    uint32_t points_per_second = 0u;
+
+    ActorId GetParentId() const {
+      return description.parent_id;
+    }
+  };
+
+  // ===========================================================================
+  // -- MockServer::Pimpl ------------------------------------------------------
+  // ===========================================================================
+
+  class MockServer::Pimpl : private NonCopyable {
+  public:
+
+    explicit Pimpl(MockServerSettings settings);
+
+    void AsyncRun(size_t worker_threads) {
+      _rpc.AsyncRun(worker_threads);
+      _streaming.AsyncRun(worker_threads);
+    }
+
+    void Run(bool has_deadline, std::chrono::steady_clock::time_point deadline);
+
+    void Stop() {
+      _stop = true;
+    }
+
+    uint64_t Tick();
+
+    uint64_t GetFrame() const {
+      return _frame;
+    }
+
+    size_t GetNumberOfActors() const {
+      return _number_of_actors;
+    }
+
+  private:
+
+    void BindFunctions();
+
+    double GetDeltaSeconds() const {
+      return _episode_settings.fixed_delta_seconds.get_value_or(1.0 / _settings.frame_rate);
+    }
+
+    uint64_t TickCue() {
+      return _episode_settings.synchronous_mode ? Tick() : _frame + 1u;
+    }
+
+    MockActor *FindActor(ActorId id) {
+      auto it = _actors.find(id);
+      return it != _actors.end() ? &it->second : nullptr;
+    }
+
+    static rpc::ResponseError ActorNotFound(ActorId id) {
+      return rpc::ResponseError("actor not found, id: " + std::to_string(id));
+    }
+
+    geom::Transform GetWorldTransform(const MockActor &actor);
+
+    geom::Vector3D GetWorldVelocity(const MockActor &actor);
+
+    const road::element::Waypoint &GetRandomSpawnWaypoint() {
+      DEBUG_ASSERT(!_spawn_waypoints.empty());
+      std::uniform_int_distribution<size_t> index(0u, _spawn_waypoints.size() - 1u);
+      return _spawn_waypoints[index(_random_engine)];
+    }
+
+    float GetRandomCruiseSpeed() {
+      std::uniform_real_distribution<float> factor(0.6f, 1.0f);
+      return factor(_random_engine) * _settings.speed_limit / 3.6f;
+    }
+
+    rpc::WalkerControl GetRandomWalkerControl() {
+      std::uniform_real_distribution<float> angle(0.0f, geom::Math::Pi2<float>());
+      const float yaw = angle(_random_engine);
+      return {geom::Vector3D{std::cos(yaw), std::sin(yaw), 0.0f}, WALKER_SPEED, false};
+    }
+
+    R<rpc::Actor> SpawnActor(
+        const rpc::ActorDescription &description,
+        const geom::Transform &transform,
+        ActorId parent = 0u);
+
+    R<bool> DestroyActor(ActorId id);
+
+    R<void> SetActorTransform(ActorId id, const geom::Transform &transform);
+
+    R<void> SetActorTargetVelocity(ActorId id, const geom::Vector3D &velocity);
+
+    R<void> SetActorSimulatePhysics(ActorId id, bool enabled);
+
+    R<void> SetActorAutopilot(ActorId id, bool enabled);
+
+    R<void> ApplyControlToVehicle(ActorId id, const rpc::VehicleControl &control);
+
+    R<void> ApplyControlToWalker(ActorId id, const rpc::WalkerControl &control);
+
+    R<void> SetVehicleLightState(ActorId id, rpc::VehicleLightState::flag_type light_state);
+
+    std::vector<rpc::CommandResponse> ApplyBatch(const std::vector<rpc::Command> &commands);
+
+    void DriveAlongLane(MockActor &actor, float delta_seconds);
+
+    void IntegrateVehicle(MockActor &actor, float delta_seconds);
+
+    void MoveWalker(MockActor &actor, float delta_seconds);
+
+    void UpdateActors(float delta_seconds);
+
+    void PublishEpisodeState(double delta_seconds);
+
+    void SendSensorData(double delta_seconds);
+
+    void Send(
+        streaming::Stream &stream,
+        uint64_t sensor_type,
+        const geom::Transform &transform,
+        Buffer &&payload);
+
+    const MockServerSettings _settings;
+
+    const std::string _opendrive;
+
+    const road::Map _map;
+
+    std::vector<road::element::Waypoint> _spawn_waypoints;
+
+    std::vector<geom::Transform> _spawn_points;
+
+    std::vector<rpc::ActorDefinition> _actor_definitions;
+
+    rpc::Server _rpc;
+
+    streaming::Server _streaming;
+
+    streaming::Stream _broadcast;
+
+    const uint64_t _episode_id;
+
+    rpc::EpisodeSettings _episode_settings;
+
+    rpc::WeatherParameters _weather;
+
+    std::map<uint16_t, std::string> _traffic_managers;
+
+    std::map<ActorId, MockActor> _actors;
+
+    ActorId _next_actor_id = 1u;
+
+    ActorId _spectator_id = 0u;
+
+    std::atomic_size_t _number_of_actors{0u};
+
+    std::atomic<uint64_t> _frame{0u};
+
+    double _elapsed_seconds = 0.0;
+
+    std::atomic_bool _stop{false};
+
+    std::mt19937 _random_engine;
+
+    /// Reused between calls to road::Map::GetNext.
+    std::vector<road::element::Waypoint> _next_waypoints;
+  };
+
+  static road::Map LoadMap(const std::string &opendrive) {
+    auto map = opendrive::OpenDriveParser::Load(opendrive);
+    if (!map.has_value()) {
+      throw_exception(std::invalid_argument("mock server: unable to parse the OpenDRIVE map"));
+    }
+    return std::move(*map);
+  }
+
+  MockServer::Pimpl::Pimpl(MockServerSettings settings)
+    : _settings(std::move(settings)),
+      _opendrive(_settings.opendrive.empty() ?
+          MockServer::MakeRingRoad(_settings.ring_radius, _settings.lanes_per_direction) :
+          _settings.opendrive),
+      _map(LoadMap(_opendrive)),
+      _rpc(_settings.port),
+      _streaming(static_cast<uint16_t>(_settings.port + 1u)),
+      _broadcast(_streaming.MakeStream()),
+      _episode_id(std::chrono::system_clock::now().time_since_epoch().count()),
+      _random_engine(_settings.seed) {
+    DEBUG_ASSERT(_settings.frame_rate > 0.0);
+    for (const auto &waypoint : _map.GenerateWaypoints(SPAWN_POINT_DISTANCE)) {
+      if (_map.GetLane(waypoint).GetType() == road::Lane::LaneType::Driving) {
+        _spawn_waypoints.emplace_back(waypoint);
+        auto transform = _map.ComputeTransform(waypoint);
+        transform.location.z += 0.5f;
+        _spawn_points.emplace_back(transform);
+      }
+    }
+    if (_spawn_waypoints.empty()) {
+      throw_exception(std::invalid_argument("mock server: the map has no driving lanes"));
+    }
+
+    _episode_settings.synchronous_mode = _settings.synchronous_mode;
+    if (_settings.synchronous_mode) {
+      _episode_settings.fixed_delta_seconds = 1.0 / _settings.frame_rate;
+    }
+    _streaming.SetSynchronousMode(_settings.synchronous_mode);
+
+    // -- Blueprints -----------------------------------------------------------
+
+    using Type = rpc::ActorAttributeType;
+    rpc::ActorDefinition vehicle;
+    vehicle.id = "vehicle.mock.sedan";
+    vehicle.tags = "vehicle,mock,sedan";
+    vehicle.attributes = {
+      MakeAttribute("role_name", Type::String, {"autopilot"}),
+      MakeAttribute("color", Type::RGBColor, {"17,37,103", "255,255,255", "0,0,0"}),
+      MakeAttribute("number_of_wheels", Type::Int, {"4"}, false),
+      MakeAttribute("generation", Type::Int, {"2"}, false),
+      MakeAttribute("base_type", Type::String, {"car"}, false),
+      MakeAttribute("has_lights", Type::Bool, {"true"}, false)};
+    rpc::ActorDefinition walker;
+    walker.id = "walker.pedestrian.0001";
+    walker.tags = "walker,pedestrian,0001";
+    walker.attributes = {
+      MakeAttribute("role_name", Type::String, {"walker"}),
+      MakeAttribute("is_invincible", Type::Bool, {"true", "false"}),
+      MakeAttribute("speed", Type::Float, {"1.4", "2.0"}),
+      MakeAttribute("generation", Type::Int, {"2"}, false)};
+    rpc::ActorDefinition camera;
+    camera.id = "sensor.camera.rgb";
+    camera.tags = "sensor,camera,rgb";
+    camera.attributes = {
+      MakeAttribute("role_name", Type::String, {"front"}),
+      MakeAttribute("image_size_x", Type::Int, {"800"}),
+      MakeAttribute("image_size_y", Type::Int, {"600"}),
+      MakeAttribute("fov", Type::Float, {"90.0"}),
+      MakeAttribute("sensor_tick", Type::Float, {"0.0"})};
+    rpc::ActorDefinition radar;
+    radar.id = "sensor.other.radar";
+    radar.tags = "sensor,other,radar";
+    radar.attributes = {
+      MakeAttribute("role_name", Type::String, {"front"}),
+      MakeAttribute("points_per_second", Type::Int, {"1500"}),
+      MakeAttribute("range", Type::Float, {"100"}),
+      MakeAttribute("horizontal_fov", Type::Float, {"30"}),
+      MakeAttribute("vertical_fov", Type::Float, {"30"}),
+      MakeAttribute("sensor_tick", Type::Float, {"0.0"})};
+    _actor_definitions = {vehicle, walker, camera, radar};
+    for (auto i = 0u; i < _actor_definitions.size(); ++i) {
+      _actor_definitions[i].uid = i + 1u;
+    }
+
+    // -- Actors ---------------------------------------------------------------
+
+    rpc::ActorDescription spectator;
+    spectator.id = "spectator";
+    _spectator_id = SpawnActor(spectator, _spawn_points.front()).Get().id;
+
+    auto make_description = [](const rpc::ActorDefinition &definition) {
+      rpc::ActorDescription description;
+      description.uid = definition.uid;
+      description.id = definition.id;
+      for (const auto &attribute : definition.attributes) {
+        description.attributes.emplace_back(attribute);
+      }
+      return description;
+    };
+    const auto vehicle_description = make_description(vehicle);
+    for (auto i = 0u; i < _settings.number_of_vehicles; ++i) {
+      const auto &waypoint = GetRandomSpawnWaypoint();
+      const auto id = SpawnActor(vehicle_description, _map.ComputeTransform(waypoint)).Get().id;
+      auto &actor = _actors.at(id);
+      actor.autopilot = true;
+      actor.waypoint = waypoint;
+      actor.speed = GetRandomCruiseSpeed();
+    }
+    const auto walker_description = make_description(walker);
+    for (auto i = 0u; i < _settings.number_of_walkers; ++i) {
+      auto transform = _map.ComputeTransform(GetRandomSpawnWaypoint());
+      transform.location.z += 1.0f;
+      const auto id = SpawnActor(walker_description, transform).Get().id;
+      auto &actor = _actors.at(id);
+      actor.autopilot = true;
+      actor.walker_control = GetRandomWalkerControl();
+    }
+
+    BindFunctions();
+  }
+
+  // ===========================================================================
+  // -- MockServer::Pimpl RPC --------------------------------------------------
+  // ===========================================================================
+
+  void MockServer::Pimpl::BindFunctions() {
+    namespace cr = carla::rpc;
+
+    // -- Episode --------------------------------------------------------------
+
+    _rpc.BindAsync("version", []() -> R<std::string> {
+      return carla::version();
+    });
+
+    _rpc.BindSync("tick_cue", [this]() -> R<uint64_t> {
+      return TickCue();
+    });
+
+    _rpc.BindSync("get_episode_info", [this]() -> R<cr::EpisodeInfo> {
+      return cr::EpisodeInfo{_episode_id, _broadcast.token()};
+    });
+
+    _rpc.BindSync("get_map_info", [this]() -> R<cr::MapInfo> {
+      return cr::MapInfo{"Carla/Maps/MockRing", _spawn_points};
+    });
+
+    _rpc.BindSync("get_map_data", [this]() -> R<std::string> {
+      return _opendrive;
+    });
+
+    _rpc.BindSync("get_available_maps", []() -> R<std::vector<std::string>> {
+      return std::vector<std::string>{"Carla/Maps/MockRing"};
+    });
+
+    _rpc.BindSync("get_required_files", [](std::string) -> R<std::vector<std::string>> {
+      return std::vector<std::string>{};
+    });
+
+    _rpc.BindSync("get_navigation_mesh", []() -> R<std::vector<uint8_t>> {
+      return std::vector<uint8_t>{};
+    });
+
+    _rpc.BindSync("get_episode_settings", [this]() -> R<cr::EpisodeSettings> {
+      return _episode_settings;
+    });
+
+    _rpc.BindSync("set_episode_settings", [this](const cr::EpisodeSettings &settings) -> R<uint64_t> {
+      _episode_settings = settings;
+      _streaming.SetSynchronousMode(settings.synchronous_mode);
+      return _frame.load();
+    });
+
+    _rpc.BindSync("get_weather_parameters", [this]() -> R<cr::WeatherParameters> {
+      return _weather;
+    });
+
+    _rpc.BindSync("set_weather_parameters", [this](const cr::WeatherParameters &weather) -> R<void> {
+      _weather = weather;
+      return R<void>::Success();
+    });
+
+    // -- Traffic Manager registry ---------------------------------------------
+
+    _rpc.BindSync("is_traffic_manager_running", [this](uint16_t port) -> R<bool> {
+      return _traffic_managers.find(port) != _traffic_managers.end();
+    });
+
+    _rpc.BindSync("get_traffic_manager_running", [this](uint16_t port) -> R<std::pair<std::string, uint16_t>> {
+      auto it = _traffic_managers.find(port);
+      if (it != _traffic_managers.end()) {
+        return std::pair<std::string, uint16_t>(it->second, it->first);
+      }
+      return std::pair<std::string, uint16_t>("", 0u);
+    });
+
+    _rpc.BindSync("add_traffic_manager_running", [this](std::pair<std::string, uint16_t> info) -> R<bool> {
+      return _traffic_managers.emplace(info.second, info.first).second;
+    });
+
+    _rpc.BindSync("destroy_traffic_manager", [this](uint16_t port) -> R<bool> {
+      return _traffic_managers.erase(port) > 0u;
+    });
+
+    // -- Actors ---------------------------------------------------------------
+
+    _rpc.BindSync("get_actor_definitions", [this]() -> R<std::vector<cr::ActorDefinition>> {
+      return _actor_definitions;
+    });
+
+    _rpc.BindSync("get_spectator", [this]() -> R<cr::Actor> {
+      return _actors.at(_spectator_id).description;
+    });
+
+    _rpc.BindSync("get_actors_by_id", [this](const std::vector<ActorId> &ids) -> R<std::vector<cr::Actor>> {
+      std::vector<cr::Actor> result;
+      result.reserve(ids.size());
+      for (auto id : ids) {
+        const auto *actor = FindActor(id);
+        if (actor != nullptr) {
+          result.emplace_back(actor->description);
+        }
+      }
+      return result;
+    });
+
+    _rpc.BindSync("spawn_actor", [this](
+        cr::ActorDescription description,
+        const cr::Transform &transform) -> R<cr::Actor> {
+      return SpawnActor(description, transform);
+    });
+
+    _rpc.BindSync("spawn_actor_with_parent", [this](
+        cr::ActorDescription description,
+        const cr::Transform &transform,
+        ActorId parent,
+        cr::AttachmentType) -> R<cr::Actor> {
+      return SpawnActor(description, transform, parent);
+    });
+
+    _rpc.BindSync("destroy_actor", [this](ActorId id) -> R<bool> {
+      return DestroyActor(id);
+    });
+
+    _rpc.BindSync("set_actor_location", [this](ActorId id, const geom::Location &location) -> R<void> {
+      auto *actor = FindActor(id);
+      if (actor == nullptr) {
+        return ActorNotFound(id);
+      }
+      auto transform = actor->transform;
+      transform.location = location;
+      return SetActorTransform(id, transform);
+    });
+
+    _rpc.BindSync("set_actor_transform", [this](ActorId id, const cr::Transform &transform) -> R<void> {
+      return SetActorTransform(id, transform);
+    });
+
+    _rpc.BindSync("set_actor_target_velocity", [this](ActorId id, const geom::Vector3D &velocity) -> R<void> {
+      return SetActorTargetVelocity(id, velocity);
+    });
+
+    _rpc.BindSync("set_actor_simulate_physics", [this](ActorId id, bool enabled) -> R<void> {
+      return SetActorSimulatePhysics(id, enabled);
+    });
+
+    _rpc.BindSync("set_actor_autopilot", [this](ActorId id, bool enabled) -> R<void> {
+      return SetActorAutopilot(id, enabled);
+    });
+
+    _rpc.BindSync("apply_control_to_vehicle", [this](ActorId id, const cr::VehicleControl &control) -> R<void> {
+      return ApplyControlToVehicle(id, control);
+    });
+
+    _rpc.BindSync("apply_control_to_walker", [this](ActorId id, const cr::WalkerControl &control) -> R<void> {
+      return ApplyControlToWalker(id, control);
+    });
+
+    _rpc.BindSync("set_vehicle_light_state", [this](ActorId id, const cr::VehicleLightState &state) -> R<void> {
+      return SetVehicleLightState(id, state.light_state);
+    });
+
+    _rpc.BindSync("get_vehicle_light_state", [this](ActorId id) -> R<cr::VehicleLightState> {
+      const auto *actor = FindActor(id);
+      if (actor == nullptr) {
+        return ActorNotFound(id);
+      }
+      return cr::VehicleLightState(actor->light_state);
+    });
+
+    _rpc.BindSync("get_vehicle_light_states", [this]() -> R<cr::VehicleLightStateList> {
+      cr::VehicleLightStateList result;
+      for (const auto &pair : _actors) {
+        if (pair.second.type == ActorType::Vehicle) {
+          result.emplace_back(pair.first, pair.second.light_state);
+        }
+      }
+      return result;
+    });
+
+    _rpc.BindSync("get_light_boxes", [](ActorId) -> R<std::vector<geom::BoundingBox>> {
+      return std::vector<geom::BoundingBox>{};
+    });
+
+    // -- Sensors --------------------------------------------------------------
+
+    _rpc.BindSync("get_sensor_token", [this](streaming::detail::stream_id_type id) -> R<streaming::Token> {
+      return _streaming.GetToken(id);
+    });
+
+    _rpc.BindSync("set_sensor_compression", [this](
+        streaming::detail::stream_id_type id,
+        uint8_t compression) -> R<void> {
+      if (compression > static_cast<uint8_t>(sensor::s11n::CompressionType::ImageDelta)) {
+        return cr::ResponseError("unknown compression " + std::to_string(compression));
+      }
+      if (!_streaming.SetCompression(id, compression)) {
+        return cr::ResponseError("stream not found, id: " + std::to_string(id));
+      }
+      return R<void>::Success();
+    });
+
+    _rpc.BindSync("set_sensor_timing", [this](streaming::detail::stream_id_type id, bool enabled) -> R<void> {
+      if (!_streaming.SetTimingEnabled(id, enabled)) {
+        return cr::ResponseError("stream not found, id: " + std::to_string(id));
+      }
+      return R<void>::Success();
+    });
+
+    // -- Batches --------------------------------------------------------------
+
+    _rpc.BindSync("apply_batch", [this](const std::vector<cr::Command> &commands, bool do_tick_cue) {
+      auto result = ApplyBatch(commands);
+      if (do_tick_cue) {
+        TickCue();
+      }
+      return result;
+    });
+
+    _rpc.BindSync("apply_vehicle_controls", [this](
+        const cr::VehicleControlBatch &batch,
+        bool do_tick_cue) -> R<std::vector<ActorId>> {
+      if (!batch.IsValid()) {
+        return cr::ResponseError("apply_vehicle_controls: malformed batch");
+      }
+      std::vector<ActorId> failed;
+      for (size_t i = 0u; i < batch.size(); ++i) {
+        if (!ApplyControlToVehicle(batch.GetActor(i), batch.GetValue(i))) {
+          failed.emplace_back(batch.GetActor(i));
+        }
+      }
+      if (do_tick_cue) {
+        TickCue();
+      }
+      return failed;
+    });
+
+    _rpc.BindSync("apply_transforms", [this](
+        const cr::TransformBatch &batch,
+        bool do_tick_cue) -> R<std::vector<ActorId>> {
+      if (!batch.IsValid()) {
+        return cr::ResponseError("apply_transforms: malformed batch");
+      }
+      std::vector<ActorId> failed;
+      for (size_t i = 0u; i < batch.size(); ++i) {
+        if (!SetActorTransform(batch.GetActor(i), batch.GetValue(i))) {
+          failed.emplace_back(batch.GetActor(i));
+        }
+      }
+      if (do_tick_cue) {
+        TickCue();
+      }
+      return failed;
+    });
+  }
+
+  R<rpc::Actor> MockServer::Pimpl::SpawnActor(
+      const rpc::ActorDescription &description,
+      const geom::Transform &transform,
+      const ActorId parent) {
+    if ((parent != 0u) && (FindActor(parent) == nullptr)) {
+      return rpc::ResponseError("unable to attach actor: parent not found, id: " + std::to_string(parent));
+    }
+    MockActor actor;
+    actor.type = GetActorType(description.id);
+    actor.description.id = _next_actor_id++;
+    actor.description.parent_id = parent;
+    actor.description.description = description;
+    actor.transform = transform;
+    switch (actor.type) {
+      case ActorType::Vehicle:
+        actor.description.bounding_box = geom::BoundingBox(geom::Vector3D{2.4f, 1.0f, 0.8f});
+        actor.description.bounding_box.location.z = 0.8f;
+        actor.description.semantic_tags = {static_cast<uint8_t>(rpc::CityObjectLabel::Car)};
+        break;
+      case ActorType::Walker:
+        actor.description.bounding_box = geom::BoundingBox(geom::Vector3D{0.3f, 0.3f, 0.9f});
+        actor.description.semantic_tags = {static_cast<uint8_t>(rpc::CityObjectLabel::Pedestrians)};
+        break;
+      case ActorType::Camera:
+        actor.image_width = static_cast<uint32_t>(std::stoul(GetAttribute(description, "image_size_x", "800")));
+        actor.image_height = static_cast<uint32_t>(std::stoul(GetAttribute(description, "image_size_y", "600")));
+        actor.fov = std::stof(GetAttribute(description, "fov", "90"));
+        actor.sensor_tick = std::stod(GetAttribute(description, "sensor_tick", "0"));
+        break;
+      case ActorType::Radar:
+        actor.points_per_second = static_cast<uint32_t>(std::stoul(GetAttribute(description, "points_per_second", "1500")));
+        actor.sensor_tick = std::stod(GetAttribute(description, "sensor_tick", "0"));
+        break;
+      default:
+        break;
+    }
+    if ((actor.type == ActorType::Camera) ||
+        (actor.type == ActorType::Radar) ||
+        (actor.type == ActorType::OtherSensor)) {
+      actor.stream = _streaming.MakeStream();
+      const auto token = actor.stream->token();
+      actor.description.stream_token.assign(token.data.begin(), token.data.end());
+    }
+    auto result = actor.description;
+    _actors.emplace(result.id, std::move(actor));
+    _number_of_actors = _actors.size();
+    return result;
+  }
+
+  R<bool> MockServer::Pimpl::DestroyActor(const ActorId id) {
+    auto it = _actors.find(id);
+    if ((it == _actors.end()) || (id == _spectator_id)) {
+      return rpc::ResponseError("unable to destroy actor: not found, id: " + std::to_string(id));
+    }
+    // Actors attached to this one stay where they are.
+    for (auto &pair : _actors) {
+      if (pair.second.GetParentId() == id) {
+        pair.second.transform = GetWorldTransform(pair.second);
+        pair.second.description.parent_id = 0u;
+      }
+    }
+    if (it->second.stream.has_value()) {
+      const streaming::detail::token_type token{it->second.stream->token()};
+      _streaming.CloseStream(token.get_stream_id());
+    }
+    _actors.erase(it);
+    _number_of_actors = _actors.size();
+    return true;
+  }
+
+  R<void> MockServer::Pimpl::SetActorTransform(const ActorId id, const geom::Transform &transform) {
+    auto *actor = FindActor(id);
+    if (actor == nullptr) {
+      return ActorNotFound(id);
+    }
+    actor->transform = transform;
+    // Teleported vehicles continue from the closest lane.
+    actor->waypoint.reset();
+    return R<void>::Success();
+  }
+
+  R<void> MockServer::Pimpl::SetActorTargetVelocity(const ActorId id, const geom::Vector3D &velocity) {
+    auto *actor = FindActor(id);
+    if (actor == nullptr) {
+      return ActorNotFound(id);
+    }
+    actor->target_velocity = velocity;
+    return R<void>::Success();
+  }
+
+  R<void> MockServer::Pimpl::SetActorSimulatePhysics(const ActorId id, const bool enabled) {
+    auto *actor = FindActor(id);
+    if (actor == nullptr) {
+      return ActorNotFound(id);
+    }
+    actor->simulate_physics = enabled;
+    if (!enabled) {
+      actor->speed = 0.0f;
+    }
+    return R<void>::Success();
+  }
+
+  R<void> MockServer::Pimpl::SetActorAutopilot(const ActorId id, const bool enabled) {
+    auto *actor = FindActor(id);
+    if ((actor == nullptr) || (actor->type != ActorType::Vehicle)) {
+      return rpc::ResponseError("unable to set autopilot: vehicle not found, id: " + std::to_string(id));
+    }
+    actor->autopilot = enabled;
+    if (enabled) {
+      actor->waypoint.reset();
+      actor->speed = GetRandomCruiseSpeed();
+    }
+    return R<void>::Success();
+  }
+
+  R<void> MockServer::Pimpl::ApplyControlToVehicle(const ActorId id, const rpc::VehicleControl &control) {
+    auto *actor = FindActor(id);
+    if ((actor == nullptr) || (actor->type != ActorType::Vehicle)) {
+      return rpc::ResponseError("unable to apply control: vehicle not found, id: " + std::to_string(id));
+    }
+    actor->vehicle_control = control;
+    return R<void>::Success();
+  }
+
+  R<void> MockServer::Pimpl::ApplyControlToWalker(const ActorId id, const rpc::WalkerControl &control) {
+    auto *actor = FindActor(id);
+    if ((actor == nullptr) || (actor->type != ActorType::Walker)) {
+      return rpc::ResponseError("unable to apply control: walker not found, id: " + std::to_string(id));
+    }
+    actor->walker_control = control;
+    actor->autopilot = false;
+    return R<void>::Success();
+  }
+
+  R<void> MockServer::Pimpl::SetVehicleLightState(
+      const ActorId id,
+      const rpc::VehicleLightState::flag_type light_state) {
+    auto *actor = FindActor(id);
+    if ((actor == nullptr) || (actor->type != ActorType::Vehicle)) {
+      return rpc::ResponseError("unable to set light state: vehicle not found, id: " + std::to_string(id));
+    }
+    actor->light_state = light_state;
+    return R<void>::Success();
+  }
+
+  std::vector<rpc::CommandResponse> MockServer::Pimpl::ApplyBatch(
+      const std::vector<rpc::Command> &commands) {
+    using C = rpc::Command;
+    using CR = rpc::CommandResponse;
+
+    auto parse_result = [](ActorId id, const auto &response) {
+      return response.HasError() ? CR{response.GetError()} : CR{id};
+    };
+
+    auto command_visitor = Functional::MakeRecursiveOverload(
+        [=](auto self, const C::SpawnActor &c) -> CR {
+          auto result = SpawnActor(c.description, c.transform, c.parent.get_value_or(0u));
+          if (result.HasError()) {
+            return result.GetError();
+          }
+          const ActorId id = result.Get().id;
+          auto set_id = Functional::MakeOverload(
+              [](C::SpawnActor &) {},
+              [](C::ConsoleCommand &) {},
+              [id](auto &s) { s.actor = id; });
+          for (auto command : c.do_after) {
+            boost::variant2::visit(set_id, command.command);
+            boost::variant2::visit(self, command.command);
+          }
+          return id;
+        },
+        [=](auto, const C::DestroyActor &c) -> CR {
+          return parse_result(c.actor, DestroyActor(c.actor));
+        },
+        [=](auto, const C::ApplyVehicleControl &c) -> CR {
+          return parse_result(c.actor, ApplyControlToVehicle(c.actor, c.control));
+        },
+        [=](auto, const C::ApplyWalkerControl &c) -> CR {
+          return parse_result(c.actor, ApplyControlToWalker(c.actor, c.control));
+        },
+        [=](auto, const C::ApplyTransform &c) -> CR {
+          return parse_result(c.actor, SetActorTransform(c.actor, c.transform));
+        },
+        [=](auto, const C::ApplyLocation &c) -> CR {
+          auto *actor = FindActor(c.actor);
+          if (actor == nullptr) {
+            return ActorNotFound(c.actor);
+          }
+          auto transform = actor->transform;
+          transform.location = c.location;
+          return parse_result(c.actor, SetActorTransform(c.actor, transform));
+        },
+        [=](auto, const C::ApplyWalkerState &c) -> CR {
+          auto result = SetActorTransform(c.actor, c.transform);
+          if (!result.HasError()) {
+            auto &actor = _actors.at(c.actor);
+            actor.walker_control.direction = c.transform.GetForwardVector();
+            actor.walker_control.speed = c.speed;
+          }
+          return parse_result(c.actor, result);
+        },
+        [=](auto, const C::ApplyTargetVelocity &c) -> CR {
+          return parse_result(c.actor, SetActorTargetVelocity(c.actor, c.velocity));
+        },
+        [=](auto, const C::SetSimulatePhysics &c) -> CR {
+          return parse_result(c.actor, SetActorSimulatePhysics(c.actor, c.enabled));
+        },
+        [=](auto, const C::SetAutopilot &c) -> CR {
+          return parse_result(c.actor, SetActorAutopilot(c.actor, c.enabled));
+        },
+        [=](auto, const C::SetVehicleLightState &c) -> CR {
+          return parse_result(c.actor, SetVehicleLightState(c.actor, c.light_state));
+        },
+        [=](auto, const C::ConsoleCommand &) -> CR {
+          return rpc::ResponseError("console commands are not supported by the mock server");
+        },
+        // Physics and traffic light commands only need the actor to exist.
+        [=](auto, const auto &c) -> CR {
+          if (FindActor(c.actor) == nullptr) {
+            return ActorNotFound(c.actor);
+          }
+          return c.actor;
+        });
+
+    std::vector<CR> result;
+    result.reserve(commands.size());
+    for (const auto &command : commands) {
+      result.emplace_back(boost::variant2::visit(command_visitor, command.command));
+    }
+    return result;
+  }
+
+  // ===========================================================================
+  // -- MockServer::Pimpl simulation -------------------------------------------
+  // ===========================================================================
+
+  void MockServer::Pimpl::Run(
+      const bool has_deadline,
+      const std::chrono::steady_clock::time_point deadline) {
+    using clock = std::chrono::steady_clock;
+    constexpr auto max_slice = std::chrono::milliseconds(10);
+    auto next_tick = clock::now();
+    while (!_stop && (!has_deadline || (clock::now() < deadline))) {
+      const auto now = clock::now();
+      if (_episode_settings.synchronous_mode) {
+        // Frames are driven by the tick cues of the client.
+        _rpc.SyncRunFor(max_slice);
+        next_tick = now;
+      } else if (now >= next_tick) {
+        Tick();
+        next_tick += std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(1.0 / _settings.frame_rate));
+        // Do not try to catch up if we fell behind.
+        next_tick = std::max(next_tick, now);
+      } else {
+        _rpc.SyncRunFor(std::min(
+            std::chrono::duration_cast<std::chrono::milliseconds>(next_tick - now) +
+                std::chrono::milliseconds(1),
+            max_slice));
+      }
+    }
+    _stop = false;
+  }
+
+  uint64_t MockServer::Pimpl::Tick() {
+    const double delta_seconds = GetDeltaSeconds();
+    ++_frame;
+    _elapsed_seconds += delta_seconds;
+    UpdateActors(static_cast<float>(delta_seconds));
+    PublishEpisodeState(delta_seconds);
+    SendSensorData(delta_seconds);
+    return _frame;
+  }
+
+  geom::Transform MockServer::Pimpl::GetWorldTransform(const MockActor &actor) {
+    const auto *parent = FindActor(actor.GetParentId());
+    if (parent == nullptr) {
+      return actor.transform;
+    }
+    // Rotations are composed by adding the angles, good enough for the usual
+    // sensor mounts.
+    const auto parent_transform = GetWorldTransform(*parent);
+    geom::Transform result = actor.transform;
+    parent_transform.TransformPoint(result.location);
+    result.rotation.pitch += parent_transform.rotation.pitch;
+    result.rotation.yaw += parent_transform.rotation.yaw;
+    result.rotation.roll += parent_transform.rotation.roll;
+    return result;
+  }
+
+  geom::Vector3D MockServer::Pimpl::GetWorldVelocity(const MockActor &actor) {
+    const auto *parent = FindActor(actor.GetParentId());
+    return parent == nullptr ? actor.velocity : GetWorldVelocity(*parent);
+  }
+
+  void MockServer::Pimpl::DriveAlongLane(MockActor &actor, const float delta_seconds) {
+    if (!actor.waypoint.has_value()) {
+      actor.waypoint = _map.GetClosestWaypointOnRoad(actor.transform.location);
+      if (!actor.waypoint.has_value()) {
+        actor.waypoint = GetRandomSpawnWaypoint();
+      }
+    }
+    const float distance = std::abs(actor.speed) * delta_seconds;
+    if (distance > 0.0f) {
+      _next_waypoints.clear();
+      _map.GetNext(*actor.waypoint, distance, _next_waypoints);
+      if (_next_waypoints.empty()) {
+        // Dead end, start over somewhere else.
+        actor.waypoint = GetRandomSpawnWaypoint();
+      } else {
+        std::uniform_int_distribution<size_t> index(0u, _next_waypoints.size() - 1u);
+        actor.waypoint = _next_waypoints[index(_random_engine)];
+      }
+    }
+    actor.transform = _map.ComputeTransform(*actor.waypoint);
+    actor.velocity = actor.transform.GetForwardVector() * std::abs(actor.speed);
+  }
+
+  void MockServer::Pimpl::IntegrateVehicle(MockActor &actor, const float delta_seconds) {
+    const auto &control = actor.vehicle_control;
+    auto forward = actor.transform.GetForwardVector();
+    if (actor.target_velocity.has_value()) {
+      actor.speed = geom::Math::Dot(*actor.target_velocity, forward);
+      actor.target_velocity.reset();
+    }
+    float speed = actor.speed;
+    const float direction = control.reverse ? -1.0f : 1.0f;
+    speed += direction * geom::Math::Clamp(control.throttle) * MAX_ACCELERATION * delta_seconds;
+    const float brake = control.hand_brake ? 1.0f : geom::Math::Clamp(control.brake);
+    const float deceleration = brake * MAX_DECELERATION + ROLLING_DECELERATION;
+    speed -= std::copysign(std::min(std::abs(speed), deceleration * delta_seconds), speed);
+    speed = geom::Math::Clamp(speed, -MAX_SPEED, MAX_SPEED);
+    // Bicycle model.
+    const float steer = geom::Math::Clamp(control.steer, -1.0f, 1.0f) *
+        geom::Math::ToRadians(MAX_STEER_ANGLE);
+    actor.transform.rotation.yaw +=
+        geom::Math::ToDegrees(speed * std::tan(steer) / WHEELBASE * delta_seconds);
+    forward = actor.transform.GetForwardVector();
+    actor.transform.location += forward * (speed * delta_seconds);
+    actor.velocity = forward * speed;
+    actor.speed = speed;
+  }
+
+  void MockServer::Pimpl::MoveWalker(MockActor &actor, const float delta_seconds) {
+    if (actor.autopilot) {
+      std::uniform_real_distribution<float> turn(0.0f, 1.0f);
+      if (turn(_random_engine) < delta_seconds / WALKER_TURN_PERIOD) {
+        actor.walker_control = GetRandomWalkerControl();
+      }
+    }
+    auto direction = actor.walker_control.direction;
+    direction.z = 0.0f;
+    direction = direction.MakeSafeUnitVector(std::numeric_limits<float>::epsilon());
+    actor.velocity = direction * actor.walker_control.speed;
+    actor.transform.location += actor.velocity * delta_seconds;
+    if (actor.walker_control.speed > 0.0f) {
+      actor.transform.rotation.yaw = geom::Math::ToDegrees(std::atan2(direction.y, direction.x));
+    }
+  }
+
+  void MockServer::Pimpl::UpdateActors(const float delta_seconds) {
+    for (auto &pair : _actors) {
+      auto &actor = pair.second;
+      if (actor.GetParentId() != 0u) {
+        continue;
+      }
+      const auto previous_velocity = actor.velocity;
+      switch (actor.type) {
+        case ActorType::Vehicle:
+          if (actor.autopilot) {
+            DriveAlongLane(actor, delta_seconds);
+          } else if (actor.simulate_physics) {
+            IntegrateVehicle(actor, delta_seconds);
+          } else {
+            actor.velocity = geom::Vector3D{};
+          }
+          break;
+        case ActorType::Walker:
+          MoveWalker(actor, delta_seconds);
+          break;
+        default:
+          if (actor.target_velocity.has_value()) {
+            actor.velocity = *actor.target_velocity;
+            actor.target_velocity.reset();
+          }
+          actor.transform.location += actor.velocity * delta_seconds;
+          break;
+      }
+      actor.acceleration = (actor.velocity - previous_velocity) / delta_seconds;
+    }
+  }
+
+  void MockServer::Pimpl::PublishEpisodeState(const double delta_seconds) {
+    using Serializer = sensor::s11n::EpisodeStateSerializer;
+    using sensor::data::ActorDynamicState;
+    const Serializer::Header header{
+      _episode_id,
+      std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(),
+      static_cast<float>(delta_seconds),
+      geom::Vector3DInt{},
+      Serializer::SimulationState::None};
+    auto buffer = _broadcast.MakeBuffer();
+    buffer.reset(sizeof(header) + _actors.size() * sizeof(ActorDynamicState));
+    auto *it = buffer.data();
+    std::memcpy(it, &header, sizeof(header));
+    it += sizeof(header);
+    for (const auto &pair : _actors) {
+      const auto &actor = pair.second;
+      ActorDynamicState state{};
+      state.id = pair.first;
+      state.actor_state = rpc::ActorState::Active;
+      state.transform = GetWorldTransform(actor);
+      state.velocity = GetWorldVelocity(actor);
+      state.acceleration = actor.acceleration;
+      if (actor.type == ActorType::Vehicle) {
+        auto &data = state.state.vehicle_data;
+        data.control = actor.vehicle_control;
+        data.speed_limit = _settings.speed_limit;
+        data.traffic_light_state = rpc::TrafficLightState::Green;
+        data.has_traffic_light = false;
+        data.traffic_light_id = 0u;
+        data.failure_state = rpc::VehicleFailureState::None;
+      } else if (actor.type == ActorType::Walker) {
+        state.state.walker_control = actor.walker_control;
+      }
+      std::memcpy(it, &state, sizeof(state));
+      it += sizeof(state);
+    }
+    Send(
+        _broadcast,
+        sensor::SensorRegistry::get<FWorldObserver *>::index,
+        geom::Transform{},
+        std::move(buffer));
+  }
+
+  void MockServer::Pimpl::SendSensorData(const double delta_seconds) {
+    using sensor::data::RadarDetection;
+    for (auto &pair : _actors) {
+      auto &actor = pair.second;
+      if (!actor.stream.has_value() ||
+          (actor.type == ActorType::OtherSensor) ||
+          (_elapsed_seconds < actor.next_measurement) ||
+          !actor.stream->AreClientsListening()) {
+        continue;
+      }
+      actor.next_measurement = _elapsed_seconds + actor.sensor_tick;
+      auto &stream = *actor.stream;
+      auto buffer = stream.MakeBuffer();
+      if (actor.type == ActorType::Camera) {
+        using Serializer = sensor::s11n::ImageSerializer;
+        const Serializer::ImageHeader header{actor.image_width, actor.image_height, actor.fov};
+        const size_t row_size = 4u * actor.image_width;
+        buffer.reset(sizeof(header) + row_size * actor.image_height);
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        // A gradient that scrolls every frame, so the images are neither
+        // constant nor random noise.
+        auto *pixels = buffer.data() + sizeof(header);
+        for (auto y = 0u; y < actor.image_height; ++y) {
+          auto *row = pixels + y * row_size;
+          for (auto x = 0u; x < actor.image_width; ++x) {
+            row[4u * x + 0u] = static_cast<unsigned char>(x + _frame);
+            row[4u * x + 1u] = static_cast<unsigned char>(y);
+            row[4u * x + 2u] = static_cast<unsigned char>(x ^ y);
+            row[4u * x + 3u] = 255u;
+          }
+        }
+        Send(stream, sensor::SensorRegistry::get<ASceneCaptureCamera *>::index, GetWorldTransform(actor), std::move(buffer));
+      } else if (actor.type == ActorType::Radar) {
+        const auto count = static_cast<size_t>(actor.points_per_second * delta_seconds);
+        std::uniform_real_distribution<float> angle(-0.25f, 0.25f);
+        std::uniform_real_distribution<float> depth(1.0f, 100.0f);
+        std::vector<RadarDetection> detections(count);
+        for (auto &detection : detections) {
+          detection = {-actor.speed, angle(_random_engine), angle(_random_engine), depth(_random_engine)};
+        }
+        buffer.copy_from(detections);
+        Send(stream, sensor::SensorRegistry::get<ARadar *>::index, GetWorldTransform(actor), std::move(buffer));
+      }
+    }
+  }
+
+  void MockServer::Pimpl::Send(
+      streaming::Stream &stream,
+      const uint64_t sensor_type,
+      const geom::Transform &transform,
+      Buffer &&payload) {
+    using Serializer = sensor::s11n::SensorHeaderSerializer;
+    const uint64_t enqueue_time = stream.IsTimingEnabled() ? Serializer::Now() : 0u;
+    auto header = Serializer::Serialize(sensor_type, _frame, _elapsed_seconds, transform);
+    const auto compression = stream.GetCompression();
+    if (compression != 0u) {
+      payload = sensor::s11n::PayloadCompression::Compress(
+          static_cast<sensor::s11n::CompressionType>(compression),
+          payload.data(),
+          payload.size(),
+          stream.MakeBuffer());
+      Serializer::SetCompression(header, compression);
+    }
+    if (enqueue_time != 0u) {
+      Serializer::SetTiming(header, true);
+      stream.Write(
+          std::move(header),
+          std::move(payload),
+          Serializer::SerializeTiming(enqueue_time, Serializer::Now()));
+      return;
+    }
+    stream.Write(std::move(header), std::move(payload));
+  }
+
+  // ===========================================================================
+  // -- MockServer -------------------------------------------------------------
+  // ===========================================================================
+
+  MockServer::MockServer(MockServerSettings settings)
+    : _pimpl(std::make_unique<Pimpl>(std::move(settings))) {}
+
+  MockServer::~MockServer() = default;
+
+  void MockServer::AsyncRun(size_t worker_threads) {
+    _pimpl->AsyncRun(worker_threads);
+  }
+
+  void MockServer::Run() {
+    _pimpl->Run(false, std::chrono::steady_clock::time_point{});
+  }
+
+  void MockServer::RunFor(time_duration duration) {
+    _pimpl->Run(true, std::chrono::steady_clock::now() + duration.to_chrono());
+  }
+
+  void MockServer::Stop() {
+    _pimpl->Stop();
+  }
+
+  uint64_t MockServer::Tick() {
+    return _pimpl->Tick();
+  }
+
+  uint64_t MockServer::GetFrame() const {
+    return _pimpl->GetFrame();
+  }
+
+  size_t MockServer::GetNumberOfActors() const {
+    return _pimpl->GetNumberOfActors();
+  }
+
+  std::string MockServer::MakeRingRoad(const double radius, const uint32_t lanes_per_direction) {
+    DEBUG_ASSERT(lanes_per_direction > 0u);
+    DEBUG_ASSERT(radius > LANE_WIDTH * lanes_per_direction);
+    const auto length = ToString(geom::Math::Pi<double>() * radius);
+    const auto curvature = ToString(1.0 / radius);
+    const auto lane_width = ToString(LANE_WIDTH);
+    auto make_lane = [&](int id) {
+      const auto str_id = std::to_string(id);
+      return
+          "<lane id=\"" + str_id + "\" type=\"driving\" level=\"false\">"
+            "<link><predecessor id=\"" + str_id + "\"/><successor id=\"" + str_id + "\"/></link>"
+            "<width sOffset=\"0\" a=\"" + lane_width + "\" b=\"0\" c=\"0\" d=\"0\"/>"
+          "</lane>";
+    };
+    std::string left;
+    std::string right;
+    for (auto i = 1; i <= static_cast<int>(lanes_per_direction); ++i) {
+      left = make_lane(i) + left;
+      right += make_lane(-i);
+    }
+    // Each road is a half circle turning left, its successor starts where it
+    // ends.
+    auto make_road = [&](int id, int other, double y, double heading) {
+      const auto str_other = std::to_string(other);
+      return
+          "<road name=\"Ring" + std::to_string(id) + "\" length=\"" + length + "\" "
+                "id=\"" + std::to_string(id) + "\" junction=\"-1\">"
+            "<link>"
+              "<predecessor elementType=\"road\" elementId=\"" + str_other + "\" contactPoint=\"end\"/>"
+              "<successor elementType=\"road\" elementId=\"" + str_other + "\" contactPoint=\"start\"/>"
+            "</link>"
+            "<planView>"
+              "<geometry s=\"0\" x=\"0\" y=\"" + ToString(y) + "\" hdg=\"" + ToString(heading) + "\" "
+                  "length=\"" + length + "\"><arc curvature=\"" + curvature + "\"/></geometry>"
+            "</planView>"
+            "<lanes><laneSection s=\"0\">"
+              "<left>" + left + "</left>"
+              "<center><lane id=\"0\" type=\"none\" level=\"false\"/></center>"
+              "<right>" + right + "</right>"
+            "</laneSection></lanes>"
+          "</road>";
+    };
+    return
+        "<?xml version=\"1.0\" standalone=\"yes\"?>"
+        "<OpenDRIVE>"
+          "<header revMajor=\"1\" revMinor=\"4\" name=\"MockRing\" version=\"1\">"
+            "<geoReference><![CDATA[+proj=tmerc +lat_0=0 +lon_0=0]]></geoReference>"
+          "</header>" +
+          make_road(1, 2, 0.0, 0.0) +
+          make_road(2, 1, 2.0 * radius, geom::Math::Pi<double>()) +
+        "</OpenDRIVE>";
+  }
+
+} // namespace mock
+} // namespace carla
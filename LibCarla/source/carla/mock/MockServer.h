@@ -0,0 +1,111 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace mock {
+
+  struct MockServerSettings {
+    /// Port of the RPC server, the streaming server uses the next one.
+    uint16_t port = 2000u;
+
+    /// Vehicles spawned at start-up and driven by the server along the lanes
+    /// of the map.
+    uint32_t number_of_vehicles = 0u;
+
+    /// Walkers spawned at start-up and moved by the server in random
+    /// directions.
+    uint32_t number_of_walkers = 0u;
+
+    /// Frames per second in asynchronous mode.
+    double frame_rate = 20.0;
+
+    /// Run in synchronous mode from the start, with @a frame_rate as fixed
+    /// delta.
+    bool synchronous_mode = false;
+
+    /// OpenDRIVE of the map, if empty a ring road generated with
+    /// MockServer::MakeRingRoad is used.
+    std::string opendrive;
+
+    /// Radius in meters and lanes per direction of the default ring road.
+    double ring_radius = 200.0;
+
+    uint32_t lanes_per_direction = 2u;
+
+    /// Speed limit reported for every vehicle, in km/h.
+    float speed_limit = 30.0f;
+
+    /// Seed for the placement and speed of the actors spawned at start-up.
+    uint32_t seed = 0u;
+  };
+
+  /// A stand-in for the simulator that runs without Unreal Engine nor a GPU,
+  /// for load tests and benchmarks of the client, the traffic manager and the
+  /// Python API.
+  ///
+  /// It implements the core of the RPC interface of the simulator (episode
+  /// info and settings, map, blueprints, actors, spawn and destroy, controls,
+  /// apply_batch and tick_cue), and publishes every frame a synthetic episode
+  /// state with all its actors. Cameras (sensor.camera.rgb) and radars
+  /// (sensor.other.radar) stream synthetic measurements of the requested
+  /// size. Vehicles integrate the controls received with a simple kinematic
+  /// model, there are no collisions nor physics.
+  ///
+  /// As in the simulator, RPC calls are served in the thread running the
+  /// simulation, in between frames.
+  class MockServer : private NonCopyable {
+  public:
+
+    explicit MockServer(MockServerSettings settings);
+
+    ~MockServer();
+
+    /// Launch @a worker_threads threads for the RPC server and for the
+    /// streaming server.
+    void AsyncRun(size_t worker_threads);
+
+    /// Run the simulation in this thread, serving the RPC calls received.
+    ///
+    /// @warning This function blocks until Stop is called.
+    void Run();
+
+    /// Run the simulation in this thread for a specific @a duration.
+    void RunFor(time_duration duration);
+
+    /// Stop Run and RunFor, can be called from any thread.
+    void Stop();
+
+    /// Advance the simulation one frame and publish it. Must be called from
+    /// the thread running the simulation, or while it is not running.
+    uint64_t Tick();
+
+    uint64_t GetFrame() const;
+
+    /// Number of actors in the episode, including the spectator.
+    size_t GetNumberOfActors() const;
+
+    /// OpenDRIVE of a circular road of @a radius meters through the origin,
+    /// made of two half circles with @a lanes_per_direction driving lanes in
+    /// each direction.
+    static std::string MakeRingRoad(double radius, uint32_t lanes_per_direction);
+
+  private:
+
+    class Pimpl;
+    const std::unique_ptr<Pimpl> _pimpl;
+  };
+
+} // namespace mock
+} // namespace carla
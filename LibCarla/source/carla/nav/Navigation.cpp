@@ -9,13 +9,17 @@
 #include <cmath>
 
 #include "carla/Logging.h"
+#include "carla/ThreadPool.h"
 #include "carla/nav/Navigation.h"
 #include "carla/nav/WalkerManager.h"
 #include "carla/geom/Math.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <fstream>
 #include <mutex>
+#include <thread>
 
 namespace carla {
 namespace nav {
@@ -36,6 +40,9 @@ namespace nav {
   static const float AGENT_HEIGHT = 1.8f;
   static const float AGENT_RADIUS = 0.3f;
 
+  // minimum number of path requests to launch another worker in a batch
+  static const size_t MIN_REQUESTS_PER_WORKER = 8u;
+
   static const float AGENT_UNBLOCK_DISTANCE = 0.5f;
   static const float AGENT_UNBLOCK_DISTANCE_SQUARED = AGENT_UNBLOCK_DISTANCE * AGENT_UNBLOCK_DISTANCE;
   static const float AGENT_UNBLOCK_TIME = 4.0f;
@@ -62,6 +69,9 @@ namespace nav {
     _walkers_blocked_position.clear();
     _yaw_walkers.clear();
     _binary_mesh.clear();
+    _path_cache.Clear();
+    _batch_pool.reset();
+    FreeBatchQueries();
     dtFreeCrowd(_crowd);
     dtFreeNavMeshQuery(_nav_query);
     dtFreeNavMesh(_nav_mesh);
@@ -172,6 +182,10 @@ namespace nav {
       tile_header.tile_ref, 0);
     }
 
+    // the query objects and corridors refer to the previous mesh
+    FreeBatchQueries();
+    _path_cache.Clear();
+
     // exchange
     dtFreeNavMesh(_nav_mesh);
     _nav_mesh = mesh;
@@ -256,70 +270,55 @@ namespace nav {
     _crowd->setObstacleAvoidanceParams(3, &params);
   }
 
-  // return the path points to go from one position to another
-  bool Navigation::GetPath(carla::geom::Location from,
-                           carla::geom::Location to,
-                           dtQueryFilter * filter,
-                           std::vector<carla::geom::Location> &path,
-                           std::vector<unsigned char> &area) {
+  // compute a path with the given query object
+  bool Navigation::ComputePath(dtNavMeshQuery &query,
+                               const dtQueryFilter *filter,
+                               carla::geom::Location from,
+                               carla::geom::Location to,
+                               std::vector<carla::geom::Location> &path,
+                               std::vector<unsigned char> &area) {
     // path found
     float straight_path[MAX_POLYS * 3];
     unsigned char straight_path_flags[MAX_POLYS];
     dtPolyRef straight_path_polys[MAX_POLYS];
-    int num_straight_path;
+    int num_straight_path = 0;
     int straight_path_options = DT_STRAIGHTPATH_AREA_CROSSINGS;
 
     // polys in path
     dtPolyRef polys[MAX_POLYS];
-    int num_polys;
-
-    // check if all is ready
-    if (!_ready) {
-      return false;
-    }
-
-    DEBUG_ASSERT(_nav_query != nullptr);
+    int num_polys = 0;
 
     // point extension
-    float poly_pick_ext[3];
-    poly_pick_ext[0] = 2;
-    poly_pick_ext[1] = 4;
-    poly_pick_ext[2] = 2;
-
-    // filter
-    dtQueryFilter filter2;
-    if (filter == nullptr) {
-      filter2.setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
-      filter2.setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
-      filter2.setIncludeFlags(CARLA_TYPE_WALKABLE);
-      filter2.setExcludeFlags(CARLA_TYPE_NONE);
-      filter = &filter2;
-    }
+    float poly_pick_ext[3] = {2,4,2};
 
     // set the points
     dtPolyRef start_ref = 0;
     dtPolyRef end_ref = 0;
     float start_pos[3] = { from.x, from.z, from.y };
     float end_pos[3] = { to.x, to.z, to.y };
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findNearestPoly(start_pos, poly_pick_ext, filter, &start_ref, 0);
-      _nav_query->findNearestPoly(end_pos, poly_pick_ext, filter, &end_ref, 0);
-    }
+    query.findNearestPoly(start_pos, poly_pick_ext, filter, &start_ref, 0);
+    query.findNearestPoly(end_pos, poly_pick_ext, filter, &end_ref, 0);
     if (!start_ref || !end_ref) {
       return false;
     }
 
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      // get the path of nodes
-      _nav_query->findPath(start_ref, end_ref, start_pos, end_pos, filter, polys, &num_polys, MAX_POLYS);
+    // get the path of nodes, reusing the corridor if we already have it
+    const PathCache::Key key {
+        start_ref,
+        end_ref,
+        filter->getIncludeFlags(),
+        filter->getExcludeFlags() };
+    if (!_path_cache.Get(key, polys, num_polys, MAX_POLYS)) {
+      dtStatus status = query.findPath(start_ref, end_ref, start_pos, end_pos, filter, polys, &num_polys, MAX_POLYS);
+      // partial corridors (no route, or the search ran out of nodes) are
+      // still followed, but not served again as if they were complete
+      if (dtStatusSucceed(status) &&
+          !dtStatusDetail(status, DT_PARTIAL_RESULT | DT_OUT_OF_NODES | DT_BUFFER_TOO_SMALL)) {
+        _path_cache.Put(key, polys, num_polys);
+      }
     }
 
     // get the path of points
-    num_straight_path = 0;
     if (num_polys == 0) {
       return false;
     }
@@ -329,52 +328,60 @@ namespace nav {
     float end_pos2[3];
     dtVcopy(end_pos2, end_pos);
     if (polys[num_polys - 1] != end_ref) {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
+      query.closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
     }
 
     // get the points
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findStraightPath(start_pos, end_pos2, polys, num_polys,
-      straight_path, straight_path_flags,
-      straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
-    }
+    query.findStraightPath(start_pos, end_pos2, polys, num_polys,
+    straight_path, straight_path_flags,
+    straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
 
     // copy the path to the output buffer
     path.clear();
     path.reserve(static_cast<unsigned long>(num_straight_path));
+    area.reserve(area.size() + static_cast<unsigned long>(num_straight_path));
     unsigned char area_type;
     for (int i = 0, j = 0; j < num_straight_path; i += 3, ++j) {
       // save coordinate for Unreal axis (x, z, y)
       path.emplace_back(straight_path[i], straight_path[i + 2], straight_path[i + 1]);
       // save area type
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
-      }
+      _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
       area.emplace_back(area_type);
     }
 
     return true;
   }
 
-  bool Navigation::GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
-  std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) {
-    // path found
-    float straight_path[MAX_POLYS * 3];
-    unsigned char straight_path_flags[MAX_POLYS];
-    dtPolyRef straight_path_polys[MAX_POLYS];
-    int num_straight_path = 0;
-    int straight_path_options = DT_STRAIGHTPATH_AREA_CROSSINGS;
+  // return the path points to go from one position to another
+  bool Navigation::GetPath(carla::geom::Location from,
+                           carla::geom::Location to,
+                           dtQueryFilter * filter,
+                           std::vector<carla::geom::Location> &path,
+                           std::vector<unsigned char> &area) {
+    // check if all is ready
+    if (!_ready) {
+      return false;
+    }
 
-    // polys in path
-    dtPolyRef polys[MAX_POLYS];
-    int num_polys;
+    DEBUG_ASSERT(_nav_query != nullptr);
 
+    // filter
+    dtQueryFilter filter2;
+    if (filter == nullptr) {
+      filter2.setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
+      filter2.setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
+      filter2.setIncludeFlags(CARLA_TYPE_WALKABLE);
+      filter2.setExcludeFlags(CARLA_TYPE_NONE);
+      filter = &filter2;
+    }
+
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
+    return ComputePath(*_nav_query, filter, from, to, path, area);
+  }
+
+  bool Navigation::GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
+  std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) {
     // check if all is ready
     if (!_ready) {
       return false;
@@ -382,84 +389,95 @@ namespace nav {
 
     DEBUG_ASSERT(_nav_query != nullptr);
 
-    // point extension
-    float poly_pick_ext[3] = {2,4,2};
-
     // get current filter from agent
     auto it = _mapped_walkers_id.find(id);
     if (it == _mapped_walkers_id.end())
       return false;
 
-    const dtQueryFilter *filter;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
-    }
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
+    const dtQueryFilter *filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
+    return ComputePath(*_nav_query, filter, from, to, path, area);
+  }
 
-    // set the points
-    dtPolyRef start_ref = 0;
-    dtPolyRef end_ref = 0;
-    float start_pos[3] = { from.x, from.z, from.y };
-    float end_pos[3] = { to.x, to.z, to.y };
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findNearestPoly(start_pos, poly_pick_ext, filter, &start_ref, 0);
-      _nav_query->findNearestPoly(end_pos, poly_pick_ext, filter, &end_ref, 0);
-    }
-    if (!start_ref || !end_ref) {
-      return false;
-    }
+  // solve many path requests at once
+  void Navigation::GetPaths(std::vector<PathRequest> &requests, size_t worker_threads) {
 
-    // get the path of nodes
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findPath(start_ref, end_ref, start_pos, end_pos, filter, polys, &num_polys, MAX_POLYS);
+    // check if all is ready
+    if (!_ready || requests.empty()) {
+      return;
     }
 
-    // get the path of points
-    if (num_polys == 0) {
-      return false;
+    DEBUG_ASSERT(_nav_mesh != nullptr);
+
+    // default filter
+    dtQueryFilter default_filter;
+    default_filter.setAreaCost(CARLA_AREA_ROAD, AREA_ROAD_COST);
+    default_filter.setAreaCost(CARLA_AREA_GRASS, AREA_GRASS_COST);
+    default_filter.setIncludeFlags(CARLA_TYPE_WALKABLE);
+    default_filter.setExcludeFlags(CARLA_TYPE_NONE);
+
+    // number of workers, avoid launching threads for a few requests
+    if (worker_threads == 0u) {
+      worker_threads = std::max(1u, std::thread::hardware_concurrency());
     }
+    const size_t max_workers = (requests.size() + MIN_REQUESTS_PER_WORKER - 1u) / MIN_REQUESTS_PER_WORKER;
+    worker_threads = std::min(worker_threads, max_workers);
 
-    // in case of partial path, make sure the end point is clamped to the last
-    // polygon
-    float end_pos2[3];
-    dtVcopy(end_pos2, end_pos);
-    if (polys[num_polys - 1] != end_ref) {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
+    // only one batch at a time, each worker owns one of the query objects
+    std::lock_guard<std::mutex> lock(_batch_mutex);
+    while (_batch_queries.size() < worker_threads) {
+      dtNavMeshQuery *query = dtAllocNavMeshQuery();
+      if (query == nullptr || dtStatusFailed(query->init(_nav_mesh, MAX_QUERY_SEARCH_NODES))) {
+        dtFreeNavMeshQuery(query);
+        break;
+      }
+      _batch_queries.emplace_back(query);
     }
+    if (_batch_queries.empty()) {
+      logging::log("Nav: failed to create the query objects for the batched paths");
+      return;
+    }
+    worker_threads = std::min(worker_threads, _batch_queries.size());
 
-    // get the points
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findStraightPath(start_pos, end_pos2, polys, num_polys,
-      straight_path, straight_path_flags,
-      straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
+    // the calling thread also works, start the pool threads for the others
+    if (_batch_pool == nullptr) {
+      _batch_pool = std::make_unique<ThreadPool>();
+    }
+    if (_batch_pool_threads + 1u < worker_threads) {
+      _batch_pool->AsyncRun(worker_threads - 1u - _batch_pool_threads);
+      _batch_pool_threads = worker_threads - 1u;
     }
 
-    // copy the path to the output buffer
-    path.clear();
-    path.reserve(static_cast<unsigned long>(num_straight_path));
-    unsigned char area_type;
-    for (int i = 0, j = 0; j < num_straight_path; i += 3, ++j) {
-      // save coordinate for Unreal axis (x, z, y)
-      path.emplace_back(straight_path[i], straight_path[i + 2], straight_path[i + 1]);
-      // save area type
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
+    // each worker takes the next pending request until there are no more
+    std::atomic_size_t next_request { 0u };
+    auto work = [&](dtNavMeshQuery &query) {
+      for (size_t i = next_request++; i < requests.size(); i = next_request++) {
+        PathRequest &request = requests[i];
+        const dtQueryFilter *filter = request.filter != nullptr ? request.filter : &default_filter;
+        request.area.clear();
+        request.found = ComputePath(query, filter, request.from, request.to, request.path, request.area);
       }
-      area.emplace_back(area_type);
-    }
+    };
 
-    return true;
+    // one chunk per worker, so each query object is used by a single thread
+    _batch_pool->ParallelFor(worker_threads, 1u, [&](const size_t i) {
+      work(*_batch_queries[i]);
+    });
+  }
+
+  // set the maximum number of corridors in the path cache
+  void Navigation::SetPathCacheCapacity(size_t capacity) {
+    _path_cache.SetCapacity(capacity);
+  }
+
+  // free the query objects of the batched path requests
+  void Navigation::FreeBatchQueries() {
+    std::lock_guard<std::mutex> lock(_batch_mutex);
+    for (auto query : _batch_queries) {
+      dtFreeNavMeshQuery(query);
+    }
+    _batch_queries.clear();
   }
 
   // create a new walker in crowd
@@ -856,6 +874,7 @@ namespace nav {
       total_agents = _crowd->getAgentCount();
     }
     const dtCrowdAgent *ag;
+    std::vector<int> blocked_agents;
     for (int i = 0; i < total_agents; ++i) {
       {
         // critical section, force single thread running this
@@ -896,15 +915,40 @@ namespace nav {
                 SetAgentFilter(i, 0);
               }
             }
-            // set a new random target
-            carla::geom::Location location;
-            GetRandomLocation(location, nullptr);
-            _walker_manager.SetWalkerRoute(_mapped_by_index[i], location);
+            // a new random target will be assigned below with the rest
+            blocked_agents.emplace_back(i);
           }
         }
       }
     }
 
+    // assign new routes to all the blocked agents in a single batch
+    if (!blocked_agents.empty()) {
+      std::vector<carla::geom::Location> targets;
+      GetRandomLocations(targets, blocked_agents.size(), nullptr);
+      std::vector<PathRequest> requests(blocked_agents.size());
+      {
+        // critical section, force single thread running this
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (size_t i = 0u; i < blocked_agents.size(); ++i) {
+          ag = _crowd->getAgent(blocked_agents[i]);
+          requests[i].from = carla::geom::Location(ag->npos[0], ag->npos[2], ag->npos[1]);
+          requests[i].to = targets[i];
+          requests[i].filter = _crowd->getFilter(ag->params.queryFilterType);
+        }
+      }
+      GetPaths(requests);
+      for (size_t i = 0u; i < blocked_agents.size(); ++i) {
+        PathRequest &request = requests[i];
+        _walker_manager.SetWalkerRoute(
+            _mapped_by_index[blocked_agents[i]],
+            request.from,
+            request.to,
+            std::move(request.path),
+            std::move(request.area));
+      }
+    }
+
     // check for resetting time
     if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
       _time_to_unblock = 0.0f;
@@ -1091,6 +1135,51 @@ namespace nav {
     return (rounds > 0);
   }
 
+  // get several random locations for navigation
+  bool Navigation::GetRandomLocations(std::vector<carla::geom::Location> &locations,
+                                      size_t count,
+                                      dtQueryFilter * filter) const {
+
+    // check if all is ready
+    if (!_ready) {
+      return false;
+    }
+
+    DEBUG_ASSERT(_nav_query != nullptr);
+
+    // filter
+    dtQueryFilter filter2;
+    if (filter == nullptr) {
+      filter2.setIncludeFlags(CARLA_TYPE_SIDEWALK);
+      filter2.setExcludeFlags(CARLA_TYPE_NONE);
+      filter = &filter2;
+    }
+
+    locations.clear();
+    locations.reserve(count);
+    bool all_found = true;
+    {
+      // critical section, force single thread running this
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (size_t i = 0u; i < count; ++i) {
+        // we will try up to 10 rounds, otherwise we failed to find a good location
+        dtPolyRef random_ref { 0 };
+        float point[3] { 0.0f, 0.0f, 0.0f };
+        dtStatus status;
+        int rounds = 10;
+        do {
+          status = _nav_query->findRandomPoint(filter, frand, &random_ref, point);
+          --rounds;
+        } while (status != DT_SUCCESS && rounds > 0);
+        all_found &= (status == DT_SUCCESS);
+        // set the location in Unreal coords
+        locations.emplace_back(point[0], point[2], point[1]);
+      }
+    }
+
+    return all_found;
+  }
+
   // assign a filter index to an agent
   void Navigation::SetAgentFilter(int agent_index, int filter_index)
   {
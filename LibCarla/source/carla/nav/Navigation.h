@@ -11,6 +11,7 @@
 #include "carla/geom/BoundingBox.h"
 #include "carla/geom/Location.h"
 #include "carla/geom/Transform.h"
+#include "carla/nav/PathCache.h"
 #include "carla/nav/WalkerManager.h"
 #include "carla/rpc/ActorId.h"
 #include <recast/Recast.h>
@@ -21,6 +22,9 @@
 #include <recast/DetourCommon.h>
 
 namespace carla {
+
+  class ThreadPool;
+
 namespace nav {
 
   enum NavAreas {
@@ -50,6 +54,18 @@ namespace nav {
     carla::geom::BoundingBox bounding;
   };
 
+  /// request of a path for the batched queries
+  struct PathRequest {
+    carla::geom::Location from;
+    carla::geom::Location to;
+    /// filter to use, the default walkable filter if null
+    const dtQueryFilter *filter { nullptr };
+    /// results
+    std::vector<carla::geom::Location> path;
+    std::vector<unsigned char> area;
+    bool found { false };
+  };
+
   /// Manage the pedestrians navigation, using the Recast & Detour library for low level calculations.
   ///
   /// This class gets the binary content of the map from the server, which is required for the path finding.
@@ -70,6 +86,11 @@ namespace nav {
     std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
     bool GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
     std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
+    /// solve many path requests at once, distributing them among @a worker_threads
+    /// threads (all hardware threads if 0), each one with its own query object
+    void GetPaths(std::vector<PathRequest> &requests, size_t worker_threads = 0u);
+    /// set the maximum number of polygon corridors kept in the path cache (0 disables it)
+    void SetPathCacheCapacity(size_t capacity);
 
     /// set the seed to use with random numbers
     void SetSeed(unsigned int seed);
@@ -100,6 +121,8 @@ namespace nav {
     void UpdateCrowd(const client::detail::EpisodeState &state);
     /// get a random location for navigation
     bool GetRandomLocation(carla::geom::Location &location, dtQueryFilter * filter = nullptr) const;
+    /// get several random locations for navigation in a single critical section
+    bool GetRandomLocations(std::vector<carla::geom::Location> &locations, size_t count, dtQueryFilter * filter = nullptr) const;
     /// set the probability that an agent could cross the roads in its path following
     void SetPedestriansCrossFactor(float percentage);
     /// set an agent as paused for the crowd
@@ -122,6 +145,15 @@ namespace nav {
     /// meshes
     dtNavMesh *_nav_mesh { nullptr };
     dtNavMeshQuery *_nav_query { nullptr };
+    /// one query object per worker thread for the batched path requests
+    std::vector<dtNavMeshQuery *> _batch_queries;
+    std::mutex _batch_mutex;
+    /// threads helping the caller with the batched path requests, started
+    /// on demand
+    std::unique_ptr<ThreadPool> _batch_pool;
+    size_t _batch_pool_threads { 0u };
+    /// recently computed corridors between polygons
+    PathCache _path_cache;
     /// crowd
     dtCrowd *_crowd { nullptr };
     /// mapping Id
@@ -144,6 +176,13 @@ namespace nav {
 
     /// assign a filter index to an agent
     void SetAgentFilter(int agent_index, int filter_index);
+    /// compute a path with the given query object (the caller must ensure
+    /// nobody else is using the same query)
+    bool ComputePath(dtNavMeshQuery &query, const dtQueryFilter *filter,
+    carla::geom::Location from, carla::geom::Location to,
+    std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
+    /// free the query objects of the batched path requests
+    void FreeBatchQueries();
   };
 
 } // namespace nav
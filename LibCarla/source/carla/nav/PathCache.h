@@ -0,0 +1,134 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <recast/DetourNavMesh.h>
+
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace nav {
+
+  /// Least recently used cache of polygon corridors between two navmesh
+  /// polygons, so repeated routes between the same areas skip the A* search
+  /// of Detour (findPath) and only need to rebuild the straight path.
+  ///
+  /// The filter flags are part of the key because walkers allowed to cross
+  /// roads get different corridors than walkers restricted to sidewalks.
+  class PathCache : private NonCopyable {
+  public:
+
+    struct Key {
+      dtPolyRef start;
+      dtPolyRef end;
+      unsigned short include_flags;
+      unsigned short exclude_flags;
+
+      bool operator==(const Key &rhs) const {
+        return start == rhs.start &&
+               end == rhs.end &&
+               include_flags == rhs.include_flags &&
+               exclude_flags == rhs.exclude_flags;
+      }
+    };
+
+    explicit PathCache(size_t capacity = 4096u) : _capacity(capacity) {}
+
+    /// copy the corridor stored for @a key into @a polys, return false if not
+    /// found
+    bool Get(const Key &key, dtPolyRef *polys, int &num_polys, int max_polys) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _index.find(key);
+      if (it == _index.end()) {
+        return false;
+      }
+      // move to the front as most recently used
+      _entries.splice(_entries.begin(), _entries, it->second);
+      const auto &corridor = it->second->second;
+      num_polys = std::min(static_cast<int>(corridor.size()), max_polys);
+      std::copy(corridor.begin(), corridor.begin() + num_polys, polys);
+      return true;
+    }
+
+    /// store the corridor for @a key, evicting the least recently used entry
+    /// if the cache is full
+    void Put(const Key &key, const dtPolyRef *polys, int num_polys) {
+      if (num_polys <= 0) {
+        return;
+      }
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_capacity == 0u) {
+        return;
+      }
+      auto it = _index.find(key);
+      if (it != _index.end()) {
+        it->second->second.assign(polys, polys + num_polys);
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return;
+      }
+      if (_entries.size() >= _capacity) {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+      }
+      _entries.emplace_front(key, std::vector<dtPolyRef>(polys, polys + num_polys));
+      _index.emplace(key, _entries.begin());
+    }
+
+    /// remove all the entries (needed when the navmesh changes)
+    void Clear() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _index.clear();
+      _entries.clear();
+    }
+
+    /// set the maximum number of corridors stored
+    void SetCapacity(size_t capacity) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _capacity = capacity;
+      while (_entries.size() > _capacity) {
+        _index.erase(_entries.back().first);
+        _entries.pop_back();
+      }
+    }
+
+    size_t Size() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _entries.size();
+    }
+
+  private:
+
+    struct KeyHash {
+      size_t operator()(const Key &key) const {
+        size_t seed = std::hash<dtPolyRef>()(key.start);
+        seed ^= std::hash<dtPolyRef>()(key.end) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        seed ^= (static_cast<size_t>(key.include_flags) << 16) | key.exclude_flags;
+        return seed;
+      }
+    };
+
+    using Entry = std::pair<Key, std::vector<dtPolyRef>>;
+
+    size_t _capacity;
+
+    std::list<Entry> _entries;
+
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _index;
+
+    mutable std::mutex _mutex;
+  };
+
+} // namespace nav
+} // namespace carla
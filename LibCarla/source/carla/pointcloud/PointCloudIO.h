@@ -6,15 +6,135 @@
 
 #pragma once
 
+#include "carla/Debug.h"
+#include "carla/Exception.h"
 #include "carla/FileSystem.h"
+#include "carla/Logging.h"
+#include "carla/NonCopyable.h"
 
+#include <boost/endian/conversion.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iterator>
 #include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace carla {
 namespace pointcloud {
 
+  /// File formats supported by PointCloudIO.
+  enum class PointCloudFormat {
+    PLYAscii,
+    PLYBinary,
+    PCDAscii,
+    PCDBinary
+  };
+
+namespace detail {
+
+  /// Single background thread that writes the point clouds queued by
+  /// PointCloudIO::SaveToDiskAsync in order. Pending writes are completed
+  /// before the writer is destroyed.
+  class BackgroundWriter : private NonCopyable {
+  public:
+
+    BackgroundWriter() : _thread([this]() { Run(); }) {}
+
+    ~BackgroundWriter() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done = true;
+      }
+      _condition.notify_all();
+      _thread.join();
+    }
+
+    static BackgroundWriter &Get() {
+      static BackgroundWriter writer;
+      return writer;
+    }
+
+    void Post(std::function<void()> task) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.emplace_back(std::move(task));
+      }
+      _condition.notify_all();
+    }
+
+    /// Block until all the writes posted so far are done. Throws if any of
+    /// the writes finished since the previous call failed.
+    void Flush() {
+      std::vector<std::string> errors;
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _tasks.empty() && !_busy; });
+        std::swap(errors, _errors);
+      }
+      if (!errors.empty()) {
+        std::string message = "failed to write " + std::to_string(errors.size()) + " point cloud(s):";
+        for (auto &error : errors) {
+          message += "\n  " + error;
+        }
+        throw_exception(std::runtime_error(message));
+      }
+    }
+
+  private:
+
+    void Run() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      for (;;) {
+        _condition.wait(lock, [this]() { return _done || !_tasks.empty(); });
+        if (_tasks.empty()) {
+          return;
+        }
+        auto task = std::move(_tasks.front());
+        _tasks.pop_front();
+        _busy = true;
+        lock.unlock();
+        std::string error;
+        try {
+          task();
+        } catch (const std::exception &e) {
+          log_error("failed to write point cloud:", e.what());
+          error = e.what();
+        }
+        lock.lock();
+        if (!error.empty()) {
+          _errors.emplace_back(std::move(error));
+        }
+        _busy = false;
+        _condition.notify_all();
+      }
+    }
+
+    std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    std::deque<std::function<void()>> _tasks;
+
+    /// Errors of the writes done since the last Flush.
+    std::vector<std::string> _errors;
+
+    bool _busy = false;
+
+    bool _done = false;
+
+    std::thread _thread;
+  };
+
+} // namespace detail
+
   class PointCloudIO {
 
   public:
@@ -27,6 +147,37 @@ namespace pointcloud {
       }
     }
 
+    /// Dump the points in @a format. The binary formats write the contiguous
+    /// range of points with a single call, so the layout of @a PointT must
+    /// match the properties described by its header info.
+    template <typename PointT>
+    static void Dump(
+        std::ostream &out,
+        const PointT *begin,
+        const PointT *end,
+        PointCloudFormat format) {
+      switch (format) {
+        case PointCloudFormat::PLYAscii:
+          Dump(out, begin, end);
+          break;
+        case PointCloudFormat::PLYBinary:
+          WriteBinaryPlyHeader(out, begin, end);
+          WriteBinaryPoints(out, begin, end);
+          break;
+        case PointCloudFormat::PCDAscii:
+          WritePcdHeader(out, begin, end, "ascii");
+          for (; begin != end; ++begin) {
+            begin->WriteDetection(out);
+            out << '\n';
+          }
+          break;
+        case PointCloudFormat::PCDBinary:
+          WritePcdHeader(out, begin, end, "binary");
+          WriteBinaryPoints(out, begin, end);
+          break;
+      }
+    }
+
     template <typename PointIt>
     static std::string SaveToDisk(std::string path, PointIt begin, PointIt end) {
       FileSystem::ValidateFilePath(path, ".ply");
@@ -35,7 +186,54 @@ namespace pointcloud {
       return path;
     }
 
+    template <typename PointT>
+    static std::string SaveToDisk(
+        std::string path,
+        const PointT *begin,
+        const PointT *end,
+        PointCloudFormat format) {
+      FileSystem::ValidateFilePath(path, GetDefaultExtension(format));
+      std::ofstream out(path, std::ios::binary);
+      Dump(out, begin, end, format);
+      return path;
+    }
+
+    /// Same as SaveToDisk but the file is written in a background thread. The
+    /// points are copied so the caller does not need to keep them alive.
+    ///
+    /// @warning The file may not be complete when this function returns, use
+    /// Flush to wait for it and to get the errors of the background writes.
+    template <typename PointT>
+    static std::string SaveToDiskAsync(
+        std::string path,
+        const PointT *begin,
+        const PointT *end,
+        PointCloudFormat format) {
+      FileSystem::ValidateFilePath(path, GetDefaultExtension(format));
+      auto points = std::make_shared<std::vector<PointT>>(begin, end);
+      detail::BackgroundWriter::Get().Post([path, points, format]() {
+        std::ofstream out(path, std::ios::binary);
+        const PointT *data = points->data();
+        Dump(out, data, data + points->size(), format);
+        out.close();
+        if (out.fail()) {
+          throw_exception(std::runtime_error("unable to write " + path));
+        }
+      });
+      return path;
+    }
+
+    /// Block until all the point clouds saved asynchronously are on disk.
+    /// Throws if any of them could not be written since the previous call.
+    static void Flush() {
+      detail::BackgroundWriter::Get().Flush();
+    }
+
   private:
+    static const char *GetDefaultExtension(PointCloudFormat format) {
+      return (format == PointCloudFormat::PCDAscii || format == PointCloudFormat::PCDBinary) ? ".pcd" : ".ply";
+    }
+
     template <typename PointIt> static void WriteHeader(std::ostream &out, PointIt begin, PointIt end) {
       DEBUG_ASSERT(std::distance(begin, end) >= 0);
       out << "ply\n"
@@ -45,6 +243,41 @@ namespace pointcloud {
       out << "\nend_header\n";
       out << std::fixed << std::setprecision(4u);
     }
+
+    template <typename PointT>
+    static void WriteBinaryPlyHeader(std::ostream &out, const PointT *begin, const PointT *end) {
+      DEBUG_ASSERT(std::distance(begin, end) >= 0);
+      out << "ply\n"
+           "format binary_little_endian 1.0\n"
+           "element vertex " << std::to_string(static_cast<size_t>(std::distance(begin, end))) << "\n";
+      PointT().WritePlyHeaderInfo(out);
+      out << "\nend_header\n";
+    }
+
+    template <typename PointT>
+    static void WritePcdHeader(std::ostream &out, const PointT *begin, const PointT *end, const char *data) {
+      DEBUG_ASSERT(std::distance(begin, end) >= 0);
+      const auto count = std::to_string(static_cast<size_t>(std::distance(begin, end)));
+      out << "# .PCD v0.7 - Point Cloud Data file format\n"
+           "VERSION 0.7\n";
+      PointT().WritePcdHeaderInfo(out);
+      out << "\nWIDTH " << count << "\n"
+           "HEIGHT 1\n"
+           "VIEWPOINT 0 0 0 1 0 0 0\n"
+           "POINTS " << count << "\n"
+           "DATA " << data << "\n";
+      out << std::fixed << std::setprecision(4u);
+    }
+
+    template <typename PointT>
+    static void WriteBinaryPoints(std::ostream &out, const PointT *begin, const PointT *end) {
+      static_assert(
+          boost::endian::order::native == boost::endian::order::little,
+          "Binary point clouds are written in little-endian order.");
+      out.write(
+          reinterpret_cast<const char *>(begin),
+          static_cast<std::streamsize>(sizeof(PointT) * static_cast<size_t>(std::distance(begin, end))));
+    }
   };
 
 } // namespace pointcloud
@@ -0,0 +1,183 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace carla {
+namespace profiler {
+
+  /// A value that can be incremented concurrently.
+  class Counter : private NonCopyable {
+  public:
+
+    void Add(int64_t value) {
+      _value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    int64_t Get() const {
+      return _value.load(std::memory_order_relaxed);
+    }
+
+  private:
+
+    std::atomic<int64_t> _value{0};
+  };
+
+  /// Distribution of non-negative values with a bounded relative error, in the
+  /// style of HdrHistogram. Each power of two is split in SUB_BUCKET_COUNT
+  /// linear sub-buckets, so quantiles are within 1/SUB_BUCKET_COUNT of the
+  /// actual value, and values below SUB_BUCKET_COUNT are exact. Values can be
+  /// added concurrently.
+  template <size_t SubBucketBits>
+  class HistogramTmpl : private NonCopyable {
+  public:
+
+    static constexpr size_t SUB_BUCKET_BITS = SubBucketBits;
+
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1u) << SUB_BUCKET_BITS;
+
+    static constexpr size_t NUMBER_OF_BUCKETS = (64u - SUB_BUCKET_BITS + 1u) * SUB_BUCKET_COUNT;
+
+    void Add(uint64_t value) {
+      _buckets[GetBucket(value)].fetch_add(1u, std::memory_order_relaxed);
+      _count.fetch_add(1u, std::memory_order_relaxed);
+      _sum.fetch_add(value, std::memory_order_relaxed);
+      auto current = _min.load(std::memory_order_relaxed);
+      while ((value < current) &&
+             !_min.compare_exchange_weak(current, value, std::memory_order_relaxed));
+      current = _max.load(std::memory_order_relaxed);
+      while ((value > current) &&
+             !_max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+    }
+
+    /// Remove all the values. Values added concurrently may be partially
+    /// kept.
+    void Clear() {
+      for (auto &bucket : _buckets) {
+        bucket.store(0u, std::memory_order_relaxed);
+      }
+      _count.store(0u, std::memory_order_relaxed);
+      _sum.store(0u, std::memory_order_relaxed);
+      _min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+      _max.store(0u, std::memory_order_relaxed);
+    }
+
+    uint64_t GetCount() const {
+      return _count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetSum() const {
+      return _sum.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetMin() const {
+      return GetCount() > 0u ? _min.load(std::memory_order_relaxed) : 0u;
+    }
+
+    uint64_t GetMax() const {
+      return _max.load(std::memory_order_relaxed);
+    }
+
+    double GetMean() const {
+      const auto count = GetCount();
+      return count > 0u ? static_cast<double>(GetSum()) / static_cast<double>(count) : 0.0;
+    }
+
+    /// Upper bound of the bucket containing the @a quantile (e.g. 0.99),
+    /// clamped to the maximum value seen.
+    uint64_t GetQuantile(double quantile) const {
+      const auto count = GetCount();
+      if (count == 0u) {
+        return 0u;
+      }
+      const auto target = std::max<uint64_t>(
+          static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count))),
+          1u);
+      const auto max = GetMax();
+      uint64_t accumulated = 0u;
+      for (auto i = 0u; i < NUMBER_OF_BUCKETS; ++i) {
+        accumulated += _buckets[i].load(std::memory_order_relaxed);
+        if (accumulated >= target) {
+          return std::min(GetUpperBound(i), max);
+        }
+      }
+      return max;
+    }
+
+    /// Index of the bucket holding @a value.
+    static size_t GetBucket(uint64_t value) {
+      if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+      }
+      size_t exponent = 0u;
+      for (auto v = value >> SUB_BUCKET_BITS; v != 0u; v >>= 1u) {
+        ++exponent;
+      }
+      // Here value is in [2^(exponent + SUB_BUCKET_BITS - 1), 2^(exponent +
+      // SUB_BUCKET_BITS)), keep its SUB_BUCKET_BITS + 1 most significant bits.
+      const auto sub_bucket = static_cast<size_t>(value >> (exponent - 1u)) - SUB_BUCKET_COUNT;
+      return exponent * SUB_BUCKET_COUNT + sub_bucket;
+    }
+
+    /// Largest value held by the bucket @a index.
+    static uint64_t GetUpperBound(size_t index) {
+      if (index < SUB_BUCKET_COUNT) {
+        return index;
+      }
+      const auto exponent = index / SUB_BUCKET_COUNT;
+      const auto sub_bucket = uint64_t(index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT);
+      // Wraps around to the maximum value for the last bucket.
+      return ((sub_bucket + 1u) << (exponent - 1u)) - 1u;
+    }
+
+  private:
+
+    std::array<std::atomic<uint64_t>, NUMBER_OF_BUCKETS> _buckets{};
+
+    std::atomic<uint64_t> _count{0u};
+
+    std::atomic<uint64_t> _sum{0u};
+
+    std::atomic<uint64_t> _min{std::numeric_limits<uint64_t>::max()};
+
+    std::atomic<uint64_t> _max{0u};
+  };
+
+  /// Histogram with one bucket per power of two, bucket i holds the values in
+  /// [2^(i-1), 2^i). Quantiles are within a factor of two of the actual value.
+  using Histogram = HistogramTmpl<0u>;
+
+  /// Histogram with 16 sub-buckets per power of two, for statistics that are
+  /// exposed through the API rather than profiling.
+  using HdrHistogram = HistogramTmpl<4u>;
+
+  /// Global registry of named counters and histograms. The returned
+  /// references are valid for the lifetime of the program, callers are
+  /// expected to look them up once and keep them.
+  class Metrics {
+  public:
+
+    static Counter &GetCounter(const std::string &name);
+
+    static Histogram &GetHistogram(const std::string &name);
+
+    /// One line per metric, sorted by name. Spans are measured in
+    /// microseconds.
+    static std::string GetSummary();
+  };
+
+} // namespace profiler
+} // namespace carla
@@ -6,12 +6,36 @@
 
 #pragma once
 
+// Instrumentation macros, they compile to nothing unless
+// LIBCARLA_ENABLE_PROFILER is defined.
+//
+//  * CARLA_PROFILE_SCOPE(context, name)      Writes the duration statistics of
+//                                            the scope to profiler.csv.
+//  * CARLA_PROFILE_FPS(context, name)        Same with the frequency of calls.
+//  * CARLA_PROFILE_SPAN(category, name)      Measures the scope as a span.
+//  * CARLA_PROFILE_DYNAMIC_SPAN(category, name_string)
+//                                            Same with a name only known at
+//                                            runtime.
+//  * CARLA_PROFILE_COUNTER(category, name, value)
+//                                            Adds value to a counter.
+//  * CARLA_PROFILE_HISTOGRAM(category, name, value)
+//                                            Adds value to a histogram.
+//
+// The spans, counters and histograms are collected in profiler::Metrics, and
+// recorded as a timeline while profiler::Tracer is recording.
+
 #ifndef LIBCARLA_ENABLE_PROFILER
 #  define CARLA_PROFILE_SCOPE(context, profiler_name)
 #  define CARLA_PROFILE_FPS(context, profiler_name)
+#  define CARLA_PROFILE_SPAN(category, name)
+#  define CARLA_PROFILE_DYNAMIC_SPAN(category, name_string)
+#  define CARLA_PROFILE_COUNTER(category, name, value)
+#  define CARLA_PROFILE_HISTOGRAM(category, name, value)
 #else
 
 #include "carla/StopWatch.h"
+#include "carla/profiler/Metrics.h"
+#include "carla/profiler/Tracer.h"
 
 #include <algorithm>
 #include <limits>
@@ -104,7 +128,34 @@ namespace detail {
     static thread_local ::carla::profiler::detail::ProfilerData carla_profiler_ ## context ## _ ## profiler_name ## _data( \
         LIBCARLA_GTEST_GET_TEST_NAME() + "." #context "." #profiler_name); \
     ::carla::profiler::detail::ScopedProfiler carla_profiler_ ## context ## _ ## profiler_name ## _scoped_profiler( \
-        carla_profiler_ ## context ## _ ## profiler_name ## _data);
+        carla_profiler_ ## context ## _ ## profiler_name ## _data); \
+    CARLA_PROFILE_SPAN(context, profiler_name)
+
+#define CARLA_PROFILE_SPAN(category, name) \
+    static ::carla::profiler::Histogram &carla_profiler_ ## category ## _ ## name ## _histogram = \
+        ::carla::profiler::Metrics::GetHistogram(#category "." #name); \
+    ::carla::profiler::ScopedSpan carla_profiler_ ## category ## _ ## name ## _span( \
+        #category, #name, carla_profiler_ ## category ## _ ## name ## _histogram);
+
+#define CARLA_PROFILE_DYNAMIC_SPAN(category, name_string) \
+    const auto carla_profiler_ ## category ## _site = \
+        ::carla::profiler::detail::GetDynamicSite(#category, name_string); \
+    ::carla::profiler::ScopedSpan carla_profiler_ ## category ## _dynamic_span( \
+        #category, carla_profiler_ ## category ## _site.name, *carla_profiler_ ## category ## _site.histogram);
+
+#define CARLA_PROFILE_COUNTER(category, name, value) \
+    { \
+      static ::carla::profiler::Counter &carla_profiler_counter = \
+          ::carla::profiler::Metrics::GetCounter(#category "." #name); \
+      ::carla::profiler::detail::AddToCounter(carla_profiler_counter, #category, #name, value); \
+    }
+
+#define CARLA_PROFILE_HISTOGRAM(category, name, value) \
+    { \
+      static ::carla::profiler::Histogram &carla_profiler_histogram = \
+          ::carla::profiler::Metrics::GetHistogram(#category "." #name); \
+      carla_profiler_histogram.Add(static_cast<uint64_t>(value)); \
+    }
 
 #define CARLA_PROFILE_FPS(context, profiler_name) \
     { \
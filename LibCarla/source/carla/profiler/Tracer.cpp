@@ -0,0 +1,483 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/profiler/Tracer.h"
+
+#include "carla/Exception.h"
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace carla {
+namespace profiler {
+
+  // ===========================================================================
+  // -- Metrics ----------------------------------------------------------------
+  // ===========================================================================
+
+  namespace {
+
+    struct MetricsRegistry {
+      std::mutex mutex;
+      // Node-based maps, references to the values are never invalidated.
+      std::map<std::string, Counter> counters;
+      std::map<std::string, Histogram> histograms;
+    };
+
+    MetricsRegistry &GetMetricsRegistry() {
+      static MetricsRegistry registry;
+      return registry;
+    }
+
+  } // namespace
+
+  Counter &Metrics::GetCounter(const std::string &name) {
+    auto &registry = GetMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.counters[name];
+  }
+
+  Histogram &Metrics::GetHistogram(const std::string &name) {
+    auto &registry = GetMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.histograms[name];
+  }
+
+  std::string Metrics::GetSummary() {
+    auto &registry = GetMetricsRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    for (auto &item : registry.histograms) {
+      const auto &histogram = item.second;
+      if (histogram.GetCount() == 0u) {
+        continue;
+      }
+      out << std::left << std::setw(44) << item.first << std::right
+          << " count " << std::setw(10) << histogram.GetCount()
+          << " mean " << std::setw(10) << histogram.GetMean()
+          << " min " << std::setw(8) << histogram.GetMin()
+          << " p50 " << std::setw(8) << histogram.GetQuantile(0.5)
+          << " p99 " << std::setw(8) << histogram.GetQuantile(0.99)
+          << " max " << std::setw(8) << histogram.GetMax() << '\n';
+    }
+    for (auto &item : registry.counters) {
+      out << std::left << std::setw(44) << item.first << std::right
+          << " value " << std::setw(10) << item.second.Get() << '\n';
+    }
+    return out.str();
+  }
+
+  // ===========================================================================
+  // -- Thread buffers ---------------------------------------------------------
+  // ===========================================================================
+
+  namespace {
+
+    struct Event {
+      enum class Type : uint8_t { Span, Counter };
+      Type type;
+      const char *category;
+      const char *name;
+      uint64_t timestamp;
+      /// Duration of spans, value of counters.
+      int64_t value;
+    };
+
+    /// Events of a single thread, a single-producer single-consumer ring
+    /// buffer.
+    class ThreadBuffer : private NonCopyable {
+    public:
+
+      ThreadBuffer(size_t capacity, uint32_t thread_id)
+        : _events(std::max<size_t>(capacity, 1u)),
+          _thread_id(thread_id) {}
+
+      uint32_t GetThreadId() const {
+        return _thread_id;
+      }
+
+      bool Push(const Event &event) {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= _events.size()) {
+          return false;
+        }
+        _events[head % _events.size()] = event;
+        _head.store(head + 1u, std::memory_order_release);
+        return true;
+      }
+
+      template <typename FunctorT>
+      void Drain(FunctorT &&functor) {
+        auto tail = _tail.load(std::memory_order_relaxed);
+        const auto head = _head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+          functor(_events[tail % _events.size()]);
+        }
+        _tail.store(tail, std::memory_order_release);
+      }
+
+    private:
+
+      std::vector<Event> _events;
+
+      std::atomic_size_t _head{0u};
+
+      std::atomic_size_t _tail{0u};
+
+      const uint32_t _thread_id;
+    };
+
+  } // namespace
+
+  // ===========================================================================
+  // -- Collector --------------------------------------------------------------
+  // ===========================================================================
+
+  namespace {
+
+    /// Owns the thread buffers and the background thread writing them out.
+    class Collector : private NonCopyable {
+    public:
+
+      Collector() {
+        // The background thread reads the metrics, construct them first so
+        // they are destroyed after the collector.
+        GetMetricsRegistry();
+      }
+
+      ~Collector() {
+        StopThread();
+      }
+
+      void Start(Tracer::Options options);
+
+      void Stop() {
+        std::lock_guard<std::mutex> lock(_control_mutex);
+        StopThread();
+      }
+
+      ThreadBuffer &GetThreadBuffer();
+
+      std::atomic<uint64_t> dropped{0u};
+
+    private:
+
+      void StopThread();
+
+      void Run();
+
+      void Drain();
+
+      void WriteEvent(uint32_t thread_id, const Event &event);
+
+      std::mutex _control_mutex;
+
+      std::mutex _buffers_mutex;
+
+      std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+
+      std::atomic_size_t _events_per_thread{1u << 16u};
+
+      Tracer::Options _options;
+
+      std::ofstream _file;
+
+      bool _first_event = true;
+
+      std::mutex _stop_mutex;
+
+      std::condition_variable _stop_condition;
+
+      bool _stop = false;
+
+      std::thread _thread;
+    };
+
+    Collector &GetCollector() {
+      static Collector collector;
+      return collector;
+    }
+
+    void WriteJsonString(std::ostream &out, const char *text) {
+      out << '"';
+      for (; *text != '\0'; ++text) {
+        if ((*text == '"') || (*text == '\\')) {
+          out << '\\';
+        }
+        out << *text;
+      }
+      out << '"';
+    }
+
+    void Collector::Start(Tracer::Options options) {
+      std::lock_guard<std::mutex> lock(_control_mutex);
+      StopThread();
+      if (!options.trace_file.empty()) {
+        _file.open(options.trace_file);
+        if (!_file.is_open()) {
+          throw_exception(std::runtime_error("failed to open trace file " + options.trace_file));
+        }
+        // JSON array format, the closing bracket is optional while the file
+        // is being written.
+        _file << "[\n";
+        _first_event = true;
+      }
+      _events_per_thread = options.events_per_thread;
+      _options = std::move(options);
+      _stop = false;
+      _thread = std::thread([this]() { Run(); });
+    }
+
+    void Collector::StopThread() {
+      if (!_thread.joinable()) {
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(_stop_mutex);
+        _stop = true;
+      }
+      _stop_condition.notify_one();
+      _thread.join();
+      if (_file.is_open()) {
+        _file << "\n]\n";
+        _file.close();
+      }
+    }
+
+    ThreadBuffer &Collector::GetThreadBuffer() {
+      static std::atomic<uint32_t> THREAD_COUNTER{0u};
+      // Owned also by the collector, so the events of finished threads are
+      // still written.
+      thread_local std::shared_ptr<ThreadBuffer> buffer;
+      if (buffer == nullptr) {
+        buffer = std::make_shared<ThreadBuffer>(_events_per_thread.load(), ++THREAD_COUNTER);
+        std::lock_guard<std::mutex> lock(_buffers_mutex);
+        _buffers.emplace_back(buffer);
+      }
+      return *buffer;
+    }
+
+    void Collector::WriteEvent(uint32_t thread_id, const Event &event) {
+      if (!_file.is_open()) {
+        return;
+      }
+      if (!_first_event) {
+        _file << ",\n";
+      }
+      _first_event = false;
+      _file << "{\"name\":";
+      WriteJsonString(_file, event.name);
+      _file << ",\"cat\":";
+      WriteJsonString(_file, event.category);
+      _file << ",\"pid\":1,\"tid\":" << thread_id << ",\"ts\":" << event.timestamp;
+      if (event.type == Event::Type::Span) {
+        _file << ",\"ph\":\"X\",\"dur\":" << event.value << '}';
+      } else {
+        _file << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}}";
+      }
+    }
+
+    void Collector::Drain() {
+      std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+      {
+        std::lock_guard<std::mutex> lock(_buffers_mutex);
+        buffers = _buffers;
+      }
+      for (auto &buffer : buffers) {
+        const auto thread_id = buffer->GetThreadId();
+        buffer->Drain([&](const Event &event) { WriteEvent(thread_id, event); });
+      }
+      {
+        // Release the buffers of the threads that finished, they were
+        // drained above.
+        std::lock_guard<std::mutex> lock(_buffers_mutex);
+        buffers.clear();
+        _buffers.erase(
+            std::remove_if(_buffers.begin(), _buffers.end(), [](const auto &buffer) {
+              return buffer.use_count() == 1;
+            }),
+            _buffers.end());
+      }
+      if (_file.is_open()) {
+        _file.flush();
+      }
+    }
+
+    void Collector::Run() {
+      const auto drain_interval = std::chrono::milliseconds(10);
+      const auto summary_interval = _options.summary_interval.to_chrono();
+      auto next_summary = std::chrono::steady_clock::now() + summary_interval;
+      std::unique_lock<std::mutex> lock(_stop_mutex);
+      while (!_stop) {
+        _stop_condition.wait_for(lock, drain_interval, [this]() { return _stop; });
+        lock.unlock();
+        Drain();
+        if ((summary_interval.count() > 0) && (std::chrono::steady_clock::now() >= next_summary)) {
+          logging::log("PROFILER: summary\n" + Metrics::GetSummary());
+          next_summary += summary_interval;
+        }
+        lock.lock();
+      }
+      lock.unlock();
+      Drain();
+      if (summary_interval.count() > 0) {
+        logging::log("PROFILER: summary\n" + Metrics::GetSummary());
+      }
+    }
+
+  } // namespace
+
+  // ===========================================================================
+  // -- Tracer -----------------------------------------------------------------
+  // ===========================================================================
+
+  std::atomic_bool Tracer::_recording{false};
+
+  void Tracer::Start(Options options) {
+    _recording = false;
+    GetCollector().Start(std::move(options));
+    _recording = true;
+  }
+
+  void Tracer::Stop() {
+    _recording = false;
+    GetCollector().Stop();
+    if (GetDroppedCount() > 0u) {
+      log_warning("profiler dropped", GetDroppedCount(), "trace events");
+    }
+  }
+
+  uint64_t Tracer::Now() {
+    static const auto EPOCH = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - EPOCH).count());
+  }
+
+  void Tracer::RecordSpan(const char *category, const char *name, uint64_t begin, uint64_t end) {
+    auto &collector = GetCollector();
+    const Event event{Event::Type::Span, category, name, begin, static_cast<int64_t>(end - begin)};
+    if (!collector.GetThreadBuffer().Push(event)) {
+      collector.dropped.fetch_add(1u, std::memory_order_relaxed);
+    }
+  }
+
+  void Tracer::RecordCounter(const char *category, const char *name, int64_t value) {
+    auto &collector = GetCollector();
+    const Event event{Event::Type::Counter, category, name, Now(), value};
+    if (!collector.GetThreadBuffer().Push(event)) {
+      collector.dropped.fetch_add(1u, std::memory_order_relaxed);
+    }
+  }
+
+  uint64_t Tracer::GetDroppedCount() {
+    return GetCollector().dropped.load(std::memory_order_relaxed);
+  }
+
+  bool Tracer::StartFromEnvironment() {
+    const char *trace_file = std::getenv("CARLA_PROFILER_TRACE_FILE");
+    if ((trace_file == nullptr) || (trace_file[0] == '\0')) {
+      return false;
+    }
+    Options options;
+    options.trace_file = trace_file;
+    const char *summary_interval = std::getenv("CARLA_PROFILER_SUMMARY_INTERVAL");
+    if (summary_interval != nullptr) {
+      options.summary_interval = time_duration::milliseconds(
+          static_cast<size_t>(1e3 * std::max(0.0, std::atof(summary_interval))));
+    }
+#ifndef LIBCARLA_NO_EXCEPTIONS
+    try {
+#endif // LIBCARLA_NO_EXCEPTIONS
+      Start(std::move(options));
+#ifndef LIBCARLA_NO_EXCEPTIONS
+    } catch (const std::exception &e) {
+      log_error("profiler: failed to start recording:", e.what());
+      return false;
+    }
+#endif // LIBCARLA_NO_EXCEPTIONS
+    log_info("profiler: recording trace to", trace_file);
+    return true;
+  }
+
+  namespace {
+
+    /// Starts recording when the library is loaded if requested through the
+    /// environment, and completes the trace when it is unloaded, before the
+    /// collector and the metrics are destroyed.
+    class StartFromEnvironmentAtLoad {
+    public:
+
+      StartFromEnvironmentAtLoad()
+        : _started(Tracer::StartFromEnvironment()) {}
+
+      ~StartFromEnvironmentAtLoad() {
+        if (_started) {
+          Tracer::Stop();
+        }
+      }
+
+    private:
+
+      const bool _started;
+    };
+
+    StartFromEnvironmentAtLoad START_FROM_ENVIRONMENT_AT_LOAD;
+
+  } // namespace
+
+  // ===========================================================================
+  // -- Dynamic sites ----------------------------------------------------------
+  // ===========================================================================
+
+namespace detail {
+
+  /// The interned names are referenced by events written when the trace is
+  /// completed at exit, after the destruction of the statics constructed
+  /// later than START_FROM_ENVIRONMENT_AT_LOAD, so the table is never freed.
+  static const char *Intern(const std::string &name) {
+    struct Names {
+      std::mutex mutex;
+      // Node-based, the strings are never moved.
+      std::unordered_set<std::string> set;
+    };
+    static Names *NAMES = new Names;
+    std::lock_guard<std::mutex> lock(NAMES->mutex);
+    return NAMES->set.emplace(name).first->c_str();
+  }
+
+  DynamicSite GetDynamicSite(const char *category, const std::string &name) {
+    thread_local std::unordered_map<const char *, std::unordered_map<std::string, DynamicSite>> cache;
+    auto &sites = cache[category];
+    auto it = sites.find(name);
+    if (it == sites.end()) {
+      const DynamicSite site{
+          Intern(name),
+          &Metrics::GetHistogram(std::string(category) + "." + name)};
+      it = sites.emplace(name, site).first;
+    }
+    return it->second;
+  }
+
+} // namespace detail
+
+} // namespace profiler
+} // namespace carla
@@ -0,0 +1,134 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/profiler/Metrics.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace carla {
+namespace profiler {
+
+  /// Records the spans and counters of the instrumented code as a timeline.
+  ///
+  /// Each thread appends its events to its own buffer, a background thread
+  /// collects them and writes them to a trace file in the Chrome trace event
+  /// format, which can be opened with chrome://tracing or Perfetto. The file
+  /// is written while recording, and is valid once Stop is called. The
+  /// background thread also logs a summary of the Metrics periodically.
+  ///
+  /// The metrics are updated whether recording or not.
+  ///
+  /// Recording starts when the library is loaded if the environment variable
+  /// CARLA_PROFILER_TRACE_FILE is set, see StartFromEnvironment.
+  class Tracer {
+  public:
+
+    struct Options {
+      /// Path of the trace file, if empty no trace is written.
+      std::string trace_file;
+
+      /// Period of the summary of the metrics, zero to disable.
+      time_duration summary_interval = time_duration::seconds(10u);
+
+      /// Maximum number of events each thread can buffer, events beyond are
+      /// dropped. Only applies to threads recording for the first time.
+      size_t events_per_thread = 1u << 16u;
+    };
+
+    /// Starts recording, restarting if already recording.
+    static void Start(Options options);
+
+    /// Stops recording and completes the trace file.
+    static void Stop();
+
+    /// Starts recording if the environment variable CARLA_PROFILER_TRACE_FILE
+    /// is set, writing the trace to the path it holds. The summary period in
+    /// seconds can be set with CARLA_PROFILER_SUMMARY_INTERVAL. Returns
+    /// whether recording started.
+    static bool StartFromEnvironment();
+
+    static bool IsRecording() {
+      return _recording.load(std::memory_order_relaxed);
+    }
+
+    /// Microseconds elapsed since an arbitrary point at the start of the
+    /// program, monotonic.
+    static uint64_t Now();
+
+    static void RecordSpan(const char *category, const char *name, uint64_t begin, uint64_t end);
+
+    static void RecordCounter(const char *category, const char *name, int64_t value);
+
+    /// Number of events dropped because a thread's buffer was full.
+    static uint64_t GetDroppedCount();
+
+  private:
+
+    static std::atomic_bool _recording;
+  };
+
+  /// Measures the duration of a scope into a histogram, and records it as a
+  /// span if the Tracer is recording.
+  class ScopedSpan : private NonCopyable {
+  public:
+
+    ScopedSpan(const char *category, const char *name, Histogram &histogram)
+      : _category(category),
+        _name(name),
+        _histogram(histogram),
+        _begin(Tracer::Now()) {}
+
+    ~ScopedSpan() {
+      const auto end = Tracer::Now();
+      _histogram.Add(end - _begin);
+      if (Tracer::IsRecording()) {
+        Tracer::RecordSpan(_category, _name, _begin, end);
+      }
+    }
+
+  private:
+
+    const char *_category;
+
+    const char *_name;
+
+    Histogram &_histogram;
+
+    const uint64_t _begin;
+  };
+
+namespace detail {
+
+  /// Name and histogram of a span whose name is only known at runtime.
+  struct DynamicSite {
+    const char *name;
+    Histogram *histogram;
+  };
+
+  /// Interns @a name and looks up its histogram "category.name", the result
+  /// is cached per thread.
+  DynamicSite GetDynamicSite(const char *category, const std::string &name);
+
+  static inline void AddToCounter(
+      Counter &counter,
+      const char *category,
+      const char *name,
+      int64_t value) {
+    counter.Add(value);
+    if (Tracer::IsRecording()) {
+      Tracer::RecordCounter(category, name, counter.Get());
+    }
+  }
+
+} // namespace detail
+} // namespace profiler
+} // namespace carla
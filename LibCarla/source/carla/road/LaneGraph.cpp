@@ -0,0 +1,63 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/LaneGraph.h"
+
+#include "carla/road/Lane.h"
+#include "carla/road/MapData.h"
+
+namespace carla {
+namespace road {
+
+  template <typename GetLinksT>
+  static void AddEdges(
+      const std::vector<const Lane *> &lanes,
+      const std::unordered_map<const Lane *, LaneGraph::LaneIndex> &indices,
+      GetLinksT &&get_links,
+      std::vector<uint32_t> &offsets,
+      std::vector<LaneGraph::LaneIndex> &edges) {
+    offsets.clear();
+    edges.clear();
+    offsets.reserve(lanes.size() + 1u);
+    offsets.emplace_back(0u);
+    for (const auto *lane : lanes) {
+      for (const auto *link : get_links(*lane)) {
+        RELEASE_ASSERT(link != nullptr);
+        auto it = indices.find(link);
+        RELEASE_ASSERT(it != indices.end());
+        edges.emplace_back(it->second);
+      }
+      offsets.emplace_back(static_cast<uint32_t>(edges.size()));
+    }
+    edges.shrink_to_fit();
+  }
+
+  LaneGraph::LaneGraph(const MapData &data) {
+    std::vector<const Lane *> lanes;
+    for (const auto &road : data.GetRoads()) {
+      for (const auto &section : road.second.GetLaneSections()) {
+        for (const auto &lane : section.GetLanes()) {
+          const auto index = static_cast<LaneIndex>(lanes.size());
+          _indices.emplace(&lane.second, index);
+          _nodes.emplace_back(Node{
+              road.first,
+              section.GetId(),
+              lane.first,
+              lane.second.GetDistance(),
+              lane.second.GetLength()});
+          lanes.emplace_back(&lane.second);
+        }
+      }
+    }
+    RELEASE_ASSERT(lanes.size() < INVALID_INDEX);
+    AddEdges(lanes, _indices, [](const Lane &lane) -> const auto & { return lane.GetNextLanes(); },
+        _successor_offsets, _successors);
+    AddEdges(lanes, _indices, [](const Lane &lane) -> const auto & { return lane.GetPreviousLanes(); },
+        _predecessor_offsets, _predecessors);
+  }
+
+} // namespace road
+} // namespace carla
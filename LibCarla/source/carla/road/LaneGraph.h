@@ -0,0 +1,108 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/ListView.h"
+#include "carla/road/RoadTypes.h"
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Lane;
+  class MapData;
+
+  /// Lane-level connectivity of the road network. Every lane gets a dense
+  /// index and the successors and predecessors of each lane are stored in
+  /// compressed sparse row layout, so traversing the graph does not allocate
+  /// nor touch the road, section, and lane maps.
+  ///
+  /// The graph holds pointers to the lanes of the MapData it was built from,
+  /// it is only valid as long as that data is alive.
+  class LaneGraph {
+  public:
+
+    using LaneIndex = uint32_t;
+
+    static constexpr LaneIndex INVALID_INDEX = std::numeric_limits<LaneIndex>::max();
+
+    /// Information of a lane needed to traverse the graph.
+    struct Node {
+      RoadId road_id;
+      SectionId section_id;
+      LaneId lane_id;
+      /// Distance (s) at the start of the lane section.
+      double distance;
+      double length;
+    };
+
+    LaneGraph() = default;
+
+    /// Build the graph from the lane links of @a data.
+    explicit LaneGraph(const MapData &data);
+
+    size_t size() const {
+      return _nodes.size();
+    }
+
+    bool empty() const {
+      return _nodes.empty();
+    }
+
+    /// Dense index of @a lane, INVALID_INDEX if the lane is not in the graph.
+    LaneIndex GetIndex(const Lane &lane) const {
+      auto it = _indices.find(&lane);
+      return it != _indices.end() ? it->second : INVALID_INDEX;
+    }
+
+    const Node &GetNode(LaneIndex index) const {
+      DEBUG_ASSERT(index < _nodes.size());
+      return _nodes[index];
+    }
+
+    auto GetSuccessors(LaneIndex index) const {
+      return GetEdges(_successor_offsets, _successors, index);
+    }
+
+    auto GetPredecessors(LaneIndex index) const {
+      return GetEdges(_predecessor_offsets, _predecessors, index);
+    }
+
+  private:
+
+    static ListView<std::vector<LaneIndex>::const_iterator> GetEdges(
+        const std::vector<uint32_t> &offsets,
+        const std::vector<LaneIndex> &edges,
+        LaneIndex index) {
+      DEBUG_ASSERT(index + 1u < offsets.size());
+      return MakeListView(
+          edges.begin() + offsets[index],
+          edges.begin() + offsets[index + 1u]);
+    }
+
+    std::vector<Node> _nodes;
+
+    std::unordered_map<const Lane *, LaneIndex> _indices;
+
+    /// Successors of lane i are _successors[_successor_offsets[i]] up to
+    /// _successors[_successor_offsets[i + 1]].
+    std::vector<uint32_t> _successor_offsets;
+
+    std::vector<LaneIndex> _successors;
+
+    std::vector<uint32_t> _predecessor_offsets;
+
+    std::vector<LaneIndex> _predecessors;
+  };
+
+} // namespace road
+} // namespace carla
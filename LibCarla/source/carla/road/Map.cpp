@@ -6,7 +6,9 @@
 
 #include "carla/road/Map.h"
 #include "carla/Exception.h"
+#include "carla/ThreadPool.h"
 #include "carla/geom/Math.h"
+#include "carla/profiler/Profiler.h"
 #include "carla/road/MeshFactory.h"
 #include "carla/road/element/LaneCrossingCalculator.h"
 #include "carla/road/element/RoadInfoCrosswalk.h"
@@ -17,6 +19,9 @@
 #include "carla/road/element/RoadInfoMarkRecord.h"
 #include "carla/road/element/RoadInfoSignal.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #include <stdexcept>
@@ -46,22 +51,55 @@ namespace road {
     return dst;
   }
 
-  static double GetDistanceAtStartOfLane(const Lane &lane) {
-    if (lane.GetId() <= 0) {
-      return lane.GetDistance() + 10.0 * EPSILON;
+  /// Start the threads of @a pool so that, with the calling thread taking part
+  /// in its ParallelFor, @a worker_threads threads do the work, or as many as
+  /// the hardware concurrency if zero.
+  static void StartWorkers(ThreadPool &pool, size_t worker_threads) {
+    if (worker_threads == 0u) {
+      worker_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (worker_threads > 1u) {
+      pool.AsyncRun(worker_threads - 1u);
+    }
+  }
+
+  /// Pool shared by the queries sampling every road, started on first use
+  /// with the hardware concurrency. Never destroyed, its idle threads are left
+  /// to the end of the process instead of being joined during static
+  /// destruction.
+  static ThreadPool &GetSharedPool() {
+    static ThreadPool *pool = []() {
+      auto *result = new ThreadPool;
+      StartWorkers(*result, 0u);
+      return result;
+    }();
+    return *pool;
+  }
+
+  static double GetDistanceAtStartOfLane(LaneId lane_id, double distance, double length) {
+    if (lane_id <= 0) {
+      return distance + 10.0 * EPSILON;
     } else {
-      return lane.GetDistance() + lane.GetLength() - 10.0 * EPSILON;
+      return distance + length - 10.0 * EPSILON;
     }
   }
 
-  static double GetDistanceAtEndOfLane(const Lane &lane) {
-    if (lane.GetId() > 0) {
-      return lane.GetDistance() + 10.0 * EPSILON;
+  static double GetDistanceAtEndOfLane(LaneId lane_id, double distance, double length) {
+    if (lane_id > 0) {
+      return distance + 10.0 * EPSILON;
     } else {
-      return lane.GetDistance() + lane.GetLength() - 10.0 * EPSILON;
+      return distance + length - 10.0 * EPSILON;
     }
   }
 
+  static double GetDistanceAtStartOfLane(const Lane &lane) {
+    return GetDistanceAtStartOfLane(lane.GetId(), lane.GetDistance(), lane.GetLength());
+  }
+
+  static double GetDistanceAtEndOfLane(const Lane &lane) {
+    return GetDistanceAtEndOfLane(lane.GetId(), lane.GetDistance(), lane.GetLength());
+  }
+
   /// Return a waypoint for each drivable lane on @a lane_section.
   template <typename FuncT>
   static void ForEachDrivableLaneImpl(
@@ -156,6 +194,7 @@ namespace road {
   boost::optional<Waypoint> Map::GetClosestWaypointOnRoad(
       const geom::Location &pos,
       int32_t lane_type) const {
+    CARLA_PROFILE_SPAN(map, get_closest_waypoint);
     std::vector<Rtree::TreeElement> query_result =
         _rtree.GetNearestNeighboursWithFilter(Rtree::BPoint(pos.x, pos.y, pos.z),
         [&](Rtree::TreeElement const &element) {
@@ -506,112 +545,147 @@ namespace road {
   // -- Map: Waypoint generation -----------------------------------------------
   // ===========================================================================
 
+  LaneGraph::LaneIndex Map::GetLaneIndex(const Waypoint waypoint) const {
+    const auto index = _lane_graph.GetIndex(GetLane(waypoint));
+    RELEASE_ASSERT(index != LaneGraph::INVALID_INDEX);
+    return index;
+  }
+
+  static Waypoint MakeWaypointAtStart(const LaneGraph::Node &node) {
+    return Waypoint{node.road_id, node.section_id, node.lane_id,
+        GetDistanceAtStartOfLane(node.lane_id, node.distance, node.length)};
+  }
+
+  static Waypoint MakeWaypointAtEnd(const LaneGraph::Node &node) {
+    return Waypoint{node.road_id, node.section_id, node.lane_id,
+        GetDistanceAtEndOfLane(node.lane_id, node.distance, node.length)};
+  }
+
   std::vector<Waypoint> Map::GetSuccessors(const Waypoint waypoint) const {
-    const auto &next_lanes = GetLane(waypoint).GetNextLanes();
     std::vector<Waypoint> result;
-    result.reserve(next_lanes.size());
-    for (auto *next_lane : next_lanes) {
-      RELEASE_ASSERT(next_lane != nullptr);
-      const auto lane_id = next_lane->GetId();
-      RELEASE_ASSERT(lane_id != 0);
-      const auto *section = next_lane->GetLaneSection();
-      RELEASE_ASSERT(section != nullptr);
-      const auto *road = next_lane->GetRoad();
-      RELEASE_ASSERT(road != nullptr);
-      const auto distance = GetDistanceAtStartOfLane(*next_lane);
-      result.emplace_back(Waypoint{road->GetId(), section->GetId(), lane_id, distance});
-    }
+    GetSuccessors(waypoint, result);
     return result;
   }
 
+  void Map::GetSuccessors(const Waypoint waypoint, std::vector<Waypoint> &result) const {
+    for (auto index : _lane_graph.GetSuccessors(GetLaneIndex(waypoint))) {
+      const auto &node = _lane_graph.GetNode(index);
+      RELEASE_ASSERT(node.lane_id != 0);
+      result.emplace_back(MakeWaypointAtStart(node));
+    }
+  }
+
   std::vector<Waypoint> Map::GetPredecessors(const Waypoint waypoint) const {
-    const auto &prev_lanes = GetLane(waypoint).GetPreviousLanes();
     std::vector<Waypoint> result;
-    result.reserve(prev_lanes.size());
-    for (auto *next_lane : prev_lanes) {
-      RELEASE_ASSERT(next_lane != nullptr);
-      const auto lane_id = next_lane->GetId();
-      RELEASE_ASSERT(lane_id != 0);
-      const auto *section = next_lane->GetLaneSection();
-      RELEASE_ASSERT(section != nullptr);
-      const auto *road = next_lane->GetRoad();
-      RELEASE_ASSERT(road != nullptr);
-      const auto distance = GetDistanceAtEndOfLane(*next_lane);
-      result.emplace_back(Waypoint{road->GetId(), section->GetId(), lane_id, distance});
-    }
+    GetPredecessors(waypoint, result);
     return result;
   }
 
+  void Map::GetPredecessors(const Waypoint waypoint, std::vector<Waypoint> &result) const {
+    for (auto index : _lane_graph.GetPredecessors(GetLaneIndex(waypoint))) {
+      const auto &node = _lane_graph.GetNode(index);
+      RELEASE_ASSERT(node.lane_id != 0);
+      result.emplace_back(MakeWaypointAtEnd(node));
+    }
+  }
+
   std::vector<Waypoint> Map::GetNext(
       const Waypoint waypoint,
       const double distance) const {
-    RELEASE_ASSERT(distance > 0.0);
-    if (distance <= EPSILON) {
-      return {waypoint};
-    }
-    const auto &lane = GetLane(waypoint);
-    const bool forward = (waypoint.lane_id <= 0);
-    const double signed_distance = forward ? distance : -distance;
-    const double relative_s = waypoint.s - lane.GetDistance();
-    const double remaining_lane_length = forward ? lane.GetLength() - relative_s : relative_s;
-    DEBUG_ASSERT(remaining_lane_length >= 0.0);
-
-    // If after subtracting the distance we are still in the same lane, return
-    // same waypoint with the extra distance.
-    if (distance <= remaining_lane_length) {
-      Waypoint result = waypoint;
-      result.s += signed_distance;
-      result.s += forward ? -EPSILON : EPSILON;
-      RELEASE_ASSERT(result.s > 0.0);
-      return { result };
-    }
-
-    // If we run out of remaining_lane_length we have to go to the successors.
     std::vector<Waypoint> result;
-    for (const auto &successor : GetSuccessors(waypoint)) {
-      DEBUG_ASSERT(
-          successor.road_id != waypoint.road_id ||
-          successor.section_id != waypoint.section_id ||
-          successor.lane_id != waypoint.lane_id);
-      result = ConcatVectors(result, GetNext(successor, distance - remaining_lane_length));
-    }
+    GetNext(waypoint, distance, result);
     return result;
   }
 
+  void Map::GetNext(
+      const Waypoint waypoint,
+      const double distance,
+      std::vector<Waypoint> &result) const {
+    Traverse(waypoint, distance, true, result);
+  }
+
   std::vector<Waypoint> Map::GetPrevious(
       const Waypoint waypoint,
       const double distance) const {
+    std::vector<Waypoint> result;
+    GetPrevious(waypoint, distance, result);
+    return result;
+  }
+
+  void Map::GetPrevious(
+      const Waypoint waypoint,
+      const double distance,
+      std::vector<Waypoint> &result) const {
+    Traverse(waypoint, distance, false, result);
+  }
+
+  void Map::Traverse(
+      const Waypoint waypoint,
+      const double distance,
+      const bool next,
+      std::vector<Waypoint> &result) const {
     RELEASE_ASSERT(distance > 0.0);
     if (distance <= EPSILON) {
-      return {waypoint};
+      result.emplace_back(waypoint);
+      return;
     }
-    const auto &lane = GetLane(waypoint);
-    const bool forward = !(waypoint.lane_id <= 0);
-    const double signed_distance = forward ? distance : -distance;
-    const double relative_s = waypoint.s - lane.GetDistance();
-    const double remaining_lane_length = forward ? lane.GetLength() - relative_s : relative_s;
-    DEBUG_ASSERT(remaining_lane_length >= 0.0);
 
-    // If after subtracting the distance we are still in the same lane, return
-    // same waypoint with the extra distance.
-    if (distance <= remaining_lane_length) {
-      Waypoint result = waypoint;
-      result.s += signed_distance;
-      result.s += forward ? -EPSILON : EPSILON;
-      RELEASE_ASSERT(result.s > 0.0);
-      return { result };
-    }
+    struct Pending {
+      Waypoint waypoint;
+      LaneGraph::LaneIndex lane;
+      double distance;
+    };
+
+    // Depth-first traversal of the lane graph, the stack is kept between calls
+    // to avoid allocations.
+    thread_local std::vector<Pending> stack;
+    stack.clear();
+    stack.emplace_back(Pending{waypoint, GetLaneIndex(waypoint), distance});
+
+    while (!stack.empty()) {
+      const Pending current = stack.back();
+      stack.pop_back();
+      if (current.distance <= EPSILON) {
+        result.emplace_back(current.waypoint);
+        continue;
+      }
+      const auto &node = _lane_graph.GetNode(current.lane);
+      const bool forward = next == (node.lane_id <= 0);
+      const double relative_s = current.waypoint.s - node.distance;
+      const double remaining_lane_length = forward ? node.length - relative_s : relative_s;
+      DEBUG_ASSERT(remaining_lane_length >= 0.0);
+
+      // If after subtracting the distance we are still in the same lane, return
+      // same waypoint with the extra distance.
+      if (current.distance <= remaining_lane_length) {
+        Waypoint end = current.waypoint;
+        end.s += forward ? current.distance : -current.distance;
+        end.s += forward ? -EPSILON : EPSILON;
+        RELEASE_ASSERT(end.s > 0.0);
+        result.emplace_back(end);
+        continue;
+      }
 
-    // If we run out of remaining_lane_length we have to go to the successors.
-    std::vector<Waypoint> result;
-    for (const auto &successor : GetPredecessors(waypoint)) {
-      DEBUG_ASSERT(
-          successor.road_id != waypoint.road_id ||
-          successor.section_id != waypoint.section_id ||
-          successor.lane_id != waypoint.lane_id);
-      result = ConcatVectors(result, GetPrevious(successor, distance - remaining_lane_length));
+      // If we run out of remaining_lane_length we have to go to the successors,
+      // pushed in reverse to visit them in order.
+      const auto links = next ?
+          _lane_graph.GetSuccessors(current.lane) :
+          _lane_graph.GetPredecessors(current.lane);
+      for (auto it = links.end(); it != links.begin();) {
+        --it;
+        const auto &link = _lane_graph.GetNode(*it);
+        RELEASE_ASSERT(link.lane_id != 0);
+        const Pending pending{
+            next ? MakeWaypointAtStart(link) : MakeWaypointAtEnd(link),
+            *it,
+            current.distance - remaining_lane_length};
+        DEBUG_ASSERT(
+            pending.waypoint.road_id != current.waypoint.road_id ||
+            pending.waypoint.section_id != current.waypoint.section_id ||
+            pending.waypoint.lane_id != current.waypoint.lane_id);
+        stack.emplace_back(pending);
+      }
     }
-    return result;
   }
 
   boost::optional<Waypoint> Map::GetRight(Waypoint waypoint) const {
@@ -636,17 +710,79 @@ namespace road {
     return IsLanePresent(_data, waypoint) ? waypoint : boost::optional<Waypoint>{};
   }
 
-  std::vector<Waypoint> Map::GenerateWaypoints(const double distance) const {
+  /// Sample the drivable lanes of every road in @a data every @a distance
+  /// meters, one list of waypoints per road.
+  static std::vector<std::vector<Waypoint>> SampleRoads(
+      const MapData &data,
+      const double distance,
+      ThreadPool &pool) {
     RELEASE_ASSERT(distance > 0.0);
-    std::vector<Waypoint> result;
-    for (const auto &pair : _data.GetRoads()) {
-      const auto &road = pair.second;
+    std::vector<const Road *> roads;
+    roads.reserve(data.GetRoads().size());
+    for (const auto &pair : data.GetRoads()) {
+      roads.emplace_back(&pair.second);
+    }
+    std::vector<std::vector<Waypoint>> result(roads.size());
+    // Roads differ a lot in length, hand them out one by one.
+    pool.ParallelFor(roads.size(), 1u, [&](const size_t i) {
+      const auto &road = *roads[i];
       for (double s = EPSILON; s < (road.GetLength() - EPSILON); s += distance) {
         ForEachDrivableLaneAt(road, s, [&](auto &&waypoint) {
-          result.emplace_back(waypoint);
+          result[i].emplace_back(waypoint);
         });
       }
+    });
+    return result;
+  }
+
+  std::vector<Waypoint> Map::GenerateWaypoints(const double distance) const {
+    CARLA_PROFILE_SPAN(map, generate_waypoints);
+    const auto roads = SampleRoads(_data, distance, GetSharedPool());
+    size_t count = 0u;
+    for (const auto &road : roads) {
+      count += road.size();
+    }
+    std::vector<Waypoint> result;
+    result.reserve(count);
+    for (const auto &road : roads) {
+      result.insert(result.end(), road.begin(), road.end());
+    }
+    return result;
+  }
+
+  element::WaypointArray Map::GenerateWaypointArray(
+      const double distance,
+      const size_t worker_threads) const {
+    CARLA_PROFILE_SPAN(map, generate_waypoint_array);
+    // A specific number of threads needs a pool of its own.
+    std::unique_ptr<ThreadPool> own_pool;
+    if (worker_threads != 0u) {
+      own_pool = std::make_unique<ThreadPool>();
+      StartWorkers(*own_pool, worker_threads);
+    }
+    ThreadPool &pool = own_pool != nullptr ? *own_pool : GetSharedPool();
+    const auto roads = SampleRoads(_data, distance, pool);
+    std::vector<size_t> offsets;
+    offsets.reserve(roads.size() + 1u);
+    offsets.emplace_back(0u);
+    for (const auto &road : roads) {
+      offsets.emplace_back(offsets.back() + road.size());
     }
+    element::WaypointArray result;
+    result.resize(offsets.back());
+    // Computing the transforms is the expensive part, each road writes its
+    // own slice of the arrays.
+    pool.ParallelFor(roads.size(), 1u, [&](const size_t i) {
+      auto index = offsets[i];
+      for (const auto &waypoint : roads[i]) {
+        result.road_id[index] = waypoint.road_id;
+        result.section_id[index] = waypoint.section_id;
+        result.lane_id[index] = waypoint.lane_id;
+        result.s[index] = waypoint.s;
+        result.transform[index] = ComputeTransform(waypoint);
+        ++index;
+      }
+    });
     return result;
   }
 
@@ -13,6 +13,8 @@
 #include "carla/road/element/LaneMarking.h"
 #include "carla/road/element/RoadInfoMarkRecord.h"
 #include "carla/road/element/Waypoint.h"
+#include "carla/road/element/WaypointArray.h"
+#include "carla/road/LaneGraph.h"
 #include "carla/road/MapData.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/rpc/OpendriveGenerationParameters.h"
@@ -33,7 +35,7 @@ namespace road {
     /// -- Constructor ---------------------------------------------------------
     /// ========================================================================
 
-    Map(MapData m) : _data(std::move(m)) {
+    Map(MapData m) : _data(std::move(m)), _lane_graph(_data) {
       CreateRtree();
     }
 
@@ -70,6 +72,11 @@ namespace road {
 
     const Lane &GetLane(Waypoint waypoint) const;
 
+    /// Lane-level connectivity of the map.
+    const LaneGraph &GetLaneGraph() const {
+      return _lane_graph;
+    }
+
     Lane::LaneType GetLaneType(Waypoint waypoint) const;
 
     double GetLaneWidth(Waypoint waypoint) const;
@@ -114,6 +121,10 @@ namespace road {
     std::vector<Waypoint> GetSuccessors(Waypoint waypoint) const;
     std::vector<Waypoint> GetPredecessors(Waypoint waypoint) const;
 
+    /// Same as above, but append the waypoints to @a result.
+    void GetSuccessors(Waypoint waypoint, std::vector<Waypoint> &result) const;
+    void GetPredecessors(Waypoint waypoint, std::vector<Waypoint> &result) const;
+
     /// Return the list of waypoints at @a distance such that a vehicle at @a
     /// waypoint could drive to.
     std::vector<Waypoint> GetNext(Waypoint waypoint, double distance) const;
@@ -121,6 +132,11 @@ namespace road {
     /// that a vehicle at @a waypoint could drive to.
     std::vector<Waypoint> GetPrevious(Waypoint waypoint, double distance) const;
 
+    /// Same as above, but append the waypoints to @a result. Reusing @a result
+    /// between calls avoids allocating on each query.
+    void GetNext(Waypoint waypoint, double distance, std::vector<Waypoint> &result) const;
+    void GetPrevious(Waypoint waypoint, double distance, std::vector<Waypoint> &result) const;
+
     /// Return a waypoint at the lane of @a waypoint's right lane.
     boost::optional<Waypoint> GetRight(Waypoint waypoint) const;
 
@@ -128,8 +144,17 @@ namespace road {
     boost::optional<Waypoint> GetLeft(Waypoint waypoint) const;
 
     /// Generate all the waypoints in @a map separated by @a approx_distance.
+    /// Roads are sampled in parallel, the result is in the same order as if
+    /// they were sampled one after the other.
     std::vector<Waypoint> GenerateWaypoints(double approx_distance) const;
 
+    /// Same waypoints as GenerateWaypoints, together with their transforms,
+    /// stored as a structure of arrays. Uses @a worker_threads threads, or
+    /// all the hardware concurrency if zero.
+    element::WaypointArray GenerateWaypointArray(
+        double approx_distance,
+        size_t worker_threads = 0u) const;
+
     /// Generate waypoints on each @a lane at the start of each @a road
     std::vector<Waypoint> GenerateWaypointsOnRoadEntries(Lane::LaneType lane_type = Lane::LaneType::Driving) const;
 
@@ -186,6 +211,19 @@ private:
     using Rtree = geom::SegmentCloudRtree<Waypoint>;
     Rtree _rtree;
 
+    /// Lane connectivity, requires the lanes of _data to be already linked by
+    /// the MapBuilder. Declared after _data so it is built from it.
+    LaneGraph _lane_graph;
+
+    LaneGraph::LaneIndex GetLaneIndex(Waypoint waypoint) const;
+
+    /// Shared implementation of GetNext (@a next true) and GetPrevious.
+    void Traverse(
+        Waypoint waypoint,
+        double distance,
+        bool next,
+        std::vector<Waypoint> &result) const;
+
     void CreateRtree();
 
     /// Helper Functions for constructing the rtree element list
@@ -0,0 +1,354 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/RoutePlanner.h"
+
+#include "carla/geom/Math.h"
+#include "carla/profiler/Profiler.h"
+#include "carla/road/Map.h"
+#include "carla/road/element/RoadInfoMarkRecord.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace carla {
+namespace road {
+
+  using element::RoadInfoMarkRecord;
+
+  /// Same margin the Map uses to keep the waypoints away from the edges of the
+  /// lane sections.
+  static constexpr double EPSILON = 10.0 * std::numeric_limits<double>::epsilon();
+
+  static bool IsForward(LaneId lane_id) {
+    return lane_id <= 0;
+  }
+
+  static double GetStartS(const LaneGraph::Node &node) {
+    return IsForward(node.lane_id) ?
+        node.distance + 10.0 * EPSILON :
+        node.distance + node.length - 10.0 * EPSILON;
+  }
+
+  static double GetEndS(const LaneGraph::Node &node) {
+    return IsForward(node.lane_id) ?
+        node.distance + node.length - 10.0 * EPSILON :
+        node.distance + 10.0 * EPSILON;
+  }
+
+  static element::Waypoint MakeWaypoint(const LaneGraph::Node &node, double s) {
+    return element::Waypoint{node.road_id, node.section_id, node.lane_id, s};
+  }
+
+  // ===========================================================================
+  // -- Lane change permissions ------------------------------------------------
+  // ===========================================================================
+
+  // Same rules as client::Waypoint::GetLaneChange, the "Increase" flag of the
+  // marking means right for lanes with negative id.
+
+  static uint8_t SwapLaneChange(uint8_t lane_change) {
+    return static_cast<uint8_t>(((lane_change & 0x01u) << 1u) | ((lane_change & 0x02u) >> 1u));
+  }
+
+  static bool CanChangeLane(const Map &map, const element::Waypoint &waypoint, bool right) {
+    constexpr uint8_t RIGHT = 0x01u;
+    constexpr uint8_t LEFT = 0x02u;
+    const auto records = map.GetMarkRecord(waypoint);
+    const RoadInfoMarkRecord *record = right ? records.first : records.second;
+    uint8_t lane_change = record != nullptr ?
+        static_cast<uint8_t>(record->GetLaneChange()) :
+        static_cast<uint8_t>(RoadInfoMarkRecord::LaneChange::Both);
+    const auto lane_id = right ?
+        waypoint.lane_id :
+        (waypoint.lane_id > 0 ? waypoint.lane_id - 1 : waypoint.lane_id + 1);
+    if (lane_id > 0) {
+      lane_change = SwapLaneChange(lane_change);
+    }
+    return (lane_change & (right ? RIGHT : LEFT)) != 0u;
+  }
+
+  // ===========================================================================
+  // -- RoutePlanner -----------------------------------------------------------
+  // ===========================================================================
+
+  RoutePlanner::RoutePlanner(const Map &map)
+    : _map(map),
+      _graph(map.GetLaneGraph()) {
+    const auto size = _graph.size();
+    _nodes.resize(size, Node{{}, {}, {}, false, false});
+    for (auto i = 0u; i < size; ++i) {
+      const auto &lane = _graph.GetNode(i);
+      auto &node = _nodes[i];
+      if (lane.lane_id == 0) {
+        continue;
+      }
+      const auto start = MakeWaypoint(lane, GetStartS(lane));
+      node.drivable = (static_cast<uint32_t>(_map.GetLaneType(start)) &
+          static_cast<uint32_t>(Lane::LaneType::Driving)) > 0;
+      if (!node.drivable) {
+        continue;
+      }
+      node.junction = _map.IsJunction(lane.road_id);
+      const auto entry = _map.ComputeTransform(start);
+      const auto exit = _map.ComputeTransform(MakeWaypoint(lane, GetEndS(lane)));
+      node.entry_location = entry.location;
+      node.entry_direction = entry.GetForwardVector();
+      node.exit_direction = exit.GetForwardVector();
+    }
+
+    _offsets.reserve(size + 1u);
+    _offsets.emplace_back(0u);
+    for (auto i = 0u; i < size; ++i) {
+      if (_nodes[i].drivable) {
+        for (auto next : _graph.GetSuccessors(i)) {
+          if (_nodes[next].drivable) {
+            _edges.emplace_back(Edge{
+                next,
+                static_cast<float>(_graph.GetNode(next).length),
+                RoadOption::LaneFollow});
+          }
+        }
+        // Lane changes are not allowed inside junctions.
+        const auto &lane = _graph.GetNode(i);
+        if (!_nodes[i].junction) {
+          const auto middle = MakeWaypoint(lane, lane.distance + 0.5 * lane.length);
+          for (bool right : {false, true}) {
+            const auto neighbour = right ? _map.GetRight(middle) : _map.GetLeft(middle);
+            if (!neighbour.has_value() ||
+                IsForward(neighbour->lane_id) != IsForward(lane.lane_id) ||
+                !CanChangeLane(_map, middle, right)) {
+              continue;
+            }
+            const auto index = _graph.GetIndex(_map.GetLane(*neighbour));
+            if (index != LaneGraph::INVALID_INDEX && _nodes[index].drivable) {
+              _edges.emplace_back(Edge{
+                  index,
+                  LANE_CHANGE_COST,
+                  right ? RoadOption::ChangeLaneRight : RoadOption::ChangeLaneLeft});
+            }
+          }
+        }
+      }
+      _offsets.emplace_back(static_cast<uint32_t>(_edges.size()));
+    }
+  }
+
+  RoutePlanner::Route RoutePlanner::TraceRoute(
+      const geom::Location &origin,
+      const geom::Location &destination,
+      const double sampling_resolution) const {
+    const auto from = _map.GetClosestWaypointOnRoad(origin);
+    const auto to = _map.GetClosestWaypointOnRoad(destination);
+    if (!from.has_value() || !to.has_value()) {
+      return {};
+    }
+    return TraceRoute(*from, *to, sampling_resolution);
+  }
+
+  RoutePlanner::Route RoutePlanner::TraceRoute(
+      const Waypoint origin,
+      const Waypoint destination,
+      const double sampling_resolution) const {
+    RELEASE_ASSERT(sampling_resolution > 0.0);
+    CARLA_PROFILE_SPAN(map, trace_route);
+    Route route;
+    const auto path = Search(origin, destination);
+    if (!path.empty()) {
+      Sample(path, origin, destination, sampling_resolution, route);
+    }
+    return route;
+  }
+
+  double RoutePlanner::GetDistanceToEnd(const LaneIndex lane, const double s) const {
+    const auto &node = _graph.GetNode(lane);
+    const double relative_s = s - node.distance;
+    return std::max(0.0, IsForward(node.lane_id) ? node.length - relative_s : relative_s);
+  }
+
+  std::vector<RoutePlanner::Step> RoutePlanner::Search(
+      const Waypoint &origin,
+      const Waypoint &destination) const {
+    const auto source = _graph.GetIndex(_map.GetLane(origin));
+    const auto target = _graph.GetIndex(_map.GetLane(destination));
+    if (source == LaneGraph::INVALID_INDEX || target == LaneGraph::INVALID_INDEX ||
+        !_nodes[source].drivable || !_nodes[target].drivable) {
+      return {};
+    }
+    const auto target_location = _map.ComputeTransform(destination).location;
+    const bool forward = IsForward(origin.lane_id);
+    // Whether the destination is ahead of the origin along the origin's lane,
+    // or along a parallel lane of the same section.
+    const bool destination_ahead =
+        (origin.road_id == destination.road_id) &&
+        (origin.section_id == destination.section_id) &&
+        (IsForward(destination.lane_id) == forward) &&
+        (forward ? destination.s >= origin.s : destination.s <= origin.s);
+    const double destination_to_end = GetDistanceToEnd(target, destination.s);
+
+    // Cost is the distance driven up to the end of each lane.
+    constexpr auto INF = std::numeric_limits<double>::infinity();
+    const auto size = _graph.size();
+    std::vector<double> cost(size, INF);
+    std::vector<LaneIndex> parent(size, LaneGraph::INVALID_INDEX);
+    std::vector<RoadOption> option(size, RoadOption::Void);
+
+    // A lower bound of the total cost of any route through @a lane, the
+    // straight distance from the start of the lane to the destination.
+    auto estimate = [&](LaneIndex lane) {
+      const double at_start = cost[lane] - _graph.GetNode(lane).length;
+      return at_start + geom::Math::Distance(_nodes[lane].entry_location, target_location);
+    };
+
+    double best_total = INF;
+    LaneIndex best_previous = LaneGraph::INVALID_INDEX;
+    RoadOption best_option = RoadOption::Void;
+    if (source == target && destination_ahead) {
+      best_total = std::abs(destination.s - origin.s);
+    }
+
+    using Entry = std::pair<double, LaneIndex>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    cost[source] = GetDistanceToEnd(source, origin.s);
+    open.emplace(estimate(source), source);
+
+    while (!open.empty()) {
+      const auto top = open.top();
+      open.pop();
+      const auto current = top.second;
+      if (top.first >= best_total) {
+        break;
+      }
+      if (top.first > estimate(current)) {
+        continue; // Outdated entry.
+      }
+      for (auto i = _offsets[current]; i < _offsets[current + 1u]; ++i) {
+        const auto &edge = _edges[i];
+        if (edge.to == target) {
+          // Complete the route stopping at the destination.
+          const bool lane_change = edge.option != RoadOption::LaneFollow;
+          if (!lane_change || current != source || destination_ahead) {
+            const double total = cost[current] + edge.cost - destination_to_end;
+            if (total < best_total) {
+              best_total = total;
+              best_previous = current;
+              best_option = edge.option;
+            }
+          }
+        }
+        const double candidate = cost[current] + edge.cost;
+        if (candidate < cost[edge.to]) {
+          cost[edge.to] = candidate;
+          parent[edge.to] = current;
+          option[edge.to] = edge.option;
+          open.emplace(estimate(edge.to), edge.to);
+        }
+      }
+    }
+
+    if (best_total == INF) {
+      return {};
+    }
+    std::vector<Step> path;
+    if (best_previous == LaneGraph::INVALID_INDEX) {
+      path.emplace_back(Step{source, RoadOption::Void});
+      return path;
+    }
+    path.emplace_back(Step{target, best_option});
+    for (auto lane = best_previous; lane != LaneGraph::INVALID_INDEX; lane = parent[lane]) {
+      path.emplace_back(Step{lane, option[lane]});
+      if (lane == source) {
+        break;
+      }
+    }
+    RELEASE_ASSERT(path.back().lane == source);
+    path.back().option = RoadOption::Void;
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+  RoadOption RoutePlanner::GetTurnDecision(const LaneIndex first, const LaneIndex last) const {
+    const auto &cv = _nodes[first].entry_direction;
+    const auto &nv = _nodes[last].exit_direction;
+    const float norms = cv.Length() * nv.Length();
+    if (norms <= 0.0f) {
+      return RoadOption::LaneFollow;
+    }
+    const float cosine = std::max(-1.0f, std::min(1.0f, geom::Math::Dot(cv, nv) / norms));
+    if (geom::Math::ToDegrees(std::acos(cosine)) < STRAIGHT_THRESHOLD) {
+      return RoadOption::Straight;
+    }
+    const float cross = cv.x * nv.y - cv.y * nv.x;
+    return cross < 0.0f ? RoadOption::Left : RoadOption::Right;
+  }
+
+  void RoutePlanner::Sample(
+      const std::vector<Step> &path,
+      const Waypoint &origin,
+      const Waypoint &destination,
+      const double sampling_resolution,
+      Route &route) const {
+    double entry_s = origin.s;
+    for (auto i = 0u; i < path.size(); ++i) {
+      const auto lane = path[i].lane;
+      const auto &node = _graph.GetNode(lane);
+      const bool last = (i + 1u == path.size());
+      const bool changes_lane = !last && path[i + 1u].option != RoadOption::LaneFollow;
+      if (i > 0u && path[i].option == RoadOption::LaneFollow) {
+        entry_s = GetStartS(node);
+      }
+
+      // Where we leave this lane, for lane changes halfway to the end of the
+      // lane or to the destination.
+      double exit_s;
+      if (last) {
+        exit_s = destination.s;
+      } else if (changes_lane) {
+        const double end = (i + 2u == path.size()) ? destination.s : GetEndS(node);
+        exit_s = 0.5 * (entry_s + end);
+      } else {
+        exit_s = GetEndS(node);
+      }
+
+      // The maneuver at a junction spans all its consecutive junction lanes.
+      RoadOption lane_option = RoadOption::LaneFollow;
+      if (_nodes[lane].junction) {
+        auto run_end = i;
+        while (run_end + 1u < path.size() && _nodes[path[run_end + 1u].lane].junction) {
+          ++run_end;
+        }
+        auto run_begin = i;
+        while (run_begin > 0u && _nodes[path[run_begin - 1u].lane].junction) {
+          --run_begin;
+        }
+        lane_option = GetTurnDecision(path[run_begin].lane, path[run_end].lane);
+      }
+
+      const double direction = IsForward(node.lane_id) ? 1.0 : -1.0;
+      const double length = std::max(0.0, direction * (exit_s - entry_s));
+      // The route starts at the origin even if it is already at the end of its
+      // lane.
+      if (i == 0u && length <= 0.0 && !last) {
+        route.emplace_back(origin, lane_option);
+      }
+      for (double travelled = 0.0; travelled < length; travelled += sampling_resolution) {
+        const auto point_option = (travelled == 0.0 && i > 0u && path[i].option != RoadOption::LaneFollow) ?
+            path[i].option :
+            lane_option;
+        route.emplace_back(MakeWaypoint(node, entry_s + direction * travelled), point_option);
+      }
+      if (last) {
+        route.emplace_back(destination, lane_option);
+      }
+      entry_s = exit_s;
+    }
+  }
+
+} // namespace road
+} // namespace carla
@@ -0,0 +1,131 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/geom/Location.h"
+#include "carla/geom/Vector3D.h"
+#include "carla/road/LaneGraph.h"
+#include "carla/road/element/Waypoint.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Map;
+
+  /// High-level maneuver associated to each waypoint of a route. The values
+  /// match the RoadOption of the Python agents.
+  enum class RoadOption : int32_t {
+    Void            = -1,
+    Left            =  1,
+    Right           =  2,
+    Straight        =  3,
+    LaneFollow      =  4,
+    ChangeLaneLeft  =  5,
+    ChangeLaneRight =  6
+  };
+
+  /// Global route planner over the driving lanes of a Map.
+  ///
+  /// Routes are searched with A* over the lane graph of the map, following
+  /// lane links and changing lanes where the lane markings allow it. The
+  /// graph is built once on construction, queries do not modify the planner
+  /// and can be run concurrently.
+  class RoutePlanner : private NonCopyable {
+  public:
+
+    using Waypoint = element::Waypoint;
+
+    using Route = std::vector<std::pair<Waypoint, RoadOption>>;
+
+    /// Cost in meters added to the route length by each lane change, avoids
+    /// routes that zig-zag between lanes of equal length.
+    static constexpr float LANE_CHANGE_COST = 5.0f;
+
+    /// Junction lanes whose heading changes less than this many degrees are
+    /// considered straight.
+    static constexpr float STRAIGHT_THRESHOLD = 35.0f;
+
+    /// @a map must outlive the planner.
+    explicit RoutePlanner(const Map &map);
+
+    /// Shortest route between the closest driving lanes to @a origin and
+    /// @a destination, sampled every @a sampling_resolution meters. Returns an
+    /// empty route if there is no path.
+    Route TraceRoute(
+        const geom::Location &origin,
+        const geom::Location &destination,
+        double sampling_resolution = 2.0) const;
+
+    /// @copydoc TraceRoute
+    Route TraceRoute(
+        Waypoint origin,
+        Waypoint destination,
+        double sampling_resolution = 2.0) const;
+
+  private:
+
+    using LaneIndex = LaneGraph::LaneIndex;
+
+    struct Edge {
+      LaneIndex to;
+      /// Length of the lane reached for lane links, LANE_CHANGE_COST for lane
+      /// changes.
+      float cost;
+      RoadOption option;
+    };
+
+    struct Node {
+      /// Location and forward vector at the start of the lane.
+      geom::Location entry_location;
+      geom::Vector3D entry_direction;
+      /// Forward vector at the end of the lane.
+      geom::Vector3D exit_direction;
+      bool drivable;
+      bool junction;
+    };
+
+    struct Step {
+      LaneIndex lane;
+      RoadOption option;
+    };
+
+    /// Returns the lanes to traverse from @a origin to @a destination, empty if
+    /// unreachable.
+    std::vector<Step> Search(const Waypoint &origin, const Waypoint &destination) const;
+
+    void Sample(
+        const std::vector<Step> &path,
+        const Waypoint &origin,
+        const Waypoint &destination,
+        double sampling_resolution,
+        Route &route) const;
+
+    RoadOption GetTurnDecision(LaneIndex first, LaneIndex last) const;
+
+    /// Distance along the lane from @a s to the end of the lane.
+    double GetDistanceToEnd(LaneIndex lane, double s) const;
+
+    const Map &_map;
+
+    const LaneGraph &_graph;
+
+    std::vector<Node> _nodes;
+
+    /// Outgoing edges of lane i are _edges[_offsets[i]] up to
+    /// _edges[_offsets[i + 1]].
+    std::vector<uint32_t> _offsets;
+
+    std::vector<Edge> _edges;
+  };
+
+} // namespace road
+} // namespace carla
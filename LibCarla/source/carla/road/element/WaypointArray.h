@@ -0,0 +1,58 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/geom/Transform.h"
+#include "carla/road/RoadTypes.h"
+#include "carla/road/element/Waypoint.h"
+
+#include <vector>
+
+namespace carla {
+namespace road {
+namespace element {
+
+  /// A list of waypoints and their transforms stored as a structure of
+  /// arrays, each field of the waypoints is contiguous in memory.
+  struct WaypointArray {
+
+    std::vector<RoadId> road_id;
+
+    std::vector<SectionId> section_id;
+
+    std::vector<LaneId> lane_id;
+
+    std::vector<double> s;
+
+    std::vector<geom::Transform> transform;
+
+    size_t size() const {
+      return s.size();
+    }
+
+    bool empty() const {
+      return s.empty();
+    }
+
+    void resize(size_t count) {
+      road_id.resize(count);
+      section_id.resize(count);
+      lane_id.resize(count);
+      s.resize(count);
+      transform.resize(count);
+    }
+
+    Waypoint GetWaypoint(size_t index) const {
+      DEBUG_ASSERT(index < size());
+      return Waypoint{road_id[index], section_id[index], lane_id[index], s[index]};
+    }
+  };
+
+} // namespace element
+} // namespace road
+} // namespace carla
@@ -7,8 +7,16 @@
 #pragma once
 
 #include "carla/rpc/Metadata.h"
+#include "carla/rpc/MethodTable.h"
 
 #include <rpc/client.h>
+#include <rpc/rpc_error.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 
 namespace carla {
 namespace rpc {
@@ -28,19 +36,82 @@ namespace rpc {
       return _client.get_timeout();
     }
 
+    /// Whether to call the functions by their numeric id when the server
+    /// provides a MethodTable, enabled by default.
+    void set_method_ids_enabled(bool enabled) {
+      _method_ids_enabled = enabled;
+    }
+
+    bool get_method_ids_enabled() const {
+      return _method_ids_enabled;
+    }
+
     template <typename... Args>
     auto call(const std::string &function, Args &&... args) {
-      return _client.call(function, Metadata::MakeSync(), std::forward<Args>(args)...);
+      if (!_method_table_fetched.load(std::memory_order_acquire)) {
+        FetchMethodTable();
+      }
+      return _client.call(GetMethodName(function), Metadata::MakeSync(), std::forward<Args>(args)...);
     }
 
     template <typename... Args>
     void async_call(const std::string &function, Args &&... args) {
-      _client.async_call(function, Metadata::MakeAsync(), std::forward<Args>(args)...);
+      _client.async_call(GetMethodName(function), Metadata::MakeAsync(), std::forward<Args>(args)...);
+    }
+
+    /// Send the call without waiting for the response, the server still
+    /// responds as with call. Many requests can be in flight at the same time
+    /// on the same connection.
+    template <typename... Args>
+    std::future<clmdep_msgpack::object_handle> async_request(
+        const std::string &function,
+        Args &&... args) {
+      return _client.async_call(GetMethodName(function), Metadata::MakeSync(), std::forward<Args>(args)...);
     }
 
   private:
 
+    /// Retrieves the method table from the server, only the synchronous calls
+    /// wait for it; until then the functions are called by name.
+    void FetchMethodTable() {
+      std::lock_guard<std::mutex> lock(_method_table_mutex);
+      if (_method_table_fetched.load(std::memory_order_relaxed)) {
+        return;
+      }
+      try {
+        auto table = _client.call(MethodTable::GetName(), Metadata::MakeSync())
+            .template as<MethodTable::table_type>();
+        for (auto &item : table) {
+          _method_aliases.emplace(std::move(item.first), MethodTable::MakeAlias(item.second));
+        }
+      } catch (const ::rpc::rpc_error &) {
+        // The server does not provide a method table, keep calling by name.
+      }
+      // On timeout the exception propagates and the table is fetched again on
+      // the next call.
+      _method_table_fetched.store(true, std::memory_order_release);
+    }
+
+    const std::string &GetMethodName(const std::string &function) const {
+      // The aliases are not modified once the table is fetched.
+      if (_method_ids_enabled && _method_table_fetched.load(std::memory_order_acquire)) {
+        auto it = _method_aliases.find(function);
+        if (it != _method_aliases.end()) {
+          return it->second;
+        }
+      }
+      return function;
+    }
+
     ::rpc::client _client;
+
+    std::atomic_bool _method_ids_enabled{true};
+
+    std::atomic_bool _method_table_fetched{false};
+
+    std::mutex _method_table_mutex;
+
+    std::unordered_map<std::string, std::string> _method_aliases;
   };
 
 } // namespace rpc
@@ -0,0 +1,171 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/MsgPack.h"
+#include "carla/geom/Transform.h"
+#include "carla/rpc/ActorId.h"
+#include "carla/rpc/VehicleControl.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+namespace detail {
+
+#pragma pack(push, 1)
+  struct PackedVehicleControl {
+    float throttle;
+    float steer;
+    float brake;
+    int32_t gear;
+    uint8_t hand_brake;
+    uint8_t reverse;
+    uint8_t manual_gear_shift;
+  };
+
+  struct PackedTransform {
+    float x;
+    float y;
+    float z;
+    float pitch;
+    float yaw;
+    float roll;
+  };
+#pragma pack(pop)
+
+  static_assert(sizeof(PackedVehicleControl) == 19u, "Invalid PackedVehicleControl size");
+  static_assert(sizeof(PackedTransform) == 24u, "Invalid PackedTransform size");
+
+  inline PackedVehicleControl Pack(const VehicleControl &control) {
+    return {
+        control.throttle,
+        control.steer,
+        control.brake,
+        control.gear,
+        static_cast<uint8_t>(control.hand_brake),
+        static_cast<uint8_t>(control.reverse),
+        static_cast<uint8_t>(control.manual_gear_shift)};
+  }
+
+  inline VehicleControl Unpack(const PackedVehicleControl &control) {
+    return {
+        control.throttle,
+        control.steer,
+        control.brake,
+        control.hand_brake != 0u,
+        control.reverse != 0u,
+        control.manual_gear_shift != 0u,
+        control.gear};
+  }
+
+  inline PackedTransform Pack(const geom::Transform &transform) {
+    return {
+        transform.location.x,
+        transform.location.y,
+        transform.location.z,
+        transform.rotation.pitch,
+        transform.rotation.yaw,
+        transform.rotation.roll};
+  }
+
+  inline geom::Transform Unpack(const PackedTransform &transform) {
+    return {
+        geom::Location{transform.x, transform.y, transform.z},
+        geom::Rotation{transform.pitch, transform.yaw, transform.roll}};
+  }
+
+} // namespace detail
+
+  /// The same command applied to many actors, stored as two contiguous
+  /// binary arrays: the actor ids and the packed values. It serializes as two
+  /// binary blobs, the cost does not grow with the number of fields of each
+  /// command as it does with a list of rpc::Command.
+  template <typename T, typename PackedT>
+  class CommandBatch {
+    static_assert(std::is_trivially_copyable<PackedT>::value, "Packed type must be trivially copyable");
+  public:
+
+    using value_type = T;
+
+    CommandBatch() = default;
+
+    void reserve(size_t count) {
+      _actors.reserve(count * sizeof(ActorId));
+      _values.reserve(count * sizeof(PackedT));
+    }
+
+    size_t size() const {
+      return _actors.size() / sizeof(ActorId);
+    }
+
+    bool empty() const {
+      return _actors.empty();
+    }
+
+    void clear() {
+      _actors.clear();
+      _values.clear();
+    }
+
+    void Add(ActorId actor, const T &value) {
+      Append(_actors, actor);
+      Append(_values, detail::Pack(value));
+    }
+
+    ActorId GetActor(size_t index) const {
+      DEBUG_ASSERT(index < size());
+      return Read<ActorId>(_actors, index);
+    }
+
+    T GetValue(size_t index) const {
+      DEBUG_ASSERT(index < size());
+      return detail::Unpack(Read<PackedT>(_values, index));
+    }
+
+    /// Whether the sizes of the arrays match, a batch received from the
+    /// network must be validated before reading from it.
+    bool IsValid() const {
+      return
+          (_actors.size() % sizeof(ActorId) == 0u) &&
+          (_values.size() == size() * sizeof(PackedT));
+    }
+
+    MSGPACK_DEFINE_ARRAY(_actors, _values);
+
+  private:
+
+    template <typename U>
+    static void Append(std::vector<unsigned char> &data, const U &value) {
+      const auto offset = data.size();
+      data.resize(offset + sizeof(U));
+      std::memcpy(data.data() + offset, &value, sizeof(U));
+    }
+
+    template <typename U>
+    static U Read(const std::vector<unsigned char> &data, size_t index) {
+      U value;
+      std::memcpy(&value, data.data() + index * sizeof(U), sizeof(U));
+      return value;
+    }
+
+    std::vector<unsigned char> _actors;
+
+    std::vector<unsigned char> _values;
+  };
+
+  using VehicleControlBatch = CommandBatch<VehicleControl, detail::PackedVehicleControl>;
+
+  using TransformBatch = CommandBatch<geom::Transform, detail::PackedTransform>;
+
+} // namespace rpc
+} // namespace carla
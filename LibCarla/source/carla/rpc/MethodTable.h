@@ -0,0 +1,45 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+  /// Numeric ids of the functions bound to an RPC server.
+  ///
+  /// The server binds every function both by its name and by a short alias
+  /// derived from a numeric id, and publishes the table of ids through the
+  /// function named by GetName(). Clients fetch the table once and call the
+  /// aliases afterwards, so each request carries and hashes a couple of bytes
+  /// instead of the full function name. Servers without the table are still
+  /// called by name.
+  class MethodTable {
+  public:
+
+    using method_id = uint32_t;
+
+    using table_type = std::vector<std::pair<std::string, method_id>>;
+
+    /// Name of the function returning the table.
+    static const char *GetName() {
+      return "_method_table";
+    }
+
+    /// Name under which the function with @a id is bound.
+    static std::string MakeAlias(method_id id) {
+      // '#' never appears in a function name, so aliases cannot collide.
+      return '#' + std::to_string(id);
+    }
+  };
+
+} // namespace rpc
+} // namespace carla
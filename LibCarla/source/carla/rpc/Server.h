@@ -9,6 +9,7 @@
 #include "carla/MoveHandler.h"
 #include "carla/Time.h"
 #include "carla/rpc/Metadata.h"
+#include "carla/rpc/MethodTable.h"
 #include "carla/rpc/Response.h"
 
 #include <boost/asio/io_context.hpp>
@@ -34,6 +35,9 @@ namespace rpc {
   /// Functions that are bind using `BindAsync` will run asynchronously in the
   /// worker threads. Functions that are bind using `BindSync` will run within
   /// `SyncRunFor` function.
+  ///
+  /// Every function is bound both by name and by its id in the MethodTable
+  /// published by the server.
   class Server {
   public:
 
@@ -67,8 +71,14 @@ namespace rpc {
 
   private:
 
+    template <typename WrappedT>
+    void Bind(const std::string &name, WrappedT &&wrapped);
+
     boost::asio::io_context _sync_io_context;
 
+    /// Only modified while binding, before the worker threads start.
+    MethodTable::table_type _method_table;
+
     ::rpc::server _server;
   };
 
@@ -146,22 +156,30 @@ namespace detail {
   inline Server::Server(Args && ... args)
     : _server(std::forward<Args>(args) ...) {
     _server.suppress_exceptions(true);
+    _server.bind(
+        MethodTable::GetName(),
+        detail::FunctionWrapper<MethodTable::table_type (*)()>::WrapAsyncCall(
+            [this]() { return _method_table; }));
   }
 
   template <typename FunctorT>
   inline void Server::BindSync(const std::string &name, FunctorT &&functor) {
     using Wrapper = detail::FunctionWrapper<FunctorT>;
-    _server.bind(
-        name,
-        Wrapper::WrapSyncCall(_sync_io_context, std::forward<FunctorT>(functor)));
+    Bind(name, Wrapper::WrapSyncCall(_sync_io_context, std::forward<FunctorT>(functor)));
   }
 
   template <typename FunctorT>
   inline void Server::BindAsync(const std::string &name, FunctorT &&functor) {
     using Wrapper = detail::FunctionWrapper<FunctorT>;
-    _server.bind(
-        name,
-        Wrapper::WrapAsyncCall(std::forward<FunctorT>(functor)));
+    Bind(name, Wrapper::WrapAsyncCall(std::forward<FunctorT>(functor)));
+  }
+
+  template <typename WrappedT>
+  inline void Server::Bind(const std::string &name, WrappedT &&wrapped) {
+    const auto id = static_cast<MethodTable::method_id>(_method_table.size());
+    _server.bind(name, wrapped);
+    _server.bind(MethodTable::MakeAlias(id), std::forward<WrappedT>(wrapped));
+    _method_table.emplace_back(name, id);
   }
 
 } // namespace rpc
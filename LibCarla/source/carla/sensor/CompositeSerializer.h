@@ -7,6 +7,7 @@
 #pragma once
 
 #include "carla/Buffer.h"
+#include "carla/Debug.h"
 #include "carla/Memory.h"
 #include "carla/sensor/CompileTimeTypeMap.h"
 #include "carla/sensor/RawData.h"
@@ -42,31 +43,35 @@ namespace sensor {
     /// serializer that generated the Buffer.
     static interpreted_type Deserialize(Buffer &&data);
 
+    /// Deserializes a Buffer generated by the serializer registered for the
+    /// given @a Sensor type. Skips the runtime dispatch, use it when the type
+    /// of the sensor that sent the data is already known.
+    template <typename Sensor>
+    static interpreted_type Deserialize(Buffer &&data);
+
   private:
 
-    template <size_t Index, typename Data>
-    static interpreted_type Deserialize_impl(Data &&data) {
+    using deserialize_function_type = interpreted_type (*)(RawData &&);
+
+    template <size_t Index>
+    static interpreted_type Deserialize_impl(RawData &&data) {
       using Serializer = typename Super::template get_by_index<Index>::type;
-      return Serializer::Deserialize(std::forward<Data>(data));
+      return Serializer::Deserialize(std::move(data));
     }
 
-    template <typename Data, size_t... Is>
-    static interpreted_type Deserialize_impl(size_t i, Data &&data, std::index_sequence<Is...>) {
-      // This function is equivalent to creating a switch statement with a case
-      // for each element in the map, the compiler should be able to optimize it
-      // into a jump table. See https://stackoverflow.com/a/46282159/5308925.
-      interpreted_type result;
-      std::initializer_list<int> ({
-          (i == Is ? (result = Deserialize_impl<Is>(std::forward<Data>(data))), 0 : 0)...
-      });
-      return result;
+    template <size_t... Is>
+    static interpreted_type Deserialize_impl(size_t i, RawData &&data, std::index_sequence<Is...>) {
+      // Table with the "Deserialize" function of each serializer, generated at
+      // compile-time, so dispatching costs a single indirect call regardless
+      // of the number of sensors registered.
+      static constexpr deserialize_function_type table[] = {&Deserialize_impl<Is>...};
+      return i < sizeof...(Is) ? table[i](std::move(data)) : interpreted_type{};
     }
 
-    template <typename Data>
-    static interpreted_type Deserialize(size_t index, Data &&data) {
+    static interpreted_type Deserialize(size_t index, RawData &&data) {
       return Deserialize_impl(
           index,
-          std::forward<Data>(data),
+          std::move(data),
           std::make_index_sequence<Super::size()>());
     }
   };
@@ -91,5 +96,16 @@ namespace sensor {
     return Deserialize(index, std::move(message));
   }
 
+  template <typename... Items>
+  template <typename Sensor>
+  inline typename CompositeSerializer<Items...>::interpreted_type
+  CompositeSerializer<Items...>::Deserialize(Buffer &&data) {
+    using TheSensor = typename std::remove_const<Sensor>::type;
+    using Serializer = typename Super::template get<TheSensor*>::type;
+    RawData message{std::move(data)};
+    DEBUG_ASSERT(message.GetSensorTypeId() == Super::template get<TheSensor*>::index);
+    return Serializer::Deserialize(std::move(message));
+  }
+
 } // namespace sensor
 } // namespace carla
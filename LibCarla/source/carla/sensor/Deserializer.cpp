@@ -6,12 +6,69 @@
 
 #include "carla/sensor/Deserializer.h"
 
+#include "carla/Exception.h"
 #include "carla/sensor/SensorRegistry.h"
+#include "carla/sensor/s11n/PayloadCompression.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <cstring>
+#include <stdexcept>
 
 namespace carla {
 namespace sensor {
 
+  static Buffer DecompressPayload(Buffer &&message, uint8_t compression) {
+    using Header = s11n::SensorHeaderSerializer;
+    constexpr auto offset = Header::header_offset;
+    if (message.size() < offset) {
+      throw_exception(std::runtime_error("invalid sensor message: header too small"));
+    }
+    Buffer result;
+    result.copy_from(message.data(), static_cast<Buffer::size_type>(offset));
+    result = s11n::PayloadCompression::Decompress(
+        static_cast<s11n::CompressionType>(compression),
+        message.data() + offset,
+        message.size() - offset,
+        std::move(result),
+        offset);
+    // Clear the compression so the sensor type is the registry index again.
+    Header::SetCompression(result, 0u);
+    return result;
+  }
+
+  /// Remove the timing trailer at the end of @a message.
+  static Deserializer::Timing PopTiming(Buffer &message) {
+    using Header = s11n::SensorHeaderSerializer;
+    constexpr auto size = sizeof(Deserializer::Timing);
+    if (message.size() < Header::header_offset + size) {
+      throw_exception(std::runtime_error("invalid sensor message: timing missing"));
+    }
+    Deserializer::Timing timing;
+    std::memcpy(&timing, message.data() + message.size() - size, size);
+    message.resize(message.size() - size);
+    // Clear the flag so the sensor type is the registry index again.
+    Header::SetTiming(message, false);
+    return timing;
+  }
+
   SharedPtr<SensorData> Deserializer::Deserialize(Buffer &&buffer) {
+    boost::optional<Timing> timing;
+    return Deserialize(std::move(buffer), timing);
+  }
+
+  SharedPtr<SensorData> Deserializer::Deserialize(
+      Buffer &&buffer,
+      boost::optional<Timing> &timing) {
+    const auto &header = s11n::SensorHeaderSerializer::Deserialize(buffer);
+    const auto compression = s11n::SensorHeaderSerializer::GetCompression(header);
+    if (s11n::SensorHeaderSerializer::HasTiming(header)) {
+      timing = PopTiming(buffer);
+    } else {
+      timing = boost::none;
+    }
+    if (compression != 0u) {
+      return SensorRegistry::Deserialize(DecompressPayload(std::move(buffer), compression));
+    }
     return SensorRegistry::Deserialize(std::move(buffer));
   }
 
@@ -8,6 +8,9 @@
 
 #include "carla/Buffer.h"
 #include "carla/Memory.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <boost/optional.hpp>
 
 namespace carla {
 namespace sensor {
@@ -22,7 +25,13 @@ namespace sensor {
   class Deserializer {
   public:
 
+    using Timing = s11n::SensorHeaderSerializer::Timing;
+
     static SharedPtr<SensorData> Deserialize(Buffer &&buffer);
+
+    /// Same as above, additionally returns in @a timing the timestamps of the
+    /// simulator if the message carries them.
+    static SharedPtr<SensorData> Deserialize(Buffer &&buffer, boost::optional<Timing> &timing);
   };
 
 } // namespace sensor
@@ -0,0 +1,95 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/profiler/Metrics.h"
+#include "carla/sensor/s11n/SensorHeaderSerializer.h"
+
+#include <array>
+#include <cstdint>
+
+namespace carla {
+namespace sensor {
+
+  /// Stages of the delivery of a sensor message, from the measurement in the
+  /// simulator to the end of the user callback.
+  enum class LatencyStage : uint8_t {
+    /// Serialization (and compression) in the simulator.
+    Server,
+    /// From the simulator's stream to the client's socket. Includes the
+    /// offset between the clocks of both hosts.
+    Network,
+    /// Waiting for a worker thread of the streaming client.
+    Queue,
+    /// Deserialization (and decompression) in the client.
+    Deserialize,
+    /// Execution of the user callback.
+    Callback,
+    /// From the measurement in the simulator to the end of the user callback.
+    Total,
+
+    SIZE
+  };
+
+  /// Timestamps of a sensor message along its way from the simulator to the
+  /// user callback. Nanoseconds since epoch, see SensorHeaderSerializer::Now.
+  struct MessageTimestamps {
+    s11n::SensorHeaderSerializer::Timing server;
+    /// When the message was read from the socket.
+    uint64_t receive;
+    /// When a worker thread picked up the message.
+    uint64_t dispatch;
+    /// When the message was deserialized.
+    uint64_t deserialize;
+    /// When the user callback returned.
+    uint64_t callback;
+  };
+
+  /// Latency histograms of the messages received from a sensor, in
+  /// microseconds. Only messages carrying the timing trailer are recorded.
+  class LatencyStats : private NonCopyable {
+  public:
+
+    void Record(const MessageTimestamps &timestamps) {
+      const auto &server = timestamps.server;
+      Add(LatencyStage::Server, server.enqueue_time, server.send_time);
+      Add(LatencyStage::Network, server.send_time, timestamps.receive);
+      Add(LatencyStage::Queue, timestamps.receive, timestamps.dispatch);
+      Add(LatencyStage::Deserialize, timestamps.dispatch, timestamps.deserialize);
+      Add(LatencyStage::Callback, timestamps.deserialize, timestamps.callback);
+      Add(LatencyStage::Total, server.enqueue_time, timestamps.callback);
+    }
+
+    const profiler::HdrHistogram &GetHistogram(LatencyStage stage) const {
+      return _histograms[static_cast<size_t>(stage)];
+    }
+
+    /// Number of messages recorded.
+    uint64_t GetCount() const {
+      return GetHistogram(LatencyStage::Total).GetCount();
+    }
+
+    void Clear() {
+      for (auto &histogram : _histograms) {
+        histogram.Clear();
+      }
+    }
+
+  private:
+
+    /// Negative intervals, only possible across hosts whose clocks are not
+    /// synchronized, are recorded as zero.
+    void Add(LatencyStage stage, uint64_t begin, uint64_t end) {
+      _histograms[static_cast<size_t>(stage)].Add(end > begin ? (end - begin) / 1000u : 0u);
+    }
+
+    std::array<profiler::HdrHistogram, static_cast<size_t>(LatencyStage::SIZE)> _histograms;
+  };
+
+} // namespace sensor
+} // namespace carla
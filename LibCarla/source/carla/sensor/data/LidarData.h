@@ -63,6 +63,13 @@ namespace data {
           "property float32 I";
       }
 
+      void WritePcdHeaderInfo(std::ostream& out) const{
+        out << "FIELDS x y z intensity\n" \
+          "SIZE 4 4 4 4\n" \
+          "TYPE F F F F\n" \
+          "COUNT 1 1 1 1";
+      }
+
       void WriteDetection(std::ostream& out) const{
         out << point.x << ' ' << point.y << ' ' << point.z << ' ' << intensity;
       }
@@ -80,21 +87,22 @@ namespace data {
     ~LidarData() = default;
 
     virtual void ResetMemory(std::vector<uint32_t> points_per_channel) {
-      DEBUG_ASSERT(GetChannelCount() > points_per_channel.size());
+      DEBUG_ASSERT(GetChannelCount() == points_per_channel.size());
       std::memset(_header.data() + Index::SIZE, 0, sizeof(uint32_t) * GetChannelCount());
 
       uint32_t total_points = static_cast<uint32_t>(
           std::accumulate(points_per_channel.begin(), points_per_channel.end(), 0));
 
-      _points.clear();
-      _points.reserve(total_points * 4);
+      ResetBuffer(total_points, 4u * sizeof(float));
     }
 
     void WritePointSync(LidarDetection &detection) {
-      _points.emplace_back(detection.point.x);
-      _points.emplace_back(detection.point.y);
-      _points.emplace_back(detection.point.z);
-      _points.emplace_back(detection.intensity);
+      const float point[4] = {
+          detection.point.x,
+          detection.point.y,
+          detection.point.z,
+          detection.intensity};
+      WriteToBuffer(point);
     }
 
     virtual void WritePointSync(SemanticLidarDetection &detection) {
@@ -103,8 +111,6 @@ namespace data {
     }
 
   private:
-    std::vector<float> _points;
-
     friend class s11n::LidarSerializer;
     friend class s11n::LidarHeaderView;
   };
@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include "carla/Buffer.h"
+#include "carla/Debug.h"
 #include "carla/rpc/Location.h"
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include <numeric>
 
@@ -46,6 +49,10 @@ namespace data {
   ///      Xn, Yn, Zn, Cos(THn), idx_n, tag_n
   ///    }
   ///
+  /// The points are written directly into a Buffer with the space for the
+  /// header reserved up front, so the buffer can be sent down the stream
+  /// without copying the points again (see PopBuffer).
+  ///
 
   #pragma pack(push, 1)
   class SemanticLidarDetection {
@@ -71,6 +78,13 @@ namespace data {
            "property uint32 ObjTag";
       }
 
+      void WritePcdHeaderInfo(std::ostream& out) const{
+        out << "FIELDS x y z CosAngle ObjIdx ObjTag\n" \
+           "SIZE 4 4 4 4 4 4\n" \
+           "TYPE F F F F U U\n" \
+           "COUNT 1 1 1 1 1 1";
+      }
+
       void WriteDetection(std::ostream& out) const{
         out << point.x << ' ' << point.y << ' ' << point.z << ' ' \
           << cos_inc_angle << ' ' << object_idx << ' ' << object_tag;
@@ -111,14 +125,13 @@ namespace data {
     }
 
     virtual void ResetMemory(std::vector<uint32_t> points_per_channel) {
-      DEBUG_ASSERT(GetChannelCount() > points_per_channel.size());
+      DEBUG_ASSERT(GetChannelCount() == points_per_channel.size());
       std::memset(_header.data() + Index::SIZE, 0, sizeof(uint32_t) * GetChannelCount());
 
       uint32_t total_points = static_cast<uint32_t>(
           std::accumulate(points_per_channel.begin(), points_per_channel.end(), 0));
 
-      _ser_points.clear();
-      _ser_points.reserve(total_points);
+      ResetBuffer(total_points, sizeof(SemanticLidarDetection));
     }
 
     virtual void WriteChannelCount(std::vector<uint32_t> points_per_channel) {
@@ -127,15 +140,70 @@ namespace data {
     }
 
     virtual void WritePointSync(SemanticLidarDetection &detection) {
-      _ser_points.emplace_back(detection);
+      WriteToBuffer(detection);
+    }
+
+    /// Number of bytes of points written since the last ResetMemory.
+    size_t GetPointsSize() const {
+      return _write_offset > GetHeaderSize() ? _write_offset - GetHeaderSize() : 0u;
+    }
+
+    /// Direct access to the points written since the last ResetMemory.
+    const unsigned char *GetPointsData() const {
+      return _buffer.empty() ? nullptr : _buffer.data() + GetHeaderSize();
+    }
+
+    /// Copy the header into the space reserved for it and return the buffer
+    /// holding the measurement. @a output (usually a buffer popped from the
+    /// pool of the stream) takes its place to hold the next measurement, this
+    /// way the points are never copied.
+    Buffer PopBuffer(Buffer &&output) {
+      const size_t header_size = GetHeaderSize();
+      if (_write_offset < header_size) {
+        ResetBuffer(0u, 0u);
+      }
+      std::memcpy(_buffer.data(), _header.data(), header_size);
+      _buffer.resize(_write_offset);
+
+      Buffer result = std::move(_buffer);
+      _buffer = std::move(output);
+      _write_offset = 0u;
+      // The points now belong to the popped buffer, sending again before
+      // writing new points produces an empty measurement.
+      std::memset(_header.data() + Index::SIZE, 0, sizeof(uint32_t) * GetChannelCount());
+      return result;
     }
 
   protected:
+
+    size_t GetHeaderSize() const {
+      return sizeof(uint32_t) * _header.size();
+    }
+
+    /// Reserve space in the buffer for the header and @a point_count points of
+    /// @a point_size bytes. Reuses the memory of the buffer if big enough.
+    void ResetBuffer(size_t point_count, size_t point_size) {
+      _write_offset = GetHeaderSize();
+      _buffer.reset(static_cast<uint64_t>(_write_offset + point_count * point_size));
+    }
+
+    template <typename T>
+    void WriteToBuffer(const T &value) {
+      if (_write_offset + sizeof(T) > _buffer.size()) {
+        // More points than reserved, grow geometrically.
+        DEBUG_ASSERT(_write_offset >= GetHeaderSize());
+        _buffer.resize(static_cast<uint64_t>(2u * _buffer.size() + sizeof(T)));
+      }
+      std::memcpy(_buffer.data() + _write_offset, &value, sizeof(T));
+      _write_offset += sizeof(T);
+    }
+
     std::vector<uint32_t> _header;
     uint32_t _max_channel_points;
 
-  private:
-    std::vector<SemanticLidarDetection> _ser_points;
+    Buffer _buffer;
+
+    size_t _write_offset = 0u;
 
   friend class s11n::SemanticLidarHeaderView;
   friend class s11n::SemanticLidarSerializer;
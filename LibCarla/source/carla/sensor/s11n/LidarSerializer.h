@@ -73,6 +73,15 @@ namespace s11n {
         const data::LidarData &data,
         Buffer &&output);
 
+    /// Moves the buffer the points were written into out of @a data, so the
+    /// points are not copied. @a output is kept by @a data for the next
+    /// measurement.
+    template <typename Sensor>
+    static Buffer Serialize(
+        const Sensor &sensor,
+        data::LidarData &data,
+        Buffer &&output);
+
     static SharedPtr<SensorData> Deserialize(RawData &&data);
   };
 
@@ -87,11 +96,19 @@ namespace s11n {
       Buffer &&output) {
     std::array<boost::asio::const_buffer, 2u> seq = {
         boost::asio::buffer(data._header),
-        boost::asio::buffer(data._points)};
+        boost::asio::buffer(data.GetPointsData(), data.GetPointsSize())};
     output.copy_from(seq);
     return std::move(output);
   }
 
+  template <typename Sensor>
+  inline Buffer LidarSerializer::Serialize(
+      const Sensor &,
+      data::LidarData &data,
+      Buffer &&output) {
+    return data.PopBuffer(std::move(output));
+  }
+
 } // namespace s11n
 } // namespace sensor
 } // namespace carla
@@ -0,0 +1,232 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/s11n/PayloadCompression.h"
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  static constexpr size_t MIN_MATCH = 4u;
+  static constexpr size_t MAX_OFFSET = 0xFFFFu;
+  static constexpr size_t HASH_BITS = 14u;
+  static constexpr size_t PIXEL_SIZE = 4u;
+
+  // The encoder does not look for matches in the last bytes, this way the last
+  // sequence always has literals and the match finder can read 4 bytes freely.
+  static constexpr size_t LAST_LITERALS = 8u;
+
+  static inline uint32_t Read32(const unsigned char *ptr) {
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+  }
+
+  static inline size_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32u - HASH_BITS);
+  }
+
+  static inline unsigned char *WriteLength(unsigned char *out, size_t length) {
+    for (; length >= 255u; length -= 255u) {
+      *out++ = 255u;
+    }
+    *out++ = static_cast<unsigned char>(length);
+    return out;
+  }
+
+  static unsigned char *WriteSequence(
+      unsigned char *out,
+      const unsigned char *literals,
+      size_t literal_count,
+      size_t offset,
+      size_t match_length) {
+    const bool has_match = match_length >= MIN_MATCH;
+    const size_t match_code = has_match ? match_length - MIN_MATCH : 0u;
+    unsigned char *token = out++;
+    *token = static_cast<unsigned char>(
+        ((literal_count < 15u ? literal_count : 15u) << 4u) |
+        (match_code < 15u ? match_code : 15u));
+    if (literal_count >= 15u) {
+      out = WriteLength(out, literal_count - 15u);
+    }
+    std::memcpy(out, literals, literal_count);
+    out += literal_count;
+    if (has_match) {
+      *out++ = static_cast<unsigned char>(offset & 0xFFu);
+      *out++ = static_cast<unsigned char>(offset >> 8u);
+      if (match_code >= 15u) {
+        out = WriteLength(out, match_code - 15u);
+      }
+    }
+    return out;
+  }
+
+  /// Greedy LZ77 with a single-entry hash table, returns the compressed size.
+  static size_t CompressLZ(const unsigned char *src, size_t size, unsigned char *dst) {
+    // Allocated once per thread, cleared for every message.
+    thread_local std::vector<uint32_t> table(1u << HASH_BITS);
+    std::fill(table.begin(), table.end(), 0u);
+    unsigned char *out = dst;
+    size_t anchor = 0u;
+    size_t pos = 0u;
+    while (pos + MIN_MATCH + LAST_LITERALS <= size) {
+      const uint32_t sequence = Read32(src + pos);
+      uint32_t &entry = table[Hash(sequence)];
+      // Entries are stored as position + 1, zero means empty.
+      const size_t candidate = entry;
+      entry = static_cast<uint32_t>(pos + 1u);
+      if ((candidate == 0u) ||
+          (pos - (candidate - 1u) > MAX_OFFSET) ||
+          (Read32(src + candidate - 1u) != sequence)) {
+        // Skip faster over incompressible data.
+        pos += 1u + ((pos - anchor) >> 6u);
+        continue;
+      }
+      const size_t match = candidate - 1u;
+      const size_t limit = size - LAST_LITERALS;
+      size_t length = MIN_MATCH;
+      while ((pos + length < limit) && (src[match + length] == src[pos + length])) {
+        ++length;
+      }
+      out = WriteSequence(out, src + anchor, pos - anchor, pos - match, length);
+      pos += length;
+      anchor = pos;
+    }
+    out = WriteSequence(out, src + anchor, size - anchor, 0u, 0u);
+    return static_cast<size_t>(out - dst);
+  }
+
+  static void ThrowCorrupted() {
+    throw_exception(std::runtime_error("corrupted compressed sensor payload"));
+  }
+
+  static inline size_t ReadLength(const unsigned char *&in, const unsigned char *end, size_t length) {
+    if (length == 15u) {
+      unsigned char byte;
+      do {
+        if (in >= end) {
+          ThrowCorrupted();
+        }
+        byte = *in++;
+        length += byte;
+      } while (byte == 255u);
+    }
+    return length;
+  }
+
+  static void DecompressLZ(
+      const unsigned char *in,
+      const unsigned char *end,
+      unsigned char *dst,
+      size_t size) {
+    unsigned char *out = dst;
+    unsigned char *const out_end = dst + size;
+    while (in < end) {
+      const unsigned char token = *in++;
+      const size_t literal_count = ReadLength(in, end, token >> 4u);
+      if ((literal_count > static_cast<size_t>(end - in)) ||
+          (literal_count > static_cast<size_t>(out_end - out))) {
+        ThrowCorrupted();
+      }
+      std::memcpy(out, in, literal_count);
+      in += literal_count;
+      out += literal_count;
+      if (in == end) {
+        break;
+      }
+      if (end - in < 2) {
+        ThrowCorrupted();
+      }
+      const size_t offset = static_cast<size_t>(in[0u]) | (static_cast<size_t>(in[1u]) << 8u);
+      in += 2u;
+      const size_t length = ReadLength(in, end, token & 0x0Fu) + MIN_MATCH;
+      if ((offset == 0u) ||
+          (offset > static_cast<size_t>(out - dst)) ||
+          (length > static_cast<size_t>(out_end - out))) {
+        ThrowCorrupted();
+      }
+      const unsigned char *match = out - offset;
+      if (offset >= length) {
+        std::memcpy(out, match, length);
+        out += length;
+      } else {
+        // Overlapping match, repeats the last offset bytes (run-length).
+        for (size_t i = 0u; i < length; ++i) {
+          *out++ = *match++;
+        }
+      }
+    }
+    if (out != out_end) {
+      ThrowCorrupted();
+    }
+  }
+
+  Buffer PayloadCompression::Compress(
+      const CompressionType type,
+      const unsigned char *data,
+      const size_t size,
+      Buffer &&output) {
+    DEBUG_ASSERT(type != CompressionType::None);
+    if (size > std::numeric_limits<uint32_t>::max()) {
+      throw_exception(std::invalid_argument("sensor payload too big to be compressed"));
+    }
+    const unsigned char *source = data;
+    thread_local std::vector<unsigned char> residuals;
+    if (type == CompressionType::ImageDelta) {
+      residuals.resize(size);
+      const size_t head = size < PIXEL_SIZE ? size : PIXEL_SIZE;
+      std::memcpy(residuals.data(), data, head);
+      for (size_t i = head; i < size; ++i) {
+        residuals[i] = static_cast<unsigned char>(data[i] - data[i - PIXEL_SIZE]);
+      }
+      source = residuals.data();
+    }
+    output.reset(static_cast<uint64_t>(GetMaxCompressedSize(size)));
+    const uint32_t original_size = static_cast<uint32_t>(size);
+    std::memcpy(output.data(), &original_size, sizeof(original_size));
+    const size_t compressed_size = CompressLZ(source, size, output.data() + sizeof(original_size));
+    output.resize(static_cast<uint64_t>(sizeof(original_size) + compressed_size));
+    return std::move(output);
+  }
+
+  Buffer PayloadCompression::Decompress(
+      const CompressionType type,
+      const unsigned char *data,
+      const size_t size,
+      Buffer &&output,
+      const size_t offset) {
+    DEBUG_ASSERT(type != CompressionType::None);
+    if ((type != CompressionType::LZ) && (type != CompressionType::ImageDelta)) {
+      throw_exception(std::invalid_argument("unknown sensor payload compression"));
+    }
+    uint32_t original_size;
+    if (size < sizeof(original_size)) {
+      ThrowCorrupted();
+    }
+    std::memcpy(&original_size, data, sizeof(original_size));
+    output.resize(static_cast<uint64_t>(offset + original_size));
+    unsigned char *payload = output.data() + offset;
+    DecompressLZ(data + sizeof(original_size), data + size, payload, original_size);
+    if (type == CompressionType::ImageDelta) {
+      for (size_t i = PIXEL_SIZE; i < original_size; ++i) {
+        payload[i] = static_cast<unsigned char>(payload[i] + payload[i - PIXEL_SIZE]);
+      }
+    }
+    return std::move(output);
+  }
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,73 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  /// Codecs that can be applied to the payload of a sensor message (everything
+  /// after the SensorHeaderSerializer::Header).
+  enum class CompressionType : uint8_t {
+    /// Payload is sent raw.
+    None = 0u,
+    /// Fast LZ77 byte-oriented codec, suitable for any sensor.
+    LZ = 1u,
+    /// Lossless image predictor: each byte is replaced by its difference with
+    /// the same channel of the previous 4-byte pixel before applying LZ. Works
+    /// best on depth and semantic segmentation images.
+    ImageDelta = 2u,
+  };
+
+  /// Lossless compression of sensor payloads.
+  ///
+  /// The compressed payload consists of the size of the original payload as a
+  /// uint32_t followed by the LZ stream. The LZ stream is a sequence of
+  ///
+  ///    {
+  ///      token: literal count (4 bits), match length - 4 (4 bits)
+  ///      [extra literal count bytes while 255]
+  ///      literals
+  ///      match offset (uint16_t, omitted in the last sequence)
+  ///      [extra match length bytes while 255]
+  ///    }
+  ///
+  class PayloadCompression {
+  public:
+
+    /// Compress @a size bytes at @a data into @a output.
+    static Buffer Compress(
+        CompressionType type,
+        const unsigned char *data,
+        size_t size,
+        Buffer &&output);
+
+    /// Decompress @a size bytes at @a data, compressed with @a type, into
+    /// @a output starting at @a offset. The first @a offset bytes of output
+    /// are left untouched.
+    ///
+    /// @throw std::runtime_error if the data is corrupted.
+    static Buffer Decompress(
+        CompressionType type,
+        const unsigned char *data,
+        size_t size,
+        Buffer &&output,
+        size_t offset = 0u);
+
+    /// Upper bound of the compressed size of @a size bytes.
+    static constexpr size_t GetMaxCompressedSize(size_t size) {
+      return sizeof(uint32_t) + size + size / 255u + 16u;
+    }
+  };
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
@@ -74,6 +74,15 @@ namespace s11n {
         const data::SemanticLidarData &measurement,
         Buffer &&output);
 
+    /// Moves the buffer the points were written into out of @a measurement,
+    /// so the points are not copied. @a output is kept by @a measurement for
+    /// the next scan.
+    template <typename Sensor>
+    static Buffer Serialize(
+        const Sensor &sensor,
+        data::SemanticLidarData &measurement,
+        Buffer &&output);
+
     static SharedPtr<SensorData> Deserialize(RawData &&data);
   };
 
@@ -88,11 +97,19 @@ namespace s11n {
       Buffer &&output) {
     std::array<boost::asio::const_buffer, 2u> seq = {
         boost::asio::buffer(measurement._header),
-        boost::asio::buffer(measurement._ser_points)};
+        boost::asio::buffer(measurement.GetPointsData(), measurement.GetPointsSize())};
     output.copy_from(seq);
     return std::move(output);
   }
 
+  template <typename Sensor>
+  inline Buffer SemanticLidarSerializer::Serialize(
+      const Sensor &,
+      data::SemanticLidarData &measurement,
+      Buffer &&output) {
+    return measurement.PopBuffer(std::move(output));
+  }
+
 } // namespace s11n
 } // namespace sensor
 } // namespace carla
@@ -16,6 +16,10 @@ namespace s11n {
       SensorHeaderSerializer::header_offset == 3u * 8u + 6u * 4u,
       "Header size missmatch");
 
+  static_assert(
+      sizeof(SensorHeaderSerializer::Timing) == 2u * 8u,
+      "Timing size missmatch");
+
   static Buffer PopBufferFromPool() {
     static auto pool = std::make_shared<BufferPool>();
     return pool->Pop();
@@ -36,6 +40,17 @@ namespace s11n {
     return buffer;
   }
 
+  Buffer SensorHeaderSerializer::SerializeTiming(
+      const uint64_t enqueue_time,
+      const uint64_t send_time) {
+    Timing t;
+    t.enqueue_time = enqueue_time;
+    t.send_time = send_time;
+    auto buffer = PopBufferFromPool();
+    buffer.copy_from(reinterpret_cast<const unsigned char *>(&t), sizeof(t));
+    return buffer;
+  }
+
 } // namespace s11n
 } // namespace sensor
 } // namespace carla
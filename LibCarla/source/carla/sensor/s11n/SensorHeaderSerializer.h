@@ -7,8 +7,11 @@
 #pragma once
 
 #include "carla/Buffer.h"
+#include "carla/Debug.h"
 #include "carla/rpc/Transform.h"
 
+#include <chrono>
+
 namespace carla {
 namespace sensor {
 namespace s11n {
@@ -26,17 +29,77 @@ namespace s11n {
     };
 #pragma pack(pop)
 
+    /// Optional trailer appended at the end of the message, after the
+    /// payload. Times are nanoseconds since epoch of the simulator's system
+    /// clock.
+#pragma pack(push, 1)
+    struct Timing {
+      /// When the header was serialized, i.e. the measurement was taken.
+      uint64_t enqueue_time;
+      /// When the message was handed to the stream.
+      uint64_t send_time;
+    };
+#pragma pack(pop)
+
     constexpr static auto header_offset = sizeof(Header);
 
+    /// The most significant byte of Header::sensor_type holds the
+    /// CompressionType applied to the payload, zero if it is sent raw. This way
+    /// the header of uncompressed messages does not change.
+    constexpr static auto compression_shift = 56u;
+
+    /// Bit of Header::sensor_type set if the message ends with a Timing
+    /// trailer.
+    constexpr static auto timing_shift = 55u;
+
+    constexpr static uint64_t timing_flag = uint64_t(1u) << timing_shift;
+
+    constexpr static uint64_t sensor_type_mask = timing_flag - 1u;
+
     static Buffer Serialize(
         uint64_t index,
         uint64_t frame,
         double timestamp,
         rpc::Transform transform);
 
+    static Buffer SerializeTiming(uint64_t enqueue_time, uint64_t send_time);
+
     static const Header &Deserialize(const Buffer &message) {
       return *reinterpret_cast<const Header *>(message.data());
     }
+
+    static uint8_t GetCompression(const Header &header) {
+      return static_cast<uint8_t>(header.sensor_type >> compression_shift);
+    }
+
+    /// Mark the payload sent with @a header as compressed with @a compression.
+    static void SetCompression(Buffer &header, uint8_t compression) {
+      DEBUG_ASSERT(header.size() >= header_offset);
+      auto &h = *reinterpret_cast<Header *>(header.data());
+      h.sensor_type = (h.sensor_type & (sensor_type_mask | timing_flag)) |
+          (static_cast<uint64_t>(compression) << compression_shift);
+    }
+
+    static bool HasTiming(const Header &header) {
+      return (header.sensor_type & timing_flag) != 0u;
+    }
+
+    /// Mark the message sent with @a header as ending with a Timing trailer.
+    static void SetTiming(Buffer &header, bool has_timing) {
+      DEBUG_ASSERT(header.size() >= header_offset);
+      auto &h = *reinterpret_cast<Header *>(header.data());
+      h.sensor_type = has_timing ?
+          (h.sensor_type | timing_flag) :
+          (h.sensor_type & ~timing_flag);
+    }
+
+    /// Nanoseconds since epoch of the system clock, the clock of the Timing
+    /// trailer. Comparing times of different hosts is only meaningful if
+    /// their clocks are synchronized.
+    static uint64_t Now() {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count());
+    }
   };
 
 } // namespace s11n
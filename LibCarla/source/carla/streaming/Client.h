@@ -52,6 +52,13 @@ namespace streaming {
       _service.AsyncRun(worker_threads);
     }
 
+    /// Time at which the message passed to the callback running in this
+    /// thread was received, in nanoseconds since epoch of the system clock.
+    /// Zero outside of a callback.
+    static uint64_t GetReceiveTime() {
+      return detail::tcp::Client::GetReceiveTime();
+    }
+
   private:
 
     // The order of these two arguments is very important.
@@ -73,6 +73,20 @@ namespace streaming {
       return _server.GetToken(sensor_id);
     }
 
+    /// Compress the payload of the sensor messages sent through stream @a id,
+    /// see carla::sensor::s11n::CompressionType. Returns false if the stream
+    /// does not exist.
+    bool SetCompression(carla::streaming::detail::stream_id_type id, uint8_t compression) {
+      return _server.SetCompression(id, compression);
+    }
+
+    /// Append the simulator's timestamps to the sensor messages sent through
+    /// stream @a id, see carla::sensor::LatencyStats. Returns false if the
+    /// stream does not exist.
+    bool SetTimingEnabled(carla::streaming::detail::stream_id_type id, bool enabled) {
+      return _server.SetTimingEnabled(id, enabled);
+    }
+
   private:
 
     // The order of these two arguments is very important.
@@ -129,6 +129,28 @@ namespace detail {
     return token_type();
   }
 
+  bool Dispatcher::SetCompression(stream_id_type id, uint8_t compression) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto search = _stream_map.find(id);
+    if (search == _stream_map.end() || search->second == nullptr) {
+      return false;
+    }
+    log_debug("Setting compression", static_cast<int>(compression), "on stream", id);
+    search->second->SetCompression(compression);
+    return true;
+  }
+
+  bool Dispatcher::SetTimingEnabled(stream_id_type id, bool enabled) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto search = _stream_map.find(id);
+    if (search == _stream_map.end() || search->second == nullptr) {
+      return false;
+    }
+    log_debug("Setting timing", enabled, "on stream", id);
+    search->second->SetTimingEnabled(enabled);
+    return true;
+  }
+
 } // namespace detail
 } // namespace streaming
 } // namespace carla
@@ -43,6 +43,14 @@ namespace detail {
     
     token_type GetToken(stream_id_type sensor_id);
 
+    /// Set the compression of the payload of the messages sent through stream
+    /// @a id. Returns false if no such stream exists.
+    bool SetCompression(stream_id_type id, uint8_t compression);
+
+    /// Enable the timing trailer on the messages sent through stream @a id.
+    /// Returns false if no such stream exists.
+    bool SetTimingEnabled(stream_id_type id, bool enabled);
+
   private:
 
     // We use a mutex here, but we assume that sessions and streams won't be
@@ -46,6 +46,18 @@ namespace detail {
       return _shared_state->MakeBuffer();
     }
 
+    /// Compression the sender should apply to the payload of the messages
+    /// written to this stream, zero if none.
+    uint8_t GetCompression() const {
+      return _shared_state->GetCompression();
+    }
+
+    /// Whether the sender should append the timing trailer to the messages
+    /// written to this stream.
+    bool IsTimingEnabled() const {
+      return _shared_state->IsTimingEnabled();
+    }
+
     /// Flush @a buffers down the stream. No copies are made.
     template <typename... Buffers>
     void Write(Buffers &&... buffers) {
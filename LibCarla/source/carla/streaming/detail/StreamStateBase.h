@@ -10,6 +10,8 @@
 #include "carla/streaming/detail/Session.h"
 #include "carla/streaming/detail/Token.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 namespace carla {
@@ -34,6 +36,26 @@ namespace detail {
 
     Buffer MakeBuffer();
 
+    /// Compression applied to the payload of the messages written to this
+    /// stream, see carla::sensor::s11n::CompressionType.
+    void SetCompression(uint8_t compression) {
+      _compression = compression;
+    }
+
+    uint8_t GetCompression() const {
+      return _compression;
+    }
+
+    /// Append carla::sensor::s11n::SensorHeaderSerializer::Timing to the
+    /// messages written to this stream.
+    void SetTimingEnabled(bool enabled) {
+      _timing_enabled = enabled;
+    }
+
+    bool IsTimingEnabled() const {
+      return _timing_enabled;
+    }
+
     virtual void ConnectSession(std::shared_ptr<Session> session) = 0;
 
     virtual void DisconnectSession(std::shared_ptr<Session> session) = 0;
@@ -45,6 +67,10 @@ namespace detail {
     const token_type _token;
 
     const std::shared_ptr<BufferPool> _buffer_pool;
+
+    std::atomic<uint8_t> _compression{0u};
+
+    std::atomic_bool _timing_enabled{false};
   };
 
 } // namespace detail
@@ -11,6 +11,7 @@
 #include "carla/Exception.h"
 #include "carla/Logging.h"
 #include "carla/Time.h"
+#include "carla/profiler/Profiler.h"
 
 #include <boost/asio/connect.hpp>
 #include <boost/asio/read.hpp>
@@ -18,6 +19,7 @@
 #include <boost/asio/post.hpp>
 #include <boost/asio/bind_executor.hpp>
 
+#include <chrono>
 #include <exception>
 
 namespace carla {
@@ -65,6 +67,17 @@ namespace tcp {
   // -- Client -----------------------------------------------------------------
   // ===========================================================================
 
+  static thread_local uint64_t RECEIVE_TIME = 0u;
+
+  static uint64_t GetSystemTime() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+  }
+
+  uint64_t Client::GetReceiveTime() {
+    return RECEIVE_TIME;
+  }
+
   Client::Client(
       boost::asio::io_context &io_context,
       const token_type &token,
@@ -182,7 +195,14 @@ namespace tcp {
           // Move the buffer to the callback function and start reading the next
           // piece of data.
           // log_debug("streaming client: success reading data, calling the callback");
-          boost::asio::post(_strand, [self, message]() { self->_callback(message->pop()); });
+          CARLA_PROFILE_COUNTER(streaming, bytes_received, message->size());
+          const auto receive_time = GetSystemTime();
+          boost::asio::post(_strand, [self, message, receive_time]() {
+            CARLA_PROFILE_SPAN(streaming, client_callback);
+            RECEIVE_TIME = receive_time;
+            self->_callback(message->pop());
+            RECEIVE_TIME = 0u;
+          });
           ReadData();
         } else {
           // As usual, if anything fails start over from the very top.
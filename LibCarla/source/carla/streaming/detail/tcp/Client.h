@@ -58,6 +58,11 @@ namespace tcp {
 
     void Stop();
 
+    /// Time at which the message passed to the callback running in this
+    /// thread was read from the socket, in nanoseconds since epoch of the
+    /// system clock. Zero outside of a callback.
+    static uint64_t GetReceiveTime();
+
   private:
 
     void Reconnect();
@@ -86,9 +86,9 @@ namespace tcp {
     std::array<boost::asio::const_buffer, MaxNumberOfBuffers + 1u> _buffer_views;
   };
 
-  /// A TCP message containing a maximum of 2 buffers. This is optimized for a
-  /// header and body sort of messages.
-  using Message = MessageTmpl<2u>;
+  /// A TCP message containing a maximum of 3 buffers. This is optimized for a
+  /// header and body sort of messages, with an optional trailer.
+  using Message = MessageTmpl<3u>;
 
 } // namespace tcp
 } // namespace detail
@@ -9,6 +9,7 @@
 
 #include "carla/Debug.h"
 #include "carla/Logging.h"
+#include "carla/profiler/Profiler.h"
 
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
@@ -80,6 +81,7 @@ namespace tcp {
     DEBUG_ASSERT(!message->empty());
     auto self = shared_from_this();
     boost::asio::post(_strand, [=]() {
+      CARLA_PROFILE_SPAN(streaming, session_write);
       if (!_socket.is_open()) {
         return;
       }
@@ -103,6 +105,7 @@ namespace tcp {
           log_info("session", _session_id, ": error sending data :", ec.message());
           CloseNow();
         } else {
+          CARLA_PROFILE_COUNTER(streaming, bytes_sent, message->size());
           DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
           DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type) + message->size());
         }
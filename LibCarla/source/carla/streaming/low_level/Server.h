@@ -77,6 +77,14 @@ namespace low_level {
       return _dispatcher.GetToken(sensor_id);
     }
 
+    bool SetCompression(carla::streaming::detail::stream_id_type id, uint8_t compression) {
+      return _dispatcher.SetCompression(id, compression);
+    }
+
+    bool SetTimingEnabled(carla::streaming::detail::stream_id_type id, bool enabled) {
+      return _dispatcher.SetTimingEnabled(id, enabled);
+    }
+
   private:
 
     void StartServer() {
@@ -1,9 +1,8 @@
 
-#include "boost/pointer_cast.hpp"
+#include <algorithm>
 
 #include "carla/client/Actor.h"
-#include "carla/client/Vehicle.h"
-#include "carla/client/Walker.h"
+#include "carla/client/WorldSnapshot.h"
 
 #include "carla/trafficmanager/Constants.h"
 #include "carla/trafficmanager/LocalizationUtils.h"
@@ -46,15 +45,20 @@ void ALSM::Update() {
 
   bool hybrid_physics_mode = parameters.GetHybridPhysicsMode();
 
-  std::set<ActorId> world_vehicle_ids;
-  std::set<ActorId> world_pedestrian_ids;
-  std::vector<ActorId> unregistered_list_to_be_deleted;
+  // Index the actors of the current frame. The snapshot holds their state
+  // until the end of the update, so it is read without copying nor locking.
+  const cc::WorldSnapshot world_snapshot = world.GetSnapshot();
+  current_timestamp = world_snapshot.GetTimestamp();
+  simulation_state.SetTimestamp(current_timestamp);
+  snapshot_index.Update(world_snapshot);
 
-  current_timestamp = world.GetSnapshot().GetTimestamp();
-  ActorList world_actors = world.GetActors();
+  // Vehicles registered or unregistered since the last update require checking
+  // all the actors instead of only the ones that appeared or disappeared.
+  const bool registration_changed = registered_vehicles.GetState() != registered_vehicles_state;
+  const std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
 
   // Find destroyed actors and perform clean up.
-  const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(world_actors);
+  const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(registered_ids, registration_changed);
 
   const ActorIdSet &destroyed_registered = destroyed_actors.first;
   for (const auto &deletion_id: destroyed_registered) {
@@ -84,7 +88,7 @@ void ALSM::Update() {
   }
 
   // Scan for new unregistered actors.
-  IdentifyNewActors(world_actors);
+  IdentifyNewActors(registered_ids, registration_changed);
 
   // Update dynamic state and static attributes for all registered vehicles.
   ALSM::IdleInfo max_idle_time = std::make_pair(0u, current_timestamp.elapsed_seconds);
@@ -110,23 +114,45 @@ void ALSM::Update() {
 
   // Update dynamic state and static attributes for unregistered actors.
   UpdateUnregisteredActorsData();
+
+  registered_vehicles_state = registered_vehicles.GetState();
 }
 
-void ALSM::IdentifyNewActors(const ActorList &actor_list) {
+void ALSM::IdentifyNewActors(const std::vector<ActorId> &registered_ids, const bool registration_changed) {
+
+  const std::vector<ActorId> &new_ids = snapshot_index.GetNewIds();
+  std::vector<ActorId> ids_to_fetch = new_ids;
+
+  // Vehicles unregistered from the traffic manager are not new to the world.
+  if (registration_changed) {
+    for (const ActorId &actor_id : snapshot_index.GetIds()) {
+      if (!std::binary_search(registered_ids.begin(), registered_ids.end(), actor_id)
+          && unregistered_actors.find(actor_id) == unregistered_actors.end()
+          && !std::binary_search(new_ids.begin(), new_ids.end(), actor_id)) {
+        ids_to_fetch.push_back(actor_id);
+      }
+    }
+  }
+
+  if (ids_to_fetch.empty()) {
+    return;
+  }
+
+  ActorList actor_list = world.GetActors(ids_to_fetch);
   for (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
     ActorPtr actor = *iter;
     ActorId actor_id = actor->GetId();
-    // Identify any new hero vehicle
-    if (actor->GetTypeId().front() == 'v') {
-     if (hero_actors.size() == 0u || hero_actors.find(actor_id) == hero_actors.end()) {
+    // Identify any new hero vehicle, its attributes never change.
+    if (actor->GetTypeId().front() == 'v'
+        && std::binary_search(new_ids.begin(), new_ids.end(), actor_id)
+        && hero_actors.find(actor_id) == hero_actors.end()) {
       for (auto&& attribute: actor->GetAttributes()) {
         if (attribute.GetId() == "role_name" && attribute.GetValue() == "hero") {
           hero_actors.insert({actor_id, actor});
         }
       }
     }
-  }
-    if (!registered_vehicles.Contains(actor_id)
+    if (!std::binary_search(registered_ids.begin(), registered_ids.end(), actor_id)
         && unregistered_actors.find(actor_id) == unregistered_actors.end()) {
 
       unregistered_actors.insert({actor_id, actor});
@@ -134,35 +160,38 @@ void ALSM::IdentifyNewActors(const ActorList &actor_list) {
   }
 }
 
-ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const ActorList &actor_list) {
+ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const std::vector<ActorId> &registered_ids,
+                                                     const bool registration_changed) {
 
   ALSM::DestroyeddActors destroyed_actors;
   ActorIdSet &deleted_registered = destroyed_actors.first;
   ActorIdSet &deleted_unregistered = destroyed_actors.second;
 
-  // Building hash set of actors present in current frame.
-  ActorIdSet current_actors;
-  for  (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
-    current_actors.insert((*iter)->GetId());
-  }
-
   // Searching for destroyed registered actors.
-  std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
   for (const ActorId &actor_id : registered_ids) {
-    if (current_actors.find(actor_id) == current_actors.end()) {
+    if (!snapshot_index.Contains(actor_id)) {
       deleted_registered.insert(actor_id);
     }
   }
 
-  // Searching for destroyed unregistered actors.
-  for (const auto &actor_info: unregistered_actors) {
-    const ActorId &actor_id = actor_info.first;
-     if (current_actors.find(actor_id) == current_actors.end()
-         || registered_vehicles.Contains(actor_id)) {
+  // Searching for destroyed unregistered actors. Unregistered actors are
+  // always present in the frame they are found, so only those that
+  // disappeared since the previous frame need to be checked.
+  for (const ActorId &actor_id : snapshot_index.GetRemovedIds()) {
+    if (unregistered_actors.find(actor_id) != unregistered_actors.end()) {
       deleted_unregistered.insert(actor_id);
     }
   }
 
+  // Searching for unregistered actors that have been registered.
+  if (registration_changed) {
+    for (const ActorId &actor_id : registered_ids) {
+      if (unregistered_actors.find(actor_id) != unregistered_actors.end()) {
+        deleted_unregistered.insert(actor_id);
+      }
+    }
+  }
+
   return destroyed_actors;
 }
 
@@ -178,29 +207,34 @@ void ALSM::UpdateRegisteredActorsData(const bool hybrid_physics_mode, ALSM::Idle
   }
   // Update first the information regarding any hero vehicle.
   for (auto &hero_actor_info: hero_actors){
+    const cc::ActorSnapshot *snapshot = snapshot_index.Find(hero_actor_info.first);
+    if (snapshot == nullptr) {
+      continue;
+    }
     if (is_respawn_vehicles) {
-      track_traffic.SetHeroLocation(hero_actor_info.second->GetTransform().location);
+      track_traffic.SetHeroLocation(snapshot->transform.location);
     }
-    UpdateData(hybrid_physics_mode, max_idle_time, hero_actor_info.second, hero_actor_present, physics_radius_square);
+    UpdateData(hybrid_physics_mode, max_idle_time, hero_actor_info.second, *snapshot, hero_actor_present, physics_radius_square);
   }
   // Update information for all other registered vehicles.
   for (const Actor &vehicle : vehicle_list) {
     ActorId actor_id = vehicle->GetId();
-    if (hero_actors.find(actor_id) == hero_actors.end()) {
-      UpdateData(hybrid_physics_mode, max_idle_time, vehicle, hero_actor_present, physics_radius_square);
+    const cc::ActorSnapshot *snapshot = snapshot_index.Find(actor_id);
+    if (snapshot != nullptr && hero_actors.find(actor_id) == hero_actors.end()) {
+      UpdateData(hybrid_physics_mode, max_idle_time, vehicle, *snapshot, hero_actor_present, physics_radius_square);
     }
   }
 }
 
 void ALSM::UpdateData(const bool hybrid_physics_mode,
                       ALSM::IdleInfo &max_idle_time, const Actor &vehicle,
+                      const cc::ActorSnapshot &snapshot,
                       const bool hero_actor_present, const float physics_radius_square) {
 
-  ActorId actor_id = vehicle->GetId();
-  cg::Transform vehicle_transform = vehicle->GetTransform();
-  cg::Location vehicle_location = vehicle_transform.location;
-  cg::Rotation vehicle_rotation = vehicle_transform.rotation;
-  cg::Vector3D vehicle_velocity = vehicle->GetVelocity();
+  ActorId actor_id = snapshot.id;
+  const cg::Location &vehicle_location = snapshot.transform.location;
+  const cg::Rotation &vehicle_rotation = snapshot.transform.rotation;
+  cg::Vector3D vehicle_velocity = snapshot.velocity;
   bool state_entry_present = simulation_state.ContainsActor(actor_id);
 
   // Initializing idle times.
@@ -245,13 +279,14 @@ void ALSM::UpdateData(const bool hybrid_physics_mode,
   }
 
   // Updated kinematic state object.
-  auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(vehicle);
+  const auto &vehicle_data = snapshot.state.vehicle_data;
+  const bool is_dormant = snapshot.actor_state == rpc::ActorState::Dormant;
   KinematicState kinematic_state{vehicle_location, vehicle_rotation,
-                                  vehicle_velocity, vehicle_ptr->GetSpeedLimit(),
-                                  enable_physics, vehicle->IsDormant(), cg::Location()};
+                                  vehicle_velocity, vehicle_data.speed_limit,
+                                  enable_physics, is_dormant, cg::Location()};
 
   // Updated traffic light state object.
-  TrafficLightState tl_state = {vehicle_ptr->GetTrafficLightState(), vehicle_ptr->IsAtTrafficLight()};
+  TrafficLightState tl_state = {vehicle_data.traffic_light_state, vehicle_data.has_traffic_light};
 
   // Update simulation state.
   if (state_entry_present) {
@@ -259,7 +294,7 @@ void ALSM::UpdateData(const bool hybrid_physics_mode,
     simulation_state.UpdateTrafficLightState(actor_id, tl_state);
   }
   else {
-    cg::Vector3D dimensions = vehicle_ptr->GetBoundingBox().extent;
+    cg::Vector3D dimensions = vehicle->GetBoundingBox().extent;
     StaticAttributes attributes{ActorType::Vehicle, dimensions.x, dimensions.y, dimensions.z};
 
     simulation_state.AddActor(actor_id, kinematic_state, attributes, tl_state);
@@ -274,14 +309,18 @@ void ALSM::UpdateUnregisteredActorsData() {
   for (auto &actor_info: unregistered_actors) {
 
     const ActorId actor_id = actor_info.first;
-    const ActorPtr actor_ptr = actor_info.second;
-    const std::string type_id = actor_ptr->GetTypeId();
-
-    const cg::Transform actor_transform = actor_ptr->GetTransform();
-    const cg::Location actor_location = actor_transform.location;
-    const cg::Rotation actor_rotation = actor_transform.rotation;
-    const cg::Vector3D actor_velocity = actor_ptr->GetVelocity();
-    const bool actor_is_dormant = actor_ptr->IsDormant();
+    const ActorPtr &actor_ptr = actor_info.second;
+    const std::string &type_id = actor_ptr->GetTypeId();
+    const cc::ActorSnapshot *snapshot = snapshot_index.Find(actor_id);
+    if (snapshot == nullptr) {
+      continue;
+    }
+
+    const cg::Transform &actor_transform = snapshot->transform;
+    const cg::Location &actor_location = actor_transform.location;
+    const cg::Rotation &actor_rotation = actor_transform.rotation;
+    const cg::Vector3D &actor_velocity = snapshot->velocity;
+    const bool actor_is_dormant = snapshot->actor_state == rpc::ActorState::Dormant;
     KinematicState kinematic_state {actor_location, actor_rotation, actor_velocity, -1.0f, true, actor_is_dormant, cg::Location()};
 
     TrafficLightState tl_state;
@@ -291,13 +330,13 @@ void ALSM::UpdateUnregisteredActorsData() {
 
     bool state_entry_not_present = !simulation_state.ContainsActor(actor_id);
     if (type_id.front() == 'v') {
-      auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(actor_ptr);
-      kinematic_state.speed_limit = vehicle_ptr->GetSpeedLimit();
+      const auto &vehicle_data = snapshot->state.vehicle_data;
+      kinematic_state.speed_limit = vehicle_data.speed_limit;
 
-      tl_state = {vehicle_ptr->GetTrafficLightState(), vehicle_ptr->IsAtTrafficLight()};
+      tl_state = {vehicle_data.traffic_light_state, vehicle_data.has_traffic_light};
 
       if (state_entry_not_present) {
-        dimensions = vehicle_ptr->GetBoundingBox().extent;
+        dimensions = actor_ptr->GetBoundingBox().extent;
         actor_type = ActorType::Vehicle;
         StaticAttributes attributes {actor_type, dimensions.x, dimensions.y, dimensions.z};
 
@@ -308,8 +347,8 @@ void ALSM::UpdateUnregisteredActorsData() {
       }
 
       // Identify occupied waypoints.
-      cg::Vector3D extent = vehicle_ptr->GetBoundingBox().extent;
-      cg::Vector3D heading_vector = vehicle_ptr->GetTransform().GetForwardVector();
+      cg::Vector3D extent = actor_ptr->GetBoundingBox().extent;
+      cg::Vector3D heading_vector = actor_transform.GetForwardVector();
       std::vector<cg::Location> corners = {actor_location + cg::Location(extent.x * heading_vector),
                                            actor_location,
                                            actor_location + cg::Location(-extent.x * heading_vector)};
@@ -319,10 +358,8 @@ void ALSM::UpdateUnregisteredActorsData() {
       }
     }
     else if (type_id.front() == 'w') {
-      auto walker_ptr = boost::static_pointer_cast<cc::Walker>(actor_ptr);
-
       if (state_entry_not_present) {
-        dimensions = walker_ptr->GetBoundingBox().extent;
+        dimensions = actor_ptr->GetBoundingBox().extent;
         actor_type = ActorType::Pedestrian;
         StaticAttributes attributes {actor_type, dimensions.x, dimensions.y, dimensions.z};
 
@@ -390,6 +427,8 @@ void ALSM::Reset() {
   unregistered_actors.clear();
   idle_time.clear();
   hero_actors.clear();
+  snapshot_index.Clear();
+  registered_vehicles_state = -1;
   elapsed_last_actor_destruction = 0.0;
   current_timestamp = world.GetSnapshot().GetTimestamp();
 }
@@ -8,6 +8,7 @@
 #include "carla/client/World.h"
 #include "carla/Memory.h"
 
+#include "carla/trafficmanager/ActorSnapshotIndex.h"
 #include "carla/trafficmanager/AtomicActorSet.h"
 #include "carla/trafficmanager/CollisionStage.h"
 #include "carla/trafficmanager/DataStructures.h"
@@ -65,6 +66,10 @@ private:
   double elapsed_last_actor_destruction {0.0};
   cc::Timestamp current_timestamp;
   std::unordered_map<ActorId, bool> has_physics_enabled;
+  // Actors of the world snapshot being processed, indexed by id.
+  ActorSnapshotIndex snapshot_index;
+  // State of the registered vehicles at the end of the last update.
+  int registered_vehicles_state {-1};
 
   // Updates the duration for which a registered vehicle is stuck at a location.
   void UpdateIdleTime(std::pair<ActorId, double>& max_idle_time, const ActorId& actor_id);
@@ -73,18 +78,21 @@ private:
   bool IsVehicleStuck(const ActorId& actor_id);
 
   // Method to identify actors newly spawned in the simulation since last tick.
-  void IdentifyNewActors(const ActorList &actor_list);
+  // If the registered vehicles changed, all the actors not registered are checked.
+  void IdentifyNewActors(const std::vector<ActorId> &registered_ids, const bool registration_changed);
 
   using DestroyeddActors = std::pair<ActorIdSet, ActorIdSet>;
   // Method to identify actors deleted in the last frame.
   // Arrays of registered and unregistered actors are returned separately.
-  DestroyeddActors IdentifyDestroyedActors(const ActorList &actor_list);
+  DestroyeddActors IdentifyDestroyedActors(const std::vector<ActorId> &registered_ids,
+                                           const bool registration_changed);
 
   using IdleInfo = std::pair<ActorId, double>;
   void UpdateRegisteredActorsData(const bool hybrid_physics_mode, IdleInfo &max_idle_time);
 
   void UpdateData(const bool hybrid_physics_mode,
                   ALSM::IdleInfo &max_idle_time, const Actor &vehicle,
+                  const cc::ActorSnapshot &snapshot,
                   const bool hero_actor_present, const float physics_radius_square);
 
   void UpdateUnregisteredActorsData();
@@ -0,0 +1,103 @@
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "carla/client/ActorSnapshot.h"
+#include "carla/rpc/ActorId.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cc = carla::client;
+
+using ActorId = carla::ActorId;
+
+/// This class indexes the actor snapshots of one world snapshot by id, and
+/// keeps track of the actors that appeared and disappeared since the
+/// previous one. Its vectors are reused from tick to tick.
+/// The snapshots are not copied, they must outlive the index until the next
+/// call to Update or Clear.
+class ActorSnapshotIndex {
+
+private:
+  // Snapshots of the current tick, sorted by actor id. The id is kept next to
+  // the pointer so sorting and searching do not touch the snapshots.
+  using Entry = std::pair<ActorId, const cc::ActorSnapshot *>;
+  std::vector<Entry> snapshots;
+  // Sorted ids of the actors in the current and the previous tick.
+  std::vector<ActorId> ids;
+  std::vector<ActorId> previous_ids;
+  // Ids present in only one of the current and the previous tick.
+  std::vector<ActorId> new_ids;
+  std::vector<ActorId> removed_ids;
+
+  static bool CompareId(const Entry &entry, ActorId id) {
+    return entry.first < id;
+  }
+
+public:
+  // Method to index a range of actor snapshots, usually a WorldSnapshot.
+  template <typename RangeT>
+  void Update(const RangeT &range) {
+    snapshots.clear();
+    for (const cc::ActorSnapshot &snapshot : range) {
+      snapshots.emplace_back(snapshot.id, &snapshot);
+    }
+    std::sort(snapshots.begin(), snapshots.end(),
+              [](const Entry &lhs, const Entry &rhs) { return lhs.first < rhs.first; });
+
+    std::swap(ids, previous_ids);
+    ids.clear();
+    for (const Entry &entry : snapshots) {
+      ids.push_back(entry.first);
+    }
+
+    new_ids.clear();
+    std::set_difference(ids.begin(), ids.end(),
+                        previous_ids.begin(), previous_ids.end(),
+                        std::back_inserter(new_ids));
+    removed_ids.clear();
+    std::set_difference(previous_ids.begin(), previous_ids.end(),
+                        ids.begin(), ids.end(),
+                        std::back_inserter(removed_ids));
+  }
+
+  // Method to find the snapshot of an actor, nullptr if not present.
+  const cc::ActorSnapshot *Find(ActorId actor_id) const {
+    auto it = std::lower_bound(snapshots.begin(), snapshots.end(), actor_id, CompareId);
+    return (it != snapshots.end() && it->first == actor_id) ? it->second : nullptr;
+  }
+
+  bool Contains(ActorId actor_id) const {
+    return std::binary_search(ids.begin(), ids.end(), actor_id);
+  }
+
+  const std::vector<ActorId> &GetIds() const {
+    return ids;
+  }
+
+  const std::vector<ActorId> &GetNewIds() const {
+    return new_ids;
+  }
+
+  const std::vector<ActorId> &GetRemovedIds() const {
+    return removed_ids;
+  }
+
+  // Method to forget the snapshots, the next update reports every actor as new.
+  void Clear() {
+    snapshots.clear();
+    ids.clear();
+    previous_ids.clear();
+    new_ids.clear();
+    removed_ids.clear();
+  }
+
+};
+
+} // namespace traffic_manager
+} // namespace carla
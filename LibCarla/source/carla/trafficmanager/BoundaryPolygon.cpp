@@ -0,0 +1,140 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "carla/trafficmanager/BoundaryPolygon.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Cross product of (a - o) and (b - o), positive if o, a, b turn left.
+static double Cross(double ox, double oy, double ax, double ay, double bx, double by) {
+  return (ax - ox) * (by - oy) - (ay - oy) * (bx - ox);
+}
+
+/// Whether p, known to be collinear with segment ab, lies on it.
+static bool OnSegment(double ax, double ay, double bx, double by, double px, double py) {
+  return std::min(ax, bx) <= px && px <= std::max(ax, bx) &&
+         std::min(ay, by) <= py && py <= std::max(ay, by);
+}
+
+static bool SegmentsIntersect(double ax, double ay, double bx, double by,
+                              double cx, double cy, double dx, double dy) {
+  const double d1 = Cross(cx, cy, dx, dy, ax, ay);
+  const double d2 = Cross(cx, cy, dx, dy, bx, by);
+  const double d3 = Cross(ax, ay, bx, by, cx, cy);
+  const double d4 = Cross(ax, ay, bx, by, dx, dy);
+  if (((d1 > 0.0 && d2 < 0.0) || (d1 < 0.0 && d2 > 0.0)) &&
+      ((d3 > 0.0 && d4 < 0.0) || (d3 < 0.0 && d4 > 0.0))) {
+    return true;
+  }
+  return (d1 == 0.0 && OnSegment(cx, cy, dx, dy, ax, ay)) ||
+         (d2 == 0.0 && OnSegment(cx, cy, dx, dy, bx, by)) ||
+         (d3 == 0.0 && OnSegment(ax, ay, bx, by, cx, cy)) ||
+         (d4 == 0.0 && OnSegment(ax, ay, bx, by, dx, dy));
+}
+
+static double PointSegmentDistanceSquared(double px, double py,
+                                          double ax, double ay, double bx, double by) {
+  const double sx = bx - ax;
+  const double sy = by - ay;
+  const double length_squared = sx * sx + sy * sy;
+  double t = 0.0;
+  if (length_squared > 0.0) {
+    t = std::min(std::max(((px - ax) * sx + (py - ay) * sy) / length_squared, 0.0), 1.0);
+  }
+  const double ex = ax + t * sx - px;
+  const double ey = ay + t * sy - py;
+  return ex * ex + ey * ey;
+}
+
+void BoundaryPolygon::Assign(const std::vector<cg::Location> &boundary) {
+  _x.clear();
+  _y.clear();
+  _min_x = _min_y = std::numeric_limits<double>::infinity();
+  _max_x = _max_y = -std::numeric_limits<double>::infinity();
+  for (const cg::Location &location : boundary) {
+    const double x = static_cast<double>(location.x);
+    const double y = static_cast<double>(location.y);
+    _x.push_back(x);
+    _y.push_back(y);
+    _min_x = std::min(_min_x, x);
+    _min_y = std::min(_min_y, y);
+    _max_x = std::max(_max_x, x);
+    _max_y = std::max(_max_y, y);
+  }
+}
+
+double BoundaryPolygon::BoundingBoxGap(const BoundaryPolygon &lhs, const BoundaryPolygon &rhs) {
+  const double gap_x = std::max({lhs._min_x - rhs._max_x, rhs._min_x - lhs._max_x, 0.0});
+  const double gap_y = std::max({lhs._min_y - rhs._max_y, rhs._min_y - lhs._max_y, 0.0});
+  return std::sqrt(gap_x * gap_x + gap_y * gap_y);
+}
+
+bool BoundaryPolygon::Contains(double x, double y) const {
+  const size_t n = size();
+  int winding_number = 0;
+  for (size_t i = 0u, j = n - 1u; i < n; j = i++) {
+    if (_y[j] <= y) {
+      if (_y[i] > y && Cross(_x[j], _y[j], _x[i], _y[i], x, y) > 0.0) {
+        ++winding_number;
+      }
+    } else if (_y[i] <= y && Cross(_x[j], _y[j], _x[i], _y[i], x, y) < 0.0) {
+      --winding_number;
+    }
+  }
+  return winding_number != 0;
+}
+
+double BoundaryPolygon::SegmentDistanceSquared(double ax, double ay, double bx, double by,
+                                               double cx, double cy, double dx, double dy) {
+  if (SegmentsIntersect(ax, ay, bx, by, cx, cy, dx, dy)) {
+    return 0.0;
+  }
+  return std::min({PointSegmentDistanceSquared(ax, ay, cx, cy, dx, dy),
+                   PointSegmentDistanceSquared(bx, by, cx, cy, dx, dy),
+                   PointSegmentDistanceSquared(cx, cy, ax, ay, bx, by),
+                   PointSegmentDistanceSquared(dx, dy, ax, ay, bx, by)});
+}
+
+double BoundaryPolygon::Distance(const BoundaryPolygon &lhs, const BoundaryPolygon &rhs) {
+  const size_t n = lhs.size();
+  const size_t m = rhs.size();
+  if (n == 0u || m == 0u) {
+    return 0.0;
+  }
+
+  // Polygons can only touch if their bounding boxes do.
+  const bool may_intersect = BoundingBoxGap(lhs, rhs) == 0.0;
+  if (may_intersect && (rhs.Contains(lhs._x[0], lhs._y[0]) || lhs.Contains(rhs._x[0], rhs._y[0]))) {
+    return 0.0;
+  }
+
+  double distance_squared = std::numeric_limits<double>::infinity();
+  for (size_t i = 0u, pi = n - 1u; i < n; pi = i++) {
+    const double ax = lhs._x[pi], ay = lhs._y[pi];
+    const double bx = lhs._x[i], by = lhs._y[i];
+    for (size_t j = 0u, pj = m - 1u; j < m; pj = j++) {
+      const double cx = rhs._x[pj], cy = rhs._y[pj];
+      const double dx = rhs._x[j], dy = rhs._y[j];
+      if (may_intersect && SegmentsIntersect(ax, ay, bx, by, cx, cy, dx, dy)) {
+        return 0.0;
+      }
+      distance_squared = std::min({distance_squared,
+                                   PointSegmentDistanceSquared(ax, ay, cx, cy, dx, dy),
+                                   PointSegmentDistanceSquared(bx, by, cx, cy, dx, dy),
+                                   PointSegmentDistanceSquared(cx, cy, ax, ay, bx, by),
+                                   PointSegmentDistanceSquared(dx, dy, ax, ay, bx, by)});
+    }
+  }
+  return std::sqrt(distance_squared);
+}
+
+} // namespace traffic_manager
+} // namespace carla
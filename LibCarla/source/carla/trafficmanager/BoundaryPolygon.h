@@ -0,0 +1,58 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <vector>
+
+#include "carla/geom/Location.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cg = carla::geom;
+
+/// Top view polygon of a vehicle boundary, closed between its last and first
+/// points, with the coordinates stored in contiguous arrays so the distance
+/// loops run over plain doubles.
+///
+/// Assigning a new boundary reuses the memory of the previous one.
+class BoundaryPolygon {
+public:
+
+  void Assign(const std::vector<cg::Location> &boundary);
+
+  size_t size() const {
+    return _x.size();
+  }
+
+  /// Distance between the axis-aligned bounding boxes of both polygons, zero
+  /// if they overlap. It is never greater than the distance between them.
+  static double BoundingBoxGap(const BoundaryPolygon &lhs, const BoundaryPolygon &rhs);
+
+  /// Distance between the areas of both polygons, zero if they intersect or
+  /// one contains the other, as computed by boost::geometry::distance.
+  static double Distance(const BoundaryPolygon &lhs, const BoundaryPolygon &rhs);
+
+  /// Squared distance between the segments ab and cd, zero if they intersect.
+  static double SegmentDistanceSquared(double ax, double ay, double bx, double by,
+                                       double cx, double cy, double dx, double dy);
+
+private:
+
+  /// Whether the point is inside the polygon, by its winding number.
+  bool Contains(double x, double y) const;
+
+  std::vector<double> _x;
+  std::vector<double> _y;
+  double _min_x = 0.0;
+  double _min_y = 0.0;
+  double _max_x = 0.0;
+  double _max_y = 0.0;
+};
+
+} // namespace traffic_manager
+} // namespace carla
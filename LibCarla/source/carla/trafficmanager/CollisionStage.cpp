@@ -9,7 +9,6 @@
 namespace carla {
 namespace traffic_manager {
 
-using Point2D = bg::model::point<double, 2, bg::cs::cartesian>;
 using TLS = carla::rpc::TrafficLightState;
 
 using namespace constants::Collision;
@@ -21,6 +20,7 @@ CollisionStage::CollisionStage(
   const BufferMap &buffer_map,
   const TrackTraffic &track_traffic,
   const Parameters &parameters,
+  const LocalMapPtr &local_map,
   CollisionFrame &output_array,
   RandomGenerator &random_device)
   : vehicle_id_list(vehicle_id_list),
@@ -28,6 +28,7 @@ CollisionStage::CollisionStage(
     buffer_map(buffer_map),
     track_traffic(track_traffic),
     parameters(parameters),
+    local_map(local_map),
     output_array(output_array),
     random_device(random_device) {}
 
@@ -111,10 +112,12 @@ void CollisionStage::Update(const unsigned long index) {
 
 void CollisionStage::RemoveActor(const ActorId actor_id) {
   collision_locks.erase(actor_id);
+  boundary_cache.erase(actor_id);
 }
 
 void CollisionStage::Reset() {
   collision_locks.clear();
+  boundary_cache.clear();
 }
 
 float CollisionStage::GetBoundingBoxExtention(const ActorId actor_id) {
@@ -172,85 +175,80 @@ LocationVector CollisionStage::GetBoundary(const ActorId actor_id) {
 LocationVector CollisionStage::GetGeodesicBoundary(const ActorId actor_id) {
   LocationVector geodesic_boundary;
 
-  if (geodesic_boundary_map.find(actor_id) != geodesic_boundary_map.end()) {
-    geodesic_boundary = geodesic_boundary_map.at(actor_id);
-  } else {
-    const LocationVector bbox = GetBoundary(actor_id);
-
-    if (buffer_map.find(actor_id) != buffer_map.end()) {
-      float bbox_extension = GetBoundingBoxExtention(actor_id);
-      const float specific_lead_distance = parameters.GetDistanceToLeadingVehicle(actor_id);
-      bbox_extension = std::max(specific_lead_distance, bbox_extension);
-      const float bbox_extension_square = SQUARE(bbox_extension);
-
-      LocationVector left_boundary;
-      LocationVector right_boundary;
-      cg::Vector3D dimensions = simulation_state.GetDimensions(actor_id);
-      const float width = dimensions.y;
-      const float length = dimensions.x;
-
-      const Buffer &waypoint_buffer = buffer_map.at(actor_id);
-      const TargetWPInfo target_wp_info = GetTargetWaypoint(waypoint_buffer, length);
-      const SimpleWaypointPtr boundary_start = target_wp_info.first;
-      const uint64_t boundary_start_index = target_wp_info.second;
-
-      // At non-signalized junctions, we extend the boundary across the junction
-      // and in all other situations, boundary length is velocity-dependent.
-      SimpleWaypointPtr boundary_end = nullptr;
-      SimpleWaypointPtr current_point = waypoint_buffer.at(boundary_start_index);
-      bool reached_distance = false;
-      for (uint64_t j = boundary_start_index; !reached_distance && (j < waypoint_buffer.size()); ++j) {
-        if (boundary_start->DistanceSquared(current_point) > bbox_extension_square || j == waypoint_buffer.size() - 1) {
-          reached_distance = true;
-        }
-        if (boundary_end == nullptr
-            || cg::Math::Dot(boundary_end->GetForwardVector(), current_point->GetForwardVector()) < COS_10_DEGREES
-            || reached_distance) {
-
-          const cg::Vector3D heading_vector = current_point->GetForwardVector();
-          const cg::Location location = current_point->GetLocation();
-          cg::Vector3D perpendicular_vector = cg::Vector3D(-heading_vector.y, heading_vector.x, 0.0f);
-          perpendicular_vector = perpendicular_vector.MakeSafeUnitVector(EPSILON);
-          // Direction determined for the left-handed system.
-          const cg::Vector3D scaled_perpendicular = perpendicular_vector * width;
-          left_boundary.push_back(location + cg::Location(scaled_perpendicular));
-          right_boundary.push_back(location + cg::Location(-1.0f * scaled_perpendicular));
-
-          boundary_end = current_point;
-        }
-
-        current_point = waypoint_buffer.at(j);
+  const LocationVector bbox = GetBoundary(actor_id);
+
+  if (buffer_map.find(actor_id) != buffer_map.end()) {
+    float bbox_extension = GetBoundingBoxExtention(actor_id);
+    const float specific_lead_distance = parameters.GetDistanceToLeadingVehicle(actor_id);
+    bbox_extension = std::max(specific_lead_distance, bbox_extension);
+    const float bbox_extension_square = SQUARE(bbox_extension);
+
+    LocationVector left_boundary;
+    LocationVector right_boundary;
+    cg::Vector3D dimensions = simulation_state.GetDimensions(actor_id);
+    const float width = dimensions.y;
+    const float length = dimensions.x;
+
+    const Buffer &waypoint_buffer = buffer_map.at(actor_id);
+    const TargetWPInfo target_wp_info = GetTargetWaypoint(waypoint_buffer, length);
+    const SimpleWaypointPtr boundary_start = target_wp_info.first;
+    const uint64_t boundary_start_index = target_wp_info.second;
+
+    // At non-signalized junctions, we extend the boundary across the junction
+    // and in all other situations, boundary length is velocity-dependent.
+    SimpleWaypointPtr boundary_end = nullptr;
+    SimpleWaypointPtr current_point = waypoint_buffer.at(boundary_start_index);
+    bool reached_distance = false;
+    for (uint64_t j = boundary_start_index; !reached_distance && (j < waypoint_buffer.size()); ++j) {
+      if (boundary_start->DistanceSquared(current_point) > bbox_extension_square || j == waypoint_buffer.size() - 1) {
+        reached_distance = true;
+      }
+      if (boundary_end == nullptr
+          || cg::Math::Dot(boundary_end->GetForwardVector(), current_point->GetForwardVector()) < COS_10_DEGREES
+          || reached_distance) {
+
+        const cg::Vector3D heading_vector = current_point->GetForwardVector();
+        const cg::Location location = current_point->GetLocation();
+        cg::Vector3D perpendicular_vector = cg::Vector3D(-heading_vector.y, heading_vector.x, 0.0f);
+        perpendicular_vector = perpendicular_vector.MakeSafeUnitVector(EPSILON);
+        // Direction determined for the left-handed system.
+        const cg::Vector3D scaled_perpendicular = perpendicular_vector * width;
+        left_boundary.push_back(location + cg::Location(scaled_perpendicular));
+        right_boundary.push_back(location + cg::Location(-1.0f * scaled_perpendicular));
+
+        boundary_end = current_point;
       }
 
-      // Reversing right boundary to construct clockwise (left-hand system)
-      // boundary. This is so because both left and right boundary vectors have
-      // the closest point to the vehicle at their starting index for the right
-      // boundary,
-      // we want to begin at the farthest point to have a clockwise trace.
-      std::reverse(right_boundary.begin(), right_boundary.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), right_boundary.begin(), right_boundary.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), bbox.begin(), bbox.end());
-      geodesic_boundary.insert(geodesic_boundary.end(), left_boundary.begin(), left_boundary.end());
-    } else {
-
-      geodesic_boundary = bbox;
+      current_point = waypoint_buffer.at(j);
     }
 
-    geodesic_boundary_map.insert({actor_id, geodesic_boundary});
+    // Reversing right boundary to construct clockwise (left-hand system)
+    // boundary. This is so because both left and right boundary vectors have
+    // the closest point to the vehicle at their starting index for the right
+    // boundary,
+    // we want to begin at the farthest point to have a clockwise trace.
+    std::reverse(right_boundary.begin(), right_boundary.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), right_boundary.begin(), right_boundary.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), bbox.begin(), bbox.end());
+    geodesic_boundary.insert(geodesic_boundary.end(), left_boundary.begin(), left_boundary.end());
+  } else {
+
+    geodesic_boundary = bbox;
   }
 
   return geodesic_boundary;
 }
 
-Polygon CollisionStage::GetPolygon(const LocationVector &boundary) {
+const ActorBoundaries &CollisionStage::GetBoundaries(const ActorId actor_id) {
 
-  traffic_manager::Polygon boundary_polygon;
-  for (const cg::Location &location : boundary) {
-    bg::append(boundary_polygon.outer(), Point2D(location.x, location.y));
+  ActorBoundaries &boundaries = boundary_cache[actor_id];
+  if (boundaries.cycle != cycle) {
+    boundaries.bbox.Assign(GetBoundary(actor_id));
+    boundaries.geodesic.Assign(GetGeodesicBoundary(actor_id));
+    boundaries.cycle = cycle;
   }
-  bg::append(boundary_polygon.outer(), Point2D(boundary.front().x, boundary.front().y));
 
-  return boundary_polygon;
+  return boundaries;
 }
 
 GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId reference_vehicle_id,
@@ -279,22 +277,27 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
     comparision_result.other_vehicle_to_reference_geodesic = mref_veh_other;
   } else {
 
-    const Polygon reference_polygon = GetPolygon(GetBoundary(reference_vehicle_id));
-    const Polygon other_polygon = GetPolygon(GetBoundary(other_actor_id));
+    const ActorBoundaries &reference = GetBoundaries(reference_vehicle_id);
+    const ActorBoundaries &other = GetBoundaries(other_actor_id);
 
-    const Polygon reference_geodesic_polygon = GetPolygon(GetGeodesicBoundary(reference_vehicle_id));
-
-    const Polygon other_geodesic_polygon = GetPolygon(GetGeodesicBoundary(other_actor_id));
-
-    const double reference_vehicle_to_other_geodesic = bg::distance(reference_polygon, other_geodesic_polygon);
-    const double other_vehicle_to_reference_geodesic = bg::distance(other_polygon, reference_geodesic_polygon);
-    const auto inter_geodesic_distance = bg::distance(reference_geodesic_polygon, other_geodesic_polygon);
-    const auto inter_bbox_distance = bg::distance(reference_polygon, other_polygon);
-
-    comparision_result = {reference_vehicle_to_other_geodesic,
-              other_vehicle_to_reference_geodesic,
-              inter_geodesic_distance,
-              inter_bbox_distance};
+    // The bounding boxes are part of the path boundaries, so no distance
+    // between the polygons is smaller than the gap between the path boundaries.
+    // Far apart paths can't lead to a collision negotiation, so the gap is
+    // reported instead of the exact distances.
+    const double geodesic_gap = BoundaryPolygon::BoundingBoxGap(reference.geodesic, other.geodesic);
+    if (geodesic_gap >= static_cast<double>(OVERLAP_THRESHOLD)) {
+      comparision_result = {geodesic_gap, geodesic_gap, geodesic_gap, geodesic_gap};
+    } else {
+      const double reference_vehicle_to_other_geodesic = BoundaryPolygon::Distance(reference.bbox, other.geodesic);
+      const double other_vehicle_to_reference_geodesic = BoundaryPolygon::Distance(other.bbox, reference.geodesic);
+      const double inter_geodesic_distance = BoundaryPolygon::Distance(reference.geodesic, other.geodesic);
+      const double inter_bbox_distance = BoundaryPolygon::Distance(reference.bbox, other.bbox);
+
+      comparision_result = {reference_vehicle_to_other_geodesic,
+                other_vehicle_to_reference_geodesic,
+                inter_geodesic_distance,
+                inter_bbox_distance};
+    }
 
     geometry_cache.insert({actor_id_key, comparision_result});
   }
@@ -302,6 +305,18 @@ GeometryComparison CollisionStage::GetGeometryBetweenActors(const ActorId refere
   return comparision_result;
 }
 
+bool CollisionStage::AreOnDisjointJunctionLanes(const ActorId reference_vehicle_id, const ActorId other_actor_id) {
+  const auto other_buffer = buffer_map.find(other_actor_id);
+  if (other_buffer == buffer_map.end() || other_buffer->second.empty()) {
+    return false;
+  }
+  const SimpleWaypointPtr &reference_point = buffer_map.at(reference_vehicle_id).front();
+  const SimpleWaypointPtr &other_point = other_buffer->second.front();
+  return other_point->CheckJunction()
+         && reference_point->GetJunctionId() == other_point->GetJunctionId()
+         && !local_map->GetJunctionConflicts().HaveConflict(*reference_point, *other_point);
+}
+
 std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId reference_vehicle_id,
                                                           const ActorId other_actor_id,
                                                           const uint64_t reference_junction_look_ahead_index) {
@@ -351,6 +366,8 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
 
   // Conditions to consider collision negotiation.
   if (!(ego_at_junction_entrance && ego_at_traffic_light && ego_stopped_by_light)
+      && !(ego_inside_junction && parameters.GetJunctionConflictMode()
+           && AreOnDisjointJunctionLanes(reference_vehicle_id, other_actor_id))
       && ((ego_inside_junction && other_vehicles_in_cross_detection_range)
           || (!ego_inside_junction && other_vehicle_in_front && other_vehicle_in_ego_range))) {
     GeometryComparison geometry_comparison = GetGeometryBetweenActors(reference_vehicle_id, other_actor_id);
@@ -420,7 +437,7 @@ std::pair<bool, float> CollisionStage::NegotiateCollision(const ActorId referenc
 }
 
 void CollisionStage::ClearCycleCache() {
-  geodesic_boundary_map.clear();
+  ++cycle;
   geometry_cache.clear();
 }
 
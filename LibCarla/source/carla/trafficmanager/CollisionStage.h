@@ -3,16 +3,14 @@
 
 #include <memory>
 
-#include "boost/geometry.hpp"
-#include "boost/geometry/geometries/geometries.hpp"
-#include "boost/geometry/geometries/point_xy.hpp"
-#include "boost/geometry/geometries/polygon.hpp"
-
+#include "carla/trafficmanager/BoundaryPolygon.h"
 #include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimulationState.h"
 #include "carla/trafficmanager/Stage.h"
+#include "carla/trafficmanager/TrackTraffic.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -32,14 +30,20 @@ struct CollisionLock {
 using CollisionLockMap = std::unordered_map<ActorId, CollisionLock>;
 
 namespace cc = carla::client;
-namespace bg = boost::geometry;
 
-using Buffer = std::deque<std::shared_ptr<SimpleWaypoint>>;
+using Buffer = WaypointBuffer;
+using LocalMapPtr = std::shared_ptr<InMemoryMap>;
 using BufferMap = std::unordered_map<carla::ActorId, Buffer>;
 using LocationVector = std::vector<cg::Location>;
-using GeodesicBoundaryMap = std::unordered_map<ActorId, LocationVector>;
 using GeometryComparisonMap = std::unordered_map<uint64_t, GeometryComparison>;
-using Polygon = bg::model::polygon<bg::model::d2::point_xy<double>>;
+
+/// Bounding box and path boundary polygons of an actor, computed once per cycle.
+struct ActorBoundaries {
+  uint64_t cycle = 0u;
+  BoundaryPolygon bbox;
+  BoundaryPolygon geodesic;
+};
+using ActorBoundariesMap = std::unordered_map<ActorId, ActorBoundaries>;
 
 /// This class has functionality to detect potential collision with a nearby actor.
 class CollisionStage : Stage {
@@ -49,14 +53,17 @@ private:
   const BufferMap &buffer_map;
   const TrackTraffic &track_traffic;
   const Parameters &parameters;
+  const LocalMapPtr &local_map;
   CollisionFrame &output_array;
   // Structure keeping track of blocking lead vehicles.
   CollisionLockMap collision_locks;
-  // Structures to cache geodesic boundaries of vehicle and
+  // Structures to cache boundaries of vehicles and
   // comparision between vehicle boundaries
   // to avoid repeated computation within a cycle.
+  // Boundaries are kept between cycles to reuse their memory.
   GeometryComparisonMap geometry_cache;
-  GeodesicBoundaryMap geodesic_boundary_map;
+  ActorBoundariesMap boundary_cache;
+  uint64_t cycle = 1u;
   RandomGenerator &random_device;
 
   // Method to determine if a vehicle is on a collision path to another.
@@ -73,7 +80,12 @@ private:
   // Method to construct polygon points around the path boundary of the vehicle.
   LocationVector GetGeodesicBoundary(const ActorId actor_id);
 
-  Polygon GetPolygon(const LocationVector &boundary);
+  // Method to get the boundary polygons of the actor for the current cycle.
+  const ActorBoundaries &GetBoundaries(const ActorId actor_id);
+
+  // Method to determine if both vehicles are driving through the same junction
+  // on connecting lanes that neither cross nor merge.
+  bool AreOnDisjointJunctionLanes(const ActorId reference_vehicle_id, const ActorId other_actor_id);
 
   // Method to compare path boundaries, bounding boxes of vehicles
   // and cache the results for reuse in current update cycle.
@@ -89,6 +101,7 @@ public:
                  const BufferMap &buffer_map,
                  const TrackTraffic &track_traffic,
                  const Parameters &parameters,
+                 const LocalMapPtr &local_map,
                  CollisionFrame &output_array,
                  RandomGenerator &random_device);
 
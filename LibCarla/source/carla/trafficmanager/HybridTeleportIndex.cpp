@@ -0,0 +1,116 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cmath>
+
+#include "carla/trafficmanager/Constants.h"
+
+#include "carla/trafficmanager/HybridTeleportIndex.h"
+
+namespace carla {
+namespace traffic_manager {
+
+using constants::Map::DELTA;
+using constants::Map::MAX_GEODESIC_GRID_LENGTH;
+using constants::Map::Z_DELTA;
+
+/// Distance used by InMemoryMap::GetWaypointsInDelta, the half side of the
+/// smallest square around @a center that contains @a location.
+static float SquareDistance(const cg::Location &center, const cg::Location &location) {
+  return std::max(std::abs(location.x - center.x), std::abs(location.y - center.y));
+}
+
+void HybridTeleportIndex::Build(const InMemoryMap &local_map,
+                                const GeoGridId grid_id,
+                                const cg::Location hero_location,
+                                const float upper_bound) {
+
+  hero_grid_id = grid_id;
+  origin = hero_location;
+  // The hero may move up to a grid length, or up to Z_DELTA vertically,
+  // before the index is built again, and the candidates are filtered by its
+  // current location.
+  max_distance = upper_bound + DELTA + MAX_GEODESIC_GRID_LENGTH;
+
+  candidates.clear();
+  for (const SpatialTreeEntry &entry : local_map.GetWaypointsInRange(origin, max_distance, 2.0f * Z_DELTA)) {
+    const cg::Location location(entry.first.get<0>(), entry.first.get<1>(), entry.first.get<2>());
+    candidates.push_back({SquareDistance(origin, location), location, entry.second});
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate &lhs, const Candidate &rhs) { return lhs.distance < rhs.distance; });
+
+  offsets.resize(static_cast<size_t>(max_distance) + 1u);
+  size_t position = 0u;
+  for (size_t meter = 0u; meter < offsets.size(); ++meter) {
+    while (position < candidates.size() && candidates.at(position).distance < static_cast<float>(meter)) {
+      ++position;
+    }
+    offsets.at(meter) = position;
+  }
+  is_built = true;
+}
+
+void HybridTeleportIndex::Update(const InMemoryMap &local_map,
+                                 const cg::Location hero_location,
+                                 const float upper_bound) {
+
+  const bool is_in_range = upper_bound + DELTA + MAX_GEODESIC_GRID_LENGTH <= max_distance;
+  if (is_built && is_in_range && hero_location == last_hero_location) {
+    return;
+  }
+  last_hero_location = hero_location;
+
+  const GeoGridId grid_id = local_map.GetWaypoint(hero_location)->GetGeodesicGridId();
+  if (!is_built || !is_in_range || grid_id != hero_grid_id ||
+      SquareDistance(origin, hero_location) > MAX_GEODESIC_GRID_LENGTH ||
+      std::abs(hero_location.z - origin.z) > Z_DELTA) {
+    Build(local_map, grid_id, hero_location, upper_bound);
+  }
+}
+
+NodeList HybridTeleportIndex::GetWaypointsInDelta(const cg::Location hero_location,
+                                                  const uint16_t n_points,
+                                                  const float random_sample) const {
+  NodeList result;
+  if (!is_built) {
+    return result;
+  }
+
+  // Candidates are sorted by their distance to the origin, which is at most
+  // one grid length away from their distance to the hero.
+  const float lower_distance = random_sample;
+  const float upper_distance = random_sample + DELTA;
+  const float first_meter = std::max(lower_distance - MAX_GEODESIC_GRID_LENGTH, 0.0f);
+  const size_t first = offsets.at(std::min(static_cast<size_t>(first_meter), offsets.size() - 1u));
+  for (size_t position = first; position < candidates.size(); ++position) {
+    const Candidate &candidate = candidates.at(position);
+    if (candidate.distance > upper_distance + MAX_GEODESIC_GRID_LENGTH) {
+      break;
+    }
+    const float distance = SquareDistance(hero_location, candidate.location);
+    const float height = std::abs(candidate.location.z - hero_location.z);
+    if (distance >= lower_distance && distance < upper_distance && height < Z_DELTA) {
+      result.push_back(candidate.waypoint);
+      if (result.size() >= n_points) {
+        break;
+      }
+    }
+  }
+
+  return result;
+}
+
+void HybridTeleportIndex::Reset() {
+  candidates.clear();
+  offsets.clear();
+  max_distance = 0.0f;
+  is_built = false;
+}
+
+} // namespace traffic_manager
+} // namespace carla
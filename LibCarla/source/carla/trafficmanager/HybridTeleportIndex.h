@@ -0,0 +1,74 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <vector>
+
+#include "carla/geom/Location.h"
+#include "carla/road/RoadTypes.h"
+
+#include "carla/trafficmanager/InMemoryMap.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cg = carla::geom;
+
+using GeoGridId = carla::road::JuncId;
+
+/// This class caches the waypoints around the hero vehicle where dormant
+/// vehicles can be respawned in hybrid mode.
+///
+/// The waypoints are sorted by their distance to the hero, and only
+/// gathered again when the hero moves to another geodesic grid, so that
+/// finding the candidates of each vehicle does not query the whole map.
+class HybridTeleportIndex {
+
+private:
+  /// Waypoint outside junctions and its distance to the location the index
+  /// was built at, as measured by InMemoryMap::GetWaypointsInDelta.
+  struct Candidate {
+    float distance;
+    cg::Location location;
+    SimpleWaypointPtr waypoint;
+  };
+  std::vector<Candidate> candidates;
+  /// Position in candidates of the first one at each whole meter.
+  std::vector<size_t> offsets;
+  /// Hero grid and location the index was built for.
+  GeoGridId hero_grid_id {0};
+  cg::Location origin;
+  /// Hero location of the last update.
+  cg::Location last_hero_location;
+  float max_distance {0.0f};
+  bool is_built {false};
+
+  void Build(const InMemoryMap &local_map,
+             const GeoGridId grid_id,
+             const cg::Location hero_location,
+             const float upper_bound);
+
+public:
+  /// Builds the index again if the hero changed its geodesic grid, moved
+  /// more than Z_DELTA vertically, or if upper_bound is out of the current
+  /// index.
+  void Update(const InMemoryMap &local_map,
+              const cg::Location hero_location,
+              const float upper_bound);
+
+  /// Returns up to n_points waypoints outside junctions between random_sample
+  /// and random_sample + DELTA from the hero location, the same area as
+  /// InMemoryMap::GetWaypointsInDelta.
+  NodeList GetWaypointsInDelta(const cg::Location hero_location,
+                               const uint16_t n_points,
+                               const float random_sample) const;
+
+  void Reset();
+};
+
+} // namespace traffic_manager
+} // namespace carla
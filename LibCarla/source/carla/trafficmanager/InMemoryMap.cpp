@@ -105,6 +105,9 @@ namespace traffic_manager {
       used_ids.insert(wp->GetId());
     }
 
+    // write junction lane conflicts
+    junction_conflicts.Write(out_file);
+
     out_file.close();
     return;
   }
@@ -157,6 +160,14 @@ namespace traffic_manager {
       }
     }
 
+    // read junction lane conflicts, missing in files cooked by older versions
+    if (pos >= content.size()) {
+      junction_conflicts.Build(dense_topology);
+    } else if (!junction_conflicts.Read(content, pos)) {
+      log_warning("Junction lane conflicts of the cached map are truncated, computing them again");
+      junction_conflicts.Build(dense_topology);
+    }
+
     // create spatial tree
     SetUpSpatialTree();
 
@@ -355,6 +366,9 @@ namespace traffic_manager {
 
     // Specifying a RoadOption for each SimpleWaypoint
     SetUpRoadOption();
+
+    // Computing which connecting lanes of each junction cross or merge
+    junction_conflicts.Build(dense_topology);
   }
 
   void InMemoryMap::SetUpSpatialTree() {
@@ -497,10 +511,28 @@ namespace traffic_manager {
     return result;
   }
 
+  std::vector<SpatialTreeEntry> InMemoryMap::GetWaypointsInRange(const cg::Location loc, const float max_distance, const float max_height) const {
+
+    Point3D p1(loc.x + max_distance, loc.y + max_distance, loc.z + max_height);
+    Point3D p2(loc.x - max_distance, loc.y - max_distance, loc.z - max_height);
+    Box query_box(p2, p1);
+
+    std::vector<SpatialTreeEntry> result;
+    rtree.query(bgi::within(query_box)
+        && bgi::satisfies([&](SpatialTreeEntry const& v) { return !v.second->CheckJunction();}),
+        std::back_inserter(result));
+
+    return result;
+  }
+
   NodeList InMemoryMap::GetDenseTopology() const {
     return dense_topology;
   }
 
+  const JunctionConflictTable &InMemoryMap::GetJunctionConflicts() const {
+    return junction_conflicts;
+  }
+
   void InMemoryMap::FindAndLinkLaneChange(SimpleWaypointPtr reference_waypoint) {
 
     const WaypointPtr raw_waypoint = reference_waypoint->GetWaypoint();
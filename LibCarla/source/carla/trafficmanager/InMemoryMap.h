@@ -25,6 +25,7 @@
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 #include "carla/trafficmanager/CachedSimpleWaypoint.h"
+#include "carla/trafficmanager/JunctionConflictTable.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -64,6 +65,8 @@ namespace bgi = boost::geometry::index;
     NodeList dense_topology;
     /// Spatial quadratic R-tree for indexing and querying waypoints.
     Rtree rtree;
+    /// Which connecting lanes of each junction cross or merge.
+    JunctionConflictTable junction_conflicts;
 
   public:
 
@@ -84,9 +87,16 @@ namespace bgi = boost::geometry::index;
     /// This method returns n waypoints in an delta area with a certain distance from the ego vehicle.
     NodeList GetWaypointsInDelta(const cg::Location loc, const uint16_t n_points, const float random_sample) const;
 
+    /// This method returns the waypoints outside junctions in a square of half side max_distance around a location,
+    /// and less than max_height above or below it.
+    std::vector<SpatialTreeEntry> GetWaypointsInRange(const cg::Location loc, const float max_distance, const float max_height) const;
+
     /// This method returns the full list of discrete samples of the map in the local cache.
     NodeList GetDenseTopology() const;
 
+    /// This method returns the lane conflicts of every junction in the map.
+    const JunctionConflictTable &GetJunctionConflicts() const;
+
     std::string GetMapName();
 
     const cc::Map& GetMap() const;
@@ -0,0 +1,215 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "carla/trafficmanager/BoundaryPolygon.h"
+#include "carla/trafficmanager/Constants.h"
+
+#include "carla/trafficmanager/JunctionConflictTable.h"
+
+namespace carla {
+namespace traffic_manager {
+
+using constants::Map::JUNCTION_LANE_OVERLAP_TOLERANCE;
+
+using Polyline = std::vector<cg::Location>;
+
+template <typename T>
+static void WriteValue(std::ofstream &out_file, const T &in_obj) {
+  out_file.write(reinterpret_cast<const char *>(&in_obj), sizeof(T));
+}
+
+template <typename T>
+static bool ReadValue(const std::vector<uint8_t> &content, unsigned long &start, T &out_obj) {
+  if (start > content.size() || content.size() - start < sizeof(T)) {
+    return false;
+  }
+  memcpy(&out_obj, &content[start], sizeof(T));
+  start += sizeof(T);
+  return true;
+}
+
+static bool PolylinesCloserThan(const Polyline &lhs, const Polyline &rhs, const float distance) {
+  const double distance_squared = static_cast<double>(distance) * static_cast<double>(distance);
+  for (size_t i = 0u; i < lhs.size(); ++i) {
+    const cg::Location &a = lhs[i];
+    const cg::Location &b = lhs[std::min(i + 1u, lhs.size() - 1u)];
+    for (size_t j = 0u; j < rhs.size(); ++j) {
+      const cg::Location &c = rhs[j];
+      const cg::Location &d = rhs[std::min(j + 1u, rhs.size() - 1u)];
+      if (BoundaryPolygon::SegmentDistanceSquared(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y) < distance_squared) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+uint64_t JunctionConflictTable::GetLaneKey(const crd::RoadId road_id, const crd::LaneId lane_id) {
+  return (static_cast<uint64_t>(road_id) << 32u) | static_cast<uint32_t>(lane_id);
+}
+
+uint64_t JunctionConflictTable::GetLaneKey(const SimpleWaypoint &waypoint) {
+  const WaypointPtr raw_waypoint = waypoint.GetWaypoint();
+  return GetLaneKey(raw_waypoint->GetRoadId(), raw_waypoint->GetLaneId());
+}
+
+void JunctionConflictTable::AddJunction(const crd::JuncId junction_id,
+                                        const std::vector<uint64_t> &lane_keys,
+                                        std::vector<uint8_t> conflicts) {
+  const uint32_t junction_index = static_cast<uint32_t>(junctions.size());
+  for (uint32_t i = 0u; i < lane_keys.size(); ++i) {
+    lane_index.insert({lane_keys[i], {junction_index, i}});
+  }
+  junctions.push_back({junction_id, static_cast<uint32_t>(lane_keys.size()), std::move(conflicts)});
+}
+
+void JunctionConflictTable::Build(const std::vector<SimpleWaypointPtr> &dense_topology) {
+
+  junctions.clear();
+  lane_index.clear();
+
+  // Waypoints of each connecting lane, sorted so that junctions and lanes
+  // always get the same position.
+  std::map<crd::JuncId, std::map<uint64_t, std::vector<SimpleWaypointPtr>>> junction_lanes;
+  for (const SimpleWaypointPtr &waypoint : dense_topology) {
+    const crd::JuncId junction_id = waypoint->GetJunctionId();
+    if (junction_id != -1) {
+      junction_lanes[junction_id][GetLaneKey(*waypoint)].push_back(waypoint);
+    }
+  }
+
+  for (auto &junction : junction_lanes) {
+    std::vector<uint64_t> lane_keys;
+    std::vector<Polyline> polylines;
+    std::vector<double> widths;
+    for (auto &lane : junction.second) {
+      // Sort the waypoints in driving order, which follows the road for
+      // right lanes and goes against it for left lanes.
+      std::vector<SimpleWaypointPtr> &waypoints = lane.second;
+      const bool forward = waypoints.front()->GetWaypoint()->GetLaneId() < 0;
+      std::sort(waypoints.begin(), waypoints.end(),
+                [forward](const SimpleWaypointPtr &lhs, const SimpleWaypointPtr &rhs) {
+                  const double lhs_s = lhs->GetWaypoint()->GetDistance();
+                  const double rhs_s = rhs->GetWaypoint()->GetDistance();
+                  return forward ? lhs_s < rhs_s : lhs_s > rhs_s;
+                });
+      // Include the waypoints right before and after the junction, so lanes
+      // merging at the exit or splitting at the entry also conflict.
+      Polyline polyline;
+      double width = 0.0;
+      const std::vector<SimpleWaypointPtr> entry = waypoints.front()->GetPreviousWaypoint();
+      const std::vector<SimpleWaypointPtr> exit = waypoints.back()->GetNextWaypoint();
+      if (!entry.empty()) {
+        polyline.push_back(entry.front()->GetLocation());
+      }
+      for (const SimpleWaypointPtr &waypoint : waypoints) {
+        polyline.push_back(waypoint->GetLocation());
+        width = std::max(width, waypoint->GetWaypoint()->GetLaneWidth());
+      }
+      if (!exit.empty()) {
+        polyline.push_back(exit.front()->GetLocation());
+      }
+      lane_keys.push_back(lane.first);
+      polylines.push_back(std::move(polyline));
+      widths.push_back(width);
+    }
+
+    // Lanes conflict when they overlap, their center lines being closer than
+    // half their widths, by more than the tolerance.
+    const size_t number_of_lanes = polylines.size();
+    std::vector<uint8_t> conflicts(number_of_lanes * number_of_lanes, 1u);
+    for (size_t i = 0u; i < number_of_lanes; ++i) {
+      for (size_t j = i + 1u; j < number_of_lanes; ++j) {
+        const float distance = static_cast<float>(0.5 * (widths[i] + widths[j])) - JUNCTION_LANE_OVERLAP_TOLERANCE;
+        const uint8_t conflict = PolylinesCloserThan(polylines[i], polylines[j], distance);
+        conflicts[i * number_of_lanes + j] = conflict;
+        conflicts[j * number_of_lanes + i] = conflict;
+      }
+    }
+    AddJunction(junction.first, lane_keys, std::move(conflicts));
+  }
+}
+
+bool JunctionConflictTable::HaveConflict(const SimpleWaypoint &lhs, const SimpleWaypoint &rhs) const {
+  const auto lhs_lane = lane_index.find(GetLaneKey(lhs));
+  const auto rhs_lane = lane_index.find(GetLaneKey(rhs));
+  if (lhs_lane == lane_index.end() || rhs_lane == lane_index.end()
+      || lhs_lane->second.first != rhs_lane->second.first) {
+    return true;
+  }
+  const JunctionLanes &junction = junctions[lhs_lane->second.first];
+  return junction.conflicts[lhs_lane->second.second * junction.number_of_lanes + rhs_lane->second.second] != 0u;
+}
+
+void JunctionConflictTable::Write(std::ofstream &out_file) const {
+
+  // Lane keys of each junction, in their position order.
+  std::vector<std::vector<uint64_t>> lane_keys(junctions.size());
+  for (const auto &lane : lane_index) {
+    std::vector<uint64_t> &keys = lane_keys[lane.second.first];
+    keys.resize(junctions[lane.second.first].number_of_lanes);
+    keys[lane.second.second] = lane.first;
+  }
+
+  WriteValue<uint32_t>(out_file, static_cast<uint32_t>(junctions.size()));
+  for (size_t i = 0u; i < junctions.size(); ++i) {
+    const JunctionLanes &junction = junctions[i];
+    WriteValue<int32_t>(out_file, junction.junction_id);
+    WriteValue<uint32_t>(out_file, junction.number_of_lanes);
+    for (const uint64_t key : lane_keys[i]) {
+      WriteValue<uint64_t>(out_file, key);
+    }
+    out_file.write(reinterpret_cast<const char *>(junction.conflicts.data()),
+                   static_cast<std::streamsize>(junction.conflicts.size()));
+  }
+}
+
+bool JunctionConflictTable::Read(const std::vector<uint8_t> &content, unsigned long &start) {
+
+  junctions.clear();
+  lane_index.clear();
+
+  uint32_t number_of_junctions;
+  if (!ReadValue<uint32_t>(content, start, number_of_junctions)) {
+    return false;
+  }
+  for (uint32_t i = 0u; i < number_of_junctions; ++i) {
+    int32_t junction_id;
+    uint32_t number_of_lanes;
+    if (!ReadValue<int32_t>(content, start, junction_id) ||
+        !ReadValue<uint32_t>(content, start, number_of_lanes)) {
+      break;
+    }
+    // Check the size of the junction before allocating anything for it.
+    const uint64_t size = static_cast<uint64_t>(number_of_lanes) * number_of_lanes;
+    const uint64_t remaining = content.size() - start;
+    if (static_cast<uint64_t>(number_of_lanes) * sizeof(uint64_t) + size > remaining) {
+      break;
+    }
+    std::vector<uint64_t> lane_keys(number_of_lanes);
+    for (uint64_t &key : lane_keys) {
+      ReadValue<uint64_t>(content, start, key);
+    }
+    std::vector<uint8_t> conflicts(content.begin() + static_cast<long>(start),
+                                   content.begin() + static_cast<long>(start + size));
+    start += size;
+    AddJunction(junction_id, lane_keys, std::move(conflicts));
+  }
+
+  if (junctions.size() != number_of_junctions) {
+    junctions.clear();
+    lane_index.clear();
+    return false;
+  }
+  return true;
+}
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,72 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "carla/road/RoadTypes.h"
+
+#include "carla/trafficmanager/SimpleWaypoint.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace crd = carla::road;
+
+using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
+
+/// This class stores, for every junction of the map, which pairs of its
+/// connecting lanes cross or merge, so the stages can check whether two
+/// vehicles inside a junction have conflicting paths without comparing
+/// their geometry.
+///
+/// Two connecting lanes conflict if, including the waypoints right before
+/// and after the junction, they overlap by more than
+/// JUNCTION_LANE_OVERLAP_TOLERANCE.
+class JunctionConflictTable {
+
+private:
+  /// Connecting lanes of a junction, and whether each pair of them conflict
+  /// in row major order.
+  struct JunctionLanes {
+    crd::JuncId junction_id;
+    uint32_t number_of_lanes;
+    std::vector<uint8_t> conflicts;
+  };
+  std::vector<JunctionLanes> junctions;
+  /// Junction and lane position of each connecting lane, by road and lane id.
+  std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> lane_index;
+
+  static uint64_t GetLaneKey(const crd::RoadId road_id, const crd::LaneId lane_id);
+
+  static uint64_t GetLaneKey(const SimpleWaypoint &waypoint);
+
+  void AddJunction(const crd::JuncId junction_id,
+                   const std::vector<uint64_t> &lane_keys,
+                   std::vector<uint8_t> conflicts);
+
+public:
+  /// Computes the conflicts of every junction in the dense topology.
+  void Build(const std::vector<SimpleWaypointPtr> &dense_topology);
+
+  /// Whether the connecting lanes of two junction waypoints cross or merge.
+  /// Waypoints on the same lane, in different junctions or not in any
+  /// junction are reported as conflicting.
+  bool HaveConflict(const SimpleWaypoint &lhs, const SimpleWaypoint &rhs) const;
+
+  void Write(std::ofstream &out_file) const;
+
+  /// Reads the table written at @a start of @a content, returns false and
+  /// leaves the table empty if the content is truncated.
+  bool Read(const std::vector<uint8_t> &content, unsigned long &start);
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -27,7 +27,7 @@ namespace traffic_manager {
   using ActorId = carla::ActorId;
   using ActorIdSet = std::unordered_set<ActorId>;
   using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-  using Buffer = std::deque<SimpleWaypointPtr>;
+  using Buffer = WaypointBuffer;
   using GeoGridId = carla::road::JuncId;
   using constants::Map::MAP_RESOLUTION;
   using constants::Map::INV_MAP_RESOLUTION;
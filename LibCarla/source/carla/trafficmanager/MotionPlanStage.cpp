@@ -39,7 +39,6 @@ MotionPlanStage::MotionPlanStage(
   const LocalizationFrame &localization_frame,
   const CollisionFrame&collision_frame,
   const TLFrame &tl_frame,
-  const cc::World &world,
   ControlFrame &output_array,
   RandomGenerator &random_device,
   const LocalMapPtr &local_map)
@@ -55,7 +54,6 @@ MotionPlanStage::MotionPlanStage(
     localization_frame(localization_frame),
     collision_frame(collision_frame),
     tl_frame(tl_frame),
-    world(world),
     output_array(output_array),
     random_device(random_device),
     local_map(local_map) {}
@@ -73,7 +71,7 @@ void MotionPlanStage::Update(const unsigned long index) {
   const LocalizationData &localization = localization_frame.at(index);
   const CollisionHazardData &collision_hazard = collision_frame.at(index);
   const bool &tl_hazard = tl_frame.at(index);
-  current_timestamp = world.GetSnapshot().GetTimestamp();
+  current_timestamp = simulation_state.GetTimestamp();
   StateEntry current_state;
 
   // Instanciating teleportation transform as current vehicle transform.
@@ -104,7 +102,8 @@ void MotionPlanStage::Update(const unsigned long index) {
 
     if (parameters.GetSynchronousMode() || elapsed_time > HYBRID_MODE_DT) {
       float random_sample = (static_cast<float>(random_device.next())*dilate_factor) + lower_bound;
-      NodeList teleport_waypoint_list = local_map->GetWaypointsInDelta(hero_location, ATTEMPTS_TO_TELEPORT, random_sample);
+      teleport_index.Update(*local_map, hero_location, upper_bound);
+      NodeList teleport_waypoint_list = teleport_index.GetWaypointsInDelta(hero_location, ATTEMPTS_TO_TELEPORT, random_sample);
       if (!teleport_waypoint_list.empty()) {
         for (auto &teleport_waypoint : teleport_waypoint_list) {
           GeoGridId geogrid_id = teleport_waypoint->GetGeodesicGridId();
@@ -473,6 +472,7 @@ void MotionPlanStage::RemoveActor(const ActorId actor_id) {
 void MotionPlanStage::Reset() {
   pid_state_map.clear();
   teleportation_instance.clear();
+  teleport_index.Reset();
 }
 
 } // namespace traffic_manager
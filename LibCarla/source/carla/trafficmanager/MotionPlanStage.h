@@ -5,6 +5,7 @@
 #pragma once
 
 #include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/HybridTeleportIndex.h"
 #include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/LocalizationUtils.h"
 #include "carla/trafficmanager/Parameters.h"
@@ -34,12 +35,13 @@ private:
   const LocalizationFrame &localization_frame;
   const CollisionFrame &collision_frame;
   const TLFrame &tl_frame;
-  const cc::World &world;
   // Structure holding the controller state for registered vehicles.
   std::unordered_map<ActorId, StateEntry> pid_state_map;
   // Structure to keep track of duration between teleportation
   // in hybrid physics mode.
   std::unordered_map<ActorId, cc::Timestamp> teleportation_instance;
+  // Waypoints around the hero where dormant vehicles can be respawned.
+  HybridTeleportIndex teleport_index;
   ControlFrame &output_array;
   cc::Timestamp current_timestamp;
   RandomGenerator &random_device;
@@ -80,7 +82,6 @@ public:
                   const LocalizationFrame &localization_frame,
                   const CollisionFrame &collision_frame,
                   const TLFrame &tl_frame,
-                  const cc::World &world,
                   ControlFrame &output_array,
                   RandomGenerator &random_device,
                   const LocalMapPtr &local_map);
@@ -193,6 +193,10 @@ void Parameters::SetOSMMode(const bool mode_switch) {
   osm_mode.store(mode_switch);
 }
 
+void Parameters::SetJunctionConflictMode(const bool mode_switch) {
+  junction_conflict_mode.store(mode_switch);
+}
+
 void Parameters::SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
   const auto entry = std::make_pair(actor->GetId(), path);
   custom_path.AddEntry(entry);
@@ -434,6 +438,11 @@ bool Parameters::GetOSMMode() const {
   return osm_mode.load();
 }
 
+bool Parameters::GetJunctionConflictMode() const {
+
+  return junction_conflict_mode.load();
+}
+
 bool Parameters::GetUploadPath(const ActorId &actor_id) const {
 
   bool custom_path_bool = false;
@@ -480,5 +489,121 @@ Route Parameters::GetImportedRoute(const ActorId &actor_id) const {
 }
 
 
+/////////////////////////////// RECORD AND REPLAY ///////////////////////////////
+
+template <typename T>
+static void ExportValue(const AtomicMap<ActorId, T> &map,
+                        const ActorId &actor_id,
+                        const uint32_t flag,
+                        uint32_t &flags,
+                        T &value) {
+  if (map.Contains(actor_id)) {
+    flags |= flag;
+    value = map.GetValue(actor_id);
+  }
+}
+
+template <typename T>
+static void ImportValue(AtomicMap<ActorId, T> &map,
+                        const ActorId &actor_id,
+                        const uint32_t flag,
+                        const uint32_t flags,
+                        const T &value) {
+  if ((flags & flag) != 0u) {
+    map.AddEntry({actor_id, value});
+  } else {
+    map.RemoveEntry(actor_id);
+  }
+}
+
+bool VehicleParameters::operator==(const VehicleParameters &rhs) const {
+  return flags == rhs.flags &&
+         percentage_speed_difference == rhs.percentage_speed_difference &&
+         lane_offset == rhs.lane_offset &&
+         desired_speed == rhs.desired_speed &&
+         distance_to_leading_vehicle == rhs.distance_to_leading_vehicle &&
+         perc_run_traffic_light == rhs.perc_run_traffic_light &&
+         perc_run_traffic_sign == rhs.perc_run_traffic_sign &&
+         perc_ignore_walkers == rhs.perc_ignore_walkers &&
+         perc_ignore_vehicles == rhs.perc_ignore_vehicles &&
+         perc_keep_right == rhs.perc_keep_right &&
+         perc_random_left == rhs.perc_random_left &&
+         perc_random_right == rhs.perc_random_right &&
+         auto_lane_change == rhs.auto_lane_change &&
+         update_vehicle_lights == rhs.update_vehicle_lights;
+}
+
+VehicleParameters Parameters::GetVehicleParameters(const ActorId &actor_id) const {
+
+  using VP = VehicleParameters;
+  VehicleParameters result;
+  uint32_t &flags = result.flags;
+  ExportValue(percentage_difference_from_speed_limit, actor_id, VP::PercentageSpeedDifference, flags, result.percentage_speed_difference);
+  ExportValue(lane_offset, actor_id, VP::LaneOffset, flags, result.lane_offset);
+  ExportValue(exact_desired_speed, actor_id, VP::DesiredSpeed, flags, result.desired_speed);
+  ExportValue(distance_to_leading_vehicle, actor_id, VP::DistanceToLeadingVehicle, flags, result.distance_to_leading_vehicle);
+  ExportValue(auto_lane_change, actor_id, VP::AutoLaneChange, flags, result.auto_lane_change);
+  ExportValue(perc_run_traffic_light, actor_id, VP::PercentageRunningLight, flags, result.perc_run_traffic_light);
+  ExportValue(perc_run_traffic_sign, actor_id, VP::PercentageRunningSign, flags, result.perc_run_traffic_sign);
+  ExportValue(perc_ignore_walkers, actor_id, VP::PercentageIgnoreWalkers, flags, result.perc_ignore_walkers);
+  ExportValue(perc_ignore_vehicles, actor_id, VP::PercentageIgnoreVehicles, flags, result.perc_ignore_vehicles);
+  ExportValue(perc_keep_right, actor_id, VP::KeepRightPercentage, flags, result.perc_keep_right);
+  ExportValue(perc_random_left, actor_id, VP::RandomLeftLaneChangePercentage, flags, result.perc_random_left);
+  ExportValue(perc_random_right, actor_id, VP::RandomRightLaneChangePercentage, flags, result.perc_random_right);
+  ExportValue(auto_update_vehicle_lights, actor_id, VP::UpdateVehicleLights, flags, result.update_vehicle_lights);
+  return result;
+}
+
+void Parameters::SetVehicleParameters(const ActorId &actor_id, const VehicleParameters &params) {
+
+  using VP = VehicleParameters;
+  const uint32_t flags = params.flags;
+  ImportValue(percentage_difference_from_speed_limit, actor_id, VP::PercentageSpeedDifference, flags, params.percentage_speed_difference);
+  ImportValue(lane_offset, actor_id, VP::LaneOffset, flags, params.lane_offset);
+  ImportValue(exact_desired_speed, actor_id, VP::DesiredSpeed, flags, params.desired_speed);
+  ImportValue(distance_to_leading_vehicle, actor_id, VP::DistanceToLeadingVehicle, flags, params.distance_to_leading_vehicle);
+  ImportValue(auto_lane_change, actor_id, VP::AutoLaneChange, flags, params.auto_lane_change);
+  ImportValue(perc_run_traffic_light, actor_id, VP::PercentageRunningLight, flags, params.perc_run_traffic_light);
+  ImportValue(perc_run_traffic_sign, actor_id, VP::PercentageRunningSign, flags, params.perc_run_traffic_sign);
+  ImportValue(perc_ignore_walkers, actor_id, VP::PercentageIgnoreWalkers, flags, params.perc_ignore_walkers);
+  ImportValue(perc_ignore_vehicles, actor_id, VP::PercentageIgnoreVehicles, flags, params.perc_ignore_vehicles);
+  ImportValue(perc_keep_right, actor_id, VP::KeepRightPercentage, flags, params.perc_keep_right);
+  ImportValue(perc_random_left, actor_id, VP::RandomLeftLaneChangePercentage, flags, params.perc_random_left);
+  ImportValue(perc_random_right, actor_id, VP::RandomRightLaneChangePercentage, flags, params.perc_random_right);
+  ImportValue(auto_update_vehicle_lights, actor_id, VP::UpdateVehicleLights, flags, params.update_vehicle_lights);
+}
+
+GlobalParameters Parameters::GetGlobalParameters() const {
+
+  GlobalParameters result;
+  result.percentage_speed_difference = global_percentage_difference_from_limit;
+  result.lane_offset = global_lane_offset;
+  result.distance_to_leading_vehicle = distance_margin.load();
+  result.hybrid_physics_radius = hybrid_physics_radius.load();
+  result.respawn_lower_bound = respawn_lower_bound.load();
+  result.respawn_upper_bound = respawn_upper_bound.load();
+  result.synchronous_mode = synchronous_mode.load();
+  result.hybrid_physics_mode = hybrid_physics_mode.load();
+  result.respawn_dormant_vehicles = respawn_dormant_vehicles.load();
+  result.osm_mode = osm_mode.load();
+  result.junction_conflict_mode = junction_conflict_mode.load();
+  return result;
+}
+
+void Parameters::SetGlobalParameters(const GlobalParameters &params) {
+
+  global_percentage_difference_from_limit = params.percentage_speed_difference;
+  global_lane_offset = params.lane_offset;
+  distance_margin.store(params.distance_to_leading_vehicle);
+  hybrid_physics_radius.store(params.hybrid_physics_radius);
+  respawn_lower_bound.store(params.respawn_lower_bound);
+  respawn_upper_bound.store(params.respawn_upper_bound);
+  synchronous_mode.store(params.synchronous_mode);
+  hybrid_physics_mode.store(params.hybrid_physics_mode);
+  respawn_dormant_vehicles.store(params.respawn_dormant_vehicles);
+  osm_mode.store(params.osm_mode);
+  junction_conflict_mode.store(params.junction_conflict_mode);
+}
+
 } // namespace traffic_manager
 } // namespace carla
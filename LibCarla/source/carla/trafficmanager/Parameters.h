@@ -14,6 +14,7 @@
 #include "carla/client/Actor.h"
 #include "carla/client/Vehicle.h"
 #include "carla/Memory.h"
+#include "carla/MsgPack.h"
 #include "carla/rpc/ActorId.h"
 
 #include "carla/trafficmanager/AtomicActorSet.h"
@@ -34,6 +35,74 @@ struct ChangeLaneInfo {
   bool direction = false;
 };
 
+/// Parameters set for a vehicle, used to record and replay the traffic
+/// manager. A value is only meaningful if its flag is set, otherwise the
+/// vehicle uses the default or the global value.
+struct VehicleParameters {
+  enum Flag : uint32_t {
+    PercentageSpeedDifference = 1u << 0u,
+    LaneOffset = 1u << 1u,
+    DesiredSpeed = 1u << 2u,
+    DistanceToLeadingVehicle = 1u << 3u,
+    AutoLaneChange = 1u << 4u,
+    PercentageRunningLight = 1u << 5u,
+    PercentageRunningSign = 1u << 6u,
+    PercentageIgnoreWalkers = 1u << 7u,
+    PercentageIgnoreVehicles = 1u << 8u,
+    KeepRightPercentage = 1u << 9u,
+    RandomLeftLaneChangePercentage = 1u << 10u,
+    RandomRightLaneChangePercentage = 1u << 11u,
+    UpdateVehicleLights = 1u << 12u
+  };
+
+  uint32_t flags = 0u;
+  float percentage_speed_difference = 0.0f;
+  float lane_offset = 0.0f;
+  float desired_speed = 0.0f;
+  float distance_to_leading_vehicle = 0.0f;
+  float perc_run_traffic_light = 0.0f;
+  float perc_run_traffic_sign = 0.0f;
+  float perc_ignore_walkers = 0.0f;
+  float perc_ignore_vehicles = 0.0f;
+  float perc_keep_right = 0.0f;
+  float perc_random_left = 0.0f;
+  float perc_random_right = 0.0f;
+  bool auto_lane_change = false;
+  bool update_vehicle_lights = false;
+
+  bool operator==(const VehicleParameters &rhs) const;
+
+  bool operator!=(const VehicleParameters &rhs) const {
+    return !(*this == rhs);
+  }
+
+  MSGPACK_DEFINE_ARRAY(flags, percentage_speed_difference, lane_offset, desired_speed,
+                       distance_to_leading_vehicle, perc_run_traffic_light, perc_run_traffic_sign,
+                       perc_ignore_walkers, perc_ignore_vehicles, perc_keep_right,
+                       perc_random_left, perc_random_right, auto_lane_change, update_vehicle_lights);
+};
+
+/// Parameters common to all vehicles, used to record and replay the traffic
+/// manager.
+struct GlobalParameters {
+  float percentage_speed_difference = 0.0f;
+  float lane_offset = 0.0f;
+  float distance_to_leading_vehicle = 0.0f;
+  float hybrid_physics_radius = 0.0f;
+  float respawn_lower_bound = 0.0f;
+  float respawn_upper_bound = 0.0f;
+  bool synchronous_mode = false;
+  bool hybrid_physics_mode = false;
+  bool respawn_dormant_vehicles = false;
+  bool osm_mode = false;
+  bool junction_conflict_mode = false;
+
+  MSGPACK_DEFINE_ARRAY(percentage_speed_difference, lane_offset, distance_to_leading_vehicle,
+                       hybrid_physics_radius, respawn_lower_bound, respawn_upper_bound,
+                       synchronous_mode, hybrid_physics_mode, respawn_dormant_vehicles, osm_mode,
+                       junction_conflict_mode);
+};
+
 class Parameters {
 
 private:
@@ -91,6 +160,9 @@ private:
   std::atomic<float> hybrid_physics_radius {70.0};
   /// Parameter specifying Open Street Map mode.
   std::atomic<bool> osm_mode {true};
+  /// Parameter specifying if vehicles on non-conflicting lanes of a junction
+  /// may drive through it together.
+  std::atomic<bool> junction_conflict_mode {false};
   /// Parameter specifying if importing a custom path.
   AtomicMap<ActorId, bool> upload_path;
   /// Structure to hold all custom paths.
@@ -184,6 +256,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set junction conflict mode.
+  void SetJunctionConflictMode(const bool mode_switch);
+
   /// Method to set if we are automatically respawning vehicles.
   void SetRespawnDormantVehicles(const bool mode_switch);
 
@@ -279,6 +354,9 @@ public:
   /// Method to get Open Street Map mode.
   bool GetOSMMode() const;
 
+  /// Method to get junction conflict mode.
+  bool GetJunctionConflictMode() const;
+
   /// Method to get if we are uploading a path.
   bool GetUploadPath(const ActorId &actor_id) const;
 
@@ -291,6 +369,18 @@ public:
   /// Method to get a custom route.
   Route GetImportedRoute(const ActorId &actor_id) const;
 
+  /// Method to get all the parameters set for a vehicle.
+  VehicleParameters GetVehicleParameters(const ActorId &actor_id) const;
+
+  /// Method to replace all the parameters of a vehicle.
+  void SetVehicleParameters(const ActorId &actor_id, const VehicleParameters &vehicle_parameters);
+
+  /// Method to get the parameters common to all vehicles.
+  GlobalParameters GetGlobalParameters() const;
+
+  /// Method to replace the parameters common to all vehicles.
+  void SetGlobalParameters(const GlobalParameters &global_parameters);
+
   /// Synchronous mode time out variable.
   std::chrono::duration<double, std::milli> synchronous_time_out;
 };
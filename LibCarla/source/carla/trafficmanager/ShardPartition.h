@@ -0,0 +1,45 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <vector>
+
+#include "carla/rpc/ActorId.h"
+
+namespace carla {
+namespace traffic_manager {
+
+using ActorId = carla::ActorId;
+
+/// This class assigns the vehicles of a traffic manager to its shards, zero
+/// being the traffic manager owning the others. A vehicle's shard only
+/// depends on its actor id and the number of shards, so the same vehicles
+/// always run together for a given number of shards.
+class ShardPartition {
+
+public:
+  /// Index of the shard running the vehicle with @a actor_id.
+  static size_t GetIndex(const ActorId actor_id, const size_t number_of_shards) {
+    return number_of_shards > 1u ? actor_id % number_of_shards : 0u;
+  }
+
+  /// Splits @a list by the shard running each of its elements, keeping their
+  /// order. @a get_id returns the actor id of an element.
+  template <typename T, typename GetIdT>
+  static std::vector<std::vector<T>> Split(const std::vector<T> &list,
+                                           const size_t number_of_shards,
+                                           GetIdT &&get_id) {
+    std::vector<std::vector<T>> shard_lists(number_of_shards > 1u ? number_of_shards : 1u);
+    for (const T &element : list) {
+      shard_lists[GetIndex(get_id(element), number_of_shards)].push_back(element);
+    }
+    return shard_lists;
+  }
+};
+
+} // namespace traffic_manager
+} // namespace carla
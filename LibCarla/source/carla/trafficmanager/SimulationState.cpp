@@ -32,6 +32,7 @@ void SimulationState::Reset() {
   kinematic_state_map.clear();
   static_attribute_map.clear();
   tl_state_map.clear();
+  timestamp = cc::Timestamp();
 }
 
 void SimulationState::UpdateKinematicState(ActorId actor_id, KinematicState state) {
@@ -54,6 +55,14 @@ void SimulationState::UpdateTrafficLightState(ActorId actor_id, TrafficLightStat
   tl_state_map.at(actor_id) = state;
 }
 
+void SimulationState::SetTimestamp(const cc::Timestamp &current_timestamp) {
+  timestamp = current_timestamp;
+}
+
+const cc::Timestamp &SimulationState::GetTimestamp() const {
+  return timestamp;
+}
+
 cg::Location SimulationState::GetLocation(ActorId actor_id) const {
   return kinematic_state_map.at(actor_id).location;
 }
@@ -3,6 +3,7 @@
 
 #include <unordered_set>
 
+#include "carla/client/Timestamp.h"
 #include "carla/trafficmanager/DataStructures.h"
 
 namespace carla {
@@ -51,6 +52,8 @@ private:
   StaticAttributeMap static_attribute_map;
   // Structure containing dynamic traffic light related state of actors.
   TrafficLightStateMap tl_state_map;
+  // Timestamp of the frame the states belong to.
+  cc::Timestamp timestamp;
 
 public :
   SimulationState();
@@ -76,6 +79,10 @@ public :
 
   void UpdateTrafficLightState(ActorId actor_id, TrafficLightState state);
 
+  void SetTimestamp(const cc::Timestamp &current_timestamp);
+
+  const cc::Timestamp &GetTimestamp() const;
+
   cg::Location GetLocation(const ActorId actor_id) const;
 
   cg::Location GetHybridEndLocation(const ActorId actor_id) const;
@@ -100,6 +107,17 @@ public :
 
   cg::Vector3D GetDimensions(const ActorId actor_id) const;
 
+  // Method to visit the states of all actors, used to record them.
+  template <typename Functor>
+  void ForEachActor(Functor &&functor) const {
+    for (const ActorId actor_id : actor_set) {
+      functor(actor_id,
+              kinematic_state_map.at(actor_id),
+              static_attribute_map.at(actor_id),
+              tl_state_map.at(actor_id));
+    }
+  }
+
 };
 
 } // namespace traffic_manager
@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "carla/trafficmanager/Constants.h"
 
 #include "carla/trafficmanager/TrackTraffic.h"
@@ -16,13 +18,13 @@ void TrackTraffic::UpdateUnregisteredGridPosition(const ActorId actor_id,
 
     DeleteActor(actor_id);
 
-    std::unordered_set<GeoGridId> current_grids;
+    GridList current_grids;
     // Step through waypoints and update grid list for actor and actor list for grids.
     for (auto &waypoint : waypoints) {
         UpdatePassingVehicle(waypoint->GetId(), actor_id);
 
         GeoGridId ggid = waypoint->GetGeodesicGridId();
-        current_grids.insert(ggid);
+        current_grids.push_back(ggid);
 
         if (grid_to_actors.find(ggid) != grid_to_actors.end()) {
             ActorIdSet &actor_ids = grid_to_actors.at(ggid);
@@ -34,44 +36,47 @@ void TrackTraffic::UpdateUnregisteredGridPosition(const ActorId actor_id,
         }
     }
 
-    actor_to_grids.insert({actor_id, current_grids});
+    std::sort(current_grids.begin(), current_grids.end());
+    current_grids.erase(std::unique(current_grids.begin(), current_grids.end()), current_grids.end());
+    actor_to_grids.insert({actor_id, std::move(current_grids)});
 }
 
 void TrackTraffic::UpdateGridPosition(const ActorId actor_id, const Buffer &buffer) {
     if (!buffer.empty()) {
 
-        // Clear current actor from all grids containing itself.
-        if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
-            std::unordered_set<GeoGridId> &current_grids = actor_to_grids.at(actor_id);
-            for (auto &grid_id : current_grids) {
-                if (grid_to_actors.find(grid_id) != grid_to_actors.end()) {
-                    ActorIdSet &actor_ids = grid_to_actors.at(grid_id);
-                    actor_ids.erase(actor_id);
-                }
+        // Step through buffer and collect its grids, consecutive waypoints mostly share their grid.
+        grid_scratch.clear();
+        for (const SimpleWaypointPtr &waypoint : buffer) {
+            const GeoGridId ggid = waypoint->GetGeodesicGridId();
+            if (grid_scratch.empty() || grid_scratch.back() != ggid) {
+                grid_scratch.push_back(ggid);
             }
-
-            actor_to_grids.erase(actor_id);
         }
-
-        // Step through buffer and update grid list for actor and actor list for grids.
-        std::unordered_set<GeoGridId> current_grids;
-        uint64_t buffer_size = buffer.size();
-        for (uint64_t i = 0u; i <= buffer_size - 1u; ++i) {
-            auto waypoint = buffer.at(i);
-            GeoGridId ggid = waypoint->GetGeodesicGridId();
-            current_grids.insert(ggid);
-            // Add grid entry if not present.
-            if (grid_to_actors.find(ggid) == grid_to_actors.end()) {
-                grid_to_actors.insert({ggid, {}});
-            }
-
-            ActorIdSet &actor_ids = grid_to_actors.at(ggid);
-            if (actor_ids.find(actor_id) == actor_ids.end()) {
-                actor_ids.insert(actor_id);
+        std::sort(grid_scratch.begin(), grid_scratch.end());
+        grid_scratch.erase(std::unique(grid_scratch.begin(), grid_scratch.end()), grid_scratch.end());
+
+        // Update actor list only for the grids the actor left or entered since the last update.
+        GridList &previous_grids = actor_to_grids[actor_id];
+        auto previous = previous_grids.begin();
+        auto current = grid_scratch.begin();
+        while (previous != previous_grids.end() || current != grid_scratch.end()) {
+            if (current == grid_scratch.end() || (previous != previous_grids.end() && *previous < *current)) {
+                auto grid = grid_to_actors.find(*previous);
+                if (grid != grid_to_actors.end()) {
+                    grid->second.erase(actor_id);
+                }
+                ++previous;
+            } else if (previous == previous_grids.end() || *current < *previous) {
+                grid_to_actors[*current].insert(actor_id);
+                ++current;
+            } else {
+                ++previous;
+                ++current;
             }
         }
 
-        actor_to_grids.insert({actor_id, current_grids});
+        // Keep the previous list allocation for the next update.
+        previous_grids.swap(grid_scratch);
     }
 }
 
@@ -102,7 +107,7 @@ ActorIdSet TrackTraffic::GetOverlappingVehicles(ActorId actor_id) const {
     ActorIdSet actor_id_set;
 
     if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
-        const std::unordered_set<GeoGridId> &grid_ids = actor_to_grids.at(actor_id);
+        const GridList &grid_ids = actor_to_grids.at(actor_id);
         for (auto &grid_id : grid_ids) {
             if (grid_to_actors.find(grid_id) != grid_to_actors.end()) {
                 const ActorIdSet &actor_ids = grid_to_actors.at(grid_id);
@@ -116,7 +121,7 @@ ActorIdSet TrackTraffic::GetOverlappingVehicles(ActorId actor_id) const {
 
 void TrackTraffic::DeleteActor(ActorId actor_id) {
     if (actor_to_grids.find(actor_id) != actor_to_grids.end()) {
-        std::unordered_set<GeoGridId> &grid_ids = actor_to_grids.at(actor_id);
+        GridList &grid_ids = actor_to_grids.at(actor_id);
         for (auto &grid_id : grid_ids) {
             if (grid_to_actors.find(grid_id) != grid_to_actors.end()) {
                 ActorIdSet &actor_ids = grid_to_actors.at(grid_id);
@@ -135,41 +140,28 @@ void TrackTraffic::DeleteActor(ActorId actor_id) {
 }
 
 void TrackTraffic::UpdatePassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
-    if (waypoint_overlap_tracker.find(waypoint_id) != waypoint_overlap_tracker.end()) {
-        ActorIdSet &actor_id_set = waypoint_overlap_tracker.at(waypoint_id);
-        if (actor_id_set.find(actor_id) == actor_id_set.end()) {
-            actor_id_set.insert(actor_id);
-        }
-    } else {
-        waypoint_overlap_tracker.insert({waypoint_id, {actor_id}});
-    }
-
-    if (waypoint_occupied.find(actor_id) != waypoint_occupied.end()) {
-        WaypointIdSet &waypoint_id_set = waypoint_occupied.at(actor_id);
-        if (waypoint_id_set.find(waypoint_id) == waypoint_id_set.end()) {
-            waypoint_id_set.insert(waypoint_id);
-        }
-    } else {
-        waypoint_occupied.insert({actor_id, {waypoint_id}});
-    }
+    waypoint_overlap_tracker[waypoint_id].insert(actor_id);
+    waypoint_occupied[actor_id].insert(waypoint_id);
 }
 
 void TrackTraffic::RemovePassingVehicle(uint64_t waypoint_id, ActorId actor_id) {
-    if (waypoint_overlap_tracker.find(waypoint_id) != waypoint_overlap_tracker.end()) {
-        ActorIdSet &actor_id_set = waypoint_overlap_tracker.at(waypoint_id);
+    auto overlap = waypoint_overlap_tracker.find(waypoint_id);
+    if (overlap != waypoint_overlap_tracker.end()) {
+        ActorIdSet &actor_id_set = overlap->second;
         actor_id_set.erase(actor_id);
 
         if (actor_id_set.size() == 0) {
-            waypoint_overlap_tracker.erase(waypoint_id);
+            waypoint_overlap_tracker.erase(overlap);
         }
     }
 
-    if (waypoint_occupied.find(actor_id) != waypoint_occupied.end()) {
-        WaypointIdSet &waypoint_id_set = waypoint_occupied.at(actor_id);
+    auto occupied = waypoint_occupied.find(actor_id);
+    if (occupied != waypoint_occupied.end()) {
+        WaypointIdSet &waypoint_id_set = occupied->second;
         waypoint_id_set.erase(waypoint_id);
 
         if (waypoint_id_set.size() == 0) {
-            waypoint_occupied.erase(actor_id);
+            waypoint_occupied.erase(occupied);
         }
     }
 }
@@ -1,10 +1,15 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "carla/road/RoadTypes.h"
 #include "carla/rpc/ActorId.h"
 
 #include "carla/trafficmanager/SimpleWaypoint.h"
+#include "carla/trafficmanager/WaypointBuffer.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -12,7 +17,7 @@ namespace traffic_manager {
 using ActorId = carla::ActorId;
 using ActorIdSet = std::unordered_set<ActorId>;
 using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
-using Buffer = std::deque<SimpleWaypointPtr>;
+using Buffer = WaypointBuffer;
 using GeoGridId = carla::road::JuncId;
 
 // This class is used to track the waypoint occupancy of all the actors.
@@ -28,8 +33,11 @@ private:
     using WaypointOccupancyMap = std::unordered_map<ActorId, WaypointIdSet>;
     WaypointOccupancyMap waypoint_occupied;
 
-    /// Geodesic grids occupied by actors's paths.
-    std::unordered_map<ActorId, std::unordered_set<GeoGridId>> actor_to_grids;
+    /// Geodesic grids occupied by actors's paths, sorted by grid id.
+    using GridList = std::vector<GeoGridId>;
+    std::unordered_map<ActorId, GridList> actor_to_grids;
+    /// Grids of the buffer being updated, reused between updates.
+    GridList grid_scratch;
     /// Actors currently passing through grids.
     std::unordered_map<GeoGridId, ActorIdSet> grid_to_actors;
     /// Current hero location.
@@ -17,14 +17,14 @@ TrafficLightStage::TrafficLightStage(
   const SimulationState &simulation_state,
   const BufferMap &buffer_map,
   const Parameters &parameters,
-  const cc::World &world,
+  const LocalMapPtr &local_map,
   TLFrame &output_array,
   RandomGenerator &random_device)
   : vehicle_id_list(vehicle_id_list),
     simulation_state(simulation_state),
     buffer_map(buffer_map),
     parameters(parameters),
-    world(world),
+    local_map(local_map),
     output_array(output_array),
     random_device(random_device) {}
 
@@ -40,7 +40,7 @@ void TrafficLightStage::Update(const unsigned long index) {
     }
     auto affected_junction_id = GetAffectedJunctionId(ego_actor_id);
 
-    current_timestamp = world.GetSnapshot().GetTimestamp();
+    current_timestamp = simulation_state.GetTimestamp();
 
     const TrafficLightState tl_state = simulation_state.GetTLS(ego_actor_id);
     const TLS traffic_light_state = tl_state.tl_state;
@@ -116,12 +116,23 @@ bool TrafficLightStage::HandleNonSignalisedJunction(const ActorId ego_actor_id,
     traffic_light_hazard = true;
   }
 
-  else if (entering_vehicles.front() == ego_actor_id) {
+  else if (entering_vehicles.front() == ego_actor_id || parameters.GetJunctionConflictMode()) {
     auto entry_elapsed_seconds = vehicle_stop_time.at(ego_actor_id).elapsed_seconds;
     if (timestamp.elapsed_seconds - entry_elapsed_seconds < MINIMUM_STOP_TIME) {
       // Wait at least the minimum amount of time before entering the junction
       traffic_light_hazard = true;
     }
+    else if (entering_vehicles.front() != ego_actor_id) {
+      // Vehicles that arrived earlier have priority, so only enter
+      // if the path through the junction is clear of all of theirs.
+      const SimpleWaypointPtr ego_lane = GetJunctionLane(ego_actor_id, junction_id);
+      const JunctionConflictTable &junction_conflicts = local_map->GetJunctionConflicts();
+      for (auto it = entering_vehicles.begin(); *it != ego_actor_id && !traffic_light_hazard; ++it) {
+        const SimpleWaypointPtr other_lane = GetJunctionLane(*it, junction_id);
+        traffic_light_hazard = ego_lane == nullptr || other_lane == nullptr
+                               || junction_conflicts.HaveConflict(*ego_lane, *other_lane);
+      }
+    }
   } else {
     // Only one vehicle can be entering the junction, so stop the rest.
     traffic_light_hazard = true;
@@ -129,6 +140,18 @@ bool TrafficLightStage::HandleNonSignalisedJunction(const ActorId ego_actor_id,
   return traffic_light_hazard;
 }
 
+SimpleWaypointPtr TrafficLightStage::GetJunctionLane(const ActorId actor_id, const JunctionID junction_id) const {
+  const auto waypoint_buffer = buffer_map.find(actor_id);
+  if (waypoint_buffer != buffer_map.end()) {
+    for (const SimpleWaypointPtr &waypoint : waypoint_buffer->second) {
+      if (waypoint->GetJunctionId() == junction_id) {
+        return waypoint;
+      }
+    }
+  }
+  return nullptr;
+}
+
 JunctionID TrafficLightStage::GetAffectedJunctionId(const ActorId ego_actor_id) {
     const Buffer &waypoint_buffer = buffer_map.at(ego_actor_id);
     const SimpleWaypointPtr look_ahead_point = GetTargetWaypoint(waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
 #include "carla/trafficmanager/SimulationState.h"
@@ -10,6 +11,8 @@
 namespace carla {
 namespace traffic_manager {
 
+using LocalMapPtr = std::shared_ptr<InMemoryMap>;
+
 /// This class has functionality for responding to traffic lights
 /// and managing entry into non-signalized junctions.
 class TrafficLightStage: Stage {
@@ -18,7 +21,7 @@ private:
   const SimulationState &simulation_state;
   const BufferMap &buffer_map;
   const Parameters &parameters;
-  const cc::World &world;
+  const LocalMapPtr &local_map;
 
   /// Variables used to handle non signalized junctions
 
@@ -34,13 +37,18 @@ private:
 
   /// This controls all vehicle's interactions at non signalized junctions. Priorities are done by order of arrival
   /// and no two vehicle will enter the junction at the same time. Only once it is exiting can the next one enter.
-  /// Additionally, all vehicles will always brake at the stop sign for a set amount of time.
+  /// In junction conflict mode, a vehicle may also enter if its connecting lane neither crosses nor merges with the
+  /// ones of the vehicles that arrived before it. Additionally, all vehicles will always brake at the stop sign for a
+  /// set amount of time.
   bool HandleNonSignalisedJunction(const ActorId ego_actor_id, const JunctionID junction_id,
                                    cc::Timestamp timestamp);
 
   /// Initialized the vehicle to the non-signalized junction maps
   void AddActorToNonSignalisedJunction(const ActorId ego_actor_id, const JunctionID junction_id);
 
+  /// Get the first waypoint of the vehicle's path inside the junction, nullptr if there is none.
+  SimpleWaypointPtr GetJunctionLane(const ActorId actor_id, const JunctionID junction_id) const;
+
   /// Get current affected junction id for the vehicle
   JunctionID GetAffectedJunctionId(const ActorId ego_actor_id);
 
@@ -49,7 +57,7 @@ public:
                     const SimulationState &Simulation_state,
                     const BufferMap &buffer_map,
                     const Parameters &parameters,
-                    const cc::World &world,
+                    const LocalMapPtr &local_map,
                     TLFrame &output_array,
                     RandomGenerator &random_device);
 
@@ -65,6 +65,15 @@ public:
     }
   }
 
+  /// Method to let vehicles on connecting lanes of a junction that neither
+  /// cross nor merge drive through it together.
+  void SetJunctionConflictMode(const bool mode_switch) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->SetJunctionConflictMode(mode_switch);
+    }
+  }
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
     TrafficManagerBase* tm_ptr = GetTM(_port);
@@ -302,6 +311,18 @@ public:
     }
   }
 
+  /// Method to split the registered vehicles by actor id among a number of
+  /// traffic manager shards, each one running its cycle on its own thread.
+  /// The shards have no port, clients reach them through this traffic manager.
+  /// This changes the behaviour: vehicles only see the ones of other shards
+  /// as unregistered actors, without their paths or junction queues.
+  void SetNumberOfShards(const uint32_t number_of_shards) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if(tm_ptr != nullptr){
+      tm_ptr->SetNumberOfShards(number_of_shards);
+    }
+  }
+
   /// Method to provide synchronous tick.
   bool SynchronousTick() {
     TrafficManagerBase* tm_ptr = GetTM(_port);
@@ -353,6 +374,24 @@ public:
 
   void ShutDown();
 
+  /// Method to start recording the inputs and outputs of every cycle to a
+  /// file, to be replayed offline with TrafficManagerReplay. Not available
+  /// while the traffic manager is split into shards.
+  void StartRecorder(const std::string &filename) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->StartRecorder(filename);
+    }
+  }
+
+  /// Method to stop recording.
+  void StopRecorder() {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      tm_ptr->StopRecorder();
+    }
+  }
+
   /// Method to get the next action.
   Action GetNextAction(const ActorId &actor_id) {
     Action next_action;
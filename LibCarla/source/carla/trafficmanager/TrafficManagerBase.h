@@ -107,6 +107,9 @@ public:
   /// Method to provide synchronous tick
   virtual bool SynchronousTick() = 0;
 
+  /// Method to split the registered vehicles among a number of traffic manager shards.
+  virtual void SetNumberOfShards(const uint32_t number_of_shards) = 0;
+
   /// Get carla episode information
   virtual  carla::client::detail::EpisodeProxy& GetEpisodeProxy() = 0;
 
@@ -134,6 +137,9 @@ public:
   /// Method to set Open Street Map mode.
   virtual void SetOSMMode(const bool mode_switch) = 0;
 
+  /// Method to set junction conflict mode.
+  virtual void SetJunctionConflictMode(const bool mode_switch) = 0;
+
   /// Method to set our own imported path.
   virtual void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) = 0;
 
@@ -167,6 +173,12 @@ public:
   /// Method to get the vehicle's action buffer.
   virtual ActionBuffer GetActionBuffer(const ActorId &actor_id) = 0;
 
+  /// Method to start recording the inputs and outputs of every cycle to a file.
+  virtual void StartRecorder(const std::string &filename) = 0;
+
+  /// Method to stop recording.
+  virtual void StopRecorder() = 0;
+
   virtual void ShutDown() = 0;
 
 protected:
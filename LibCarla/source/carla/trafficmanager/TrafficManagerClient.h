@@ -176,6 +176,12 @@ public:
     _client->call("set_synchronous_mode_timeout_in_milisecond", time);
   }
 
+  /// Method to split the registered vehicles among a number of traffic manager shards.
+  void SetNumberOfShards(const uint32_t number_of_shards) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_number_of_shards", number_of_shards);
+  }
+
   /// Method to provide synchronous tick.
   bool SynchronousTick() {
     DEBUG_ASSERT(_client != nullptr);
@@ -237,6 +243,12 @@ public:
     _client->call("set_osm_mode", mode_switch);
   }
 
+  /// Method to set junction conflict mode.
+  void SetJunctionConflictMode(const bool mode_switch) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("set_junction_conflict_mode", mode_switch);
+  }
+
   /// Method to set our own imported path.
   void SetCustomPath(const carla::rpc::Actor &actor, const Path path, const bool empty_buffer) {
     DEBUG_ASSERT(_client != nullptr);
@@ -310,6 +322,18 @@ public:
     _client->call("shut_down");
   }
 
+  /// Method to start recording the inputs and outputs of every cycle to a file.
+  void StartRecorder(const std::string &filename) {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("start_recorder", filename);
+  }
+
+  /// Method to stop recording.
+  void StopRecorder() {
+    DEBUG_ASSERT(_client != nullptr);
+    _client->call("stop_recorder");
+  }
+
 private:
 
   /// RPC client.
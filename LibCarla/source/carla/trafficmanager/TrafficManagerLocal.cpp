@@ -6,7 +6,9 @@
 
 #include <algorithm>
 
+#include "carla/Exception.h"
 #include "carla/Logging.h"
+#include "carla/profiler/Profiler.h"
 
 #include "carla/client/detail/Simulator.h"
 
@@ -24,7 +26,8 @@ TrafficManagerLocal::TrafficManagerLocal(
   std::vector<float> lateral_highway_PID_parameters,
   float perc_difference_from_limit,
   cc::detail::EpisodeProxy &episode_proxy,
-  uint16_t &RPCportTM)
+  uint16_t &RPCportTM,
+  TrafficManagerLocal *leader)
 
   : longitudinal_PID_parameters(longitudinal_PID_parameters),
     longitudinal_highway_PID_parameters(longitudinal_highway_PID_parameters),
@@ -34,6 +37,8 @@ TrafficManagerLocal::TrafficManagerLocal(
     episode_proxy(episode_proxy),
     world(cc::World(episode_proxy)),
 
+    parameters(leader == nullptr ? own_parameters : leader->parameters),
+
     localization_stage(LocalizationStage(vehicle_id_list,
                                          buffer_map,
                                          simulation_state,
@@ -49,6 +54,7 @@ TrafficManagerLocal::TrafficManagerLocal(
                                    buffer_map,
                                    track_traffic,
                                    parameters,
+                                   local_map,
                                    collision_frame,
                                    random_device)),
 
@@ -56,7 +62,7 @@ TrafficManagerLocal::TrafficManagerLocal(
                                           simulation_state,
                                           buffer_map,
                                           parameters,
-                                          world,
+                                          local_map,
                                           tl_frame,
                                           random_device)),
 
@@ -72,7 +78,6 @@ TrafficManagerLocal::TrafficManagerLocal(
                                       localization_frame,
                                       collision_frame,
                                       tl_frame,
-                                      world,
                                       control_frame,
                                       random_device,
                                       local_map)),
@@ -97,9 +102,15 @@ TrafficManagerLocal::TrafficManagerLocal(
               motion_plan_stage,
               vehicle_light_stage)),
 
-    server(TrafficManagerServer(RPCportTM, static_cast<carla::traffic_manager::TrafficManagerBase *>(this))) {
+    server(leader == nullptr
+           ? std::make_unique<TrafficManagerServer>(RPCportTM, static_cast<carla::traffic_manager::TrafficManagerBase *>(this))
+           : nullptr),
 
-  parameters.SetGlobalPercentageSpeedDifference(perc_difference_from_limit);
+    leader(leader) {
+
+  if (leader == nullptr) {
+    parameters.SetGlobalPercentageSpeedDifference(perc_difference_from_limit);
+  }
 
   registered_vehicles_state = -1;
 
@@ -109,11 +120,19 @@ TrafficManagerLocal::TrafficManagerLocal(
 }
 
 TrafficManagerLocal::~TrafficManagerLocal() {
-  episode_proxy.Lock()->DestroyTrafficManager(server.port());
+  if (server) {
+    episode_proxy.Lock()->DestroyTrafficManager(server->port());
+  }
   Release();
 }
 
 void TrafficManagerLocal::SetupLocalMap() {
+  // Shards only read the map, so they share the leader's.
+  if (leader != nullptr) {
+    local_map = leader->local_map;
+    return;
+  }
+
   const carla::SharedPtr<const cc::Map> world_map = world.GetMap();
   local_map = std::make_shared<InMemoryMap>(world_map);
 
@@ -179,9 +198,14 @@ void TrafficManagerLocal::Run() {
       last_frame = timestamp.frame;
     }
 
+    CARLA_PROFILE_SPAN(traffic_manager, cycle);
+
     std::unique_lock<std::mutex> registration_lock(registration_mutex);
     // Updating simulation state, actor life cycle and performing necessary cleanup.
-    alsm.Update();
+    {
+      CARLA_PROFILE_SPAN(traffic_manager, alsm);
+      alsm.Update();
+    }
 
     // Re-allocating inter-stage communication frames based on changed number of registered vehicles.
     int current_registered_vehicles_state = registered_vehicles.GetState();
@@ -218,26 +242,47 @@ void TrafficManagerLocal::Run() {
     // that will be inserted by the motion_plan_stage stage.
     control_frame.resize(number_of_vehicles);
 
+    if (recorder) {
+      recorder->RecordInputs(vehicle_id_list, simulation_state, parameters, track_traffic);
+    }
+
     // Run core operation stages.
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      localization_stage.Update(index);
+    {
+      CARLA_PROFILE_SPAN(traffic_manager, localization_stage);
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        localization_stage.Update(index);
+      }
     }
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      collision_stage.Update(index);
+    {
+      CARLA_PROFILE_SPAN(traffic_manager, collision_stage);
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        collision_stage.Update(index);
+      }
+      collision_stage.ClearCycleCache();
     }
-    collision_stage.ClearCycleCache();
-    vehicle_light_stage.UpdateWorldInfo();
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      traffic_light_stage.Update(index);
-      motion_plan_stage.Update(index);
-      vehicle_light_stage.Update(index);
+    {
+      CARLA_PROFILE_SPAN(traffic_manager, planning_stages);
+      vehicle_light_stage.UpdateWorldInfo();
+      if (recorder) {
+        recorder->RecordWorldInfo(vehicle_light_stage.GetLightStates(), vehicle_light_stage.GetWeather());
+      }
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        traffic_light_stage.Update(index);
+        motion_plan_stage.Update(index);
+        vehicle_light_stage.Update(index);
+      }
+    }
+    CARLA_PROFILE_HISTOGRAM(traffic_manager, vehicles_per_cycle, vehicle_id_list.size());
+
+    if (recorder) {
+      recorder->RecordOutputs(control_frame);
     }
 
     registration_lock.unlock();
 
     // Sending the current cycle's batch command to the simulator.
+    // In synchronous mode SynchronousTick sends it with the ones of the other shards.
     if (synchronous_mode) {
-      episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
       step_end.store(true);
       step_end_trigger.notify_one();
     } else {
@@ -248,20 +293,135 @@ void TrafficManagerLocal::Run() {
   }
 }
 
+void TrafficManagerLocal::BeginSynchronousStep() {
+  step_begin.store(true);
+  step_begin_trigger.notify_one();
+}
+
+void TrafficManagerLocal::EndSynchronousStep() {
+  std::unique_lock<std::mutex> lock(step_execution_mutex);
+  step_end_trigger.wait(lock, [this]() { return step_end.load(); });
+  step_end.store(false);
+}
+
 bool TrafficManagerLocal::SynchronousTick() {
   if (parameters.GetSynchronousMode()) {
-    step_begin.store(true);
-    step_begin_trigger.notify_one();
+    std::lock_guard<std::mutex> shard_lock(shard_mutex);
 
-    std::unique_lock<std::mutex> lock(step_execution_mutex);
-    step_end_trigger.wait(lock, [this]() { return step_end.load(); });
-    step_end.store(false);
+    // Run the cycles of all the shards in parallel.
+    BeginSynchronousStep();
+    for (auto &shard : shards) {
+      shard->BeginSynchronousStep();
+    }
+    EndSynchronousStep();
+    for (auto &shard : shards) {
+      shard->EndSynchronousStep();
+    }
+
+    // Send the commands of all the shards in a single batch.
+    if (shards.empty()) {
+      episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+    } else {
+      size_t batch_size = control_frame.size();
+      for (auto &shard : shards) {
+        batch_size += shard->control_frame.size();
+      }
+      ControlFrame batch;
+      batch.reserve(batch_size);
+      batch.insert(batch.end(), control_frame.begin(), control_frame.end());
+      for (auto &shard : shards) {
+        batch.insert(batch.end(), shard->control_frame.begin(), shard->control_frame.end());
+      }
+      episode_proxy.Lock()->ApplyBatchSync(std::move(batch), false);
+    }
   }
   return true;
 }
 
+size_t TrafficManagerLocal::GetShardIndex(const ActorId actor_id) const {
+  return ShardPartition::GetIndex(actor_id, shards.size() + 1u);
+}
+
+TrafficManagerLocal &TrafficManagerLocal::GetShard(const size_t index) {
+  return index == 0u ? *this : *shards.at(index - 1u);
+}
+
+void TrafficManagerLocal::SetNumberOfShards(const uint32_t number_of_shards) {
+  if (leader != nullptr) {
+    log_warning("traffic manager shards can not be split further");
+    return;
+  }
+  const size_t number_of_followers = number_of_shards > 0u ? number_of_shards - 1u : 0u;
+
+  std::lock_guard<std::mutex> shard_lock(shard_mutex);
+  if (number_of_followers == shards.size()) {
+    return;
+  }
+  {
+    // A recording only holds the vehicles of one traffic manager.
+    std::lock_guard<std::mutex> registration_lock(registration_mutex);
+    if (recorder) {
+      throw_exception(std::runtime_error("traffic manager can not be split into shards while recording"));
+    }
+  }
+
+  // Start the new shards before moving any vehicle, so that if one of them
+  // fails the vehicles stay where they were.
+  std::vector<std::unique_ptr<TrafficManagerLocal>> new_shards;
+  // Shards have no server, so they do not take a port.
+  uint16_t port = server->port();
+  for (size_t index = shards.size(); index < number_of_followers; ++index) {
+    new_shards.emplace_back(std::make_unique<TrafficManagerLocal>(longitudinal_PID_parameters,
+                                                                  longitudinal_highway_PID_parameters,
+                                                                  lateral_PID_parameters,
+                                                                  lateral_highway_PID_parameters,
+                                                                  0.0f, // Shards use the leader's parameters.
+                                                                  episode_proxy,
+                                                                  port,
+                                                                  this));
+    TrafficManagerLocal &shard = *new_shards.back();
+    shard.seed = seed + index + 1u;
+    shard.random_device = RandomGenerator(shard.seed);
+  }
+
+  // Take the vehicles out of their current shards.
+  std::vector<ActorPtr> actor_list;
+  for (size_t index = 0u; index <= shards.size(); ++index) {
+    TrafficManagerLocal &shard = GetShard(index);
+    const std::vector<ActorPtr> shard_actors = shard.registered_vehicles.GetList();
+    shard.RemoveVehicles(shard_actors);
+    actor_list.insert(actor_list.end(), shard_actors.begin(), shard_actors.end());
+  }
+
+  if (number_of_followers < shards.size()) {
+    shards.resize(number_of_followers);
+  }
+  for (auto &shard : new_shards) {
+    shards.emplace_back(std::move(shard));
+  }
+
+  // Hand them over to their new owners.
+  const auto shard_actor_lists = ShardPartition::Split(
+      actor_list, shards.size() + 1u, [](const ActorPtr &actor) { return actor->GetId(); });
+  for (size_t index = 0u; index <= shards.size(); ++index) {
+    GetShard(index).InsertVehicles(shard_actor_lists.at(index));
+  }
+
+  if (!shards.empty()) {
+    log_warning("traffic manager split into", shards.size() + 1u,
+                "shards, vehicles only see the ones of other shards as unregistered actors");
+  }
+}
+
 void TrafficManagerLocal::Stop() {
 
+  {
+    std::lock_guard<std::mutex> shard_lock(shard_mutex);
+    for (auto &shard : shards) {
+      shard->Stop();
+    }
+  }
+
   run_traffic_manger.store(false);
   if (parameters.GetSynchronousMode()) {
     step_begin_trigger.notify_one();
@@ -274,6 +434,9 @@ void TrafficManagerLocal::Stop() {
     worker_thread.release();
   }
 
+  // A recording is only valid within one episode.
+  StopRecorder();
+
   vehicle_id_list.clear();
   registered_vehicles.Clear();
   registered_vehicles_state = -1;
@@ -311,21 +474,51 @@ void TrafficManagerLocal::Reset() {
   world = cc::World(episode_proxy);
   SetupLocalMap();
   Start();
+
+  std::lock_guard<std::mutex> shard_lock(shard_mutex);
+  for (auto &shard : shards) {
+    shard->Reset();
+  }
 }
 
-void TrafficManagerLocal::RegisterVehicles(const std::vector<ActorPtr> &vehicle_list) {
+void TrafficManagerLocal::InsertVehicles(const std::vector<ActorPtr> &vehicle_list) {
   std::lock_guard<std::mutex> registration_lock(registration_mutex);
   registered_vehicles.Insert(vehicle_list);
 }
 
-void TrafficManagerLocal::UnregisterVehicles(const std::vector<ActorPtr> &actor_list) {
+void TrafficManagerLocal::RemoveVehicles(const std::vector<ActorPtr> &actor_list) {
   std::lock_guard<std::mutex> registration_lock(registration_mutex);
-  std::vector<ActorId> actor_id_list;
   for (auto &actor : actor_list) {
     alsm.RemoveActor(actor->GetId(), true);
   }
 }
 
+void TrafficManagerLocal::RegisterVehicles(const std::vector<ActorPtr> &vehicle_list) {
+  std::lock_guard<std::mutex> shard_lock(shard_mutex);
+  if (shards.empty()) {
+    InsertVehicles(vehicle_list);
+    return;
+  }
+  const auto shard_vehicle_lists = ShardPartition::Split(
+      vehicle_list, shards.size() + 1u, [](const ActorPtr &vehicle) { return vehicle->GetId(); });
+  for (size_t index = 0u; index <= shards.size(); ++index) {
+    GetShard(index).InsertVehicles(shard_vehicle_lists.at(index));
+  }
+}
+
+void TrafficManagerLocal::UnregisterVehicles(const std::vector<ActorPtr> &actor_list) {
+  std::lock_guard<std::mutex> shard_lock(shard_mutex);
+  if (shards.empty()) {
+    RemoveVehicles(actor_list);
+    return;
+  }
+  const auto shard_actor_lists = ShardPartition::Split(
+      actor_list, shards.size() + 1u, [](const ActorPtr &actor) { return actor->GetId(); });
+  for (size_t index = 0u; index <= shards.size(); ++index) {
+    GetShard(index).RemoveVehicles(shard_actor_lists.at(index));
+  }
+}
+
 void TrafficManagerLocal::SetPercentageSpeedDifference(const ActorPtr &actor, const float percentage) {
   parameters.SetPercentageSpeedDifference(actor, percentage);
 }
@@ -411,6 +604,10 @@ void TrafficManagerLocal::SetOSMMode(const bool mode_switch) {
   parameters.SetOSMMode(mode_switch);
 }
 
+void TrafficManagerLocal::SetJunctionConflictMode(const bool mode_switch) {
+  parameters.SetJunctionConflictMode(mode_switch);
+}
+
 void TrafficManagerLocal::SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer) {
   parameters.SetCustomPath(actor, path, empty_buffer);
 }
@@ -448,11 +645,60 @@ void TrafficManagerLocal::SetMaxBoundaries(const float lower, const float upper)
 }
 
 Action TrafficManagerLocal::GetNextAction(const ActorId &actor_id) {
-  return localization_stage.ComputeNextAction(actor_id);
+  std::lock_guard<std::mutex> shard_lock(shard_mutex);
+  return GetShard(GetShardIndex(actor_id)).localization_stage.ComputeNextAction(actor_id);
 }
 
 ActionBuffer TrafficManagerLocal::GetActionBuffer(const ActorId &actor_id) {
-  return localization_stage.ComputeActionBuffer(actor_id);
+  std::lock_guard<std::mutex> shard_lock(shard_mutex);
+  return GetShard(GetShardIndex(actor_id)).localization_stage.ComputeActionBuffer(actor_id);
+}
+
+void TrafficManagerLocal::StartRecorder(const std::string &filename) {
+  // A recording only holds the vehicles of one traffic manager.
+  std::lock_guard<std::mutex> shard_lock(shard_mutex);
+  if (!shards.empty()) {
+    throw_exception(std::runtime_error("traffic manager split into shards can not be recorded"));
+  }
+
+  RecordingHeader header;
+  header.map_name = local_map->GetMapName();
+  header.opendrive = local_map->GetMap().GetOpenDrive();
+  header.seed = seed;
+  header.longitudinal_PID_parameters = longitudinal_PID_parameters;
+  header.longitudinal_highway_PID_parameters = longitudinal_highway_PID_parameters;
+  header.lateral_PID_parameters = lateral_PID_parameters;
+  header.lateral_highway_PID_parameters = lateral_highway_PID_parameters;
+
+  std::lock_guard<std::mutex> registration_lock(registration_mutex);
+  recorder = std::make_unique<TrafficManagerRecorder>(filename, header);
+
+  // The replay starts without any state, so is the traffic manager from here.
+  // Vehicles are localized again and the random sequence restarts.
+  for (const ActorId actor_id : vehicle_id_list) {
+    localization_stage.RemoveActor(actor_id);
+    collision_stage.RemoveActor(actor_id);
+    traffic_light_stage.RemoveActor(actor_id);
+    motion_plan_stage.RemoveActor(actor_id);
+    vehicle_light_stage.RemoveActor(actor_id);
+  }
+  buffer_map.clear();
+  track_traffic.Clear();
+  localization_stage.Reset();
+  collision_stage.Reset();
+  traffic_light_stage.Reset();
+  motion_plan_stage.Reset();
+  vehicle_light_stage.Reset();
+  random_device = RandomGenerator(seed);
+  log_info("traffic manager recording to", filename);
+}
+
+void TrafficManagerLocal::StopRecorder() {
+  std::lock_guard<std::mutex> registration_lock(registration_mutex);
+  if (recorder) {
+    log_info("traffic manager recorded", recorder->GetNumberOfTicks(), "cycles");
+    recorder.reset();
+  }
 }
 
 bool TrafficManagerLocal::CheckAllFrozen(TLGroup tl_to_freeze) {
@@ -468,8 +714,11 @@ void TrafficManagerLocal::SetSynchronousMode(bool mode) {
   const bool previous_mode = parameters.GetSynchronousMode();
   parameters.SetSynchronousMode(mode);
   if (previous_mode && !mode) {
-    step_begin.store(true);
-    step_begin_trigger.notify_one();
+    BeginSynchronousStep();
+    std::lock_guard<std::mutex> shard_lock(shard_mutex);
+    for (auto &shard : shards) {
+      shard->BeginSynchronousStep();
+    }
   }
 }
 
@@ -482,12 +731,26 @@ carla::client::detail::EpisodeProxy &TrafficManagerLocal::GetEpisodeProxy() {
 }
 
 std::vector<ActorId> TrafficManagerLocal::GetRegisteredVehiclesIDs() {
-  return registered_vehicles.GetIDList();
+  std::vector<ActorId> actor_id_list = registered_vehicles.GetIDList();
+  std::lock_guard<std::mutex> shard_lock(shard_mutex);
+  for (auto &shard : shards) {
+    const std::vector<ActorId> shard_id_list = shard->registered_vehicles.GetIDList();
+    actor_id_list.insert(actor_id_list.end(), shard_id_list.begin(), shard_id_list.end());
+  }
+  return actor_id_list;
 }
 
 void TrafficManagerLocal::SetRandomDeviceSeed(const uint64_t _seed) {
   seed = _seed;
   random_device = RandomGenerator(seed);
+  {
+    // Each shard gets its own sequence, reproducible from the same seed.
+    std::lock_guard<std::mutex> shard_lock(shard_mutex);
+    for (size_t index = 0u; index < shards.size(); ++index) {
+      shards[index]->seed = seed + index + 1u;
+      shards[index]->random_device = RandomGenerator(shards[index]->seed);
+    }
+  }
   world.ResetAllTrafficLights();
 }
 
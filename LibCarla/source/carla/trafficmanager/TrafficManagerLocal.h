@@ -8,6 +8,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -22,9 +23,11 @@
 #include "carla/trafficmanager/InMemoryMap.h"
 #include "carla/trafficmanager/Parameters.h"
 #include "carla/trafficmanager/RandomGenerator.h"
+#include "carla/trafficmanager/ShardPartition.h"
 #include "carla/trafficmanager/SimulationState.h"
 #include "carla/trafficmanager/TrackTraffic.h"
 #include "carla/trafficmanager/TrafficManagerBase.h"
+#include "carla/trafficmanager/TrafficManagerRecorder.h"
 #include "carla/trafficmanager/TrafficManagerServer.h"
 
 #include "carla/trafficmanager/ALSM.h"
@@ -76,8 +79,9 @@ private:
   SimulationState simulation_state;
   /// Time instance used to calculate dt in asynchronous mode.
   TimePoint previous_update_instance;
-  /// Parameterization object.
-  Parameters parameters;
+  /// Parameterization object, shared by all the shards of a traffic manager.
+  Parameters own_parameters;
+  Parameters &parameters;
   /// Array to hold output data of localization stage.
   LocalizationFrame localization_frame;
   /// Array to hold output data of collision avoidance.
@@ -95,8 +99,9 @@ private:
   MotionPlanStage motion_plan_stage;
   VehicleLightStage vehicle_light_stage;
   ALSM alsm;
-  /// Traffic manager server instance.
-  TrafficManagerServer server;
+  /// Traffic manager server instance. Shards have none, so remote clients
+  /// always reach the leader, which routes each vehicle to its shard.
+  std::unique_ptr<TrafficManagerServer> server;
   /// Switch to turn on / turn off traffic manager.
   std::atomic<bool> run_traffic_manger{true};
   /// Flags to signal step begin and end.
@@ -116,19 +121,45 @@ private:
   std::vector<ActorId> marked_for_removal;
   /// Mutex to prevent vehicle registration during frame array re-allocation.
   std::mutex registration_mutex;
+  /// Recorder of the inputs and outputs of every cycle, if recording.
+  std::unique_ptr<TrafficManagerRecorder> recorder;
+  /// Traffic manager owning this one as a shard, nullptr if it is not a shard.
+  TrafficManagerLocal *leader;
+  /// Additional traffic managers running part of the registered vehicles,
+  /// each one on its own thread.
+  std::vector<std::unique_ptr<TrafficManagerLocal>> shards;
+  /// Mutex to prevent routing vehicles while the shards change.
+  std::mutex shard_mutex;
 
   /// Method to check if all traffic lights are frozen in a group.
   bool CheckAllFrozen(TLGroup tl_to_freeze);
 
+  /// Index of the shard owning a vehicle, zero being this traffic manager.
+  size_t GetShardIndex(const ActorId actor_id) const;
+
+  /// Method to get a shard by index, zero being this traffic manager.
+  TrafficManagerLocal &GetShard(const size_t index);
+
+  /// Methods to register and unregister vehicles with this shard only.
+  void InsertVehicles(const std::vector<ActorPtr> &actor_list);
+  void RemoveVehicles(const std::vector<ActorPtr> &actor_list);
+
+  /// Methods to trigger a synchronous cycle and to wait for its end.
+  void BeginSynchronousStep();
+  void EndSynchronousStep();
+
 public:
   /// Private constructor for singleton lifecycle management.
+  /// If a leader is given, the traffic manager is one of its shards, shares
+  /// its parameters and local map, and ignores @a RPCportTM.
   TrafficManagerLocal(std::vector<float> longitudinal_PID_parameters,
                       std::vector<float> longitudinal_highway_PID_parameters,
                       std::vector<float> lateral_PID_parameters,
                       std::vector<float> lateral_highway_PID_parameters,
                       float perc_decrease_from_limit,
                       cc::detail::EpisodeProxy &episode_proxy,
-                      uint16_t &RPCportTM);
+                      uint16_t &RPCportTM,
+                      TrafficManagerLocal *leader = nullptr);
 
   /// Destructor.
   virtual ~TrafficManagerLocal();
@@ -211,13 +242,21 @@ public:
   /// Method to set Tick timeout for synchronous execution.
   void SetSynchronousModeTimeOutInMiliSecond(double time);
 
-  /// Method to provide synchronous tick.
+  /// Method to provide synchronous tick. The cycles of all the shards run in
+  /// parallel and their commands are sent in a single batch.
   bool SynchronousTick();
 
+  /// Method to split the registered vehicles by actor id among a number of
+  /// traffic managers. The shards have no server of their own, clients reach
+  /// them through this one. Vehicles only see the ones of other shards as
+  /// unregistered actors, so the behaviour depends on the number of shards.
+  /// Throws if the traffic manager is recording.
+  void SetNumberOfShards(const uint32_t number_of_shards);
+
   /// Get CARLA episode information.
   carla::client::detail::EpisodeProxy &GetEpisodeProxy();
 
-  /// Get list of all registered vehicles.
+  /// Get list of all registered vehicles, in all the shards.
   std::vector<ActorId> GetRegisteredVehiclesIDs();
 
   /// Method to specify how much distance a vehicle should maintain to
@@ -245,6 +284,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set junction conflict mode.
+  void SetJunctionConflictMode(const bool mode_switch);
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer);
 
@@ -278,6 +320,15 @@ public:
   /// Method to get the vehicle's action buffer.
   ActionBuffer GetActionBuffer(const ActorId &actor_id);
 
+  /// Method to start recording the inputs and outputs of every cycle to a file.
+  /// The per vehicle state of the stages and the random generator are reset,
+  /// so that the recording can be replayed from its first cycle.
+  /// Throws if the traffic manager is split into shards.
+  void StartRecorder(const std::string &filename);
+
+  /// Method to stop recording.
+  void StopRecorder();
+
   void ShutDown() {};
 };
 
@@ -0,0 +1,138 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <cstring>
+#include <stdexcept>
+
+#include "carla/Exception.h"
+
+#include "carla/trafficmanager/TrafficManagerRecorder.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Identifies the files and the version of their format.
+static constexpr char RECORDING_MAGIC[] = "CARLA_TM_REC_1";
+
+TrafficManagerRecorder::TrafficManagerRecorder(const std::string &filename, const RecordingHeader &header)
+  : file(filename, std::ios::binary | std::ios::trunc) {
+  if (!file) {
+    throw_exception(std::runtime_error("unable to open TM recording " + filename));
+  }
+  file.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+  WriteBuffer(MsgPack::Pack(header));
+}
+
+void TrafficManagerRecorder::WriteBuffer(const carla::Buffer &buffer) {
+  const uint32_t size = static_cast<uint32_t>(buffer.size());
+  file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  file.write(reinterpret_cast<const char *>(buffer.data()), size);
+}
+
+void TrafficManagerRecorder::RecordInputs(const std::vector<ActorId> &vehicle_id_list,
+                                          const SimulationState &simulation_state,
+                                          const Parameters &parameters,
+                                          const TrackTraffic &track_traffic) {
+
+  const cc::Timestamp &timestamp = simulation_state.GetTimestamp();
+  tick.frame = timestamp.frame;
+  tick.elapsed_seconds = timestamp.elapsed_seconds;
+  tick.delta_seconds = timestamp.delta_seconds;
+  tick.platform_timestamp = timestamp.platform_timestamp;
+  tick.vehicle_id_list = vehicle_id_list;
+
+  tick.actors.clear();
+  simulation_state.ForEachActor([this](const ActorId actor_id,
+                                       const KinematicState &kinematic_state,
+                                       const StaticAttributes &attributes,
+                                       const TrafficLightState &tl_state) {
+    RecordedActor actor;
+    actor.id = actor_id;
+    actor.location = kinematic_state.location;
+    actor.rotation = kinematic_state.rotation;
+    actor.velocity = kinematic_state.velocity;
+    actor.hybrid_end_location = kinematic_state.hybrid_end_location;
+    actor.speed_limit = kinematic_state.speed_limit;
+    actor.half_length = attributes.half_length;
+    actor.half_width = attributes.half_width;
+    actor.half_height = attributes.half_height;
+    actor.actor_type = static_cast<uint8_t>(attributes.actor_type);
+    actor.tl_state = static_cast<uint8_t>(tl_state.tl_state);
+    actor.physics_enabled = kinematic_state.physics_enabled;
+    actor.is_dormant = kinematic_state.is_dormant;
+    actor.at_traffic_light = tl_state.at_traffic_light;
+    tick.actors.push_back(actor);
+  });
+
+  // Only the parameters that changed are recorded, the replay keeps the rest.
+  tick.vehicle_parameters.clear();
+  std::unordered_map<ActorId, VehicleParameters> current_parameters;
+  current_parameters.reserve(vehicle_id_list.size());
+  for (const ActorId actor_id : vehicle_id_list) {
+    const VehicleParameters vehicle_parameters = parameters.GetVehicleParameters(actor_id);
+    auto previous = last_parameters.find(actor_id);
+    const VehicleParameters &previous_parameters =
+        previous != last_parameters.end() ? previous->second : VehicleParameters();
+    if (vehicle_parameters != previous_parameters) {
+      tick.vehicle_parameters.emplace_back(actor_id, vehicle_parameters);
+    }
+    current_parameters.emplace(actor_id, vehicle_parameters);
+  }
+  last_parameters = std::move(current_parameters);
+  tick.global_parameters = parameters.GetGlobalParameters();
+
+  tick.hero_location = track_traffic.GetHeroLocation();
+  tick.light_states.clear();
+}
+
+void TrafficManagerRecorder::RecordWorldInfo(const rpc::VehicleLightStateList &light_states,
+                                             const rpc::WeatherParameters &weather) {
+  tick.light_states = light_states;
+  tick.weather = weather;
+}
+
+void TrafficManagerRecorder::RecordOutputs(const ControlFrame &control_frame) {
+  tick.control_frame = control_frame;
+  WriteBuffer(MsgPack::Pack(tick));
+  ++number_of_ticks;
+}
+
+TrafficManagerRecording::TrafficManagerRecording(const std::string &filename)
+  : file(filename, std::ios::binary) {
+  char magic[sizeof(RECORDING_MAGIC)];
+  file.read(magic, sizeof(magic));
+  if (!file || std::memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0) {
+    throw_exception(std::runtime_error(filename + " is not a TM recording"));
+  }
+  std::vector<unsigned char> buffer;
+  if (!ReadBuffer(buffer)) {
+    throw_exception(std::runtime_error("TM recording " + filename + " is truncated"));
+  }
+  header = MsgPack::UnPack<RecordingHeader>(buffer.data(), buffer.size());
+}
+
+bool TrafficManagerRecording::ReadBuffer(std::vector<unsigned char> &buffer) {
+  uint32_t size = 0u;
+  file.read(reinterpret_cast<char *>(&size), sizeof(size));
+  if (!file) {
+    return false;
+  }
+  buffer.resize(size);
+  file.read(reinterpret_cast<char *>(buffer.data()), size);
+  return static_cast<bool>(file);
+}
+
+bool TrafficManagerRecording::ReadTick(RecordedTick &tick) {
+  std::vector<unsigned char> buffer;
+  if (!ReadBuffer(buffer)) {
+    return false;
+  }
+  tick = MsgPack::UnPack<RecordedTick>(buffer.data(), buffer.size());
+  return true;
+}
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,146 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "carla/MsgPack.h"
+#include "carla/rpc/Command.h"
+#include "carla/rpc/VehicleLightStateList.h"
+#include "carla/rpc/WeatherParameters.h"
+
+#include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/Parameters.h"
+#include "carla/trafficmanager/SimulationState.h"
+#include "carla/trafficmanager/TrackTraffic.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Data needed to set up the stages of the traffic manager offline.
+struct RecordingHeader {
+  std::string map_name;
+  std::string opendrive;
+  uint64_t seed;
+  std::vector<float> longitudinal_PID_parameters;
+  std::vector<float> longitudinal_highway_PID_parameters;
+  std::vector<float> lateral_PID_parameters;
+  std::vector<float> lateral_highway_PID_parameters;
+
+  MSGPACK_DEFINE_ARRAY(map_name, opendrive, seed,
+                       longitudinal_PID_parameters, longitudinal_highway_PID_parameters,
+                       lateral_PID_parameters, lateral_highway_PID_parameters);
+};
+
+/// State of an actor as found by the stages in the simulation state.
+struct RecordedActor {
+  ActorId id;
+  cg::Location location;
+  cg::Rotation rotation;
+  cg::Vector3D velocity;
+  cg::Location hybrid_end_location;
+  float speed_limit;
+  float half_length;
+  float half_width;
+  float half_height;
+  uint8_t actor_type;
+  uint8_t tl_state;
+  bool physics_enabled;
+  bool is_dormant;
+  bool at_traffic_light;
+
+  MSGPACK_DEFINE_ARRAY(id, location, rotation, velocity, hybrid_end_location, speed_limit,
+                       half_length, half_width, half_height, actor_type, tl_state,
+                       physics_enabled, is_dormant, at_traffic_light);
+};
+
+/// Inputs consumed by the stages in one cycle of the traffic manager, and the
+/// commands they produced.
+struct RecordedTick {
+  uint64_t frame;
+  double elapsed_seconds;
+  double delta_seconds;
+  double platform_timestamp;
+  /// Registered vehicles, in the order the stages process them.
+  std::vector<ActorId> vehicle_id_list;
+  std::vector<RecordedActor> actors;
+  /// Parameters of the vehicles that changed since the previous tick.
+  std::vector<std::pair<ActorId, VehicleParameters>> vehicle_parameters;
+  GlobalParameters global_parameters;
+  cg::Location hero_location;
+  rpc::VehicleLightStateList light_states;
+  rpc::WeatherParameters weather;
+  ControlFrame control_frame;
+
+  MSGPACK_DEFINE_ARRAY(frame, elapsed_seconds, delta_seconds, platform_timestamp,
+                       vehicle_id_list, actors, vehicle_parameters, global_parameters,
+                       hero_location, light_states, weather, control_frame);
+};
+
+/// Writes the inputs and outputs of every cycle of the traffic manager to a
+/// binary file, to be replayed offline with TrafficManagerReplay.
+///
+/// The file starts with a magic string and the msgpack-encoded
+/// RecordingHeader, followed by one size-prefixed msgpack-encoded
+/// RecordedTick per cycle.
+class TrafficManagerRecorder {
+
+private:
+  std::ofstream file;
+  RecordedTick tick;
+  /// Last parameters recorded for each vehicle.
+  std::unordered_map<ActorId, VehicleParameters> last_parameters;
+  uint64_t number_of_ticks {0u};
+
+  void WriteBuffer(const carla::Buffer &buffer);
+
+public:
+  TrafficManagerRecorder(const std::string &filename, const RecordingHeader &header);
+
+  /// To be called after the ALSM update, before running the stages.
+  void RecordInputs(const std::vector<ActorId> &vehicle_id_list,
+                    const SimulationState &simulation_state,
+                    const Parameters &parameters,
+                    const TrackTraffic &track_traffic);
+
+  /// To be called after the vehicle light stage queried the simulator.
+  void RecordWorldInfo(const rpc::VehicleLightStateList &light_states,
+                       const rpc::WeatherParameters &weather);
+
+  /// To be called after running the stages, writes the cycle to the file.
+  void RecordOutputs(const ControlFrame &control_frame);
+
+  uint64_t GetNumberOfTicks() const {
+    return number_of_ticks;
+  }
+};
+
+/// Reads a file written by TrafficManagerRecorder.
+class TrafficManagerRecording {
+
+private:
+  std::ifstream file;
+  RecordingHeader header;
+
+  bool ReadBuffer(std::vector<unsigned char> &buffer);
+
+public:
+  explicit TrafficManagerRecording(const std::string &filename);
+
+  const RecordingHeader &GetHeader() const {
+    return header;
+  }
+
+  /// Reads the next cycle, returns false at the end of the file.
+  bool ReadTick(RecordedTick &tick);
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -221,6 +221,10 @@ void TrafficManagerRemote::SetOSMMode(const bool mode_switch) {
   client.SetOSMMode(mode_switch);
 }
 
+void TrafficManagerRemote::SetJunctionConflictMode(const bool mode_switch) {
+  client.SetJunctionConflictMode(mode_switch);
+}
+
 void TrafficManagerRemote::SetCustomPath(const ActorPtr &_actor, const Path path, const bool empty_buffer) {
   carla::rpc::Actor actor(_actor->Serialize());
 
@@ -273,6 +277,10 @@ void TrafficManagerRemote::SetSynchronousModeTimeOutInMiliSecond(double time) {
   client.SetSynchronousModeTimeOutInMiliSecond(time);
 }
 
+void TrafficManagerRemote::SetNumberOfShards(const uint32_t number_of_shards) {
+  client.SetNumberOfShards(number_of_shards);
+}
+
 Action TrafficManagerRemote::GetNextAction(const ActorId &actor_id) {
   return client.GetNextAction(actor_id);
 }
@@ -281,6 +289,14 @@ ActionBuffer TrafficManagerRemote::GetActionBuffer(const ActorId &actor_id) {
   return client.GetActionBuffer(actor_id);
 }
 
+void TrafficManagerRemote::StartRecorder(const std::string &filename) {
+  client.StartRecorder(filename);
+}
+
+void TrafficManagerRemote::StopRecorder() {
+  client.StopRecorder();
+}
+
 bool TrafficManagerRemote::SynchronousTick() {
   return false;
 }
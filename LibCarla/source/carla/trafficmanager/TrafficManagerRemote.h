@@ -110,6 +110,9 @@ public:
   /// Method to set Tick timeout for synchronous execution.
   void SetSynchronousModeTimeOutInMiliSecond(double time);
 
+  /// Method to split the registered vehicles among a number of traffic manager shards.
+  void SetNumberOfShards(const uint32_t number_of_shards);
+
   /// Method to set % to keep on the right lane.
   void SetKeepRightPercentage(const ActorPtr &actor, const float percentage);
 
@@ -128,6 +131,9 @@ public:
   /// Method to set Open Street Map mode.
   void SetOSMMode(const bool mode_switch);
 
+  /// Method to set junction conflict mode.
+  void SetJunctionConflictMode(const bool mode_switch);
+
   /// Method to set our own imported path.
   void SetCustomPath(const ActorPtr &actor, const Path path, const bool empty_buffer);
 
@@ -163,6 +169,12 @@ public:
   /// Method to get the vehicle's action buffer.
   ActionBuffer GetActionBuffer(const ActorId &actor_id);
 
+  /// Method to start recording the inputs and outputs of every cycle to a file.
+  void StartRecorder(const std::string &filename);
+
+  /// Method to stop recording.
+  void StopRecorder();
+
   /// Method to provide synchronous tick
   bool SynchronousTick();
 
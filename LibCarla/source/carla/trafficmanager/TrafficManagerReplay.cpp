@@ -0,0 +1,193 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "carla/client/Map.h"
+#include "carla/profiler/Profiler.h"
+
+#include "carla/trafficmanager/TrafficManagerReplay.h"
+
+namespace carla {
+namespace traffic_manager {
+
+TrafficManagerReplay::TrafficManagerReplay(const std::string &filename)
+  : recording(filename),
+    world(cc::detail::EpisodeProxy{}),
+    random_device(recording.GetHeader().seed),
+
+    localization_stage(LocalizationStage(vehicle_id_list,
+                                         buffer_map,
+                                         simulation_state,
+                                         track_traffic,
+                                         local_map,
+                                         parameters,
+                                         marked_for_removal,
+                                         localization_frame,
+                                         random_device)),
+
+    collision_stage(CollisionStage(vehicle_id_list,
+                                   simulation_state,
+                                   buffer_map,
+                                   track_traffic,
+                                   parameters,
+                                   local_map,
+                                   collision_frame,
+                                   random_device)),
+
+    traffic_light_stage(TrafficLightStage(vehicle_id_list,
+                                          simulation_state,
+                                          buffer_map,
+                                          parameters,
+                                          local_map,
+                                          tl_frame,
+                                          random_device)),
+
+    motion_plan_stage(MotionPlanStage(vehicle_id_list,
+                                      simulation_state,
+                                      parameters,
+                                      buffer_map,
+                                      track_traffic,
+                                      recording.GetHeader().longitudinal_PID_parameters,
+                                      recording.GetHeader().longitudinal_highway_PID_parameters,
+                                      recording.GetHeader().lateral_PID_parameters,
+                                      recording.GetHeader().lateral_highway_PID_parameters,
+                                      localization_frame,
+                                      collision_frame,
+                                      tl_frame,
+                                      control_frame,
+                                      random_device,
+                                      local_map)),
+
+    vehicle_light_stage(VehicleLightStage(vehicle_id_list,
+                                          buffer_map,
+                                          parameters,
+                                          world,
+                                          control_frame)) {
+
+  const RecordingHeader &header = recording.GetHeader();
+  const auto world_map = carla::MakeShared<const cc::Map>(header.map_name, header.opendrive);
+  local_map = std::make_shared<InMemoryMap>(world_map);
+  local_map->SetUp();
+}
+
+void TrafficManagerReplay::RemoveActors(const RecordedTick &next_tick) {
+
+  const std::unordered_set<ActorId> next_vehicles(next_tick.vehicle_id_list.begin(),
+                                                  next_tick.vehicle_id_list.end());
+  for (const ActorId actor_id : vehicle_id_list) {
+    if (next_vehicles.find(actor_id) == next_vehicles.end()) {
+      buffer_map.erase(actor_id);
+      localization_stage.RemoveActor(actor_id);
+      collision_stage.RemoveActor(actor_id);
+      traffic_light_stage.RemoveActor(actor_id);
+      motion_plan_stage.RemoveActor(actor_id);
+      vehicle_light_stage.RemoveActor(actor_id);
+      track_traffic.DeleteActor(actor_id);
+    }
+  }
+
+  std::unordered_set<ActorId> next_actors;
+  for (const RecordedActor &actor : next_tick.actors) {
+    next_actors.insert(actor.id);
+  }
+  for (const RecordedActor &actor : tick.actors) {
+    if (next_actors.find(actor.id) == next_actors.end()) {
+      track_traffic.DeleteActor(actor.id);
+    }
+  }
+}
+
+void TrafficManagerReplay::LoadInputs() {
+
+  simulation_state.Reset();
+  simulation_state.SetTimestamp(cc::Timestamp(tick.frame,
+                                              tick.elapsed_seconds,
+                                              tick.delta_seconds,
+                                              tick.platform_timestamp));
+  for (const RecordedActor &actor : tick.actors) {
+    KinematicState kinematic_state{actor.location,
+                                   actor.rotation,
+                                   actor.velocity,
+                                   actor.speed_limit,
+                                   actor.physics_enabled,
+                                   actor.is_dormant,
+                                   actor.hybrid_end_location};
+    StaticAttributes attributes{static_cast<ActorType>(actor.actor_type),
+                                actor.half_length,
+                                actor.half_width,
+                                actor.half_height};
+    TrafficLightState tl_state{static_cast<TLS>(actor.tl_state), actor.at_traffic_light};
+    simulation_state.AddActor(actor.id, kinematic_state, attributes, tl_state);
+  }
+
+  for (const auto &entry : tick.vehicle_parameters) {
+    parameters.SetVehicleParameters(entry.first, entry.second);
+  }
+  parameters.SetGlobalParameters(tick.global_parameters);
+
+  track_traffic.SetHeroLocation(tick.hero_location);
+  vehicle_light_stage.SetWorldInfo(tick.light_states, tick.weather);
+  vehicle_id_list = tick.vehicle_id_list;
+}
+
+bool TrafficManagerReplay::Tick() {
+
+  RecordedTick next_tick;
+  if (!recording.ReadTick(next_tick)) {
+    return false;
+  }
+  RemoveActors(next_tick);
+  tick = std::move(next_tick);
+  LoadInputs();
+
+  CARLA_PROFILE_SPAN(traffic_manager, replay_cycle);
+
+  // Same frame layout and stage order as TrafficManagerLocal::Run.
+  const unsigned long number_of_vehicles = vehicle_id_list.size();
+  localization_frame.clear();
+  localization_frame.resize(number_of_vehicles);
+  collision_frame.clear();
+  collision_frame.resize(number_of_vehicles);
+  tl_frame.clear();
+  tl_frame.resize(number_of_vehicles);
+  control_frame.clear();
+  control_frame.reserve(2 * number_of_vehicles);
+  control_frame.resize(number_of_vehicles);
+
+  for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+    localization_stage.Update(index);
+  }
+  for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+    collision_stage.Update(index);
+  }
+  collision_stage.ClearCycleCache();
+  for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+    traffic_light_stage.Update(index);
+    motion_plan_stage.Update(index);
+    vehicle_light_stage.Update(index);
+  }
+
+  // Vehicles marked for removal are destroyed by the ALSM, and they will be
+  // missing from the next recorded tick.
+  marked_for_removal.clear();
+
+  const carla::Buffer replayed = MsgPack::Pack(control_frame);
+  const carla::Buffer recorded = MsgPack::Pack(tick.control_frame);
+  last_tick_matches =
+      replayed.size() == recorded.size() &&
+      std::memcmp(replayed.data(), recorded.data(), replayed.size()) == 0;
+  if (!last_tick_matches) {
+    ++number_of_mismatches;
+  }
+  ++number_of_ticks;
+  return true;
+}
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,113 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "carla/client/World.h"
+
+#include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/InMemoryMap.h"
+#include "carla/trafficmanager/Parameters.h"
+#include "carla/trafficmanager/RandomGenerator.h"
+#include "carla/trafficmanager/SimulationState.h"
+#include "carla/trafficmanager/TrackTraffic.h"
+#include "carla/trafficmanager/TrafficManagerRecorder.h"
+
+#include "carla/trafficmanager/LocalizationStage.h"
+#include "carla/trafficmanager/CollisionStage.h"
+#include "carla/trafficmanager/TrafficLightStage.h"
+#include "carla/trafficmanager/MotionPlanStage.h"
+#include "carla/trafficmanager/VehicleLightStage.h"
+
+namespace carla {
+namespace traffic_manager {
+
+/// Runs the stages of the traffic manager offline, feeding them the inputs
+/// of a file written by TrafficManagerRecorder, without a simulator.
+///
+/// Each tick produces the same ControlFrame the traffic manager produced
+/// when recording, which allows profiling the stages in isolation and
+/// checking that changes to them are deterministic.
+class TrafficManagerReplay {
+
+private:
+  TrafficManagerRecording recording;
+  /// World without simulator, the vehicle light stage requires one but it
+  /// is never queried while replaying.
+  cc::World world;
+  std::vector<ActorId> vehicle_id_list;
+  LocalMapPtr local_map;
+  BufferMap buffer_map;
+  TrackTraffic track_traffic;
+  SimulationState simulation_state;
+  Parameters parameters;
+  RandomGenerator random_device;
+  std::vector<ActorId> marked_for_removal;
+  LocalizationFrame localization_frame;
+  CollisionFrame collision_frame;
+  TLFrame tl_frame;
+  ControlFrame control_frame;
+  LocalizationStage localization_stage;
+  CollisionStage collision_stage;
+  TrafficLightStage traffic_light_stage;
+  MotionPlanStage motion_plan_stage;
+  VehicleLightStage vehicle_light_stage;
+  /// Cycle currently being replayed.
+  RecordedTick tick;
+  uint64_t number_of_ticks {0u};
+  uint64_t number_of_mismatches {0u};
+  bool last_tick_matches {true};
+
+  /// Cleans up the vehicles and actors that are not in @a next_tick, as the
+  /// ALSM does when they are destroyed.
+  void RemoveActors(const RecordedTick &next_tick);
+
+  /// Sets the simulation state and parameters of the current tick.
+  void LoadInputs();
+
+public:
+  /// Opens @a filename and sets up the map it was recorded in.
+  explicit TrafficManagerReplay(const std::string &filename);
+
+  /// Runs the stages with the inputs of the next recorded cycle, returns
+  /// false at the end of the recording.
+  bool Tick();
+
+  /// Commands produced by the last tick.
+  const ControlFrame &GetControlFrame() const {
+    return control_frame;
+  }
+
+  /// Commands the traffic manager produced in the last tick when recording.
+  const ControlFrame &GetRecordedControlFrame() const {
+    return tick.control_frame;
+  }
+
+  /// Whether the last tick produced exactly the recorded commands.
+  bool MatchesRecording() const {
+    return last_tick_matches;
+  }
+
+  uint64_t GetFrame() const {
+    return tick.frame;
+  }
+
+  uint64_t GetNumberOfTicks() const {
+    return number_of_ticks;
+  }
+
+  /// Number of ticks whose commands differ from the recorded ones.
+  uint64_t GetNumberOfMismatches() const {
+    return number_of_mismatches;
+  }
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -203,6 +203,11 @@ public:
         tm->SetOSMMode(mode_switch);
       });
 
+      /// Method to set junction conflict mode.
+      server->bind("set_junction_conflict_mode", [=](const bool mode_switch) {
+        tm->SetJunctionConflictMode(mode_switch);
+      });
+
       /// Method to set our own imported path.
       server->bind("set_path", [=](carla::rpc::Actor actor, const Path path, const bool empty_buffer) {
         tm->SetCustomPath(carla::client::detail::ActorVariant(actor).Get(tm->GetEpisodeProxy()), path, empty_buffer);
@@ -257,6 +262,16 @@ public:
         tm->Release();
       });
 
+      /// Method to start recording the inputs and outputs of every cycle to a file.
+      server->bind("start_recorder", [=](const std::string &filename) {
+        tm->StartRecorder(filename);
+      });
+
+      /// Method to stop recording.
+      server->bind("stop_recorder", [=]() {
+        tm->StopRecorder();
+      });
+
       /// Method to set synchronous mode.
       server->bind("set_synchronous_mode", [=](const bool mode) {
         tm->SetSynchronousMode(mode);
@@ -267,6 +282,11 @@ public:
         tm->SetSynchronousModeTimeOutInMiliSecond(time);
       });
 
+      /// Method to split the registered vehicles among a number of traffic manager shards.
+      server->bind("set_number_of_shards", [=](const uint32_t number_of_shards) {
+        tm->SetNumberOfShards(number_of_shards);
+      });
+
       /// Method to set randomization seed.
       server->bind("set_random_device_seed", [=](const uint64_t seed) {
         tm->SetRandomDeviceSeed(seed);
@@ -27,6 +27,20 @@ void VehicleLightStage::UpdateWorldInfo() {
   weather = world.GetWeather();
 }
 
+void VehicleLightStage::SetWorldInfo(rpc::VehicleLightStateList light_states,
+                                     rpc::WeatherParameters weather_parameters) {
+  all_light_states = std::move(light_states);
+  weather = weather_parameters;
+}
+
+const rpc::VehicleLightStateList &VehicleLightStage::GetLightStates() const {
+  return all_light_states;
+}
+
+const rpc::WeatherParameters &VehicleLightStage::GetWeather() const {
+  return weather;
+}
+
 void VehicleLightStage::Update(const unsigned long index) {
   ActorId actor_id = vehicle_id_list.at(index);
 
@@ -33,6 +33,14 @@ public:
 
   void UpdateWorldInfo();
 
+  /// Sets the world information without querying the simulator, used when
+  /// replaying a recording.
+  void SetWorldInfo(rpc::VehicleLightStateList light_states, rpc::WeatherParameters weather_parameters);
+
+  const rpc::VehicleLightStateList &GetLightStates() const;
+
+  const rpc::WeatherParameters &GetWeather() const;
+
   void Update(const unsigned long index) override;
 
   void RemoveActor(const ActorId actor_id) override;
@@ -0,0 +1,179 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "carla/Exception.h"
+
+namespace carla {
+namespace traffic_manager {
+
+class SimpleWaypoint;
+using SimpleWaypointPtr = std::shared_ptr<SimpleWaypoint>;
+
+/// Ring buffer holding the path of a vehicle, with the subset of the
+/// std::deque interface used by the stages.
+///
+/// The capacity only grows, to the next power of two, so once a vehicle's
+/// buffer reached its usual horizon, pushing and popping waypoints does not
+/// allocate memory.
+class WaypointBuffer {
+private:
+
+  template <typename BufferT, typename ValueT>
+  class Iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = SimpleWaypointPtr;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ValueT *;
+    using reference = ValueT &;
+
+    Iterator(BufferT *buffer, size_t index) : _buffer(buffer), _index(index) {}
+
+    reference operator*() const {
+      return (*_buffer)[_index];
+    }
+
+    pointer operator->() const {
+      return &(*_buffer)[_index];
+    }
+
+    Iterator &operator++() {
+      ++_index;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      ++_index;
+      return copy;
+    }
+
+    bool operator==(const Iterator &rhs) const {
+      return _index == rhs._index;
+    }
+
+    bool operator!=(const Iterator &rhs) const {
+      return _index != rhs._index;
+    }
+
+  private:
+    BufferT *_buffer;
+    size_t _index;
+  };
+
+  std::vector<SimpleWaypointPtr> _ring;
+  size_t _head = 0u;
+  size_t _size = 0u;
+
+  size_t Position(size_t index) const {
+    return (_head + index) & (_ring.size() - 1u);
+  }
+
+  void Grow() {
+    std::vector<SimpleWaypointPtr> ring(_ring.empty() ? 16u : 2u * _ring.size());
+    for (size_t i = 0u; i < _size; ++i) {
+      ring[i] = std::move(_ring[Position(i)]);
+    }
+    _ring.swap(ring);
+    _head = 0u;
+  }
+
+public:
+
+  using value_type = SimpleWaypointPtr;
+  using iterator = Iterator<WaypointBuffer, SimpleWaypointPtr>;
+  using const_iterator = Iterator<const WaypointBuffer, const SimpleWaypointPtr>;
+
+  size_t size() const {
+    return _size;
+  }
+
+  bool empty() const {
+    return _size == 0u;
+  }
+
+  size_t capacity() const {
+    return _ring.size();
+  }
+
+  SimpleWaypointPtr &operator[](size_t index) {
+    return _ring[Position(index)];
+  }
+
+  const SimpleWaypointPtr &operator[](size_t index) const {
+    return _ring[Position(index)];
+  }
+
+  const SimpleWaypointPtr &at(size_t index) const {
+    if (index >= _size) {
+      throw_exception(std::out_of_range("waypoint buffer index out of range"));
+    }
+    return (*this)[index];
+  }
+
+  const SimpleWaypointPtr &front() const {
+    return (*this)[0u];
+  }
+
+  const SimpleWaypointPtr &back() const {
+    return (*this)[_size - 1u];
+  }
+
+  void push_back(const SimpleWaypointPtr &waypoint) {
+    if (_size == _ring.size()) {
+      Grow();
+    }
+    _ring[Position(_size)] = waypoint;
+    ++_size;
+  }
+
+  void pop_front() {
+    _ring[_head].reset();
+    _head = Position(1u);
+    --_size;
+  }
+
+  void pop_back() {
+    _ring[Position(_size - 1u)].reset();
+    --_size;
+  }
+
+  /// Removes all the waypoints, keeping the capacity.
+  void clear() {
+    for (size_t i = 0u; i < _size; ++i) {
+      _ring[Position(i)].reset();
+    }
+    _head = 0u;
+    _size = 0u;
+  }
+
+  iterator begin() {
+    return iterator(this, 0u);
+  }
+
+  iterator end() {
+    return iterator(this, _size);
+  }
+
+  const_iterator begin() const {
+    return const_iterator(this, 0u);
+  }
+
+  const_iterator end() const {
+    return const_iterator(this, _size);
+  }
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,102 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+// Headless stand-in for the simulator, see carla::mock::MockServer.
+//
+//   carla-mock-server [--port 2000] [--vehicles 0] [--walkers 0]
+//                     [--frame-rate 20] [--sync] [--xodr FILE] [--seed 0]
+//                     [--threads 2] [--duration SECONDS]
+
+#include <carla/Logging.h>
+#include <carla/mock/MockServer.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+static void PrintUsage(const char *program) {
+  std::cerr
+      << "usage: " << program << " [options]\n"
+      << "  --port N          RPC port, streaming uses N+1 (default 2000)\n"
+      << "  --vehicles N      vehicles driven by the server (default 0)\n"
+      << "  --walkers N       walkers moved by the server (default 0)\n"
+      << "  --frame-rate F    frames per second (default 20)\n"
+      << "  --sync            start in synchronous mode\n"
+      << "  --xodr FILE       OpenDRIVE map, a ring road if not given\n"
+      << "  --seed N          seed of the actors spawned at start-up\n"
+      << "  --threads N       RPC and streaming worker threads (default 2)\n"
+      << "  --duration S      stop after S seconds, run forever if zero\n";
+}
+
+static std::string ReadFile(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("unable to open " + path);
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+
+int main(int argc, char *argv[]) {
+  try {
+    carla::mock::MockServerSettings settings;
+    size_t threads = 2u;
+    double duration = 0.0;
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      auto next = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--port") {
+        settings.port = static_cast<uint16_t>(std::stoul(next()));
+      } else if (arg == "--vehicles") {
+        settings.number_of_vehicles = static_cast<uint32_t>(std::stoul(next()));
+      } else if (arg == "--walkers") {
+        settings.number_of_walkers = static_cast<uint32_t>(std::stoul(next()));
+      } else if (arg == "--frame-rate") {
+        settings.frame_rate = std::stod(next());
+      } else if (arg == "--sync") {
+        settings.synchronous_mode = true;
+      } else if (arg == "--xodr") {
+        settings.opendrive = ReadFile(next());
+      } else if (arg == "--seed") {
+        settings.seed = static_cast<uint32_t>(std::stoul(next()));
+      } else if (arg == "--threads") {
+        threads = std::stoul(next());
+      } else if (arg == "--duration") {
+        duration = std::stod(next());
+      } else {
+        PrintUsage(argv[0]);
+        return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+      }
+    }
+
+    carla::mock::MockServer server(settings);
+    server.AsyncRun(threads);
+    carla::log_info(
+        "mock server listening on port", settings.port,
+        "with", server.GetNumberOfActors(), "actors");
+    if (duration > 0.0) {
+      server.RunFor(std::chrono::milliseconds(static_cast<int64_t>(1e3 * duration)));
+    } else {
+      server.Run();
+    }
+    carla::log_info("mock server stopped at frame", server.GetFrame());
+  } catch (const std::exception &e) {
+    carla::log_error("mock server:", e.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StringUtil.h>
+#include <carla/client/detail/EpisodeState.h>
+#include <carla/client/detail/LandmarkActorIndex.h>
+#include <carla/sensor/Deserializer.h>
+#include <carla/sensor/SensorRegistry.h>
+#include <carla/sensor/data/RawEpisodeState.h>
+
+#include <boost/optional/optional_io.hpp>
+
+#include <cstring>
+
+using namespace carla::client::detail;
+using namespace carla::sensor;
+
+namespace {
+
+  struct Landmark {
+    carla::ActorId id;
+    std::string type_id;
+    std::string sign_id;
+  };
+
+  /// Builds the episode state the simulator streams with a snapshot of each
+  /// of @a landmarks.
+  static std::shared_ptr<const EpisodeState> make_state(
+      uint64_t episode_id,
+      const std::vector<Landmark> &landmarks) {
+    auto header = s11n::SensorHeaderSerializer::Serialize(
+        SensorRegistry::get<FWorldObserver *>::index,
+        1u,
+        0.5,
+        carla::rpc::Transform{});
+    s11n::EpisodeStateSerializer::Header episode_header{};
+    episode_header.episode_id = episode_id;
+    const auto offset = header.size() + sizeof(episode_header);
+    carla::Buffer message(offset + landmarks.size() * sizeof(data::ActorDynamicState));
+    std::memcpy(message.data(), header.data(), header.size());
+    std::memcpy(message.data() + header.size(), &episode_header, sizeof(episode_header));
+    for (auto i = 0u; i < landmarks.size(); ++i) {
+      data::ActorDynamicState actor{};
+      actor.id = landmarks[i].id;
+      actor.actor_state = carla::rpc::ActorState::Active;
+      std::strncpy(
+          actor.state.traffic_light_data.sign_id,
+          landmarks[i].sign_id.c_str(),
+          sizeof(actor.state.traffic_light_data.sign_id) - 1u);
+      std::memcpy(message.data() + offset + i * sizeof(actor), &actor, sizeof(actor));
+    }
+    auto data = Deserializer::Deserialize(std::move(message));
+    auto raw = boost::dynamic_pointer_cast<data::RawEpisodeState>(data);
+    DEBUG_ASSERT(raw != nullptr);
+    return std::make_shared<const EpisodeState>(*raw);
+  }
+
+  static std::vector<carla::rpc::Actor> make_actors(const std::vector<Landmark> &landmarks) {
+    std::vector<carla::rpc::Actor> actors;
+    for (auto &&landmark : landmarks) {
+      carla::rpc::Actor actor;
+      actor.id = landmark.id;
+      actor.description.id = landmark.type_id;
+      actors.emplace_back(std::move(actor));
+    }
+    return actors;
+  }
+
+  /// The search World::GetTrafficSign and World::GetTrafficLight did before
+  /// the index, reading the sign id as TrafficSign::GetSignId does.
+  static boost::optional<carla::ActorId> linear_search(
+      const EpisodeState &state,
+      const std::vector<carla::rpc::Actor> &actors,
+      const char *pattern,
+      const carla::road::SignId &sign_id) {
+    for (auto &&actor : actors) {
+      if (carla::StringUtil::Match(actor.description.id, pattern)) {
+        const auto snapshot = state.GetActorSnapshot(actor.id);
+        if (std::string(snapshot.state.traffic_light_data.sign_id) == sign_id) {
+          return actor.id;
+        }
+      }
+    }
+    return boost::none;
+  }
+
+  static const std::vector<Landmark> LANDMARKS = {
+    {1u, "vehicle.tesla.model3", "100"},
+    {2u, "traffic.stop", "100"},
+    {3u, "traffic.traffic_light", "200"},
+    {4u, "traffic.speed_limit.30", "300"},
+    {5u, "traffic.speed_limit.60", "300"},
+    {6u, "traffic.traffic_light", "400"},
+    {7u, "traffic.traffic_light", "400"},
+    {8u, "traffic.yield", ""},
+    {9u, "traffic.unknown", "0123456789012345678901234567890"},
+    {10u, "static.prop.streetsign", "500"},
+  };
+
+} // namespace
+
+TEST(landmark_actor_index, matches_linear_search) {
+  auto state = make_state(1u, LANDMARKS);
+  const auto actors = make_actors(LANDMARKS);
+  LandmarkActorIndex index;
+  ASSERT_FALSE(index.IsUpToDate(state));
+  index.Rebuild(state, actors);
+  ASSERT_TRUE(index.IsUpToDate(state));
+  const std::vector<carla::road::SignId> sign_ids = {
+      "100", "200", "300", "400", "500", "", "600",
+      "0123456789012345678901234567890"};
+  for (auto &&sign_id : sign_ids) {
+    ASSERT_EQ(index.FindTrafficSign(sign_id), linear_search(*state, actors, "*traffic.*", sign_id))
+        << "sign id '" << sign_id << "'";
+    ASSERT_EQ(index.FindTrafficLight(sign_id), linear_search(*state, actors, "*traffic_light*", sign_id))
+        << "sign id '" << sign_id << "'";
+  }
+  // Duplicated sign ids resolve to the first actor, as the search did.
+  ASSERT_EQ(index.FindTrafficSign("300"), carla::ActorId(4u));
+  ASSERT_EQ(index.FindTrafficLight("400"), carla::ActorId(6u));
+  // Traffic lights are traffic signs too, other actors are neither.
+  ASSERT_EQ(index.FindTrafficSign("200"), carla::ActorId(3u));
+  ASSERT_EQ(index.FindTrafficLight("300"), boost::none);
+  ASSERT_EQ(index.FindTrafficSign("500"), boost::none);
+}
+
+TEST(landmark_actor_index, skips_actors_missing_from_state) {
+  std::vector<Landmark> present(LANDMARKS.begin(), LANDMARKS.begin() + 4);
+  auto state = make_state(1u, present);
+  const auto actors = make_actors(LANDMARKS);
+  LandmarkActorIndex index;
+  index.Rebuild(state, actors);
+  ASSERT_EQ(index.FindTrafficSign("300"), carla::ActorId(4u));
+  ASSERT_EQ(index.FindTrafficLight("400"), boost::none);
+}
+
+TEST(landmark_actor_index, invalidated_by_actor_set) {
+  auto state = make_state(1u, LANDMARKS);
+  LandmarkActorIndex index;
+  index.Rebuild(state, make_actors(LANDMARKS));
+
+  // Same actors in a newer frame.
+  ASSERT_TRUE(index.IsUpToDate(make_state(1u, LANDMARKS)));
+
+  // An actor destroyed.
+  std::vector<Landmark> fewer(LANDMARKS.begin() + 1, LANDMARKS.end());
+  ASSERT_FALSE(index.IsUpToDate(make_state(1u, fewer)));
+
+  // An actor spawned.
+  auto more = LANDMARKS;
+  more.push_back({11u, "traffic.stop", "700"});
+  ASSERT_FALSE(index.IsUpToDate(make_state(1u, more)));
+
+  // Same number of actors with different ids.
+  auto replaced = LANDMARKS;
+  replaced.back().id = 12u;
+  ASSERT_FALSE(index.IsUpToDate(make_state(1u, replaced)));
+
+  // A new episode.
+  ASSERT_FALSE(index.IsUpToDate(make_state(2u, LANDMARKS)));
+
+  index.Clear();
+  ASSERT_FALSE(index.IsUpToDate(state));
+  ASSERT_EQ(index.FindTrafficSign("100"), boost::none);
+}
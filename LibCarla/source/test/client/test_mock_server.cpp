@@ -0,0 +1,116 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/ThreadGroup.h>
+#include <carla/client/ActorBlueprint.h>
+#include <carla/client/BlueprintLibrary.h>
+#include <carla/client/Client.h>
+#include <carla/client/Map.h>
+#include <carla/client/Vehicle.h>
+#include <carla/client/World.h>
+#include <carla/geom/Math.h>
+#include <carla/mock/MockServer.h>
+#include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/Map.h>
+
+#include <set>
+
+using namespace std::chrono_literals;
+using carla::mock::MockServer;
+using carla::mock::MockServerSettings;
+
+TEST(mock_server, ring_road) {
+  constexpr double radius = 50.0;
+  constexpr auto lanes_per_direction = 2u;
+  auto map = carla::opendrive::OpenDriveParser::Load(
+      MockServer::MakeRingRoad(radius, lanes_per_direction));
+  ASSERT_TRUE(map.has_value());
+
+  std::set<int32_t> lanes;
+  const auto waypoints = map->GenerateWaypoints(10.0);
+  ASSERT_FALSE(waypoints.empty());
+  for (const auto &waypoint : waypoints) {
+    lanes.insert(waypoint.lane_id);
+    const auto location = map->ComputeTransform(waypoint).location;
+    const auto distance = carla::geom::Math::Distance2D(location, carla::geom::Location(0.0f, -radius, 0.0f));
+    ASSERT_NEAR(distance, radius, 4.0 * lanes_per_direction);
+  }
+  ASSERT_EQ(lanes, (std::set<int32_t>{-2, -1, 1, 2}));
+
+  // Every lane loops, driving one lap and a half never hits a dead end.
+  for (const auto &start : waypoints) {
+    auto waypoint = start;
+    for (auto i = 0u; i < 30u; ++i) {
+      auto next = map->GetNext(waypoint, carla::geom::Math::Pi<double>() * radius / 10.0);
+      ASSERT_FALSE(next.empty());
+      ASSERT_EQ(next.front().lane_id, start.lane_id);
+      waypoint = next.front();
+    }
+  }
+}
+
+/// Stops the server when the test returns, also after a failed assertion, so
+/// the simulation thread can be joined.
+struct StopGuard {
+  ~StopGuard() { server.Stop(); }
+  MockServer &server;
+};
+
+TEST(mock_server, client_round_trip) {
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+  constexpr auto number_of_vehicles = 20u;
+  constexpr auto number_of_ticks = 100u;
+
+  MockServerSettings settings;
+  settings.port = port;
+  settings.number_of_vehicles = number_of_vehicles;
+  settings.number_of_walkers = 5u;
+  settings.synchronous_mode = true;
+  MockServer server(settings);
+  server.AsyncRun(2u);
+  ASSERT_EQ(server.GetNumberOfActors(), 1u + number_of_vehicles + 5u);
+
+  carla::ThreadGroup simulation;
+  StopGuard stop_guard = {server};
+  simulation.CreateThread([&]() { server.Run(); });
+
+  {
+    carla::client::Client client("localhost", port, 1u);
+    client.SetTimeout(10s);
+    auto world = client.GetWorld();
+    const auto &spawn_points = world.GetMap()->GetRecommendedSpawnPoints();
+    ASSERT_FALSE(spawn_points.empty());
+
+    const auto *blueprint = world.GetBlueprintLibrary()->Find("vehicle.mock.sedan");
+    ASSERT_NE(blueprint, nullptr);
+    auto actor = world.SpawnActor(*blueprint, spawn_points.front());
+    auto vehicle = boost::static_pointer_cast<carla::client::Vehicle>(actor);
+    carla::rpc::VehicleControl control;
+    control.throttle = 1.0f;
+    vehicle->ApplyControl(control);
+
+    carla::StopWatch stop_watch;
+    uint64_t frame = 0u;
+    for (auto i = 0u; i < number_of_ticks; ++i) {
+      frame = world.Tick(10s);
+    }
+    stop_watch.Stop();
+
+    const auto snapshot = world.GetSnapshot();
+    ASSERT_EQ(snapshot.GetFrame(), frame);
+    ASSERT_EQ(snapshot.size(), server.GetNumberOfActors());
+    ASSERT_TRUE(snapshot.Find(vehicle->GetId()).has_value());
+    ASSERT_GT(vehicle->GetVelocity().Length(), 1.0f);
+    ASSERT_TRUE(vehicle->Destroy());
+
+    carla::logging::log(
+        "mock server:", number_of_ticks, "ticks with", server.GetNumberOfActors(), "actors in",
+        stop_watch.GetElapsedTime(), "ms");
+  }
+}
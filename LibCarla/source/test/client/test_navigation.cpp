@@ -0,0 +1,253 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/nav/Navigation.h>
+#include <carla/nav/PathCache.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace carla::nav;
+using carla::geom::Location;
+
+namespace {
+
+  static constexpr int MAX_POLYS = 8;
+
+  static std::vector<dtPolyRef> get(PathCache &cache, const PathCache::Key &key, int max_polys = MAX_POLYS) {
+    dtPolyRef polys[MAX_POLYS];
+    int num_polys = 0;
+    if (!cache.Get(key, polys, num_polys, max_polys)) {
+      return {};
+    }
+    return std::vector<dtPolyRef>(polys, polys + num_polys);
+  }
+
+  static void put(PathCache &cache, const PathCache::Key &key, const std::vector<dtPolyRef> &polys) {
+    cache.Put(key, polys.data(), static_cast<int>(polys.size()));
+  }
+
+  static void append(std::vector<uint8_t> &content, const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    content.insert(content.end(), bytes, bytes + size);
+  }
+
+  /// Builds the navigation mesh of a flat square of sidewalk made of
+  /// @a size x @a size polygons of one meter, in the format the server sends.
+  static std::vector<uint8_t> make_grid_navmesh(const int size) {
+    constexpr int cells_per_meter = 4;
+    constexpr int nvp = 6;
+    const unsigned short none = 0xffff;
+    const int row = size + 1;
+
+    // Detour uses y as the up axis.
+    std::vector<unsigned short> verts;
+    for (int z = 0; z <= size; ++z) {
+      for (int x = 0; x <= size; ++x) {
+        verts.push_back(static_cast<unsigned short>(x * cells_per_meter));
+        verts.push_back(0u);
+        verts.push_back(static_cast<unsigned short>(z * cells_per_meter));
+      }
+    }
+    // Each polygon lists its vertices and then the polygon across each edge.
+    std::vector<unsigned short> polys;
+    for (int z = 0; z < size; ++z) {
+      for (int x = 0; x < size; ++x) {
+        const int v = z * row + x;
+        const int p = z * size + x;
+        const unsigned short poly[nvp * 2] = {
+          static_cast<unsigned short>(v),
+          static_cast<unsigned short>(v + 1),
+          static_cast<unsigned short>(v + row + 1),
+          static_cast<unsigned short>(v + row),
+          none, none,
+          z > 0 ? static_cast<unsigned short>(p - size) : none,
+          x + 1 < size ? static_cast<unsigned short>(p + 1) : none,
+          z + 1 < size ? static_cast<unsigned short>(p + size) : none,
+          x > 0 ? static_cast<unsigned short>(p - 1) : none,
+          none, none};
+        polys.insert(polys.end(), poly, poly + nvp * 2);
+      }
+    }
+    const int poly_count = size * size;
+    std::vector<unsigned short> flags(static_cast<size_t>(poly_count), CARLA_TYPE_SIDEWALK);
+    std::vector<unsigned char> areas(static_cast<size_t>(poly_count), CARLA_AREA_SIDEWALK);
+
+    dtNavMeshCreateParams params;
+    std::memset(&params, 0, sizeof(params));
+    params.verts = verts.data();
+    params.vertCount = row * row;
+    params.polys = polys.data();
+    params.polyFlags = flags.data();
+    params.polyAreas = areas.data();
+    params.polyCount = poly_count;
+    params.nvp = nvp;
+    params.walkableHeight = 2.0f;
+    params.walkableRadius = 0.3f;
+    params.walkableClimb = 0.5f;
+    params.bmin[0] = 0.0f;
+    params.bmin[1] = 0.0f;
+    params.bmin[2] = 0.0f;
+    params.bmax[0] = static_cast<float>(size);
+    params.bmax[1] = 2.0f;
+    params.bmax[2] = static_cast<float>(size);
+    params.cs = 1.0f / cells_per_meter;
+    params.ch = 0.2f;
+    params.buildBvTree = true;
+    unsigned char *data = nullptr;
+    int data_size = 0;
+    EXPECT_TRUE(dtCreateNavMeshData(&params, &data, &data_size));
+
+    // Add the tile to a mesh to get its reference.
+    dtNavMeshParams mesh_params;
+    dtVcopy(mesh_params.orig, params.bmin);
+    mesh_params.tileWidth = static_cast<float>(size);
+    mesh_params.tileHeight = static_cast<float>(size);
+    mesh_params.maxTiles = 1;
+    mesh_params.maxPolys = poly_count;
+    dtNavMesh *mesh = dtAllocNavMesh();
+    EXPECT_FALSE(dtStatusFailed(mesh->init(&mesh_params)));
+    dtTileRef tile_ref = 0;
+    EXPECT_FALSE(dtStatusFailed(mesh->addTile(data, data_size, 0, 0, &tile_ref)));
+
+    const int magic = 'M' << 24 | 'S' << 16 | 'E' << 8 | 'T';
+    const int version = 1;
+    const int num_tiles = 1;
+    std::vector<uint8_t> content;
+    append(content, &magic, sizeof(magic));
+    append(content, &version, sizeof(version));
+    append(content, &num_tiles, sizeof(num_tiles));
+    append(content, &mesh_params, sizeof(mesh_params));
+    append(content, &tile_ref, sizeof(tile_ref));
+    append(content, &data_size, sizeof(data_size));
+    append(content, data, static_cast<size_t>(data_size));
+
+    dtFreeNavMesh(mesh);
+    dtFree(data);
+    return content;
+  }
+
+} // namespace
+
+TEST(navigation, path_cache_hit_and_eviction) {
+  PathCache cache(2u);
+  const PathCache::Key a {1u, 2u, CARLA_TYPE_WALKABLE, CARLA_TYPE_ROAD};
+  const PathCache::Key b {1u, 3u, CARLA_TYPE_WALKABLE, CARLA_TYPE_ROAD};
+  const PathCache::Key c {1u, 4u, CARLA_TYPE_WALKABLE, CARLA_TYPE_ROAD};
+  const std::vector<dtPolyRef> corridor_a = {1u, 7u, 2u};
+  const std::vector<dtPolyRef> corridor_b = {1u, 3u};
+  const std::vector<dtPolyRef> corridor_c = {1u, 5u, 6u, 4u};
+
+  ASSERT_TRUE(get(cache, a).empty());
+  put(cache, a, corridor_a);
+  ASSERT_EQ(get(cache, a), corridor_a);
+  ASSERT_EQ(get(cache, a, 2), std::vector<dtPolyRef>(corridor_a.begin(), corridor_a.begin() + 2));
+
+  // The filter flags are part of the key.
+  ASSERT_TRUE(get(cache, {1u, 2u, CARLA_TYPE_WALKABLE, CARLA_TYPE_NONE}).empty());
+
+  // Getting an entry makes it the most recently used.
+  put(cache, b, corridor_b);
+  ASSERT_EQ(get(cache, a), corridor_a);
+  put(cache, c, corridor_c);
+  ASSERT_EQ(cache.Size(), 2u);
+  ASSERT_TRUE(get(cache, b).empty());
+  ASSERT_EQ(get(cache, a), corridor_a);
+  ASSERT_EQ(get(cache, c), corridor_c);
+
+  // Empty corridors are not stored, existing ones are replaced.
+  put(cache, b, {});
+  ASSERT_TRUE(get(cache, b).empty());
+  put(cache, a, corridor_b);
+  ASSERT_EQ(get(cache, a), corridor_b);
+  ASSERT_EQ(cache.Size(), 2u);
+
+  // Shrinking keeps the most recently used.
+  cache.SetCapacity(1u);
+  ASSERT_EQ(cache.Size(), 1u);
+  ASSERT_EQ(get(cache, a), corridor_b);
+  ASSERT_TRUE(get(cache, c).empty());
+
+  // Zero capacity disables the cache.
+  cache.SetCapacity(0u);
+  ASSERT_EQ(cache.Size(), 0u);
+  put(cache, c, corridor_c);
+  ASSERT_EQ(cache.Size(), 0u);
+  ASSERT_TRUE(get(cache, c).empty());
+
+  cache.SetCapacity(4u);
+  put(cache, c, corridor_c);
+  ASSERT_EQ(get(cache, c), corridor_c);
+  cache.Clear();
+  ASSERT_EQ(cache.Size(), 0u);
+  ASSERT_TRUE(get(cache, c).empty());
+}
+
+TEST(navigation, batched_paths_match_single_paths) {
+  constexpr int size = 12;
+  Navigation nav;
+  ASSERT_TRUE(nav.Load(make_grid_navmesh(size)));
+
+  std::mt19937 random(0u);
+  std::uniform_real_distribution<float> coordinate(0.1f, static_cast<float>(size) - 0.1f);
+  std::vector<PathRequest> requests;
+  for (int i = 0; i < 150; ++i) {
+    PathRequest request;
+    request.from = Location(coordinate(random), coordinate(random), 0.0f);
+    request.to = Location(coordinate(random), coordinate(random), 0.0f);
+    requests.emplace_back(std::move(request));
+  }
+  // Repeated routes, served from the cache in the second pass.
+  for (int i = 0; i < 50; ++i) {
+    requests.push_back(requests[static_cast<size_t>(i)]);
+  }
+  // A target out of the mesh.
+  PathRequest outside;
+  outside.from = requests.front().from;
+  outside.to = Location(static_cast<float>(size) + 20.0f, 0.0f, 0.0f);
+  requests.push_back(outside);
+
+  // One by one, without the cache.
+  nav.SetPathCacheCapacity(0u);
+  std::vector<PathRequest> expected = requests;
+  for (auto &request : expected) {
+    request.found = nav.GetPath(request.from, request.to, nullptr, request.path, request.area);
+  }
+  ASSERT_FALSE(expected.back().found);
+  for (size_t i = 0u; i + 1u < expected.size(); ++i) {
+    const auto &request = expected[i];
+    ASSERT_TRUE(request.found) << "request " << i;
+    ASSERT_GE(request.path.size(), 2u);
+    ASSERT_EQ(request.area.size(), request.path.size());
+    ASSERT_NEAR(request.path.front().x, request.from.x, 0.01f);
+    ASSERT_NEAR(request.path.front().y, request.from.y, 0.01f);
+    ASSERT_NEAR(request.path.back().x, request.to.x, 0.01f);
+    ASSERT_NEAR(request.path.back().y, request.to.y, 0.01f);
+  }
+
+  // Batched, with an empty and then a warm cache.
+  nav.SetPathCacheCapacity(4096u);
+  for (int pass = 0; pass < 2; ++pass) {
+    std::vector<PathRequest> batch = requests;
+    nav.GetPaths(batch, 4u);
+    for (size_t i = 0u; i < batch.size(); ++i) {
+      ASSERT_EQ(batch[i].found, expected[i].found) << "pass " << pass << " request " << i;
+      ASSERT_EQ(batch[i].path, expected[i].path) << "pass " << pass << " request " << i;
+      ASSERT_EQ(batch[i].area, expected[i].area) << "pass " << pass << " request " << i;
+    }
+  }
+
+  // Single paths served from the cache filled by the batches.
+  for (size_t i = 0u; i < requests.size(); ++i) {
+    std::vector<Location> path;
+    std::vector<unsigned char> area;
+    ASSERT_EQ(nav.GetPath(requests[i].from, requests[i].to, nullptr, path, area), expected[i].found);
+    ASSERT_EQ(path, expected[i].path) << "request " << i;
+  }
+}
@@ -14,6 +14,7 @@
 #include <carla/geom/Math.h>
 #include <carla/opendrive/OpenDriveParser.h>
 #include <carla/road/MapBuilder.h>
+#include <carla/road/RoutePlanner.h>
 #include <carla/road/element/RoadInfoElevation.h>
 #include <carla/road/element/RoadInfoGeometry.h>
 #include <carla/road/element/RoadInfoMarkRecord.h>
@@ -21,8 +22,12 @@
 
 #include <pugixml/pugixml.hpp>
 
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <string>
+#include <tuple>
+#include <vector>
 
 using namespace carla::road;
 using namespace carla::road::element;
@@ -424,3 +429,208 @@ TEST(road, get_waypoint) {
     result.get();
   }
 }
+
+// The recursive GetNext and GetPrevious that Map used before the lane graph,
+// following the lane links of MapData directly.
+namespace recursive_look_ahead {
+
+  static constexpr double EPSILON = 10.0 * std::numeric_limits<double>::epsilon();
+
+  static std::vector<Waypoint> Concat(std::vector<Waypoint> dst, std::vector<Waypoint> src) {
+    if (src.size() > dst.size()) {
+      return Concat(src, dst);
+    }
+    dst.insert(dst.end(), src.begin(), src.end());
+    return dst;
+  }
+
+  static std::vector<Waypoint> GetLinks(const Map &map, const Waypoint waypoint, const bool next) {
+    const auto &lane = map.GetLane(waypoint);
+    std::vector<Waypoint> result;
+    for (const auto *link : next ? lane.GetNextLanes() : lane.GetPreviousLanes()) {
+      // Successors are entered at their start and predecessors at their end,
+      // which is the lowest s for right lanes and the highest for left lanes.
+      const bool lowest_s = next == (link->GetId() <= 0);
+      const double s = lowest_s ?
+          link->GetDistance() + 10.0 * EPSILON :
+          link->GetDistance() + link->GetLength() - 10.0 * EPSILON;
+      result.emplace_back(Waypoint{
+          link->GetRoad()->GetId(), link->GetLaneSection()->GetId(), link->GetId(), s});
+    }
+    return result;
+  }
+
+  static std::vector<Waypoint> Get(
+      const Map &map,
+      const Waypoint waypoint,
+      const double distance,
+      const bool next) {
+    if (distance <= EPSILON) {
+      return {waypoint};
+    }
+    const auto &lane = map.GetLane(waypoint);
+    const bool forward = next == (waypoint.lane_id <= 0);
+    const double relative_s = waypoint.s - lane.GetDistance();
+    const double remaining_lane_length = forward ? lane.GetLength() - relative_s : relative_s;
+    if (distance <= remaining_lane_length) {
+      Waypoint result = waypoint;
+      result.s += forward ? distance : -distance;
+      result.s += forward ? -EPSILON : EPSILON;
+      return {result};
+    }
+    std::vector<Waypoint> result;
+    for (const auto &link : GetLinks(map, waypoint, next)) {
+      result = Concat(result, Get(map, link, distance - remaining_lane_length, next));
+    }
+    return result;
+  }
+
+} // namespace recursive_look_ahead
+
+static void expect_same_waypoints(
+    std::vector<Waypoint> lhs,
+    std::vector<Waypoint> rhs,
+    const bool same_order) {
+  ASSERT_EQ(lhs.size(), rhs.size());
+  if (!same_order) {
+    auto compare = [](const Waypoint &a, const Waypoint &b) {
+      return std::tie(a.road_id, a.section_id, a.lane_id, a.s) <
+             std::tie(b.road_id, b.section_id, b.lane_id, b.s);
+    };
+    std::sort(lhs.begin(), lhs.end(), compare);
+    std::sort(rhs.begin(), rhs.end(), compare);
+  }
+  for (auto i = 0u; i < lhs.size(); ++i) {
+    ASSERT_EQ(lhs[i].road_id, rhs[i].road_id);
+    ASSERT_EQ(lhs[i].section_id, rhs[i].section_id);
+    ASSERT_EQ(lhs[i].lane_id, rhs[i].lane_id);
+    ASSERT_EQ(lhs[i].s, rhs[i].s);
+  }
+}
+
+TEST(road, look_ahead_matches_recursive_look_ahead) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    for (const auto &waypoint : map.GenerateWaypoints(5.0)) {
+      ASSERT_NO_FATAL_FAILURE(expect_same_waypoints(
+          map.GetSuccessors(waypoint), recursive_look_ahead::GetLinks(map, waypoint, true), true));
+      ASSERT_NO_FATAL_FAILURE(expect_same_waypoints(
+          map.GetPredecessors(waypoint), recursive_look_ahead::GetLinks(map, waypoint, false), true));
+      for (const auto distance : {0.5, 10.0, 60.0, 200.0}) {
+        ASSERT_NO_FATAL_FAILURE(expect_same_waypoints(
+            map.GetNext(waypoint, distance),
+            recursive_look_ahead::Get(map, waypoint, distance, true),
+            false)) << file << " next " << distance;
+        ASSERT_NO_FATAL_FAILURE(expect_same_waypoints(
+            map.GetPrevious(waypoint, distance),
+            recursive_look_ahead::Get(map, waypoint, distance, false),
+            false)) << file << " previous " << distance;
+      }
+    }
+  }
+}
+
+TEST(road, benchmark_look_ahead) {
+  constexpr auto look_ahead = 200.0;
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    const auto waypoints = map.GenerateWaypoints(2.0);
+    ASSERT_FALSE(waypoints.empty());
+
+    // The buffered overloads must return the same waypoints.
+    std::vector<Waypoint> buffer;
+    for (auto i = 0u; i < std::min<size_t>(500u, waypoints.size()); ++i) {
+      buffer.clear();
+      map.GetNext(waypoints[i], look_ahead, buffer);
+      ASSERT_EQ(buffer, map.GetNext(waypoints[i], look_ahead));
+      buffer.clear();
+      map.GetPrevious(waypoints[i], look_ahead, buffer);
+      ASSERT_EQ(buffer, map.GetPrevious(waypoints[i], look_ahead));
+    }
+
+    size_t count = 0u;
+    carla::StopWatch stop_watch;
+    for (const auto &waypoint : waypoints) {
+      buffer.clear();
+      map.GetNext(waypoint, look_ahead, buffer);
+      count += buffer.size();
+    }
+    stop_watch.Stop();
+    const auto microseconds = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    carla::logging::log(
+        file, ':', waypoints.size(), "look-ahead queries of", look_ahead, "m in",
+        1e-3 * static_cast<double>(microseconds), "ms,",
+        static_cast<double>(count) / static_cast<double>(waypoints.size()), "waypoints per query");
+  }
+}
+
+TEST(road, trace_route) {
+  constexpr auto number_of_routes = 10000u;
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    std::vector<Waypoint> waypoints;
+    for (const auto &waypoint : map.GenerateWaypoints(2.0)) {
+      if (map.GetLaneType(waypoint) == Lane::LaneType::Driving) {
+        waypoints.emplace_back(waypoint);
+      }
+    }
+    ASSERT_FALSE(waypoints.empty());
+
+    carla::StopWatch build_watch;
+    const RoutePlanner planner(map);
+    build_watch.Stop();
+
+    size_t found = 0u;
+    carla::StopWatch stop_watch;
+    for (auto i = 0u; i < number_of_routes; ++i) {
+      const auto &origin = waypoints[static_cast<size_t>(
+          Random::Uniform(0.0, static_cast<double>(waypoints.size() - 1u)))];
+      const auto &destination = waypoints[static_cast<size_t>(
+          Random::Uniform(0.0, static_cast<double>(waypoints.size() - 1u)))];
+      const auto route = planner.TraceRoute(origin, destination);
+      if (!route.empty()) {
+        ++found;
+        ASSERT_EQ(route.back().first, destination);
+        ASSERT_EQ(route.front().first.road_id, origin.road_id);
+      }
+    }
+    stop_watch.Stop();
+    carla::logging::log(
+        file, ": route planner built in", build_watch.GetElapsedTime(), "ms,",
+        found, '/', number_of_routes, "routes found in", stop_watch.GetElapsedTime(), "ms");
+  }
+}
+
+TEST(road, generate_waypoint_array) {
+  constexpr auto distance = 0.5;
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+
+    carla::StopWatch serial_watch;
+    const auto waypoints = map.GenerateWaypoints(distance);
+    serial_watch.Stop();
+    carla::StopWatch array_watch;
+    const auto array = map.GenerateWaypointArray(distance);
+    array_watch.Stop();
+
+    ASSERT_EQ(array.size(), waypoints.size());
+    for (auto i = 0u; i < waypoints.size(); ++i) {
+      ASSERT_EQ(array.GetWaypoint(i), waypoints[i]);
+    }
+    for (auto i = 0u; i < waypoints.size(); i += 97u) {
+      const auto transform = map.ComputeTransform(waypoints[i]);
+      ASSERT_NEAR(Math::Distance(array.transform[i].location, transform.location), 0.0, 1e-4);
+    }
+    carla::logging::log(
+        file, ':', waypoints.size(), "waypoints generated in", serial_watch.GetElapsedTime(),
+        "ms, with transforms in", array_watch.GetElapsedTime(), "ms");
+  }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/pointcloud/PointCloudIO.h>
+#include <carla/sensor/data/LidarData.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+using carla::pointcloud::PointCloudFormat;
+using carla::pointcloud::PointCloudIO;
+using carla::sensor::data::LidarDetection;
+
+static std::vector<LidarDetection> make_points(size_t count) {
+  std::vector<LidarDetection> points;
+  points.reserve(count);
+  for (auto i = 0u; i < count; ++i) {
+    points.emplace_back(
+        static_cast<float>(i),
+        -static_cast<float>(i),
+        0.5f * static_cast<float>(i),
+        1.0f / static_cast<float>(i + 1u));
+  }
+  return points;
+}
+
+static std::string dump(const std::vector<LidarDetection> &points, PointCloudFormat format) {
+  std::ostringstream out;
+  const auto *begin = points.data();
+  PointCloudIO::Dump(out, begin, begin + points.size(), format);
+  return out.str();
+}
+
+TEST(pointcloud, binary_ply) {
+  const auto points = make_points(100u);
+  const auto file = dump(points, PointCloudFormat::PLYBinary);
+  const std::string end_header = "end_header\n";
+  const auto pos = file.find(end_header);
+  ASSERT_NE(pos, std::string::npos);
+  ASSERT_EQ(file.find("format binary_little_endian 1.0\n"), 4u);
+  ASSERT_NE(file.find("element vertex 100\n"), std::string::npos);
+  const auto body = pos + end_header.size();
+  ASSERT_EQ(file.size() - body, sizeof(LidarDetection) * points.size());
+  ASSERT_EQ(std::memcmp(file.data() + body, points.data(), file.size() - body), 0);
+}
+
+TEST(pointcloud, binary_pcd) {
+  const auto points = make_points(100u);
+  const auto file = dump(points, PointCloudFormat::PCDBinary);
+  const std::string data = "DATA binary\n";
+  const auto pos = file.find(data);
+  ASSERT_NE(pos, std::string::npos);
+  ASSERT_NE(file.find("FIELDS x y z intensity\n"), std::string::npos);
+  ASSERT_NE(file.find("POINTS 100\n"), std::string::npos);
+  const auto body = pos + data.size();
+  ASSERT_EQ(file.size() - body, sizeof(LidarDetection) * points.size());
+  ASSERT_EQ(std::memcmp(file.data() + body, points.data(), file.size() - body), 0);
+}
+
+TEST(pointcloud, ascii_pcd) {
+  const auto points = make_points(10u);
+  std::istringstream in(dump(points, PointCloudFormat::PCDAscii));
+  std::string line;
+  while (std::getline(in, line) && line != "DATA ascii") {}
+  ASSERT_EQ(line, "DATA ascii");
+  auto count = 0u;
+  while (std::getline(in, line)) {
+    ++count;
+  }
+  ASSERT_EQ(count, points.size());
+}
+
+TEST(pointcloud, background_save_and_flush) {
+  namespace fs = boost::filesystem;
+  const auto points = make_points(1000u);
+  const auto *begin = points.data();
+  const fs::path folder = "libcarla_test_pointcloud";
+  fs::remove_all(folder);
+
+  std::vector<std::string> paths;
+  for (auto i = 0u; i < 8u; ++i) {
+    paths.emplace_back(PointCloudIO::SaveToDiskAsync(
+        (folder / ("cloud_" + std::to_string(i))).string(), begin, begin + points.size(), PointCloudFormat::PCDBinary));
+  }
+  PointCloudIO::Flush();
+  const auto expected = dump(points, PointCloudFormat::PCDBinary);
+  for (auto &path : paths) {
+    ASSERT_EQ(fs::path(path).extension(), ".pcd");
+    std::ifstream in(path, std::ios::binary);
+    const std::string file{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    ASSERT_EQ(file, expected) << path;
+  }
+
+  // A write that fails is reported by the next flush only.
+  fs::create_directories(folder / "directory.ply");
+  PointCloudIO::SaveToDiskAsync((folder / "directory.ply").string(), begin, begin + points.size(), PointCloudFormat::PLYBinary);
+  PointCloudIO::SaveToDiskAsync((folder / "after_error").string(), begin, begin + points.size(), PointCloudFormat::PLYBinary);
+  ASSERT_THROW(PointCloudIO::Flush(), std::runtime_error);
+  ASSERT_TRUE(fs::exists(folder / "after_error.ply"));
+  PointCloudIO::Flush();
+
+  fs::remove_all(folder);
+}
+
+TEST(pointcloud, benchmark_dump) {
+  // One second of a 128 channels lidar at 2.6 million points per second is
+  // too slow in ASCII for a unit test, a tenth of it is enough to compare.
+  const auto points = make_points(260000u);
+  const auto megabytes = static_cast<double>(sizeof(LidarDetection) * points.size()) / 1e6;
+  for (auto format : {PointCloudFormat::PLYAscii, PointCloudFormat::PLYBinary, PointCloudFormat::PCDBinary}) {
+    carla::StopWatch stop_watch;
+    const auto file = dump(points, format);
+    stop_watch.Stop();
+    ASSERT_FALSE(file.empty());
+    const auto seconds = std::max(1e-6, static_cast<double>(
+        stop_watch.GetElapsedTime<std::chrono::microseconds>()) / 1e6);
+    carla::logging::log(
+        "format", static_cast<int>(format), ':',
+        static_cast<double>(points.size()) / seconds / 1e6, "Mpoints/s,",
+        megabytes / seconds, "MB/s");
+  }
+}
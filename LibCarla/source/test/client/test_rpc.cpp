@@ -7,7 +7,9 @@
 #include "test.h"
 
 #include <carla/MsgPackAdaptors.h>
+#include <carla/StopWatch.h>
 #include <carla/ThreadGroup.h>
+#include <carla/client/detail/ResponseFuture.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/Client.h>
 #include <carla/rpc/Response.h>
@@ -62,3 +64,98 @@ TEST(rpc, server_bind_sync_run_on_game_thread) {
   std::cout << "game thread: run " << i << " slices.\n";
   ASSERT_TRUE(done);
 }
+
+TEST(rpc, benchmark_pipelined_calls) {
+  constexpr auto number_of_calls = 500;
+
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+
+  server.BindSync("get_value", [](int x) -> Response<int> {
+    return x * 2;
+  });
+
+  server.AsyncRun(4u);
+
+  std::atomic_bool done{false};
+
+  carla::ThreadGroup threads;
+  threads.CreateThread([&]() {
+    Client client("localhost", port);
+    const auto timeout = carla::time_duration::seconds(10u);
+
+    carla::StopWatch sequential;
+    for (auto i = 0; i < number_of_calls; ++i) {
+      auto result = client.call("get_value", i).as<Response<int>>();
+      EXPECT_EQ(result.Get(), 2 * i);
+    }
+    sequential.Stop();
+
+    carla::StopWatch pipelined;
+    std::vector<carla::client::detail::ResponseFuture<int>> futures;
+    futures.reserve(number_of_calls);
+    for (auto i = 0; i < number_of_calls; ++i) {
+      futures.emplace_back(client.async_request("get_value", i), timeout, "localhost");
+    }
+    for (auto i = 0; i < number_of_calls; ++i) {
+      EXPECT_EQ(futures[i].Get(), 2 * i);
+    }
+    pipelined.Stop();
+
+    carla::logging::log(
+        number_of_calls, "calls: sequential", sequential.GetElapsedTime(),
+        "ms, pipelined", pipelined.GetElapsedTime(), "ms");
+    done = true;
+  });
+
+  // Simulate the game thread, which only serves calls between ticks.
+  for (auto i = 0u; i < 1'000'000u && !done; ++i) {
+    server.SyncRunFor(1ms);
+    std::this_thread::sleep_for(1ms);
+  }
+  ASSERT_TRUE(done);
+}
+
+TEST(rpc, benchmark_method_ids) {
+  constexpr auto number_of_calls = 2000;
+
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+
+  server.BindAsync("a_function_with_a_rather_long_name", [](int x) { return x; });
+
+  server.AsyncRun(1u);
+
+  auto benchmark = [&](bool use_method_ids) {
+    Client client("localhost", port);
+    client.set_method_ids_enabled(use_method_ids);
+    carla::StopWatch stop_watch;
+    for (auto i = 0; i < number_of_calls; ++i) {
+      EXPECT_EQ(client.call("a_function_with_a_rather_long_name", i).as<int>(), i);
+    }
+    stop_watch.Stop();
+    return stop_watch.GetElapsedTime();
+  };
+
+  const auto by_name = benchmark(false);
+  const auto by_id = benchmark(true);
+  carla::logging::log(
+      number_of_calls, "calls: by name", by_name, "ms, by id", by_id, "ms");
+}
+
+TEST(rpc, method_ids_fallback_to_names) {
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  // A server without method table.
+  ::rpc::server server(port);
+  server.suppress_exceptions(true);
+  server.bind("echo", [](Metadata, int x) { return x; });
+  server.async_run(1u);
+
+  Client client("localhost", port);
+  for (auto i = 0; i < 10; ++i) {
+    ASSERT_EQ(client.call("echo", i).as<int>(), i);
+  }
+}
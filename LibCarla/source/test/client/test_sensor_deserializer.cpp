@@ -0,0 +1,87 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/sensor/Deserializer.h>
+#include <carla/sensor/SensorRegistry.h>
+#include <carla/sensor/data/Image.h>
+#include <carla/sensor/s11n/PayloadCompression.h>
+
+#include <cstring>
+
+using namespace carla::sensor;
+
+namespace {
+
+  constexpr uint32_t WIDTH = 64u;
+
+  constexpr uint32_t HEIGHT = 48u;
+
+  /// Payload of a depth camera, the image header followed by the BGRA pixels.
+  static carla::Buffer make_image_payload() {
+    const s11n::ImageSerializer::ImageHeader image_header = {WIDTH, HEIGHT, 90.0f};
+    carla::Buffer payload(sizeof(image_header) + 4u * WIDTH * HEIGHT);
+    std::memcpy(payload.data(), &image_header, sizeof(image_header));
+    auto *pixel = payload.data() + sizeof(image_header);
+    for (auto y = 0u; y < HEIGHT; ++y) {
+      for (auto x = 0u; x < WIDTH; ++x, pixel += 4u) {
+        const auto depth = 1000u * y + 7u * x;
+        pixel[0u] = static_cast<unsigned char>(depth >> 16u);
+        pixel[1u] = static_cast<unsigned char>(depth >> 8u);
+        pixel[2u] = static_cast<unsigned char>(depth);
+        pixel[3u] = 255u;
+      }
+    }
+    return payload;
+  }
+
+  /// Builds the message the simulator streams for @a payload, compressing it
+  /// with @a type the same way FAsyncDataStream does.
+  static carla::Buffer make_message(s11n::CompressionType type, const carla::Buffer &payload) {
+    auto header = s11n::SensorHeaderSerializer::Serialize(
+        SensorRegistry::get<ADepthCamera *>::index,
+        42u,
+        1.5,
+        carla::rpc::Transform{});
+    carla::Buffer body(payload.data(), payload.size());
+    if (type != s11n::CompressionType::None) {
+      body = s11n::PayloadCompression::Compress(type, payload.data(), payload.size(), carla::Buffer{});
+      s11n::SensorHeaderSerializer::SetCompression(header, static_cast<uint8_t>(type));
+    }
+    carla::Buffer message(header.size() + body.size());
+    std::memcpy(message.data(), header.data(), header.size());
+    std::memcpy(message.data() + header.size(), body.data(), body.size());
+    return message;
+  }
+
+  static void check_round_trip(s11n::CompressionType type) {
+    const auto payload = make_image_payload();
+    auto data = Deserializer::Deserialize(make_message(type, payload));
+    ASSERT_NE(data, nullptr);
+    auto image = boost::dynamic_pointer_cast<data::Image>(data);
+    ASSERT_NE(image, nullptr);
+    ASSERT_EQ(image->GetFrame(), 42u);
+    ASSERT_EQ(image->GetWidth(), WIDTH);
+    ASSERT_EQ(image->GetHeight(), HEIGHT);
+    ASSERT_EQ(image->size(), WIDTH * HEIGHT);
+    const auto offset = sizeof(s11n::ImageSerializer::ImageHeader);
+    ASSERT_EQ(std::memcmp(image->data(), payload.data() + offset, payload.size() - offset), 0);
+  }
+
+} // namespace
+
+TEST(sensor_deserializer, round_trip_uncompressed) {
+  check_round_trip(s11n::CompressionType::None);
+}
+
+TEST(sensor_deserializer, round_trip_lz) {
+  check_round_trip(s11n::CompressionType::LZ);
+}
+
+TEST(sensor_deserializer, round_trip_image_delta) {
+  check_round_trip(s11n::CompressionType::ImageDelta);
+}
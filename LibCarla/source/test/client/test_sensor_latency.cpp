@@ -0,0 +1,152 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/profiler/Metrics.h>
+#include <carla/sensor/Deserializer.h>
+#include <carla/sensor/LatencyStats.h>
+#include <carla/sensor/SensorRegistry.h>
+#include <carla/sensor/data/RadarMeasurement.h>
+#include <carla/sensor/s11n/PayloadCompression.h>
+
+#include <cstring>
+
+using namespace carla::sensor;
+using carla::profiler::HdrHistogram;
+using Serializer = carla::sensor::s11n::SensorHeaderSerializer;
+
+namespace {
+
+  struct FakeSensor {};
+
+  constexpr auto NUMBER_OF_DETECTIONS = 3u;
+
+  /// Radar message as written by the simulator, optionally compressed and
+  /// with the timing trailer. The number of detections is deduced from the
+  /// size of the payload.
+  static carla::Buffer make_radar_message(
+      s11n::CompressionType compression,
+      const Serializer::Timing *timing) {
+    auto header = Serializer::Serialize(
+        SensorRegistry::get<ARadar *>::index,
+        42u,
+        1.5,
+        carla::rpc::Transform{});
+    data::RadarData radar;
+    radar.SetResolution(NUMBER_OF_DETECTIONS);
+    for (auto i = 0u; i < NUMBER_OF_DETECTIONS; ++i) {
+      radar.WriteDetection({1.0f * i, 2.0f, 3.0f, 4.0f});
+    }
+    auto payload = s11n::RadarSerializer::Serialize(FakeSensor{}, radar, carla::Buffer());
+    if (compression != s11n::CompressionType::None) {
+      payload = s11n::PayloadCompression::Compress(
+          compression,
+          payload.data(),
+          payload.size(),
+          carla::Buffer());
+      Serializer::SetCompression(header, static_cast<uint8_t>(compression));
+    }
+    carla::Buffer trailer;
+    if (timing != nullptr) {
+      Serializer::SetTiming(header, true);
+      trailer = Serializer::SerializeTiming(timing->enqueue_time, timing->send_time);
+    }
+    carla::Buffer message(header.size() + payload.size() + trailer.size());
+    auto *it = message.data();
+    for (auto *buffer : {&header, &payload, &trailer}) {
+      if (buffer->size() > 0u) {
+        std::memcpy(it, buffer->data(), buffer->size());
+        it += buffer->size();
+      }
+    }
+    return message;
+  }
+
+} // namespace
+
+TEST(sensor_latency, hdr_histogram_buckets) {
+  for (auto i = 0u; i < HdrHistogram::SUB_BUCKET_COUNT * 2u; ++i) {
+    ASSERT_EQ(HdrHistogram::GetBucket(i), i);
+    ASSERT_EQ(HdrHistogram::GetUpperBound(i), i);
+  }
+  for (uint64_t value : {33u, 1000u, 123456u, 1u << 30u}) {
+    const auto bucket = HdrHistogram::GetBucket(value);
+    const auto upper = HdrHistogram::GetUpperBound(bucket);
+    ASSERT_GE(upper, value);
+    ASSERT_LT(HdrHistogram::GetUpperBound(bucket - 1u), value);
+    ASSERT_LE(upper - value, value / HdrHistogram::SUB_BUCKET_COUNT);
+  }
+  const auto last = HdrHistogram::GetBucket(std::numeric_limits<uint64_t>::max());
+  ASSERT_EQ(last, HdrHistogram::NUMBER_OF_BUCKETS - 1u);
+  ASSERT_EQ(HdrHistogram::GetUpperBound(last), std::numeric_limits<uint64_t>::max());
+}
+
+TEST(sensor_latency, hdr_histogram_quantiles) {
+  HdrHistogram histogram;
+  ASSERT_EQ(histogram.GetQuantile(0.5), 0u);
+  for (auto i = 1u; i <= 10000u; ++i) {
+    histogram.Add(i);
+  }
+  ASSERT_EQ(histogram.GetCount(), 10000u);
+  ASSERT_EQ(histogram.GetMin(), 1u);
+  ASSERT_EQ(histogram.GetMax(), 10000u);
+  for (auto quantile : {0.5, 0.9, 0.99}) {
+    const auto expected = static_cast<double>(quantile * 10000.0);
+    const auto actual = static_cast<double>(histogram.GetQuantile(quantile));
+    ASSERT_GE(actual, expected);
+    ASSERT_LE(actual, expected * (1.0 + 1.0 / HdrHistogram::SUB_BUCKET_COUNT));
+  }
+  ASSERT_EQ(histogram.GetQuantile(1.0), 10000u);
+  histogram.Clear();
+  ASSERT_EQ(histogram.GetCount(), 0u);
+  ASSERT_EQ(histogram.GetMax(), 0u);
+}
+
+TEST(sensor_latency, deserialize_timing_trailer) {
+  const Serializer::Timing expected{1000u, 2000u};
+  for (auto compression : {s11n::CompressionType::None, s11n::CompressionType::LZ}) {
+    boost::optional<Deserializer::Timing> timing;
+    auto data = Deserializer::Deserialize(make_radar_message(compression, &expected), timing);
+    auto *radar = dynamic_cast<data::RadarMeasurement *>(data.get());
+    ASSERT_NE(radar, nullptr);
+    ASSERT_EQ(radar->GetFrame(), 42u);
+    ASSERT_EQ(radar->GetDetectionAmount(), NUMBER_OF_DETECTIONS);
+    ASSERT_EQ(radar->at(NUMBER_OF_DETECTIONS - 1u).velocity, NUMBER_OF_DETECTIONS - 1.0f);
+    ASSERT_TRUE(timing != boost::none);
+    ASSERT_EQ(timing->enqueue_time, expected.enqueue_time);
+    ASSERT_EQ(timing->send_time, expected.send_time);
+
+    data = Deserializer::Deserialize(make_radar_message(compression, nullptr), timing);
+    radar = dynamic_cast<data::RadarMeasurement *>(data.get());
+    ASSERT_NE(radar, nullptr);
+    ASSERT_EQ(radar->GetDetectionAmount(), NUMBER_OF_DETECTIONS);
+    ASSERT_TRUE(timing == boost::none);
+  }
+}
+
+TEST(sensor_latency, record_stages) {
+  LatencyStats stats;
+  MessageTimestamps timestamps;
+  timestamps.server = {1'000'000u, 3'000'000u};
+  timestamps.receive = 7'000'000u;
+  timestamps.dispatch = 8'000'000u;
+  timestamps.deserialize = 8'500'000u;
+  timestamps.callback = 10'000'000u;
+  stats.Record(timestamps);
+  // Client clock behind the simulator's.
+  timestamps.receive = 2'000'000u;
+  stats.Record(timestamps);
+  ASSERT_EQ(stats.GetCount(), 2u);
+  ASSERT_EQ(stats.GetHistogram(LatencyStage::Server).GetMax(), 2000u);
+  ASSERT_EQ(stats.GetHistogram(LatencyStage::Network).GetMax(), 4000u);
+  ASSERT_EQ(stats.GetHistogram(LatencyStage::Network).GetMin(), 0u);
+  ASSERT_EQ(stats.GetHistogram(LatencyStage::Deserialize).GetMax(), 500u);
+  ASSERT_EQ(stats.GetHistogram(LatencyStage::Callback).GetMax(), 1500u);
+  ASSERT_EQ(stats.GetHistogram(LatencyStage::Total).GetMax(), 9000u);
+  stats.Clear();
+  ASSERT_EQ(stats.GetCount(), 0u);
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/sensor/SensorRegistry.h>
+#include <carla/sensor/data/GnssMeasurement.h>
+#include <carla/sensor/data/IMUMeasurement.h>
+
+#include <cstring>
+
+using namespace carla::sensor;
+
+namespace {
+
+  struct FakeSensor {};
+
+  template <typename Sensor>
+  static carla::Buffer make_message(carla::Buffer payload) {
+    auto header = s11n::SensorHeaderSerializer::Serialize(
+        SensorRegistry::get<Sensor *>::index,
+        42u,
+        1.5,
+        carla::rpc::Transform{});
+    carla::Buffer message(header.size() + payload.size());
+    std::memcpy(message.data(), header.data(), header.size());
+    std::memcpy(message.data() + header.size(), payload.data(), payload.size());
+    return message;
+  }
+
+  static carla::Buffer make_imu_message() {
+    return make_message<AInertialMeasurementUnit>(s11n::IMUSerializer::Serialize(
+        FakeSensor{},
+        carla::geom::Vector3D{1.0f, 2.0f, 3.0f},
+        carla::geom::Vector3D{4.0f, 5.0f, 6.0f},
+        0.5f));
+  }
+
+  static carla::Buffer make_gnss_message() {
+    return make_message<AGnssSensor>(s11n::GnssSerializer::Serialize(
+        FakeSensor{},
+        carla::geom::GeoLocation{41.0, 2.0, 100.0}));
+  }
+
+  /// Returns the time in nanoseconds spent per message deserializing @a count
+  /// copies of @a message.
+  template <typename Sensor>
+  static double benchmark_deserialize(const carla::Buffer &message, size_t count, bool typed) {
+    std::vector<carla::Buffer> messages;
+    messages.reserve(count);
+    for (auto i = 0u; i < count; ++i) {
+      messages.emplace_back(message.data(), message.size());
+    }
+    carla::StopWatch stop_watch;
+    for (auto &buffer : messages) {
+      auto data = typed ?
+          SensorRegistry::Deserialize<Sensor>(std::move(buffer)) :
+          SensorRegistry::Deserialize(std::move(buffer));
+      EXPECT_NE(data, nullptr);
+    }
+    stop_watch.Stop();
+    return 1e3 * static_cast<double>(
+        stop_watch.GetElapsedTime<std::chrono::microseconds>()) / static_cast<double>(count);
+  }
+
+} // namespace
+
+TEST(sensor_registry, deserialize) {
+  auto imu = SensorRegistry::Deserialize(make_imu_message());
+  auto *measurement = dynamic_cast<data::IMUMeasurement *>(imu.get());
+  ASSERT_NE(measurement, nullptr);
+  ASSERT_EQ(measurement->GetFrame(), 42u);
+  ASSERT_EQ(measurement->GetAccelerometer(), (carla::geom::Vector3D{1.0f, 2.0f, 3.0f}));
+
+  auto gnss = SensorRegistry::Deserialize<AGnssSensor>(make_gnss_message());
+  auto *geo = dynamic_cast<data::GnssMeasurement *>(gnss.get());
+  ASSERT_NE(geo, nullptr);
+  ASSERT_EQ(geo->GetLatitude(), 41.0);
+}
+
+TEST(sensor_registry, unknown_sensor_type) {
+  auto message = s11n::SensorHeaderSerializer::Serialize(
+      SensorRegistry::size(), 0u, 0.0, carla::rpc::Transform{});
+  ASSERT_EQ(SensorRegistry::Deserialize(std::move(message)), nullptr);
+}
+
+TEST(sensor_registry, benchmark_small_messages) {
+  constexpr auto count = 200000u;
+  const auto imu = make_imu_message();
+  const auto gnss = make_gnss_message();
+  carla::logging::log(
+      "IMU:",
+      benchmark_deserialize<AInertialMeasurementUnit>(imu, count, false), "ns per message,",
+      benchmark_deserialize<AInertialMeasurementUnit>(imu, count, true), "ns per message typed");
+  carla::logging::log(
+      "GNSS:",
+      benchmark_deserialize<AGnssSensor>(gnss, count, false), "ns per message,",
+      benchmark_deserialize<AGnssSensor>(gnss, count, true), "ns per message typed");
+}
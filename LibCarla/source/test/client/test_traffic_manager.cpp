@@ -0,0 +1,969 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include "OpenDrive.h"
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/linestring.hpp>
+#include <boost/geometry/geometries/point_xy.hpp>
+#include <boost/geometry/geometries/polygon.hpp>
+
+#include <carla/StopWatch.h>
+#include <carla/client/Map.h>
+#include <carla/trafficmanager/ActorSnapshotIndex.h>
+#include <carla/trafficmanager/BoundaryPolygon.h>
+#include <carla/trafficmanager/CollisionStage.h>
+#include <carla/trafficmanager/Constants.h>
+#include <carla/trafficmanager/HybridTeleportIndex.h>
+#include <carla/trafficmanager/InMemoryMap.h>
+#include <carla/trafficmanager/JunctionConflictTable.h>
+#include <carla/trafficmanager/ShardPartition.h>
+#include <carla/trafficmanager/TrafficLightStage.h>
+#include <carla/trafficmanager/TrafficManagerRecorder.h>
+#include <carla/trafficmanager/TrafficManagerReplay.h>
+#include <carla/trafficmanager/WaypointBuffer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using carla::client::ActorSnapshot;
+using carla::traffic_manager::ActorSnapshotIndex;
+using ActorId = carla::ActorId;
+
+namespace {
+
+  using EpisodeActors = std::unordered_map<ActorId, ActorSnapshot>;
+
+  static EpisodeActors make_actors(std::vector<ActorId> ids) {
+    EpisodeActors actors;
+    for (auto id : ids) {
+      ActorSnapshot snapshot;
+      snapshot.id = id;
+      snapshot.transform.location.x = static_cast<float>(id);
+      actors.emplace(id, snapshot);
+    }
+    return actors;
+  }
+
+  /// Range over the values of the map, as iterated by WorldSnapshot.
+  struct ActorRange {
+    std::vector<ActorSnapshot> values;
+
+    explicit ActorRange(const EpisodeActors &actors) {
+      for (auto &pair : actors) {
+        values.push_back(pair.second);
+      }
+    }
+
+    auto begin() const { return values.begin(); }
+
+    auto end() const { return values.end(); }
+  };
+
+} // namespace
+
+TEST(traffic_manager, actor_snapshot_index_diff) {
+  ActorSnapshotIndex index;
+  ActorRange first{make_actors({5u, 1u, 3u})};
+  index.Update(first);
+  ASSERT_EQ(index.GetIds(), (std::vector<ActorId>{1u, 3u, 5u}));
+  ASSERT_EQ(index.GetNewIds(), (std::vector<ActorId>{1u, 3u, 5u}));
+  ASSERT_TRUE(index.GetRemovedIds().empty());
+  ASSERT_NE(index.Find(3u), nullptr);
+  ASSERT_EQ(index.Find(3u)->transform.location.x, 3.0f);
+  ASSERT_EQ(index.Find(4u), nullptr);
+
+  ActorRange second{make_actors({7u, 3u, 2u})};
+  index.Update(second);
+  ASSERT_EQ(index.GetIds(), (std::vector<ActorId>{2u, 3u, 7u}));
+  ASSERT_EQ(index.GetNewIds(), (std::vector<ActorId>{2u, 7u}));
+  ASSERT_EQ(index.GetRemovedIds(), (std::vector<ActorId>{1u, 5u}));
+  ASSERT_TRUE(index.Contains(7u));
+  ASSERT_FALSE(index.Contains(5u));
+  for (auto &snapshot : second.values) {
+    ASSERT_EQ(index.Find(snapshot.id), &snapshot);
+  }
+
+  index.Update(second);
+  ASSERT_TRUE(index.GetNewIds().empty());
+  ASSERT_TRUE(index.GetRemovedIds().empty());
+
+  index.Clear();
+  index.Update(second);
+  ASSERT_EQ(index.GetNewIds(), (std::vector<ActorId>{2u, 3u, 7u}));
+}
+
+// Synthetic model of the ALSM's actor ingestion, without the RPC calls of
+// World::GetActors, which the index also avoids for known actors. With 1000
+// actors it measured about 400us per tick with per-getter copies against
+// 85us with the index, a 4-5x gain rather than an order of magnitude.
+TEST(traffic_manager, benchmark_actor_snapshot_index) {
+  constexpr auto number_of_actors = 1000u;
+  constexpr auto number_of_ticks = 200u;
+  std::vector<ActorId> ids;
+  for (auto i = 0u; i < number_of_actors; ++i) {
+    ids.push_back(1000u + 3u * i);
+  }
+  const auto state = std::make_shared<const EpisodeActors>(make_actors(ids));
+  const ActorRange range{*state};
+  /// Stand-in for the actor descriptions returned by World::GetActors.
+  struct Description {
+    ActorId id;
+    std::string type_id;
+    std::vector<std::string> attributes;
+  };
+  std::vector<Description> descriptions;
+  for (auto id : ids) {
+    descriptions.push_back({id, "vehicle.tesla.model3", {"role_name", "autopilot", "color", "0,0,0"}});
+  }
+  float checksum = 0.0f;
+
+  // Previous access pattern: copy the descriptions of every actor and hash
+  // their ids, then for each of the five getters of each vehicle load the
+  // episode state atomically and copy the actor snapshot out of it.
+  carla::StopWatch per_getter;
+  for (auto tick = 0u; tick < number_of_ticks; ++tick) {
+    const auto world_actors = descriptions;
+    std::unordered_set<ActorId> current_actors;
+    for (auto &description : world_actors) {
+      current_actors.insert(description.id);
+    }
+    for (auto id : ids) {
+      for (auto getter = 0u; getter < 5u; ++getter) {
+        ActorSnapshot snapshot = std::atomic_load(&state)->at(id);
+        checksum += snapshot.transform.location.x;
+      }
+    }
+  }
+  per_getter.Stop();
+
+  ActorSnapshotIndex index;
+  carla::StopWatch single_pass;
+  for (auto tick = 0u; tick < number_of_ticks; ++tick) {
+    index.Update(range);
+    for (auto id : ids) {
+      const ActorSnapshot *snapshot = index.Find(id);
+      checksum += snapshot->transform.location.x;
+    }
+  }
+  single_pass.Stop();
+
+  ASSERT_GT(checksum, 0.0f);
+  carla::logging::log(
+      "alsm snapshot ingestion (synthetic),", number_of_actors, "actors:",
+      per_getter.GetElapsedTime<std::chrono::microseconds>() / number_of_ticks, "us per tick with per-getter copies,",
+      single_pass.GetElapsedTime<std::chrono::microseconds>() / number_of_ticks, "us per tick with the index");
+}
+
+TEST(traffic_manager, waypoint_buffer_matches_deque) {
+  using carla::traffic_manager::SimpleWaypoint;
+  using carla::traffic_manager::SimpleWaypointPtr;
+  using carla::traffic_manager::WaypointBuffer;
+  std::vector<SimpleWaypointPtr> waypoints;
+  for (auto i = 0u; i < 100u; ++i) {
+    waypoints.push_back(std::make_shared<SimpleWaypoint>(nullptr));
+  }
+  WaypointBuffer buffer;
+  std::deque<SimpleWaypointPtr> expected;
+  size_t next = 0u;
+  // Slide a window over the waypoints so the ring wraps around.
+  for (auto step = 0u; step < 1000u; ++step) {
+    if (step % 3u == 2u && !expected.empty()) {
+      buffer.pop_front();
+      expected.pop_front();
+    } else if (step % 7u == 6u && !expected.empty()) {
+      buffer.pop_back();
+      expected.pop_back();
+    } else if (expected.size() < 40u) {
+      buffer.push_back(waypoints.at(next));
+      expected.push_back(waypoints.at(next));
+      next = (next + 1u) % waypoints.size();
+    }
+    ASSERT_EQ(buffer.size(), expected.size());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+    if (!expected.empty()) {
+      ASSERT_EQ(buffer.front(), expected.front());
+      ASSERT_EQ(buffer.back(), expected.back());
+      ASSERT_EQ(buffer.at(expected.size() - 1u), expected.back());
+    }
+  }
+  ASSERT_EQ(buffer.capacity(), 64u);
+  buffer.clear();
+  ASSERT_TRUE(buffer.empty());
+  ASSERT_EQ(buffer.capacity(), 64u);
+  ASSERT_EQ(waypoints.front().use_count(), 1);
+}
+
+TEST(traffic_manager, hybrid_teleport_index_matches_delta_query) {
+  using namespace carla::traffic_manager;
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  if (files.empty()) {
+    return;
+  }
+  // Setting up the local map is slow, one map is enough.
+  const auto &file = files.front();
+  auto world_map = carla::MakeShared<const carla::client::Map>(file, util::OpenDrive::Load(file));
+  auto local_map = std::make_shared<InMemoryMap>(world_map);
+  local_map->SetUp();
+  const NodeList topology = local_map->GetDenseTopology();
+  ASSERT_FALSE(topology.empty());
+
+  constexpr float lower_bound = 25.0f;
+  constexpr float upper_bound = 100.0f;
+  constexpr uint16_t all_points = std::numeric_limits<uint16_t>::max();
+  HybridTeleportIndex index;
+  auto check_query = [&](const carla::geom::Location &hero_location, const float random_sample) {
+    const NodeList expected = local_map->GetWaypointsInDelta(hero_location, all_points, random_sample);
+    const NodeList found = index.GetWaypointsInDelta(hero_location, all_points, random_sample);
+    const std::unordered_set<SimpleWaypointPtr> expected_set(expected.begin(), expected.end());
+    ASSERT_EQ(found.size(), expected.size());
+    for (const auto &waypoint : found) {
+      ASSERT_TRUE(expected_set.find(waypoint) != expected_set.end());
+    }
+  };
+  for (size_t i = 0u; i < topology.size(); i += topology.size() / 8u + 1u) {
+    const carla::geom::Location hero_location = topology.at(i)->GetLocation();
+    index.Update(*local_map, hero_location, upper_bound);
+    for (float random_sample = lower_bound; random_sample <= upper_bound; random_sample += 15.0f) {
+      check_query(hero_location, random_sample);
+    }
+  }
+
+  // The height is checked against the hero location of each query, not only
+  // against the one the index was built at.
+  using constants::Map::Z_DELTA;
+  const carla::geom::Location hero_location = topology.front()->GetLocation();
+  for (const float height : {0.5f * Z_DELTA, 1.5f * Z_DELTA, -1.5f * Z_DELTA}) {
+    carla::geom::Location raised_location = hero_location;
+    raised_location.z += height;
+    index.Update(*local_map, hero_location, upper_bound);
+    check_query(raised_location, lower_bound);
+    index.Update(*local_map, raised_location, upper_bound);
+    check_query(raised_location, lower_bound);
+    check_query(hero_location, lower_bound);
+  }
+}
+
+TEST(traffic_manager, boundary_polygon_distance_matches_boost) {
+  namespace bg = boost::geometry;
+  using carla::geom::Location;
+  using carla::traffic_manager::BoundaryPolygon;
+  using Polygon = bg::model::polygon<bg::model::d2::point_xy<double>>;
+
+  std::mt19937 generator(42u);
+  std::uniform_real_distribution<float> position(-20.0f, 20.0f);
+  std::uniform_real_distribution<float> radius(0.5f, 10.0f);
+  std::uniform_int_distribution<int> corners(3, 12);
+
+  // Star-shaped polygons in clockwise order, as built by the collision stage.
+  auto make_boundary = [&]() {
+    const Location center(position(generator), position(generator), 0.0f);
+    const int n = corners(generator);
+    std::vector<Location> boundary;
+    for (int i = 0; i < n; ++i) {
+      const float angle = -2.0f * 3.14159265f * static_cast<float>(i) / static_cast<float>(n);
+      const float r = radius(generator);
+      boundary.emplace_back(center.x + r * std::cos(angle), center.y + r * std::sin(angle), 0.0f);
+    }
+    return boundary;
+  };
+  auto make_polygon = [](const std::vector<Location> &boundary) {
+    Polygon polygon;
+    for (const auto &location : boundary) {
+      bg::append(polygon.outer(), bg::model::d2::point_xy<double>(location.x, location.y));
+    }
+    bg::append(polygon.outer(), bg::model::d2::point_xy<double>(boundary.front().x, boundary.front().y));
+    return polygon;
+  };
+
+  BoundaryPolygon lhs;
+  BoundaryPolygon rhs;
+  for (auto i = 0u; i < 2000u; ++i) {
+    const auto lhs_boundary = make_boundary();
+    const auto rhs_boundary = make_boundary();
+    lhs.Assign(lhs_boundary);
+    rhs.Assign(rhs_boundary);
+    const double expected = bg::distance(make_polygon(lhs_boundary), make_polygon(rhs_boundary));
+    const double distance = BoundaryPolygon::Distance(lhs, rhs);
+    ASSERT_NEAR(distance, expected, 1e-6);
+    ASSERT_LE(BoundaryPolygon::BoundingBoxGap(lhs, rhs), distance + 1e-9);
+  }
+}
+
+namespace {
+
+  /// The stages of a traffic manager wired as in TrafficManagerLocal, each
+  /// cycle is run and recorded the way TrafficManagerLocal::Run does, with
+  /// the simulation state set by hand instead of by the ALSM.
+  class RecordingTrafficManager {
+  public:
+
+    RecordingTrafficManager(
+        const std::string &filename,
+        const carla::traffic_manager::RecordingHeader &header,
+        carla::traffic_manager::LocalMapPtr map)
+      : recorder(filename, header),
+        world(carla::client::detail::EpisodeProxy{}),
+        local_map(std::move(map)),
+        random_device(header.seed),
+        localization_stage(vehicle_id_list, buffer_map, simulation_state, track_traffic,
+                           local_map, parameters, marked_for_removal, localization_frame,
+                           random_device),
+        collision_stage(vehicle_id_list, simulation_state, buffer_map, track_traffic,
+                        parameters, local_map, collision_frame, random_device),
+        traffic_light_stage(vehicle_id_list, simulation_state, buffer_map, parameters,
+                            local_map, tl_frame, random_device),
+        motion_plan_stage(vehicle_id_list, simulation_state, parameters, buffer_map,
+                          track_traffic,
+                          header.longitudinal_PID_parameters,
+                          header.longitudinal_highway_PID_parameters,
+                          header.lateral_PID_parameters,
+                          header.lateral_highway_PID_parameters,
+                          localization_frame, collision_frame, tl_frame, control_frame,
+                          random_device, local_map),
+        vehicle_light_stage(vehicle_id_list, buffer_map, parameters, world, control_frame) {}
+
+    carla::traffic_manager::SimulationState simulation_state;
+
+    carla::traffic_manager::Parameters parameters;
+
+    carla::traffic_manager::TrackTraffic track_traffic;
+
+    std::vector<ActorId> vehicle_id_list;
+
+    /// Runs the stages over the current state, records the cycle with
+    /// @a recorded_commands as its outputs, or with the commands of the stages
+    /// if null, and returns the commands of the stages.
+    carla::traffic_manager::ControlFrame Tick(
+        const carla::traffic_manager::ControlFrame *recorded_commands) {
+      const unsigned long number_of_vehicles = vehicle_id_list.size();
+      localization_frame.clear();
+      localization_frame.resize(number_of_vehicles);
+      collision_frame.clear();
+      collision_frame.resize(number_of_vehicles);
+      tl_frame.clear();
+      tl_frame.resize(number_of_vehicles);
+      control_frame.clear();
+      control_frame.reserve(2 * number_of_vehicles);
+      control_frame.resize(number_of_vehicles);
+
+      recorder.RecordInputs(vehicle_id_list, simulation_state, parameters, track_traffic);
+      for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+        localization_stage.Update(index);
+      }
+      for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+        collision_stage.Update(index);
+      }
+      collision_stage.ClearCycleCache();
+      // Instead of UpdateWorldInfo, which queries the simulator.
+      vehicle_light_stage.SetWorldInfo({}, carla::rpc::WeatherParameters{});
+      recorder.RecordWorldInfo(vehicle_light_stage.GetLightStates(), vehicle_light_stage.GetWeather());
+      for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+        traffic_light_stage.Update(index);
+        motion_plan_stage.Update(index);
+        vehicle_light_stage.Update(index);
+      }
+      recorder.RecordOutputs(recorded_commands != nullptr ? *recorded_commands : control_frame);
+      marked_for_removal.clear();
+      return control_frame;
+    }
+
+  private:
+
+    carla::traffic_manager::TrafficManagerRecorder recorder;
+    carla::client::World world;
+    carla::traffic_manager::LocalMapPtr local_map;
+    carla::traffic_manager::BufferMap buffer_map;
+    carla::traffic_manager::RandomGenerator random_device;
+    std::vector<ActorId> marked_for_removal;
+    carla::traffic_manager::LocalizationFrame localization_frame;
+    carla::traffic_manager::CollisionFrame collision_frame;
+    carla::traffic_manager::TLFrame tl_frame;
+    carla::traffic_manager::ControlFrame control_frame;
+    carla::traffic_manager::LocalizationStage localization_stage;
+    carla::traffic_manager::CollisionStage collision_stage;
+    carla::traffic_manager::TrafficLightStage traffic_light_stage;
+    carla::traffic_manager::MotionPlanStage motion_plan_stage;
+    carla::traffic_manager::VehicleLightStage vehicle_light_stage;
+  };
+
+  /// Runs the stages of a traffic manager for @a number_of_ticks cycles in
+  /// which the vehicles drive along their lanes at constant speed, and writes
+  /// the recording. Returns the commands of each cycle, the ones recorded
+  /// unless @a record_commands is false, in which case no commands are.
+  static std::vector<carla::traffic_manager::ControlFrame> write_recording(
+      const std::string &filename,
+      const carla::traffic_manager::RecordingHeader &header,
+      const carla::traffic_manager::LocalMapPtr &local_map,
+      const carla::traffic_manager::NodeList &starts,
+      const size_t number_of_ticks,
+      const bool record_commands) {
+    using namespace carla::traffic_manager;
+    constexpr float speed = 8.0f;
+    constexpr double delta_seconds = 0.05;
+    RecordingTrafficManager traffic_manager(filename, header, local_map);
+    for (size_t i = 0u; i < starts.size(); ++i) {
+      traffic_manager.vehicle_id_list.push_back(static_cast<ActorId>(100u + i));
+    }
+    const ControlFrame no_commands;
+    std::vector<ControlFrame> result;
+    NodeList positions = starts;
+    for (size_t tick = 0u; tick < number_of_ticks; ++tick) {
+      SimulationState &simulation_state = traffic_manager.simulation_state;
+      simulation_state.Reset();
+      simulation_state.SetTimestamp(carla::client::Timestamp(
+          tick + 1u,
+          static_cast<double>(tick) * delta_seconds,
+          delta_seconds,
+          static_cast<double>(tick) * delta_seconds));
+      for (size_t i = 0u; i < positions.size(); ++i) {
+        const carla::geom::Transform transform = positions[i]->GetTransform();
+        const KinematicState kinematic_state{transform.location,
+                                             transform.rotation,
+                                             speed * positions[i]->GetForwardVector(),
+                                             30.0f / 3.6f,
+                                             true,
+                                             false,
+                                             transform.location};
+        const StaticAttributes attributes{ActorType::Vehicle, 2.4f, 1.0f, 0.8f};
+        simulation_state.AddActor(
+            traffic_manager.vehicle_id_list[i], kinematic_state, attributes, {TLS::Green, false});
+        // Each cycle the vehicles move to the next waypoint of their lane.
+        const NodeList next = positions[i]->GetNextWaypoint();
+        if (!next.empty()) {
+          positions[i] = next.front();
+        }
+      }
+      traffic_manager.track_traffic.SetHeroLocation(starts.front()->GetLocation());
+      // Halfway, the parameters change as if set by a client.
+      if (tick == number_of_ticks / 2u) {
+        traffic_manager.parameters.SetGlobalPercentageSpeedDifference(-40.0f);
+        traffic_manager.parameters.SetGlobalDistanceToLeadingVehicle(10.0f);
+      }
+      result.push_back(traffic_manager.Tick(record_commands ? nullptr : &no_commands));
+    }
+    return result;
+  }
+
+} // namespace
+
+TEST(traffic_manager, replay_matches_recording) {
+  using namespace carla::traffic_manager;
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  if (files.empty()) {
+    return;
+  }
+  const auto &file = files.front();
+  RecordingHeader header;
+  header.map_name = file;
+  header.opendrive = util::OpenDrive::Load(file);
+  header.seed = 42u;
+  header.longitudinal_PID_parameters = constants::PID::LONGITUDIAL_PARAM;
+  header.longitudinal_highway_PID_parameters = constants::PID::LONGITUDIAL_HIGHWAY_PARAM;
+  header.lateral_PID_parameters = constants::PID::LATERAL_PARAM;
+  header.lateral_highway_PID_parameters = constants::PID::LATERAL_HIGHWAY_PARAM;
+
+  auto world_map = carla::MakeShared<const carla::client::Map>(file, header.opendrive);
+  auto local_map = std::make_shared<InMemoryMap>(world_map);
+  local_map->SetUp();
+  const NodeList topology = local_map->GetDenseTopology();
+  ASSERT_FALSE(topology.empty());
+  NodeList starts;
+  for (size_t i = 0u; i < topology.size() && starts.size() < 16u; i += topology.size() / 16u + 1u) {
+    starts.push_back(topology[i]);
+  }
+
+  constexpr size_t number_of_ticks = 40u;
+  const std::string filename = "libcarla_test_traffic_manager_recording.bin";
+
+  // Commands that were not produced by the stages are reported.
+  write_recording(filename, header, local_map, starts, number_of_ticks, false);
+  {
+    TrafficManagerReplay replay(filename);
+    while (replay.Tick()) {
+      ASSERT_FALSE(replay.MatchesRecording()) << "frame " << replay.GetFrame();
+    }
+    ASSERT_EQ(replay.GetNumberOfMismatches(), number_of_ticks);
+  }
+
+  // The stages of a separate traffic manager record, the replay reproduces
+  // their commands from the recorded inputs alone.
+  const auto commands = write_recording(filename, header, local_map, starts, number_of_ticks, true);
+  ASSERT_EQ(commands.size(), number_of_ticks);
+  TrafficManagerReplay replay(filename);
+  for (size_t tick = 0u; replay.Tick(); ++tick) {
+    ASSERT_GE(commands[tick].size(), starts.size());
+    ASSERT_EQ(replay.GetControlFrame().size(), commands[tick].size()) << "frame " << replay.GetFrame();
+    ASSERT_TRUE(replay.MatchesRecording()) << "frame " << replay.GetFrame();
+  }
+  ASSERT_EQ(replay.GetNumberOfTicks(), number_of_ticks);
+  ASSERT_EQ(replay.GetNumberOfMismatches(), 0u);
+  std::remove(filename.c_str());
+}
+
+namespace {
+
+  using carla::traffic_manager::NodeList;
+  using carla::traffic_manager::SimpleWaypointPtr;
+
+  /// Waypoints of each connecting lane of each junction, in driving order.
+  static std::vector<NodeList> get_junction_lanes(const NodeList &topology) {
+    std::map<std::tuple<int32_t, uint32_t, int32_t>, NodeList> lanes;
+    for (const auto &waypoint : topology) {
+      if (waypoint->GetJunctionId() != -1) {
+        const auto raw_waypoint = waypoint->GetWaypoint();
+        lanes[std::make_tuple(waypoint->GetJunctionId(), raw_waypoint->GetRoadId(), raw_waypoint->GetLaneId())]
+            .push_back(waypoint);
+      }
+    }
+    std::vector<NodeList> result;
+    for (auto &lane : lanes) {
+      NodeList &waypoints = lane.second;
+      const bool forward = waypoints.front()->GetWaypoint()->GetLaneId() < 0;
+      std::sort(waypoints.begin(), waypoints.end(), [forward](const SimpleWaypointPtr &lhs, const SimpleWaypointPtr &rhs) {
+        const double lhs_s = lhs->GetWaypoint()->GetDistance();
+        const double rhs_s = rhs->GetWaypoint()->GetDistance();
+        return forward ? lhs_s < rhs_s : lhs_s > rhs_s;
+      });
+      result.push_back(waypoints);
+    }
+    return result;
+  }
+
+  static void check_same_conflicts(
+      const carla::traffic_manager::JunctionConflictTable &lhs,
+      const carla::traffic_manager::JunctionConflictTable &rhs,
+      const std::vector<NodeList> &lanes) {
+    for (const auto &lhs_lane : lanes) {
+      for (const auto &rhs_lane : lanes) {
+        const auto &a = *lhs_lane.front();
+        const auto &b = *rhs_lane.front();
+        ASSERT_EQ(lhs.HaveConflict(a, b), rhs.HaveConflict(a, b));
+      }
+    }
+  }
+
+  static std::vector<uint8_t> read_file(const std::string &filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+} // namespace
+
+TEST(traffic_manager, junction_conflict_table_matches_lane_geometry) {
+  namespace bg = boost::geometry;
+  using namespace carla::traffic_manager;
+  using Point = bg::model::d2::point_xy<double>;
+  using Linestring = bg::model::linestring<Point>;
+
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto world_map = carla::MakeShared<const carla::client::Map>(file, util::OpenDrive::Load(file));
+    auto local_map = std::make_shared<InMemoryMap>(world_map);
+    local_map->SetUp();
+    const JunctionConflictTable &table = local_map->GetJunctionConflicts();
+    const std::vector<NodeList> lanes = get_junction_lanes(local_map->GetDenseTopology());
+
+    // Center line of each lane from the waypoint before the junction to the
+    // one after it, and its widest point inside the junction.
+    std::vector<Linestring> lines;
+    std::vector<double> widths;
+    for (const NodeList &lane : lanes) {
+      Linestring line;
+      double width = 0.0;
+      auto append = [&line](const SimpleWaypointPtr &waypoint) {
+        const auto location = waypoint->GetLocation();
+        bg::append(line, Point(location.x, location.y));
+      };
+      const NodeList entry = lane.front()->GetPreviousWaypoint();
+      const NodeList exit = lane.back()->GetNextWaypoint();
+      if (!entry.empty()) {
+        append(entry.front());
+      }
+      for (const auto &waypoint : lane) {
+        append(waypoint);
+        width = std::max(width, waypoint->GetWaypoint()->GetLaneWidth());
+      }
+      if (!exit.empty()) {
+        append(exit.front());
+      }
+      if (line.size() == 1u) {
+        line.push_back(line.front());
+      }
+      lines.push_back(line);
+      widths.push_back(width);
+    }
+
+    for (size_t i = 0u; i < lanes.size(); ++i) {
+      const auto &lhs = *lanes[i].front();
+      for (size_t j = 0u; j < lanes.size(); ++j) {
+        const auto &rhs = *lanes[j].front();
+        bool expected = true;
+        if (i != j && lhs.GetJunctionId() == rhs.GetJunctionId()) {
+          const double threshold = 0.5 * (widths[i] + widths[j]) - constants::Map::JUNCTION_LANE_OVERLAP_TOLERANCE;
+          expected = bg::distance(lines[i], lines[j]) < threshold;
+        }
+        ASSERT_EQ(table.HaveConflict(lhs, rhs), expected)
+            << file << ", junction " << lhs.GetJunctionId() << ", lanes " << i << " and " << j;
+      }
+    }
+  }
+}
+
+TEST(traffic_manager, junction_conflict_table_write_read) {
+  using namespace carla::traffic_manager;
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  if (files.empty()) {
+    return;
+  }
+  const auto &file = files.front();
+  auto world_map = carla::MakeShared<const carla::client::Map>(file, util::OpenDrive::Load(file));
+  auto local_map = std::make_shared<InMemoryMap>(world_map);
+  local_map->SetUp();
+  const JunctionConflictTable &table = local_map->GetJunctionConflicts();
+  const std::vector<NodeList> lanes = get_junction_lanes(local_map->GetDenseTopology());
+
+  const std::string filename = "libcarla_test_junction_conflicts.bin";
+  {
+    std::ofstream out_file(filename, std::ios::binary);
+    table.Write(out_file);
+  }
+  const std::vector<uint8_t> content = read_file(filename);
+  std::remove(filename.c_str());
+
+  JunctionConflictTable read_table;
+  unsigned long start = 0u;
+  ASSERT_TRUE(read_table.Read(content, start));
+  ASSERT_EQ(start, content.size());
+  check_same_conflicts(table, read_table, lanes);
+
+  // Truncated tables are rejected, and report every pair as conflicting.
+  JunctionConflictTable empty_table;
+  for (size_t size = 0u; size < content.size(); size += content.size() / 16u + 1u) {
+    const std::vector<uint8_t> truncated(content.begin(), content.begin() + static_cast<long>(size));
+    start = 0u;
+    ASSERT_FALSE(read_table.Read(truncated, start)) << "size " << size;
+    check_same_conflicts(empty_table, read_table, lanes);
+  }
+}
+
+TEST(traffic_manager, in_memory_map_loads_cooked_junction_conflicts) {
+  using namespace carla::traffic_manager;
+  const auto files = util::OpenDrive::GetAvailableFiles();
+  if (files.empty()) {
+    return;
+  }
+  const auto &file = files.front();
+  auto world_map = carla::MakeShared<const carla::client::Map>(file, util::OpenDrive::Load(file));
+  auto local_map = std::make_shared<InMemoryMap>(world_map);
+  local_map->SetUp();
+  const std::vector<NodeList> lanes = get_junction_lanes(local_map->GetDenseTopology());
+
+  const std::string filename = "libcarla_test_junction_conflicts.bin";
+  InMemoryMap::Cook(world_map, filename);
+  const std::vector<uint8_t> content = read_file(filename);
+  {
+    std::ofstream out_file(filename, std::ios::binary);
+    local_map->GetJunctionConflicts().Write(out_file);
+  }
+  const size_t table_size = read_file(filename).size();
+  std::remove(filename.c_str());
+  ASSERT_LT(table_size, content.size());
+
+  // Current files, files cooked before the table existed, and files whose
+  // table is truncated.
+  const std::vector<size_t> sizes = {content.size(), content.size() - table_size, content.size() - 1u};
+  for (const size_t size : sizes) {
+    const std::vector<uint8_t> cooked(content.begin(), content.begin() + static_cast<long>(size));
+    InMemoryMap loaded_map(world_map);
+    ASSERT_TRUE(loaded_map.Load(cooked));
+    ASSERT_EQ(loaded_map.GetDenseTopology().size(), local_map->GetDenseTopology().size());
+    check_same_conflicts(local_map->GetJunctionConflicts(), loaded_map.GetJunctionConflicts(), lanes);
+  }
+}
+
+namespace {
+
+  using carla::traffic_manager::Buffer;
+
+  /// The stages deciding whether vehicles enter a junction, over a state set
+  /// by hand: vehicles standing still at the start of their buffers.
+  class JunctionStages {
+  public:
+
+    explicit JunctionStages(carla::traffic_manager::LocalMapPtr map, const bool junction_conflict_mode)
+      : local_map(std::move(map)),
+        collision_stage(vehicle_id_list, simulation_state, buffer_map, track_traffic,
+                        parameters, local_map, collision_frame, random_device),
+        traffic_light_stage(vehicle_id_list, simulation_state, buffer_map, parameters,
+                            local_map, tl_frame, random_device) {
+      parameters.SetJunctionConflictMode(junction_conflict_mode);
+    }
+
+    /// Adds a vehicle of the given half width and length, at a stop sign.
+    void AddVehicle(const ActorId actor_id, const Buffer &buffer, const float half_size = 0.0f) {
+      using namespace carla::traffic_manager;
+      const carla::geom::Transform transform = buffer.front()->GetTransform();
+      const KinematicState kinematic_state{transform.location,
+                                           transform.rotation,
+                                           carla::geom::Vector3D(),
+                                           30.0f / 3.6f,
+                                           true,
+                                           false,
+                                           transform.location};
+      const StaticAttributes attributes{ActorType::Vehicle,
+                                        half_size > 0.0f ? half_size : 2.4f,
+                                        half_size > 0.0f ? half_size : 1.0f,
+                                        0.8f};
+      simulation_state.AddActor(actor_id, kinematic_state, attributes, {TLS::Red, false});
+      buffer_map.insert({actor_id, buffer});
+      track_traffic.UpdateGridPosition(actor_id, buffer);
+      vehicle_id_list.push_back(actor_id);
+    }
+
+    /// Runs the traffic light stage at @a elapsed_seconds, returns whether
+    /// each vehicle is held.
+    std::vector<bool> UpdateTrafficLights(const double elapsed_seconds) {
+      simulation_state.SetTimestamp(carla::client::Timestamp(0u, elapsed_seconds, 0.05, elapsed_seconds));
+      tl_frame.clear();
+      tl_frame.resize(vehicle_id_list.size());
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        traffic_light_stage.Update(index);
+      }
+      return std::vector<bool>(tl_frame.begin(), tl_frame.end());
+    }
+
+    /// Runs the collision stage, returns whether each vehicle is held.
+    std::vector<bool> UpdateCollisions() {
+      collision_frame.clear();
+      collision_frame.resize(vehicle_id_list.size());
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        collision_stage.Update(index);
+      }
+      collision_stage.ClearCycleCache();
+      std::vector<bool> result;
+      for (const auto &hazard_data : collision_frame) {
+        result.push_back(hazard_data.hazard);
+      }
+      return result;
+    }
+
+  private:
+
+    std::vector<ActorId> vehicle_id_list;
+    carla::traffic_manager::SimulationState simulation_state;
+    carla::traffic_manager::BufferMap buffer_map;
+    carla::traffic_manager::TrackTraffic track_traffic;
+    carla::traffic_manager::Parameters parameters;
+    carla::traffic_manager::LocalMapPtr local_map;
+    carla::traffic_manager::RandomGenerator random_device {0u};
+    carla::traffic_manager::CollisionFrame collision_frame;
+    carla::traffic_manager::TLFrame tl_frame;
+    carla::traffic_manager::CollisionStage collision_stage;
+    carla::traffic_manager::TrafficLightStage traffic_light_stage;
+  };
+
+  /// Buffer of a vehicle driving through @a lane from its waypoint at
+  /// @a index, or from the waypoint before the junction if @a index is
+  /// negative, up to the waypoint after the junction.
+  static Buffer make_buffer(const NodeList &lane, const int index) {
+    Buffer buffer;
+    if (index < 0) {
+      const NodeList entry = lane.front()->GetPreviousWaypoint();
+      if (!entry.empty()) {
+        buffer.push_back(entry.front());
+      }
+    }
+    for (size_t i = static_cast<size_t>(std::max(index, 0)); i < lane.size(); ++i) {
+      buffer.push_back(lane[i]);
+    }
+    const NodeList exit = lane.back()->GetNextWaypoint();
+    if (!exit.empty()) {
+      buffer.push_back(exit.front());
+    }
+    return buffer;
+  }
+
+  /// Indices of the closest waypoints of two lanes and their distance.
+  static std::tuple<int, int, float> get_closest_waypoints(const NodeList &lhs, const NodeList &rhs) {
+    std::tuple<int, int, float> closest {0, 0, std::numeric_limits<float>::max()};
+    for (size_t i = 0u; i < lhs.size(); ++i) {
+      for (size_t j = 0u; j < rhs.size(); ++j) {
+        const float distance = std::sqrt(lhs[i]->DistanceSquared(rhs[j]));
+        if (distance < std::get<2>(closest)) {
+          closest = std::make_tuple(static_cast<int>(i), static_cast<int>(j), distance);
+        }
+      }
+    }
+    return closest;
+  }
+
+} // namespace
+
+TEST(traffic_manager, junction_conflict_mode_admits_disjoint_lanes) {
+  using namespace carla::traffic_manager;
+
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto world_map = carla::MakeShared<const carla::client::Map>(file, util::OpenDrive::Load(file));
+    auto local_map = std::make_shared<InMemoryMap>(world_map);
+    local_map->SetUp();
+    const JunctionConflictTable &table = local_map->GetJunctionConflicts();
+    const std::vector<NodeList> lanes = get_junction_lanes(local_map->GetDenseTopology());
+
+    // A lane of a junction, the closest one that does not conflict with it
+    // and the closest one that does.
+    size_t lane = lanes.size();
+    size_t disjoint_lane = lanes.size();
+    size_t conflicting_lane = lanes.size();
+    float disjoint_distance = std::numeric_limits<float>::max();
+    for (size_t i = 0u; i < lanes.size(); ++i) {
+      size_t disjoint = lanes.size();
+      size_t conflicting = lanes.size();
+      float closest_disjoint = std::numeric_limits<float>::max();
+      float closest_conflicting = std::numeric_limits<float>::max();
+      for (size_t j = 0u; j < lanes.size(); ++j) {
+        if (i == j || lanes[i].front()->GetJunctionId() != lanes[j].front()->GetJunctionId()) {
+          continue;
+        }
+        const float distance = std::get<2>(get_closest_waypoints(lanes[i], lanes[j]));
+        const bool conflict = table.HaveConflict(*lanes[i].front(), *lanes[j].front());
+        if (!conflict && distance < closest_disjoint) {
+          disjoint = j;
+          closest_disjoint = distance;
+        } else if (conflict && distance < closest_conflicting) {
+          conflicting = j;
+          closest_conflicting = distance;
+        }
+      }
+      if (disjoint != lanes.size() && conflicting != lanes.size()
+          && lanes[i].size() > 1u && closest_disjoint < disjoint_distance) {
+        lane = i;
+        disjoint_lane = disjoint;
+        conflicting_lane = conflicting;
+        disjoint_distance = closest_disjoint;
+      }
+    }
+    if (lane == lanes.size()) {
+      continue;
+    }
+    const NodeList &a = lanes[lane];
+    const NodeList &b = lanes[disjoint_lane];
+    const NodeList &c = lanes[conflicting_lane];
+
+    // Stop sign: vehicles queue in arrival order, a on each lane and then a
+    // second one on the first lane. Once they have stopped long enough the
+    // first to arrive enters, and with the junction conflict mode so do the
+    // ones whose path does not conflict with any vehicle ahead in the queue.
+    for (const bool mode : {false, true}) {
+      JunctionStages stages(local_map, mode);
+      stages.AddVehicle(1u, make_buffer(a, -1));
+      stages.AddVehicle(2u, make_buffer(b, -1));
+      stages.AddVehicle(3u, make_buffer(c, -1));
+      stages.AddVehicle(4u, make_buffer(a, -1));
+      const std::vector<bool> all_held(4u, true);
+      ASSERT_EQ(stages.UpdateTrafficLights(0.0), all_held) << file;
+      ASSERT_EQ(stages.UpdateTrafficLights(0.1), all_held) << file;
+      const std::vector<bool> expected = {false, !mode, true, true};
+      ASSERT_EQ(stages.UpdateTrafficLights(0.2 + constants::TrafficLight::MINIMUM_STOP_TIME), expected)
+          << file << ", junction conflict mode " << mode;
+    }
+
+    // Inside the junction, vehicles wide enough for their boxes to overlap
+    // at the closest points of their lanes, so that only the lanes decide.
+    for (const bool mode : {false, true}) {
+      const auto closest = get_closest_waypoints(a, b);
+      const float half_size = 0.5f * std::get<2>(closest) + 0.5f;
+      JunctionStages stages(local_map, mode);
+      stages.AddVehicle(1u, make_buffer(a, std::get<0>(closest)), half_size);
+      stages.AddVehicle(2u, make_buffer(b, std::get<1>(closest)), half_size);
+      const std::vector<bool> held = stages.UpdateCollisions();
+      if (mode) {
+        ASSERT_EQ(held, std::vector<bool>(2u, false)) << file;
+      } else {
+        ASSERT_TRUE(held[0] || held[1]) << file;
+      }
+    }
+    {
+      const auto closest = get_closest_waypoints(a, c);
+      const float half_size = 0.5f * std::get<2>(closest) + 0.5f;
+      JunctionStages stages(local_map, true);
+      stages.AddVehicle(1u, make_buffer(a, std::get<0>(closest)), half_size);
+      stages.AddVehicle(3u, make_buffer(c, std::get<1>(closest)), half_size);
+      const std::vector<bool> held = stages.UpdateCollisions();
+      ASSERT_TRUE(held[0] || held[1]) << file;
+    }
+    {
+      // The second vehicle follows the first one on its lane.
+      JunctionStages stages(local_map, true);
+      stages.AddVehicle(1u, make_buffer(a, 1));
+      stages.AddVehicle(4u, make_buffer(a, 0));
+      ASSERT_TRUE(stages.UpdateCollisions()[1]) << file;
+    }
+  }
+}
+
+TEST(traffic_manager, shard_partition_splits_by_actor_id) {
+  using carla::traffic_manager::ShardPartition;
+  std::vector<ActorId> ids(1000u);
+  std::iota(ids.begin(), ids.end(), 100u);
+  std::mt19937 random(0u);
+  std::shuffle(ids.begin(), ids.end(), random);
+  const auto get_id = [](const ActorId id) { return id; };
+
+  for (const size_t number_of_shards : {0u, 1u, 2u, 3u, 8u}) {
+    const auto shard_lists = ShardPartition::Split(ids, number_of_shards, get_id);
+    ASSERT_EQ(shard_lists.size(), std::max<size_t>(number_of_shards, 1u));
+
+    // Every vehicle is in exactly one shard, the one GetIndex gives, and the
+    // shards keep the order of the list.
+    std::map<ActorId, size_t> shard_of;
+    size_t max_size = 0u;
+    size_t min_size = ids.size();
+    for (size_t index = 0u; index < shard_lists.size(); ++index) {
+      const auto &shard_list = shard_lists[index];
+      for (const ActorId id : shard_list) {
+        ASSERT_TRUE(shard_of.emplace(id, index).second) << "vehicle " << id << " in two shards";
+        ASSERT_EQ(ShardPartition::GetIndex(id, number_of_shards), index);
+      }
+      std::vector<ActorId> in_list_order;
+      std::copy_if(ids.begin(), ids.end(), std::back_inserter(in_list_order),
+                   [&](const ActorId id) { return ShardPartition::GetIndex(id, number_of_shards) == index; });
+      ASSERT_EQ(shard_list, in_list_order);
+      max_size = std::max(max_size, shard_list.size());
+      min_size = std::min(min_size, shard_list.size());
+    }
+    ASSERT_EQ(shard_of.size(), ids.size());
+    // Consecutive actor ids are spread evenly.
+    ASSERT_LE(max_size - min_size, 1u);
+
+    // Splitting again, as when vehicles register in several calls, gives the
+    // same shards.
+    const std::vector<ActorId> first_half(ids.begin(), ids.begin() + 500);
+    const std::vector<ActorId> second_half(ids.begin() + 500, ids.end());
+    const auto first_lists = ShardPartition::Split(first_half, number_of_shards, get_id);
+    const auto second_lists = ShardPartition::Split(second_half, number_of_shards, get_id);
+    for (size_t index = 0u; index < shard_lists.size(); ++index) {
+      std::vector<ActorId> merged = first_lists[index];
+      merged.insert(merged.end(), second_lists[index].begin(), second_lists[index].end());
+      ASSERT_EQ(merged, shard_lists[index]);
+    }
+  }
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/AsyncLogger.h>
+#include <carla/StopWatch.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using carla::logging::AsyncLogger;
+using carla::logging::Level;
+
+static const char *LOG_FILE = "libcarla_test_async_logger.log";
+
+struct BinaryRecord {
+  uint64_t timestamp;
+  Level level;
+  std::string message;
+};
+
+static std::vector<BinaryRecord> ReadBinaryRecords(const char *path) {
+  std::vector<BinaryRecord> result;
+  std::ifstream file(path, std::ios::binary);
+  for (;;) {
+    BinaryRecord record;
+    uint8_t level;
+    uint32_t size;
+    if (!file.read(reinterpret_cast<char *>(&record.timestamp), sizeof(record.timestamp)) ||
+        !file.read(reinterpret_cast<char *>(&level), sizeof(level)) ||
+        !file.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+      break;
+    }
+    record.level = static_cast<Level>(level);
+    record.message.resize(size);
+    file.read(&record.message[0], size);
+    result.emplace_back(std::move(record));
+  }
+  return result;
+}
+
+TEST(logging, async_binary_output) {
+  std::remove(LOG_FILE);
+  AsyncLogger::Options options;
+  options.file_path = LOG_FILE;
+  options.binary = true;
+  AsyncLogger::Enable(options);
+  {
+    std::string temporary = "temporary";
+    carla::log_error("value", 42, true, temporary.c_str());
+    temporary = "overwritten";
+  }
+  carla::log_critical("second");
+  AsyncLogger::Disable();
+
+  auto records = ReadBinaryRecords(LOG_FILE);
+  std::remove(LOG_FILE);
+  ASSERT_EQ(records.size(), 2u);
+  ASSERT_EQ(records[0].level, Level::Error);
+  ASSERT_EQ(records[0].message, "value 42 true temporary");
+  ASSERT_EQ(records[1].level, Level::Critical);
+  ASSERT_EQ(records[1].message, "second");
+  ASSERT_LE(records[0].timestamp, records[1].timestamp);
+}
+
+TEST(logging, async_rate_limit) {
+  std::remove(LOG_FILE);
+  AsyncLogger::Options options;
+  options.file_path = LOG_FILE;
+  options.binary = true;
+  options.max_rate_per_call_site = 10u;
+  AsyncLogger::Enable(options);
+  const auto dropped = AsyncLogger::GetDroppedCount();
+  const auto suppressed = AsyncLogger::GetSuppressedCount();
+  for (auto i = 0; i < 100; ++i) {
+    carla::logging::log("rate limited", i);
+    // Warnings and errors are never rate limited.
+    carla::log_error("rate limited", i);
+  }
+  AsyncLogger::Disable();
+
+  auto records = ReadBinaryRecords(LOG_FILE);
+  std::remove(LOG_FILE);
+  ASSERT_EQ(AsyncLogger::GetDroppedCount(), dropped);
+  // Unless the loop straddles a second.
+  ASSERT_GE(AsyncLogger::GetSuppressedCount() - suppressed, 80u);
+  size_t errors = 0u;
+  size_t logs = 0u;
+  for (const auto &record : records) {
+    if (record.level == Level::Error) {
+      ++errors;
+    } else if (record.level == Level::Log) {
+      ++logs;
+    }
+  }
+  ASSERT_EQ(errors, 100u);
+  ASSERT_GE(logs, 10u);
+  ASSERT_LE(logs, 20u);
+  ASSERT_EQ(records.back().level, Level::Warning);
+  ASSERT_EQ(records.back().message.find("async logger suppressed"), 0u);
+}
+
+TEST(logging, benchmark_log_call) {
+  constexpr auto number_of_calls = 10'000;
+
+  const auto benchmark = [](auto &&log_call) {
+    carla::StopWatch stop_watch;
+    for (auto i = 0; i < number_of_calls; ++i) {
+      log_call(i);
+    }
+    stop_watch.Stop();
+    return 1e3 * static_cast<double>(stop_watch.GetElapsedTime<std::chrono::microseconds>()) / number_of_calls;
+  };
+
+  std::ofstream file(LOG_FILE);
+  const auto sync = benchmark([&](int i) {
+    carla::logging::write_to_stream(file, "ERROR:", "connection error", i, 0.5f, '\n');
+  });
+  file.close();
+
+  AsyncLogger::Options options;
+  options.file_path = LOG_FILE;
+  options.capacity = number_of_calls;
+  options.max_rate_per_call_site = 0u;
+  AsyncLogger::Enable(options);
+  const auto dropped = AsyncLogger::GetDroppedCount();
+  const auto async = benchmark([](int i) {
+    carla::log_error("connection error", i, 0.5f);
+  });
+  AsyncLogger::Disable();
+  std::remove(LOG_FILE);
+
+  ASSERT_EQ(AsyncLogger::GetDroppedCount(), dropped);
+  carla::logging::log("log call: synchronous", sync, "ns, asynchronous", async, "ns");
+}
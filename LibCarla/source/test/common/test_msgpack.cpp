@@ -7,8 +7,12 @@
 #include "test.h"
 
 #include <carla/MsgPackAdaptors.h>
+#include <carla/StopWatch.h>
 #include <carla/rpc/Actor.h>
+#include <carla/rpc/Command.h>
+#include <carla/rpc/CommandBatch.h>
 #include <carla/rpc/Response.h>
+#include <carla/rpc/Transform.h>
 
 #include <thread>
 
@@ -105,3 +109,68 @@ TEST(msgpack, optional) {
   ASSERT_TRUE(result.has_value());
   ASSERT_EQ(*result, 42.0f);
 }
+
+TEST(msgpack, command_batch) {
+  using mp = carla::MsgPack;
+  VehicleControlBatch controls;
+  TransformBatch transforms;
+  for (auto i = 0u; i < 10u; ++i) {
+    controls.Add(i, VehicleControl{0.1f * i, -0.5f, 0.2f, i % 2u == 0u, false, true, static_cast<int32_t>(i)});
+    transforms.Add(i, Transform{
+        carla::geom::Location{1.0f * i, 2.0f, 3.0f},
+        Rotation{10.0f, 20.0f * i, 30.0f}});
+  }
+  auto controls_result = mp::UnPack<VehicleControlBatch>(mp::Pack(controls));
+  auto transforms_result = mp::UnPack<TransformBatch>(mp::Pack(transforms));
+  ASSERT_TRUE(controls_result.IsValid());
+  ASSERT_TRUE(transforms_result.IsValid());
+  ASSERT_EQ(controls_result.size(), 10u);
+  ASSERT_EQ(transforms_result.size(), 10u);
+  for (auto i = 0u; i < 10u; ++i) {
+    ASSERT_EQ(controls_result.GetActor(i), i);
+    ASSERT_EQ(controls_result.GetValue(i), controls.GetValue(i));
+    ASSERT_EQ(transforms_result.GetActor(i), i);
+    ASSERT_EQ(transforms_result.GetValue(i), transforms.GetValue(i));
+  }
+}
+
+TEST(msgpack, benchmark_command_batch) {
+  using mp = carla::MsgPack;
+  constexpr auto number_of_vehicles = 1000u;
+  constexpr auto iterations = 100u;
+  const VehicleControl control{0.7f, -0.1f, 0.0f, false, false, false, 0};
+
+  std::vector<Command> commands;
+  VehicleControlBatch batch;
+  for (auto i = 0u; i < number_of_vehicles; ++i) {
+    commands.push_back(Command::ApplyVehicleControl{i, control});
+    batch.Add(i, control);
+  }
+
+  size_t size = 0u;
+  carla::StopWatch variant_watch;
+  for (auto i = 0u; i < iterations; ++i) {
+    auto buffer = mp::Pack(commands);
+    size = buffer.size();
+    auto result = mp::UnPack<std::vector<Command>>(buffer);
+    ASSERT_EQ(result.size(), number_of_vehicles);
+  }
+  variant_watch.Stop();
+  carla::logging::log(
+      "list of commands:", size, "bytes,",
+      1e-3 * static_cast<double>(variant_watch.GetElapsedTime<std::chrono::microseconds>()) / iterations,
+      "ms per round trip");
+
+  carla::StopWatch batch_watch;
+  for (auto i = 0u; i < iterations; ++i) {
+    auto buffer = mp::Pack(batch);
+    size = buffer.size();
+    auto result = mp::UnPack<VehicleControlBatch>(buffer);
+    ASSERT_EQ(result.size(), number_of_vehicles);
+  }
+  batch_watch.Stop();
+  carla::logging::log(
+      "columnar batch:", size, "bytes,",
+      1e-3 * static_cast<double>(batch_watch.GetElapsedTime<std::chrono::microseconds>()) / iterations,
+      "ms per round trip");
+}
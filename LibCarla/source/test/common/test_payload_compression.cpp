@@ -0,0 +1,192 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/sensor/s11n/PayloadCompression.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <thread>
+
+using carla::sensor::s11n::CompressionType;
+using carla::sensor::s11n::PayloadCompression;
+
+namespace {
+
+  constexpr uint32_t WIDTH = 800u;
+
+  constexpr uint32_t HEIGHT = 600u;
+
+  /// BGRA depth image as sent by the depth camera, the depth is encoded in
+  /// the three color channels and changes smoothly along each row.
+  static std::vector<unsigned char> make_depth_image() {
+    std::vector<unsigned char> image(4u * WIDTH * HEIGHT);
+    auto *pixel = image.data();
+    for (auto y = 0u; y < HEIGHT; ++y) {
+      for (auto x = 0u; x < WIDTH; ++x, pixel += 4u) {
+        const auto depth = static_cast<uint32_t>(1000u * y + 7u * x);
+        pixel[0u] = static_cast<unsigned char>(depth >> 16u);
+        pixel[1u] = static_cast<unsigned char>(depth >> 8u);
+        pixel[2u] = static_cast<unsigned char>(depth);
+        pixel[3u] = 255u;
+      }
+    }
+    return image;
+  }
+
+  /// BGRA semantic segmentation image, large regions with the same tag.
+  static std::vector<unsigned char> make_semantic_image() {
+    std::vector<unsigned char> image(4u * WIDTH * HEIGHT, 0u);
+    auto *pixel = image.data();
+    for (auto y = 0u; y < HEIGHT; ++y) {
+      for (auto x = 0u; x < WIDTH; ++x, pixel += 4u) {
+        pixel[2u] = static_cast<unsigned char>((x / 97u + y / 61u) % 23u);
+        pixel[3u] = 255u;
+      }
+    }
+    return image;
+  }
+
+  /// Lidar points {x, y, z, intensity} of a single rotation.
+  static std::vector<unsigned char> make_lidar_points() {
+    constexpr auto channels = 64u;
+    constexpr auto points_per_channel = 1800u;
+    std::vector<float> points;
+    points.reserve(4u * channels * points_per_channel);
+    for (auto channel = 0u; channel < channels; ++channel) {
+      const float pitch = -0.4f + 0.01f * static_cast<float>(channel);
+      for (auto i = 0u; i < points_per_channel; ++i) {
+        const float yaw = 6.2831853f * static_cast<float>(i) / points_per_channel;
+        const float range = 20.0f + 5.0f * std::sin(4.0f * yaw);
+        points.push_back(range * std::cos(yaw));
+        points.push_back(range * std::sin(yaw));
+        points.push_back(range * std::sin(pitch));
+        points.push_back(0.8f);
+      }
+    }
+    std::vector<unsigned char> bytes(sizeof(float) * points.size());
+    std::memcpy(bytes.data(), points.data(), bytes.size());
+    return bytes;
+  }
+
+  static carla::Buffer round_trip(
+      CompressionType type,
+      const std::vector<unsigned char> &data,
+      size_t &compressed_size) {
+    const auto compressed = PayloadCompression::Compress(
+        type, data.data(), data.size(), carla::Buffer());
+    compressed_size = compressed.size();
+    return PayloadCompression::Decompress(
+        type, compressed.data(), compressed.size(), carla::Buffer());
+  }
+
+  static void benchmark(const char *name, CompressionType type, const std::vector<unsigned char> &data) {
+    constexpr auto iterations = 10u;
+    carla::Buffer compressed;
+    carla::Buffer decompressed;
+    carla::StopWatch compress_watch;
+    for (auto i = 0u; i < iterations; ++i) {
+      compressed = PayloadCompression::Compress(type, data.data(), data.size(), std::move(compressed));
+    }
+    compress_watch.Stop();
+    carla::StopWatch decompress_watch;
+    for (auto i = 0u; i < iterations; ++i) {
+      decompressed = PayloadCompression::Decompress(
+          type, compressed.data(), compressed.size(), std::move(decompressed));
+    }
+    decompress_watch.Stop();
+    ASSERT_EQ(decompressed.size(), data.size());
+    ASSERT_EQ(std::memcmp(decompressed.data(), data.data(), data.size()), 0);
+    carla::logging::log(
+        name, ':',
+        "ratio", static_cast<double>(data.size()) / static_cast<double>(compressed.size()), ',',
+        compress_watch.GetElapsedTime<std::chrono::microseconds>() / iterations, "us compressing,",
+        decompress_watch.GetElapsedTime<std::chrono::microseconds>() / iterations, "us decompressing");
+  }
+
+} // namespace
+
+TEST(payload_compression, round_trip) {
+  std::mt19937 rng(42u);
+  std::uniform_int_distribution<int> byte(0, 3);
+  for (auto type : {CompressionType::LZ, CompressionType::ImageDelta}) {
+    for (size_t size : {0u, 1u, 3u, 4u, 12u, 13u, 100u, 4096u, 70000u, 300000u}) {
+      std::vector<unsigned char> data(size);
+      for (auto &value : data) {
+        value = static_cast<unsigned char>(byte(rng));
+      }
+      size_t compressed_size;
+      const auto result = round_trip(type, data, compressed_size);
+      ASSERT_EQ(result.size(), size);
+      ASSERT_LE(compressed_size, PayloadCompression::GetMaxCompressedSize(size));
+      if (size > 0u) {
+        ASSERT_EQ(std::memcmp(result.data(), data.data(), size), 0);
+      }
+    }
+  }
+}
+
+TEST(payload_compression, output_does_not_depend_on_previous_messages) {
+  // The match finder table is reused by each thread, the output of a message
+  // must be the same as if it was the first one compressed by the thread.
+  const auto semantic = make_semantic_image();
+  auto compress = [](const std::vector<unsigned char> &data) {
+    const auto buffer = PayloadCompression::Compress(
+        CompressionType::LZ, data.data(), data.size(), carla::Buffer());
+    return std::vector<unsigned char>(buffer.begin(), buffer.end());
+  };
+  std::vector<unsigned char> expected;
+  std::thread([&]() { expected = compress(semantic); }).join();
+  compress(make_lidar_points());
+  compress(make_depth_image());
+  ASSERT_EQ(compress(semantic), expected);
+}
+
+TEST(payload_compression, decompress_with_offset) {
+  const auto data = make_semantic_image();
+  const auto compressed = PayloadCompression::Compress(
+      CompressionType::LZ, data.data(), data.size(), carla::Buffer());
+  carla::Buffer header(std::string("header"));
+  const auto result = PayloadCompression::Decompress(
+      CompressionType::LZ, compressed.data(), compressed.size(), std::move(header), 6u);
+  ASSERT_EQ(result.size(), 6u + data.size());
+  ASSERT_EQ(std::memcmp(result.data(), "header", 6u), 0);
+  ASSERT_EQ(std::memcmp(result.data() + 6u, data.data(), data.size()), 0);
+}
+
+#ifndef LIBCARLA_NO_EXCEPTIONS
+TEST(payload_compression, corrupted_data) {
+  const auto data = make_depth_image();
+  auto compressed = PayloadCompression::Compress(
+      CompressionType::LZ, data.data(), data.size(), carla::Buffer());
+  // Claim a bigger original size than the stream decodes to.
+  const uint32_t wrong_size = static_cast<uint32_t>(data.size() + 1u);
+  std::memcpy(compressed.data(), &wrong_size, sizeof(wrong_size));
+  ASSERT_THROW(
+      PayloadCompression::Decompress(
+          CompressionType::LZ, compressed.data(), compressed.size(), carla::Buffer()),
+      std::runtime_error);
+  // Truncated stream.
+  ASSERT_THROW(
+      PayloadCompression::Decompress(
+          CompressionType::LZ, compressed.data(), compressed.size() / 2u, carla::Buffer()),
+      std::runtime_error);
+}
+#endif // LIBCARLA_NO_EXCEPTIONS
+
+TEST(payload_compression, benchmark) {
+  const auto depth = make_depth_image();
+  const auto semantic = make_semantic_image();
+  const auto lidar = make_lidar_points();
+  benchmark("depth LZ", CompressionType::LZ, depth);
+  benchmark("depth ImageDelta", CompressionType::ImageDelta, depth);
+  benchmark("semantic segmentation LZ", CompressionType::LZ, semantic);
+  benchmark("semantic segmentation ImageDelta", CompressionType::ImageDelta, semantic);
+  benchmark("lidar LZ", CompressionType::LZ, lidar);
+}
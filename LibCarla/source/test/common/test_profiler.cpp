@@ -0,0 +1,140 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StopWatch.h>
+#include <carla/ThreadGroup.h>
+#include <carla/profiler/Metrics.h>
+#include <carla/profiler/Tracer.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace carla::profiler;
+
+static const char *TRACE_FILE = "libcarla_test_profiler_trace.json";
+
+static void profiled_function() {
+  CARLA_PROFILE_SPAN(test, profiled_function);
+  CARLA_PROFILE_COUNTER(test, calls, 1);
+}
+
+TEST(profiler, histogram) {
+  Histogram histogram;
+  for (auto i = 1u; i <= 1000u; ++i) {
+    histogram.Add(i);
+  }
+  ASSERT_EQ(histogram.GetCount(), 1000u);
+  ASSERT_EQ(histogram.GetMin(), 1u);
+  ASSERT_EQ(histogram.GetMax(), 1000u);
+  ASSERT_DOUBLE_EQ(histogram.GetMean(), 500.5);
+  // Within a factor of two.
+  ASSERT_GE(histogram.GetQuantile(0.5), 500u);
+  ASSERT_LT(histogram.GetQuantile(0.5), 1000u);
+  ASSERT_EQ(histogram.GetQuantile(1.0), 1000u);
+  ASSERT_EQ(Histogram::GetBucket(0u), 0u);
+  ASSERT_EQ(Histogram::GetBucket(1u), 1u);
+  ASSERT_EQ(Histogram::GetBucket(1023u), 10u);
+  ASSERT_EQ(Histogram::GetBucket(1024u), 11u);
+}
+
+TEST(profiler, metrics) {
+  auto &histogram = Metrics::GetHistogram("test.profiled_function");
+  auto &counter = Metrics::GetCounter("test.calls");
+  const auto count = histogram.GetCount();
+  const auto calls = counter.Get();
+  for (auto i = 0; i < 10; ++i) {
+    profiled_function();
+  }
+  ASSERT_EQ(histogram.GetCount(), count + 10u);
+  ASSERT_EQ(counter.Get(), calls + 10);
+  ASSERT_NE(Metrics::GetSummary().find("test.profiled_function"), std::string::npos);
+}
+
+TEST(profiler, chrome_trace) {
+  std::remove(TRACE_FILE);
+  Tracer::Options options;
+  options.trace_file = TRACE_FILE;
+  options.summary_interval = carla::time_duration::milliseconds(0u);
+  Tracer::Start(options);
+  {
+    carla::ThreadGroup threads;
+    threads.CreateThreads(4u, []() {
+      for (auto i = 0; i < 100; ++i) {
+        profiled_function();
+      }
+    });
+  }
+  const std::string rpc_name = "get_episode_info";
+  {
+    CARLA_PROFILE_DYNAMIC_SPAN(rpc, rpc_name);
+  }
+  Tracer::Stop();
+
+  std::ifstream file(TRACE_FILE);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  file.close();
+  std::remove(TRACE_FILE);
+  const auto trace = buffer.str();
+  ASSERT_EQ(trace.front(), '[');
+  ASSERT_EQ(trace.substr(trace.size() - 2u), "]\n");
+  size_t spans = 0u;
+  for (auto pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1u)) {
+    ++spans;
+  }
+  ASSERT_EQ(spans + Tracer::GetDroppedCount(), 401u);
+  ASSERT_NE(trace.find("\"name\":\"get_episode_info\",\"cat\":\"rpc\""), std::string::npos);
+  ASSERT_NE(trace.find("\"ph\":\"C\""), std::string::npos);
+}
+
+#ifndef PLATFORM_WINDOWS
+TEST(profiler, start_from_environment) {
+  std::remove(TRACE_FILE);
+  unsetenv("CARLA_PROFILER_TRACE_FILE");
+  ASSERT_FALSE(Tracer::StartFromEnvironment());
+  ASSERT_FALSE(Tracer::IsRecording());
+  setenv("CARLA_PROFILER_TRACE_FILE", TRACE_FILE, 1);
+  setenv("CARLA_PROFILER_SUMMARY_INTERVAL", "0", 1);
+  ASSERT_TRUE(Tracer::StartFromEnvironment());
+  unsetenv("CARLA_PROFILER_TRACE_FILE");
+  unsetenv("CARLA_PROFILER_SUMMARY_INTERVAL");
+  ASSERT_TRUE(Tracer::IsRecording());
+  profiled_function();
+  Tracer::Stop();
+  ASSERT_FALSE(Tracer::IsRecording());
+  std::ifstream file(TRACE_FILE);
+  ASSERT_TRUE(file.is_open());
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  file.close();
+  std::remove(TRACE_FILE);
+  ASSERT_NE(buffer.str().find("\"name\":\"profiled_function\""), std::string::npos);
+}
+#endif // PLATFORM_WINDOWS
+
+TEST(profiler, benchmark_span) {
+  constexpr auto number_of_spans = 100'000;
+  const auto benchmark = []() {
+    carla::StopWatch stop_watch;
+    for (auto i = 0; i < number_of_spans; ++i) {
+      CARLA_PROFILE_SPAN(test, benchmark_span);
+    }
+    stop_watch.Stop();
+    return 1e3 * static_cast<double>(stop_watch.GetElapsedTime<std::chrono::microseconds>()) / number_of_spans;
+  };
+  const auto idle = benchmark();
+  Tracer::Options options;
+  options.summary_interval = carla::time_duration::milliseconds(0u);
+  Tracer::Start(options);
+  const auto recording = benchmark();
+  Tracer::Stop();
+  carla::logging::log("span: not recording", idle, "ns, recording", recording, "ns");
+}
@@ -0,0 +1,197 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/MoveHandler.h>
+#include <carla/StopWatch.h>
+#include <carla/Task.h>
+#include <carla/ThreadGroup.h>
+#include <carla/ThreadPool.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using carla::Task;
+using carla::ThreadPool;
+
+TEST(thread_pool, task_storage) {
+  auto counter = std::make_shared<int>(0);
+  {
+    Task task([counter]() { ++*counter; });
+    ASSERT_TRUE(static_cast<bool>(task));
+    Task moved = std::move(task);
+    ASSERT_FALSE(static_cast<bool>(task));
+    moved();
+    ASSERT_EQ(*counter, 1);
+    ASSERT_EQ(counter.use_count(), 2);
+  }
+  ASSERT_EQ(counter.use_count(), 1);
+
+  std::array<char, 2u * Task::INLINE_SIZE> big{};
+  big[0u] = 41;
+  auto lambda = [big, counter]() mutable { *counter = ++big[0u]; };
+  static_assert(!Task::IsInline<decltype(lambda)>(), "expected a heap-allocated task");
+  static_assert(Task::IsInline<std::packaged_task<int()>>(), "expected an inline task");
+  Task task(std::move(lambda));
+  Task moved;
+  moved = std::move(task);
+  moved();
+  ASSERT_EQ(*counter, 42);
+  moved.Reset();
+  ASSERT_EQ(counter.use_count(), 1);
+}
+
+TEST(thread_pool, post_from_many_threads) {
+  constexpr auto number_of_threads = 4u;
+  constexpr auto tasks_per_thread = 1000u;
+  ThreadPool pool;
+  pool.AsyncRun(2u);
+  std::atomic_size_t sum{0u};
+  {
+    carla::ThreadGroup threads;
+    threads.CreateThreads(number_of_threads, [&]() {
+      std::vector<std::future<size_t>> results;
+      for (auto i = 0u; i < tasks_per_thread; ++i) {
+        results.emplace_back(pool.Post([i]() { return size_t(i); }));
+      }
+      for (auto &result : results) {
+        sum += result.get();
+      }
+    });
+  }
+  ASSERT_EQ(sum, number_of_threads * (tasks_per_thread * (tasks_per_thread - 1u) / 2u));
+}
+
+TEST(thread_pool, run_for) {
+  ThreadPool pool;
+  auto result = pool.Post([]() { return 42; });
+  pool.RunFor(carla::time_duration::milliseconds(10u));
+  ASSERT_EQ(result.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  ASSERT_EQ(result.get(), 42);
+}
+
+TEST(thread_pool, parallel_for) {
+  constexpr auto size = 10'000u;
+  for (auto workers : {0u, 1u, 3u}) {
+    ThreadPool pool;
+    pool.AsyncRun(workers);
+    for (auto grain_size : {0u, 1u, 7u, size, 2u * size}) {
+      std::vector<std::atomic_int> visited(size);
+      pool.ParallelFor(size, grain_size, [&](size_t i) { ++visited[i]; });
+      for (auto &count : visited) {
+        ASSERT_EQ(count, 1);
+      }
+    }
+  }
+}
+
+TEST(thread_pool, parallel_for_on_a_fresh_pool) {
+  constexpr auto workers = 3u;
+  ThreadPool pool;
+  // Right after AsyncRun, the workers may not have started yet.
+  pool.AsyncRun(workers);
+  // Each chunk waits for the others, so every thread must run one of them.
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::set<std::thread::id> threads;
+  pool.ParallelFor(workers + 1u, 1u, [&](size_t) {
+    std::unique_lock<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+    condition.notify_all();
+    condition.wait_for(lock, std::chrono::seconds(5), [&]() {
+      return threads.size() == workers + 1u;
+    });
+  });
+  ASSERT_EQ(threads.size(), workers + 1u);
+}
+
+TEST(thread_pool, nested_parallel_for) {
+  constexpr auto size = 64u;
+  ThreadPool pool;
+  pool.AsyncRun(2u);
+  std::atomic_size_t count{0u};
+  auto result = pool.Post([&]() {
+    pool.ParallelFor(size, 1u, [&](size_t) {
+      pool.ParallelFor(size, 1u, [&](size_t) { ++count; });
+    });
+  });
+  result.get();
+  ASSERT_EQ(count, size * size);
+}
+
+#ifndef LIBCARLA_NO_EXCEPTIONS
+TEST(thread_pool, parallel_for_exception) {
+  ThreadPool pool;
+  pool.AsyncRun(2u);
+  std::atomic_size_t count{0u};
+  ASSERT_THROW(pool.ParallelFor(1000u, 10u, [&](size_t i) {
+    ++count;
+    if (i == 500u) {
+      throw std::runtime_error("parallel_for");
+    }
+  }), std::runtime_error);
+  ASSERT_LE(count, 1000u);
+}
+#endif // LIBCARLA_NO_EXCEPTIONS
+
+TEST(thread_pool, benchmark_scheduling) {
+  constexpr auto number_of_threads = 4u;
+  constexpr auto tasks_per_thread = 20'000u;
+
+  /// Nanoseconds per task posting empty tasks from several threads and
+  /// waiting for all of them.
+  const auto benchmark = [](auto &&post) {
+    carla::StopWatch stop_watch;
+    {
+      carla::ThreadGroup threads;
+      threads.CreateThreads(number_of_threads, [&]() {
+        std::vector<std::future<void>> results;
+        results.reserve(tasks_per_thread);
+        for (auto i = 0u; i < tasks_per_thread; ++i) {
+          results.emplace_back(post());
+        }
+        for (auto &result : results) {
+          result.get();
+        }
+      });
+    }
+    stop_watch.Stop();
+    return 1e3 * static_cast<double>(stop_watch.GetElapsedTime<std::chrono::microseconds>()) /
+        (number_of_threads * tasks_per_thread);
+  };
+
+  // Posting directly to the io_context, as the pool used to.
+  ThreadPool asio_pool;
+  asio_pool.AsyncRun(number_of_threads);
+  const auto asio = benchmark([&]() {
+    auto task = std::packaged_task<void()>([]() {});
+    auto future = task.get_future();
+    boost::asio::post(asio_pool.io_context(), carla::MoveHandler(task));
+    return future;
+  });
+
+  ThreadPool pool;
+  pool.AsyncRun(number_of_threads);
+  const auto stealing = benchmark([&]() { return pool.Post([]() {}); });
+
+  constexpr auto size = 1'000'000u;
+  std::vector<float> values(size, 1.0f);
+  carla::StopWatch stop_watch;
+  pool.ParallelFor(size, [&](size_t i) { values[i] *= 2.0f; });
+  stop_watch.Stop();
+
+  carla::logging::log(
+      "post: io_context", asio, "ns, work-stealing", stealing, "ns per task;",
+      "parallel for:", stop_watch.GetElapsedTime<std::chrono::microseconds>(), "us for", size, "elements");
+}
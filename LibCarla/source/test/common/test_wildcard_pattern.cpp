@@ -0,0 +1,41 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/StringUtil.h>
+#include <carla/WildcardPattern.h>
+
+using carla::StringUtil;
+using carla::WildcardPattern;
+
+TEST(wildcard_pattern, same_as_fnmatch) {
+  const std::vector<std::string> patterns = {
+      "", "*", "**", "vehicle.*", "*.*", "walker.*", "*traffic.*", "*traffic_light*",
+      "traffic.traffic_light", "*light", "v*e*h*", "*a*a*", "aa*aa", "*.tesla.*",
+      "vehicle.?esla.*", "vehicle.[a-m]*", "sensor.camera.\\*"};
+  const std::vector<std::string> strings = {
+      "", "a", "aa", "aaa", "aaaa", "vehicle", "vehicle.", "vehicle.tesla.model3",
+      "walker.pedestrian.0001", "traffic.traffic_light", "traffic.stop",
+      "traffic.speed_limit.30", "static.prop.streetlight", "sensor.camera.*",
+      "sensor.camera.rgb"};
+  for (auto &&pattern : patterns) {
+    const WildcardPattern compiled(pattern);
+    for (auto &&str : strings) {
+      ASSERT_EQ(compiled.Match(str), StringUtil::Match(str, pattern))
+          << "pattern '" << pattern << "' string '" << str << "'";
+    }
+  }
+}
+
+TEST(wildcard_pattern, cache) {
+  auto pattern = WildcardPattern::Get("vehicle.*");
+  ASSERT_EQ(pattern, WildcardPattern::Get("vehicle.*"));
+  ASSERT_NE(pattern, WildcardPattern::Get("walker.*"));
+  ASSERT_EQ(pattern->GetPattern(), "vehicle.*");
+  ASSERT_TRUE(pattern->Match("vehicle.audi.tt"));
+  ASSERT_FALSE(pattern->Match("walker.pedestrian.0001"));
+}
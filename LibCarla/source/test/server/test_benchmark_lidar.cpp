@@ -0,0 +1,100 @@
+// Copyright (c) 2017 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/BufferPool.h>
+#include <carla/StopWatch.h>
+#include <carla/sensor/s11n/LidarSerializer.h>
+
+using namespace carla::sensor;
+
+namespace {
+
+  struct FakeLidar {};
+
+  constexpr uint32_t CHANNELS = 128u;
+
+  constexpr size_t POINTS_PER_SECOND = 2600000u;
+
+  template <typename LidarDataT>
+  static void WriteScan(LidarDataT &lidar, std::vector<uint32_t> &points_per_channel) {
+    lidar.ResetMemory(points_per_channel);
+    for (auto channel = 0u; channel < CHANNELS; ++channel) {
+      for (auto i = 0u; i < points_per_channel[channel]; ++i) {
+        data::LidarDetection detection{
+            static_cast<float>(i),
+            static_cast<float>(channel),
+            1.0f,
+            0.5f};
+        lidar.WritePointSync(detection);
+      }
+    }
+    lidar.WriteChannelCount(points_per_channel);
+  }
+
+  /// Returns the time in microseconds spent writing and serializing @a scans
+  /// scans, serializing through the zero-copy path if @a zero_copy is true.
+  static size_t benchmark_lidar(size_t frequency, size_t scans, bool zero_copy) {
+    auto pool = std::make_shared<carla::BufferPool>();
+    data::LidarData lidar{CHANNELS};
+    std::vector<uint32_t> points_per_channel(CHANNELS, static_cast<uint32_t>(
+        POINTS_PER_SECOND / (frequency * CHANNELS)));
+    const size_t expected_size =
+        sizeof(uint32_t) * (2u + CHANNELS) +
+        sizeof(float) * 4u * CHANNELS * points_per_channel[0u];
+
+    FakeLidar sensor;
+    carla::StopWatch stop_watch;
+    for (auto i = 0u; i < scans; ++i) {
+      WriteScan(lidar, points_per_channel);
+      carla::Buffer message = zero_copy ?
+          s11n::LidarSerializer::Serialize(sensor, lidar, pool->Pop()) :
+          s11n::LidarSerializer::Serialize(sensor, static_cast<const data::LidarData &>(lidar), pool->Pop());
+      EXPECT_EQ(message.size(), expected_size);
+    }
+    stop_watch.Stop();
+    return stop_watch.GetElapsedTime<std::chrono::microseconds>();
+  }
+
+} // namespace
+
+TEST(lidar, zero_copy_serialization) {
+  data::LidarData lidar{CHANNELS};
+  std::vector<uint32_t> points_per_channel(CHANNELS, 10u);
+  WriteScan(lidar, points_per_channel);
+  FakeLidar sensor;
+  const carla::Buffer copied = s11n::LidarSerializer::Serialize(
+      sensor,
+      static_cast<const data::LidarData &>(lidar),
+      carla::Buffer());
+  const carla::Buffer moved = s11n::LidarSerializer::Serialize(sensor, lidar, carla::Buffer());
+  ASSERT_EQ(copied.size(), moved.size());
+  ASSERT_TRUE(copied == moved);
+  // Channel counts are reset once the points are popped.
+  const carla::Buffer empty = s11n::LidarSerializer::Serialize(sensor, lidar, carla::Buffer());
+  ASSERT_EQ(empty.size(), sizeof(uint32_t) * (2u + CHANNELS));
+}
+
+TEST(benchmark_lidar, channels_128_10Hz) {
+  constexpr auto scans = 50u;
+  const auto copy = benchmark_lidar(10u, scans, false);
+  const auto zero_copy = benchmark_lidar(10u, scans, true);
+  carla::logging::log(
+      "128 channels at 10Hz:",
+      copy / scans, "us per scan copying,",
+      zero_copy / scans, "us per scan zero-copy");
+}
+
+TEST(benchmark_lidar, channels_128_20Hz) {
+  constexpr auto scans = 100u;
+  const auto copy = benchmark_lidar(20u, scans, false);
+  const auto zero_copy = benchmark_lidar(20u, scans, true);
+  carla::logging::log(
+      "128 channels at 20Hz:",
+      copy / scans, "us per scan copying,",
+      zero_copy / scans, "us per scan zero-copy");
+}
@@ -179,11 +179,14 @@ void export_actor() {
       .def("close_door", &cc::Vehicle::CloseDoor, (arg("door_idx")))
       .def("set_wheel_steer_direction", &cc::Vehicle::SetWheelSteerDirection, (arg("wheel_location")), (arg("angle_in_deg")))
       .def("get_wheel_steer_angle", &cc::Vehicle::GetWheelSteerAngle, (arg("wheel_location")))
+      .def("get_wheel_steer_angle_async", CALL_RETURNING_FUTURE_1(cc::Vehicle, GetWheelSteerAngleAsync, cr::VehicleWheelLocation), (arg("wheel_location")))
       .def("get_light_state", CONST_CALL_WITHOUT_GIL(cc::Vehicle, GetLightState))
       .def("apply_physics_control", &cc::Vehicle::ApplyPhysicsControl, (arg("physics_control")))
       .def("get_physics_control", CONST_CALL_WITHOUT_GIL(cc::Vehicle, GetPhysicsControl))
+      .def("get_physics_control_async", CALL_RETURNING_FUTURE(cc::Vehicle, GetPhysicsControlAsync))
       .def("apply_ackermann_controller_settings", &cc::Vehicle::ApplyAckermannControllerSettings, (arg("settings")))
       .def("get_ackermann_controller_settings", CONST_CALL_WITHOUT_GIL(cc::Vehicle, GetAckermannControllerSettings))
+      .def("get_ackermann_controller_settings_async", CALL_RETURNING_FUTURE(cc::Vehicle, GetAckermannControllerSettingsAsync))
       .def("set_autopilot", CALL_WITHOUT_GIL_2(cc::Vehicle, SetAutopilot, bool, uint16_t), (arg("enabled") = true, arg("tm_port") = ctm::TM_DEFAULT_PORT))
       .def("show_debug_telemetry", &cc::Vehicle::ShowDebugTelemetry, (arg("enabled") = true))
       .def("get_speed_limit", &cc::Vehicle::GetSpeedLimit)
@@ -251,6 +254,7 @@ void export_actor() {
       .def("reset_group", &cc::TrafficLight::ResetGroup)
       .def("get_affected_lane_waypoints", CALL_RETURNING_LIST(cc::TrafficLight, GetAffectedLaneWaypoints))
       .def("get_light_boxes", &GetLightBoxes)
+      .def("get_light_boxes_async", CALL_RETURNING_FUTURE(cc::TrafficLight, GetLightBoxesAsync))
       .def("get_opendrive_id", &cc::TrafficLight::GetOpenDRIVEID)
       .def("get_stop_waypoints", CALL_RETURNING_LIST(cc::TrafficLight, GetStopWaypoints))
       .def(self_ns::str(self_ns::self))
@@ -9,6 +9,7 @@
 #include "carla/client/World.h"
 #include "carla/Logging.h"
 #include "carla/rpc/ActorId.h"
+#include "carla/rpc/CommandBatch.h"
 #include "carla/trafficmanager/TrafficManager.h"
 
 #include <thread>
@@ -49,6 +50,84 @@ static void ApplyBatchCommands(
   self.ApplyBatch(std::move(cmds), do_tick);
 }
 
+/// Build a columnar batch from a sequence of actor ids and a sequence of
+/// values of the same length.
+template <typename BatchT>
+static BatchT MakeCommandBatch(
+    const boost::python::object &actor_ids,
+    const boost::python::object &values) {
+  namespace py = boost::python;
+  using ValueType = typename BatchT::value_type;
+  const auto size = py::len(actor_ids);
+  if (py::len(values) != size) {
+    throw std::invalid_argument("the number of actor ids and values must match");
+  }
+  BatchT batch;
+  batch.reserve(static_cast<size_t>(size));
+  py::stl_input_iterator<carla::rpc::ActorId> actor(actor_ids);
+  py::stl_input_iterator<ValueType> value(values);
+  for (auto i = 0; i < size; ++i, ++actor, ++value) {
+    batch.Add(*actor, *value);
+  }
+  return batch;
+}
+
+static void ApplyVehicleControls(
+    const carla::client::Client &self,
+    const boost::python::object &actor_ids,
+    const boost::python::object &controls,
+    bool do_tick) {
+  const auto batch = MakeCommandBatch<carla::rpc::VehicleControlBatch>(actor_ids, controls);
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.ApplyVehicleControls(batch, do_tick);
+}
+
+static auto ApplyVehicleControlsSync(
+    const carla::client::Client &self,
+    const boost::python::object &actor_ids,
+    const boost::python::object &controls,
+    bool do_tick) {
+  const auto batch = MakeCommandBatch<carla::rpc::VehicleControlBatch>(actor_ids, controls);
+  std::vector<carla::rpc::ActorId> failed;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    failed = self.ApplyVehicleControlsSync(batch, do_tick);
+  }
+  boost::python::list result;
+  for (auto id : failed) {
+    result.append(id);
+  }
+  return result;
+}
+
+static void ApplyTransforms(
+    const carla::client::Client &self,
+    const boost::python::object &actor_ids,
+    const boost::python::object &transforms,
+    bool do_tick) {
+  const auto batch = MakeCommandBatch<carla::rpc::TransformBatch>(actor_ids, transforms);
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.ApplyTransforms(batch, do_tick);
+}
+
+static auto ApplyTransformsSync(
+    const carla::client::Client &self,
+    const boost::python::object &actor_ids,
+    const boost::python::object &transforms,
+    bool do_tick) {
+  const auto batch = MakeCommandBatch<carla::rpc::TransformBatch>(actor_ids, transforms);
+  std::vector<carla::rpc::ActorId> failed;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    failed = self.ApplyTransformsSync(batch, do_tick);
+  }
+  boost::python::list result;
+  for (auto id : failed) {
+    result.append(id);
+  }
+  return result;
+}
+
 static auto ApplyBatchCommandsSync(
     const carla::client::Client &self,
     const boost::python::object &commands,
@@ -175,6 +254,12 @@ void export_client() {
   namespace cc = carla::client;
   namespace rpc = carla::rpc;
 
+  class_<PythonFuture>("Future", no_init)
+    .def("done", &PythonFuture::done)
+    .def("result", &PythonFuture::result)
+    .def("__await__", &PythonFuture::await)
+  ;
+
   class_<rpc::OpendriveGenerationParameters>("OpendriveGenerationParameters",
       init<double, double, double, double, bool, bool, bool>((arg("vertex_distance")=2.0, arg("max_road_length")=50.0, arg("wall_height")=1.0, arg("additional_width")=0.6, arg("smooth_junctions")=true, arg("enable_mesh_visibility")=true, arg("enable_pedestrian_navigation")=true)))
     .def_readwrite("vertex_distance", &rpc::OpendriveGenerationParameters::vertex_distance)
@@ -212,6 +297,10 @@ void export_client() {
     .def("set_replayer_ignore_hero", &cc::Client::SetReplayerIgnoreHero, (arg("ignore_hero")))
     .def("apply_batch", &ApplyBatchCommands, (arg("commands"), arg("do_tick")=false))
     .def("apply_batch_sync", &ApplyBatchCommandsSync, (arg("commands"), arg("do_tick")=false))
+    .def("apply_vehicle_controls", &ApplyVehicleControls, (arg("actor_ids"), arg("controls"), arg("do_tick")=false))
+    .def("apply_vehicle_controls_sync", &ApplyVehicleControlsSync, (arg("actor_ids"), arg("controls"), arg("do_tick")=false))
+    .def("apply_transforms", &ApplyTransforms, (arg("actor_ids"), arg("transforms"), arg("do_tick")=false))
+    .def("apply_transforms_sync", &ApplyTransformsSync, (arg("actor_ids"), arg("transforms"), arg("do_tick")=false))
     .def("get_trafficmanager", CONST_CALL_WITHOUT_GIL_1(cc::Client, GetInstanceTM, uint16_t), (arg("port")=ctm::TM_DEFAULT_PORT))
   ;
 }
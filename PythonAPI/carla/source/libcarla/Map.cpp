@@ -10,6 +10,7 @@
 #include <carla/client/Map.h>
 #include <carla/client/Waypoint.h>
 #include <carla/road/element/LaneMarking.h>
+#include <carla/road/element/WaypointArray.h>
 #include <carla/client/Landmark.h>
 #include <carla/road/SignalType.h>
 
@@ -52,6 +53,131 @@ static auto GetTopology(const carla::client::Map &self) {
   return result;
 }
 
+static auto TraceRoute(
+    const carla::client::Map &self,
+    const carla::geom::Location &origin,
+    const carla::geom::Location &destination,
+    double sampling_resolution) {
+  namespace py = boost::python;
+  carla::client::Map::Route route;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    route = self.TraceRoute(origin, destination, sampling_resolution);
+  }
+  py::list result;
+  for (auto &&point : route) {
+    result.append(py::make_tuple(point.first, point.second));
+  }
+  return result;
+}
+
+#if PY_MAJOR_VERSION >= 3
+/// Python object exporting a column of a WaypointArray through the buffer
+/// protocol. It holds a reference to the Python object owning the memory, so
+/// the views created from it keep the array alive.
+struct ArrayViewExporter {
+  PyObject_HEAD
+  PyObject *owner;
+  void *data;
+  Py_ssize_t size;
+  const char *format;
+  Py_ssize_t itemsize;
+  int ndim;
+  Py_ssize_t shape[2u];
+};
+
+static int ArrayViewExporterGetBuffer(PyObject *object, Py_buffer *buffer, int flags) {
+  auto *self = reinterpret_cast<ArrayViewExporter *>(object);
+  if (PyBuffer_FillInfo(buffer, object, self->data, self->size, 1, flags) != 0) {
+    return -1;
+  }
+  if ((flags & PyBUF_FORMAT) && (flags & PyBUF_ND)) {
+    buffer->format = const_cast<char *>(self->format);
+    buffer->itemsize = self->itemsize;
+    buffer->ndim = self->ndim;
+    buffer->shape = self->shape;
+    buffer->strides = nullptr;
+  }
+  return 0;
+}
+
+static void ArrayViewExporterDealloc(PyObject *object) {
+  Py_XDECREF(reinterpret_cast<ArrayViewExporter *>(object)->owner);
+  Py_TYPE(object)->tp_free(object);
+}
+
+static PyTypeObject *GetArrayViewExporterType() {
+  static PyBufferProcs buffer_procs = {&ArrayViewExporterGetBuffer, nullptr};
+  static PyTypeObject type{};
+  if (type.tp_name == nullptr) {
+    // Static types are never released, hold the reference the header
+    // initializer would have set.
+    Py_INCREF(&type);
+    type.tp_name = "carla.ArrayViewExporter";
+    type.tp_basicsize = sizeof(ArrayViewExporter);
+    type.tp_flags = Py_TPFLAGS_DEFAULT;
+    type.tp_dealloc = &ArrayViewExporterDealloc;
+    type.tp_as_buffer = &buffer_procs;
+    if (PyType_Ready(&type) != 0) {
+      boost::python::throw_error_already_set();
+    }
+  }
+  return &type;
+}
+#endif // PY_MAJOR_VERSION >= 3
+
+/// Read-only view of the memory of @a data with @a columns values per row,
+/// convertible to a numpy array without copying. The view keeps @a owner, the
+/// Python object holding @a data, alive.
+template <typename T>
+static auto MakeArrayView(
+    boost::python::object owner,
+    const std::vector<T> &data,
+    const char *format,
+    size_t columns) {
+  auto *ptr = const_cast<T *>(data.data());
+  const auto size = static_cast<Py_ssize_t>(sizeof(T) * data.size());
+#if PY_MAJOR_VERSION >= 3
+  auto *exporter = PyObject_New(ArrayViewExporter, GetArrayViewExporterType());
+  if (exporter == nullptr) {
+    boost::python::throw_error_already_set();
+  }
+  exporter->owner = boost::python::incref(owner.ptr());
+  exporter->data = ptr;
+  exporter->size = size;
+  exporter->format = format;
+  exporter->itemsize = static_cast<Py_ssize_t>(sizeof(T) / columns);
+  exporter->ndim = columns > 1u ? 2 : 1;
+  exporter->shape[0u] = static_cast<Py_ssize_t>(data.size());
+  exporter->shape[1u] = static_cast<Py_ssize_t>(columns);
+  boost::python::handle<> handle(reinterpret_cast<PyObject *>(exporter));
+  auto *view = PyMemoryView_FromObject(handle.get());
+#else
+  (void) owner;
+  (void) format;
+  (void) columns;
+  auto *view = PyBuffer_FromMemory(ptr, size);
+#endif
+  return boost::python::object(boost::python::handle<>(view));
+}
+
+/// Exposes the column @a member of the WaypointArray held by @a self.
+template <typename T>
+static auto GetWaypointArrayColumn(
+    boost::python::object self,
+    std::vector<T> carla::road::element::WaypointArray::*member,
+    const char *format,
+    size_t columns = 1u) {
+  const carla::road::element::WaypointArray &array =
+      boost::python::extract<const carla::road::element::WaypointArray &>(self);
+  return MakeArrayView(self, array.*member, format, columns);
+}
+
+static auto GetWaypointArrayTransforms(boost::python::object self) {
+  static_assert(sizeof(carla::geom::Transform) == 6u * sizeof(float), "Unexpected padding in Transform");
+  return GetWaypointArrayColumn(self, &carla::road::element::WaypointArray::transform, "f", 6u);
+}
+
 static auto GetJunctionWaypoints(const carla::client::Junction &self, const carla::road::Lane::LaneType lane_type) {
   namespace py = boost::python;
   auto topology = self.GetWaypoints(lane_type);
@@ -150,6 +276,16 @@ void export_map() {
     .value("Negative", cr::SignalOrientation::Negative)
     .value("Both", cr::SignalOrientation::Both)
   ;
+
+  enum_<cr::RoadOption>("RoadOption")
+    .value("Void", cr::RoadOption::Void)
+    .value("Left", cr::RoadOption::Left)
+    .value("Right", cr::RoadOption::Right)
+    .value("Straight", cr::RoadOption::Straight)
+    .value("LaneFollow", cr::RoadOption::LaneFollow)
+    .value("ChangeLaneLeft", cr::RoadOption::ChangeLaneLeft)
+    .value("ChangeLaneRight", cr::RoadOption::ChangeLaneRight)
+  ;
   // ===========================================================================
   // -- Map --------------------------------------------------------------------
   // ===========================================================================
@@ -162,6 +298,8 @@ void export_map() {
     .def("get_waypoint_xodr", &cc::Map::GetWaypointXODR, (arg("road_id"), arg("lane_id"), arg("s")))
     .def("get_topology", &GetTopology)
     .def("generate_waypoints", CALL_RETURNING_LIST_1(cc::Map, GenerateWaypoints, double), (args("distance")))
+    .def("generate_waypoint_array", CONST_CALL_WITHOUT_GIL_1(cc::Map, GenerateWaypointArray, double), (arg("distance")))
+    .def("trace_route", &TraceRoute, (arg("origin"), arg("destination"), arg("sampling_resolution")=2.0))
     .def("transform_to_geolocation", &ToGeolocation, (arg("location")))
     .def("to_opendrive", CALL_RETURNING_COPY(cc::Map, GetOpenDrive))
     .def("save_to_disk", &SaveOpenDriveToDisk, (arg("path")=""))
@@ -178,6 +316,15 @@ void export_map() {
   // -- Helper objects ---------------------------------------------------------
   // ===========================================================================
 
+  class_<cre::WaypointArray>("WaypointArray", no_init)
+    .add_property("road_id", +[](object self) { return GetWaypointArrayColumn(self, &cre::WaypointArray::road_id, "I"); })
+    .add_property("section_id", +[](object self) { return GetWaypointArrayColumn(self, &cre::WaypointArray::section_id, "I"); })
+    .add_property("lane_id", +[](object self) { return GetWaypointArrayColumn(self, &cre::WaypointArray::lane_id, "i"); })
+    .add_property("s", +[](object self) { return GetWaypointArrayColumn(self, &cre::WaypointArray::s, "d"); })
+    .add_property("transform", &GetWaypointArrayTransforms)
+    .def("__len__", &cre::WaypointArray::size)
+  ;
+
   class_<cre::LaneMarking>("LaneMarking", no_init)
     .add_property("type", &cre::LaneMarking::type)
     .add_property("color", &cre::LaneMarking::color)
@@ -9,11 +9,54 @@
 #include <carla/client/LaneInvasionSensor.h>
 #include <carla/client/Sensor.h>
 #include <carla/client/ServerSideSensor.h>
+#include <carla/sensor/LatencyStats.h>
+
+#include <iomanip>
+#include <ostream>
+
+namespace carla {
+namespace sensor {
+
+  std::ostream &operator<<(std::ostream &out, const LatencyStats &stats) {
+    static const char *names[] = {"server", "network", "queue", "deserialize", "callback", "total"};
+    out << "SensorLatencyStats(count=" << stats.GetCount() << ", us";
+    for (auto i = 0u; i < static_cast<size_t>(LatencyStage::SIZE); ++i) {
+      const auto &histogram = stats.GetHistogram(static_cast<LatencyStage>(i));
+      out << ", " << names[i]
+          << "={p50=" << histogram.GetQuantile(0.5)
+          << ", p99=" << histogram.GetQuantile(0.99)
+          << ", max=" << histogram.GetMax() << '}';
+    }
+    out << ')';
+    return out;
+  }
+
+} // namespace sensor
+} // namespace carla
 
 static void SubscribeToStream(carla::client::Sensor &self, boost::python::object callback) {
   self.Listen(MakeCallback(std::move(callback)));
 }
 
+static uint64_t GetLatencyMin(const carla::sensor::LatencyStats &self, carla::sensor::LatencyStage stage) {
+  return self.GetHistogram(stage).GetMin();
+}
+
+static uint64_t GetLatencyMax(const carla::sensor::LatencyStats &self, carla::sensor::LatencyStage stage) {
+  return self.GetHistogram(stage).GetMax();
+}
+
+static double GetLatencyMean(const carla::sensor::LatencyStats &self, carla::sensor::LatencyStage stage) {
+  return self.GetHistogram(stage).GetMean();
+}
+
+static uint64_t GetLatencyPercentile(
+    const carla::sensor::LatencyStats &self,
+    carla::sensor::LatencyStage stage,
+    double percentile) {
+  return self.GetHistogram(stage).GetQuantile(percentile / 100.0);
+}
+
 static void SubscribeToGBuffer(
   carla::client::ServerSideSensor &self,
   uint32_t GBufferId,
@@ -24,6 +67,33 @@ static void SubscribeToGBuffer(
 void export_sensor() {
   using namespace boost::python;
   namespace cc = carla::client;
+  namespace cs = carla::sensor;
+  namespace cs11n = carla::sensor::s11n;
+
+  enum_<cs11n::CompressionType>("SensorCompression")
+    .value("Disabled", cs11n::CompressionType::None)
+    .value("LZ", cs11n::CompressionType::LZ)
+    .value("ImageDelta", cs11n::CompressionType::ImageDelta)
+  ;
+
+  enum_<cs::LatencyStage>("SensorLatencyStage")
+    .value("Server", cs::LatencyStage::Server)
+    .value("Network", cs::LatencyStage::Network)
+    .value("Queue", cs::LatencyStage::Queue)
+    .value("Deserialize", cs::LatencyStage::Deserialize)
+    .value("Callback", cs::LatencyStage::Callback)
+    .value("Total", cs::LatencyStage::Total)
+  ;
+
+  class_<cs::LatencyStats, boost::noncopyable, boost::shared_ptr<cs::LatencyStats>>("SensorLatencyStats", no_init)
+    .add_property("count", &cs::LatencyStats::GetCount)
+    .def("get_min", &GetLatencyMin, (arg("stage")))
+    .def("get_max", &GetLatencyMax, (arg("stage")))
+    .def("get_mean", &GetLatencyMean, (arg("stage")))
+    .def("get_percentile", &GetLatencyPercentile, (arg("stage"), arg("percentile")))
+    .def("clear", &cs::LatencyStats::Clear)
+    .def(self_ns::str(self_ns::self))
+  ;
 
   class_<cc::Sensor, bases<cc::Actor>, boost::noncopyable, boost::shared_ptr<cc::Sensor>>("Sensor", no_init)
     .add_property("is_listening", &cc::Sensor::IsListening)
@@ -38,6 +108,9 @@ void export_sensor() {
     .def("listen_to_gbuffer", &SubscribeToGBuffer, (arg("gbuffer_id"), arg("callback")))
     .def("is_listening_gbuffer", &cc::ServerSideSensor::IsListeningGBuffer, (arg("gbuffer_id")))
     .def("stop_gbuffer", &cc::ServerSideSensor::StopGBuffer, (arg("gbuffer_id")))
+    .def("set_compression", &cc::ServerSideSensor::SetCompression, (arg("compression")))
+    .def("enable_latency_stats", &cc::ServerSideSensor::EnableLatencyStats, (arg("enabled")=true))
+    .def("get_latency_stats", &cc::ServerSideSensor::GetLatencyStats)
     .def(self_ns::str(self_ns::self))
   ;
 
@@ -351,9 +351,22 @@ static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc
 }
 
 template <typename T>
-static std::string SavePointCloudToDisk(T &self, std::string path) {
+static std::string SavePointCloudToDisk(
+    T &self,
+    std::string path,
+    carla::pointcloud::PointCloudFormat format,
+    bool background) {
+  using carla::pointcloud::PointCloudIO;
   carla::PythonUtil::ReleaseGIL unlock;
-  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end());
+  if (background) {
+    return PointCloudIO::SaveToDiskAsync(std::move(path), self.begin(), self.end(), format);
+  }
+  return PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end(), format);
+}
+
+static void FlushPointClouds() {
+  carla::PythonUtil::ReleaseGIL unlock;
+  carla::pointcloud::PointCloudIO::Flush();
 }
 
 void export_sensor_data() {
@@ -387,6 +400,18 @@ void export_sensor_data() {
     .value("CityScapesPalette", EColorConverter::CityScapesPalette)
   ;
 
+  enum_<carla::pointcloud::PointCloudFormat>("PointCloudFormat")
+    .value("PLYAscii", carla::pointcloud::PointCloudFormat::PLYAscii)
+    .value("PLYBinary", carla::pointcloud::PointCloudFormat::PLYBinary)
+    .value("PCDAscii", carla::pointcloud::PointCloudFormat::PCDAscii)
+    .value("PCDBinary", carla::pointcloud::PointCloudFormat::PCDBinary)
+  ;
+
+  class_<carla::pointcloud::PointCloudIO>("PointCloudIO", no_init)
+    .def("flush", &FlushPointClouds)
+    .staticmethod("flush")
+  ;
+
   // The values here should match the ones in the enum EGBufferTextureID,
   // from the CARLA fork of Unreal Engine (Renderer/Public/GBufferView.h).
   enum_<int>("GBufferTextureID")
@@ -445,7 +470,7 @@ void export_sensor_data() {
     .add_property("channels", &csd::LidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::LidarMeasurement>)
     .def("get_point_count", &csd::LidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path"), arg("format")=carla::pointcloud::PointCloudFormat::PLYAscii, arg("background")=false))
     .def("__len__", &csd::LidarMeasurement::size)
     .def("__iter__", iterator<csd::LidarMeasurement>())
     .def("__getitem__", +[](const csd::LidarMeasurement &self, size_t pos) -> csd::LidarDetection {
@@ -462,7 +487,7 @@ void export_sensor_data() {
     .add_property("channels", &csd::SemanticLidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::SemanticLidarMeasurement>)
     .def("get_point_count", &csd::SemanticLidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path"), arg("format")=carla::pointcloud::PointCloudFormat::PLYAscii, arg("background")=false))
     .def("__len__", &csd::SemanticLidarMeasurement::size)
     .def("__iter__", iterator<csd::SemanticLidarMeasurement>())
     .def("__getitem__", +[](const csd::SemanticLidarMeasurement &self, size_t pos) -> csd::SemanticLidarDetection {
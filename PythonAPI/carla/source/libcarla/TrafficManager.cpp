@@ -11,6 +11,7 @@
 #include "boost/python/suite/indexing/vector_indexing_suite.hpp"
 
 #include "carla/trafficmanager/TrafficManager.h"
+#include "carla/trafficmanager/TrafficManagerReplay.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 
 using ActorPtr = carla::SharedPtr<carla::client::Actor>;
@@ -105,15 +106,27 @@ void export_trafficmanager() {
     .def("random_left_lanechange_percentage", &ctm::TrafficManager::SetRandomLeftLaneChangePercentage)
     .def("random_right_lanechange_percentage", &ctm::TrafficManager::SetRandomRightLaneChangePercentage)
     .def("set_synchronous_mode", &ctm::TrafficManager::SetSynchronousMode)
+    .def("set_number_of_shards", &ctm::TrafficManager::SetNumberOfShards, (arg("number_of_shards")))
     .def("set_hybrid_physics_mode", &ctm::TrafficManager::SetHybridPhysicsMode)
     .def("set_hybrid_physics_radius", &ctm::TrafficManager::SetHybridPhysicsRadius)
     .def("set_random_device_seed", &ctm::TrafficManager::SetRandomDeviceSeed)
     .def("set_osm_mode", &carla::traffic_manager::TrafficManager::SetOSMMode)
+    .def("set_junction_conflict_mode", &ctm::TrafficManager::SetJunctionConflictMode)
     .def("set_path", &InterSetCustomPath, (arg("empty_buffer") = true))
     .def("set_route", &InterSetImportedRoute, (arg("empty_buffer") = true))
     .def("set_respawn_dormant_vehicles", &carla::traffic_manager::TrafficManager::SetRespawnDormantVehicles)
     .def("set_boundaries_respawn_dormant_vehicles", &carla::traffic_manager::TrafficManager::SetBoundariesRespawnDormantVehicles)
     .def("get_next_action", &InterGetNextAction)
     .def("get_all_actions", &InterGetActionBuffer)
+    .def("start_recorder", &ctm::TrafficManager::StartRecorder, (arg("filename")))
+    .def("stop_recorder", &ctm::TrafficManager::StopRecorder)
     .def("shut_down", &ctm::TrafficManager::ShutDown);
+
+  class_<ctm::TrafficManagerReplay, boost::noncopyable>("TrafficManagerReplay",
+      init<std::string>((arg("filename"))))
+    .add_property("frame", &ctm::TrafficManagerReplay::GetFrame)
+    .add_property("number_of_ticks", &ctm::TrafficManagerReplay::GetNumberOfTicks)
+    .add_property("number_of_mismatches", &ctm::TrafficManagerReplay::GetNumberOfMismatches)
+    .def("tick", CALL_WITHOUT_GIL(ctm::TrafficManagerReplay, Tick))
+    .def("matches_recording", &ctm::TrafficManagerReplay::MatchesRecording);
 }
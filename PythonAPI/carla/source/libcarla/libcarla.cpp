@@ -7,7 +7,11 @@
 #include <carla/Memory.h>
 #include <carla/PythonUtil.h>
 #include <carla/Time.h>
+#include <carla/client/detail/ResponseFuture.h>
 
+#include <exception>
+#include <functional>
+#include <mutex>
 #include <ostream>
 #include <type_traits>
 #include <vector>
@@ -216,6 +220,100 @@ static auto MakeCallback(boost::python::object callback) {
   };
 }
 
+/// Type-erased future exposed to Python as carla.Future. It can be waited
+/// for with result(), or awaited from asyncio coroutines.
+class PythonFuture {
+public:
+
+  template <typename T>
+  explicit PythonFuture(carla::client::detail::ResponseFuture<T> future)
+    : _state(std::make_shared<State>()) {
+    auto shared = std::make_shared<carla::client::detail::ResponseFuture<T>>(std::move(future));
+    _state->is_ready = [shared]() { return shared->IsReady(); };
+    _state->get = [shared]() { return ToPython(GetWithoutGIL(*shared)); };
+  }
+
+  bool done() const {
+    return _state->has_result || _state->is_ready();
+  }
+
+  /// Blocks until the response arrives, subsequent calls return the same
+  /// result or raise the same exception. Can be called from several threads.
+  boost::python::object result() {
+    {
+      // Wait for any other thread getting the result without holding the GIL.
+      carla::PythonUtil::ReleaseGIL unlock;
+      _state->mutex.lock();
+    }
+    std::lock_guard<std::mutex> lock(_state->mutex, std::adopt_lock);
+    if (!_state->has_result) {
+      try {
+        _state->result = _state->get();
+      } catch (...) {
+        _state->error = std::current_exception();
+      }
+      _state->has_result = true;
+    }
+    if (_state->error != nullptr) {
+      std::rethrow_exception(_state->error);
+    }
+    return _state->result;
+  }
+
+  /// Awaitable waiting for the result in the default executor of the running
+  /// event loop, so the loop sleeps instead of polling the future.
+  static boost::python::object await(boost::python::object self) {
+    namespace py = boost::python;
+    py::object loop = py::import("asyncio").attr("get_event_loop")();
+    py::object result = self.attr("result");
+    py::object waiter = loop.attr("run_in_executor")(py::object(), result);
+    return waiter.attr("__await__")();
+  }
+
+private:
+
+  struct State {
+    std::function<bool()> is_ready;
+    std::function<boost::python::object()> get;
+    std::mutex mutex;
+    boost::python::object result;
+    std::exception_ptr error;
+    bool has_result = false;
+  };
+
+  template <typename T>
+  static T GetWithoutGIL(carla::client::detail::ResponseFuture<T> &future) {
+    carla::PythonUtil::ReleaseGIL unlock;
+    return future.Get();
+  }
+
+  template <typename T>
+  static boost::python::object ToPython(const T &value) {
+    return boost::python::object(value);
+  }
+
+  template <typename T>
+  static boost::python::object ToPython(const std::vector<T> &values) {
+    boost::python::list result;
+    for (auto &&item : values) {
+      result.append(item);
+    }
+    return result;
+  }
+
+  std::shared_ptr<State> _state;
+};
+
+// Convenient for requests that return a ResponseFuture, converts it to a
+// carla.Future.
+#define CALL_RETURNING_FUTURE(cls, fn) +[](const cls &self) { \
+      return PythonFuture(self.fn()); \
+    }
+
+#define CALL_RETURNING_FUTURE_1(cls, fn, T1_) +[](const cls &self, T1_ t1) { \
+      return PythonFuture(self.fn(std::forward<T1_>(t1))); \
+    }
+
 #include "Geom.cpp"
 #include "Actor.cpp"
 #include "Blueprint.cpp"
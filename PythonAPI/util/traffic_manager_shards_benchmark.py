@@ -0,0 +1,173 @@
+#!/usr/bin/env python
+
+# Copyright (c) 2021 Computer Vision Center (CVC) at the Universitat Autonoma de
+# Barcelona (UAB).
+#
+# This work is licensed under the terms of the MIT license.
+# For a copy, see <https://opensource.org/licenses/MIT>.
+
+"""
+Measures how the synchronous tick of the traffic manager scales with the
+number of shards its vehicles are split into.
+
+The script spawns a fleet of vehicles on autopilot, and for every number of
+shards it ticks the world in synchronous mode and reports the mean time per
+tick.
+
+Vehicles only see the ones of other shards as unregistered actors, so the
+traffic does not behave the same with each number of shards; only the tick
+times are comparable.
+"""
+
+import glob
+import os
+import sys
+import time
+
+try:
+    sys.path.append(glob.glob('../carla/dist/carla-*%d.%d-%s.egg' % (
+        sys.version_info.major,
+        sys.version_info.minor,
+        'win-amd64' if os.name == 'nt' else 'linux-x86_64'))[0])
+except IndexError:
+    pass
+
+import carla
+
+import argparse
+import logging
+import random
+
+
+def spawn_vehicles(client, world, number_of_vehicles, tm_port):
+    blueprints = [bp for bp in world.get_blueprint_library().filter('vehicle.*')
+                  if int(bp.get_attribute('number_of_wheels')) == 4]
+    spawn_points = world.get_map().get_spawn_points()
+    random.shuffle(spawn_points)
+    if number_of_vehicles > len(spawn_points):
+        logging.warning('requested %d vehicles, but the map only has %d spawn points',
+                        number_of_vehicles, len(spawn_points))
+        number_of_vehicles = len(spawn_points)
+
+    batch = []
+    for transform in spawn_points[:number_of_vehicles]:
+        blueprint = random.choice(blueprints)
+        batch.append(carla.command.SpawnActor(blueprint, transform)
+                     .then(carla.command.SetAutopilot(carla.command.FutureActor, True, tm_port)))
+
+    vehicles = []
+    for response in client.apply_batch_sync(batch, True):
+        if response.error:
+            logging.error(response.error)
+        else:
+            vehicles.append(response.actor_id)
+    return vehicles
+
+
+def measure(world, warmup_ticks, ticks):
+    for _ in range(warmup_ticks):
+        world.tick()
+    start = time.time()
+    for _ in range(ticks):
+        world.tick()
+    return (time.time() - start) / ticks
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__)
+    argparser.add_argument(
+        '--host',
+        metavar='H',
+        default='127.0.0.1',
+        help='IP of the host server (default: 127.0.0.1)')
+    argparser.add_argument(
+        '-p', '--port',
+        metavar='P',
+        default=2000,
+        type=int,
+        help='TCP port to listen to (default: 2000)')
+    argparser.add_argument(
+        '--tm-port',
+        metavar='P',
+        default=8000,
+        type=int,
+        help='Port to communicate with TM (default: 8000)')
+    argparser.add_argument(
+        '-n', '--number-of-vehicles',
+        metavar='N',
+        default=200,
+        type=int,
+        help='Number of vehicles (default: 200)')
+    argparser.add_argument(
+        '--shards',
+        metavar='S',
+        nargs='+',
+        default=[1, 2, 4, 8],
+        type=int,
+        help='Numbers of shards to measure (default: 1 2 4 8)')
+    argparser.add_argument(
+        '--ticks',
+        metavar='T',
+        default=200,
+        type=int,
+        help='Number of measured ticks for each number of shards (default: 200)')
+    argparser.add_argument(
+        '--warmup-ticks',
+        metavar='T',
+        default=50,
+        type=int,
+        help='Number of ticks before measuring (default: 50)')
+    argparser.add_argument(
+        '--seed',
+        metavar='S',
+        default=0,
+        type=int,
+        help='Random seed (default: 0)')
+    args = argparser.parse_args()
+
+    logging.basicConfig(format='%(levelname)s: %(message)s', level=logging.INFO)
+    random.seed(args.seed)
+
+    client = carla.Client(args.host, args.port)
+    client.set_timeout(20.0)
+    world = client.get_world()
+    original_settings = world.get_settings()
+
+    traffic_manager = client.get_trafficmanager(args.tm_port)
+    traffic_manager.set_random_device_seed(args.seed)
+    vehicles = []
+
+    try:
+        settings = world.get_settings()
+        settings.synchronous_mode = True
+        settings.fixed_delta_seconds = 0.05
+        world.apply_settings(settings)
+        traffic_manager.set_synchronous_mode(True)
+
+        vehicles = spawn_vehicles(client, world, args.number_of_vehicles, args.tm_port)
+        print('spawned %d vehicles' % len(vehicles))
+
+        baseline = None
+        print('%8s %12s %9s' % ('shards', 'ms/tick', 'speedup'))
+        for number_of_shards in args.shards:
+            traffic_manager.set_number_of_shards(number_of_shards)
+            seconds_per_tick = measure(world, args.warmup_ticks, args.ticks)
+            if baseline is None:
+                baseline = seconds_per_tick
+            print('%8d %12.2f %8.2fx' % (
+                number_of_shards, 1000.0 * seconds_per_tick, baseline / seconds_per_tick))
+
+    finally:
+        traffic_manager.set_number_of_shards(1)
+        client.apply_batch([carla.command.DestroyActor(x) for x in vehicles])
+        traffic_manager.set_synchronous_mode(False)
+        world.apply_settings(original_settings)
+        time.sleep(0.5)
+
+
+if __name__ == '__main__':
+
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
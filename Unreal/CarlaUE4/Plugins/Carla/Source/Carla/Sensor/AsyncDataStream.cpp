@@ -22,4 +22,7 @@ inline FAsyncDataStreamTmpl<T>::FAsyncDataStreamTmpl(
           FCarlaEngine::GetFrameCounter(),
           Timestamp,
           Sensor.GetActorTransform());
-    }()) {}
+    }()),
+    EnqueueTime(Stream.IsTimingEnabled() ?
+        carla::sensor::s11n::SensorHeaderSerializer::Now() :
+        0u) {}
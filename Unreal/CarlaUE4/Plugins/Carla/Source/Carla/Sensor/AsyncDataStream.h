@@ -10,6 +10,7 @@
 #include <carla/Buffer.h>
 #include <carla/Logging.h>
 #include <carla/sensor/SensorRegistry.h>
+#include <carla/sensor/s11n/PayloadCompression.h>
 #include <carla/sensor/s11n/SensorHeaderSerializer.h>
 #include <carla/streaming/Stream.h>
 #include <compiler/enable-ue4-macros.h>
@@ -86,6 +87,9 @@ private:
   StreamType Stream;
 
   carla::Buffer Header;
+
+  /// When the header was serialized, zero if the stream has timing disabled.
+  uint64_t EnqueueTime = 0u;
 };
 
 // =============================================================================
@@ -104,7 +108,27 @@ template <typename T>
 template <typename SensorT, typename... ArgsT>
 inline void FAsyncDataStreamTmpl<T>::Send(SensorT &Sensor, ArgsT &&... Args)
 {
-  Stream.Write(
-      std::move(Header),
-      carla::sensor::SensorRegistry::Serialize(Sensor, std::forward<ArgsT>(Args)...));
+  carla::Buffer Payload =
+      carla::sensor::SensorRegistry::Serialize(Sensor, std::forward<ArgsT>(Args)...);
+  const auto Compression = Stream.GetCompression();
+  if (Compression != 0u)
+  {
+    Payload = carla::sensor::s11n::PayloadCompression::Compress(
+        static_cast<carla::sensor::s11n::CompressionType>(Compression),
+        Payload.data(),
+        Payload.size(),
+        Stream.MakeBuffer());
+    carla::sensor::s11n::SensorHeaderSerializer::SetCompression(Header, Compression);
+  }
+  if (EnqueueTime != 0u)
+  {
+    using Serializer = carla::sensor::s11n::SensorHeaderSerializer;
+    Serializer::SetTiming(Header, true);
+    Stream.Write(
+        std::move(Header),
+        std::move(Payload),
+        Serializer::SerializeTiming(EnqueueTime, Serializer::Now()));
+    return;
+  }
+  Stream.Write(std::move(Header), std::move(Payload));
 }
@@ -27,6 +27,7 @@
 #include "Misc/FileHelper.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/AsyncLogger.h>
 #include <carla/Functional.h>
 #include <carla/multigpu/router.h>
 #include <carla/Version.h>
@@ -36,6 +37,7 @@
 #include <carla/rpc/ActorDescription.h>
 #include <carla/rpc/BoneTransformDataIn.h>
 #include <carla/rpc/Command.h>
+#include <carla/rpc/CommandBatch.h>
 #include <carla/rpc/CommandResponse.h>
 #include <carla/rpc/DebugShape.h>
 #include <carla/rpc/EnvironmentObject.h>
@@ -62,6 +64,7 @@
 #include <carla/rpc/WalkerControl.h>
 #include <carla/rpc/VehicleWheels.h>
 #include <carla/rpc/WeatherParameters.h>
+#include <carla/sensor/s11n/PayloadCompression.h>
 #include <carla/streaming/detail/Types.h>
 #include <carla/rpc/Texture.h>
 #include <carla/rpc/MaterialParameter.h>
@@ -800,6 +803,61 @@ void FCarlaServer::FPimpl::BindActions()
     }
   };
 
+  BIND_SYNC(set_sensor_compression) << [this](
+      carla::streaming::detail::stream_id_type sensor_id,
+      uint8_t compression) -> R<void>
+  {
+    REQUIRE_CARLA_EPISODE();
+    if (compression > static_cast<uint8_t>(carla::sensor::s11n::CompressionType::ImageDelta))
+    {
+      return RespondError(
+          "set_sensor_compression",
+          "Unknown compression",
+          " Compression: " + FString::FromInt(compression));
+    }
+    FString Desc = Episode->GetActorDescriptionFromStream(sensor_id);
+    if (SecondaryServer->HasClientsConnected() && Desc != "sensor.other.collision")
+    {
+      // multi-gpu, the data is sent by the secondary servers.
+      return RespondError(
+          "set_sensor_compression",
+          ECarlaServerResponse::FunctionNotSupported,
+          " Compression is not supported in multi-GPU mode");
+    }
+    if (!StreamingServer.SetCompression(sensor_id, compression))
+    {
+      return RespondError(
+          "set_sensor_compression",
+          ECarlaServerResponse::ActorNotFound,
+          " Stream Id: " + FString::FromInt(sensor_id));
+    }
+    return R<void>::Success();
+  };
+
+  BIND_SYNC(set_sensor_timing) << [this](
+      carla::streaming::detail::stream_id_type sensor_id,
+      bool enabled) -> R<void>
+  {
+    REQUIRE_CARLA_EPISODE();
+    FString Desc = Episode->GetActorDescriptionFromStream(sensor_id);
+    if (SecondaryServer->HasClientsConnected() && Desc != "sensor.other.collision")
+    {
+      // multi-gpu, the data is sent by the secondary servers.
+      return RespondError(
+          "set_sensor_timing",
+          ECarlaServerResponse::FunctionNotSupported,
+          " Timing is not supported in multi-GPU mode");
+    }
+    if (!StreamingServer.SetTimingEnabled(sensor_id, enabled))
+    {
+      return RespondError(
+          "set_sensor_timing",
+          ECarlaServerResponse::ActorNotFound,
+          " Stream Id: " + FString::FromInt(sensor_id));
+    }
+    return R<void>::Success();
+  };
+
   // ~~ Actor physics ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
   BIND_SYNC(set_actor_location) << [this](
@@ -2332,6 +2390,66 @@ void FCarlaServer::FPimpl::BindActions()
     return result;
   };
 
+  // Columnar batches of a single command, applied in a tight loop without
+  // building a response per actor. They return the ids of the actors the
+  // command could not be applied to.
+
+  BIND_SYNC(apply_vehicle_controls) << [=](
+      const cr::VehicleControlBatch &Batch,
+      bool do_tick_cue) -> R<std::vector<cr::ActorId>>
+  {
+    REQUIRE_CARLA_EPISODE();
+    if (!Batch.IsValid())
+    {
+      return RespondError("apply_vehicle_controls", FString("malformed batch"));
+    }
+    std::vector<cr::ActorId> Failed;
+    for (size_t i = 0u; i < Batch.size(); ++i)
+    {
+      const cr::ActorId ActorId = Batch.GetActor(i);
+      FCarlaActor* CarlaActor = Episode->FindCarlaActor(ActorId);
+      if (!CarlaActor ||
+          CarlaActor->ApplyControlToVehicle(Batch.GetValue(i), EVehicleInputPriority::Client) !=
+              ECarlaServerResponse::Success)
+      {
+        Failed.emplace_back(ActorId);
+      }
+    }
+    if (do_tick_cue)
+    {
+      tick_cue();
+    }
+    return Failed;
+  };
+
+  BIND_SYNC(apply_transforms) << [=](
+      const cr::TransformBatch &Batch,
+      bool do_tick_cue) -> R<std::vector<cr::ActorId>>
+  {
+    REQUIRE_CARLA_EPISODE();
+    if (!Batch.IsValid())
+    {
+      return RespondError("apply_transforms", FString("malformed batch"));
+    }
+    std::vector<cr::ActorId> Failed;
+    for (size_t i = 0u; i < Batch.size(); ++i)
+    {
+      const cr::ActorId ActorId = Batch.GetActor(i);
+      FCarlaActor* CarlaActor = Episode->FindCarlaActor(ActorId);
+      if (!CarlaActor)
+      {
+        Failed.emplace_back(ActorId);
+        continue;
+      }
+      CarlaActor->SetActorGlobalTransform(Batch.GetValue(i), ETeleportType::TeleportPhysics);
+    }
+    if (do_tick_cue)
+    {
+      tick_cue();
+    }
+    return Failed;
+  };
+
   // ~~ Light Subsystem ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
   BIND_SYNC(query_lights_state) << [this](std::string client) -> R<std::vector<cr::LightState>>
@@ -2488,6 +2606,12 @@ void FCarlaServer::AsyncRun(uint32 NumberOfWorkerThreads)
   UE_LOG(LogCarla, Log, TEXT("FCarlaServer AsyncRun %d, RPCThreads %d, StreamingThreads %d, SecondaryThreads %d"),
         NumberOfWorkerThreads, RPCThreads, StreamingThreads, SecondaryThreads);
 
+  // Keep LibCarla's logging off the network threads.
+  if (FParse::Param(FCommandLine::Get(), TEXT("carla-async-log")))
+  {
+    carla::logging::AsyncLogger::Enable({});
+  }
+
   Pimpl->Server.AsyncRun(RPCThreads);
   Pimpl->StreamingServer.AsyncRun(StreamingThreads);
   Pimpl->SecondaryServer->AsyncRun(SecondaryThreads);
@@ -2520,6 +2644,7 @@ void FCarlaServer::Stop()
     Pimpl->Server.Stop();
     Pimpl->SecondaryServer->Stop();
   }
+  carla::logging::AsyncLogger::Disable();
 }
 
 FDataStream FCarlaServer::OpenStream() const